@@ -0,0 +1,362 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <meteoio/MeteoIO.h>
+
+#include "generators.h"
+
+using namespace std;
+using namespace mio; //The MeteoIO namespace is called mio
+
+//Benchmarks of the core hot paths, on synthetic data (see generators.h). The results are written as JSON
+//so they can be compared between releases (the progress is printed on stderr).
+//Usage: benchmarks [--quick] [--path dir] [--output results.json]
+
+static double min_time = 1.; //each benchmark is repeated until it has run at least this long (in seconds)
+static const size_t max_iterations = 1000;
+
+class Results {
+	public:
+		Results() : names(), sizes(), iterations(), times() {}
+
+		void add(const std::string& name, const std::string& size, const size_t& nr_iterations, const double& total_time) {
+			names.push_back(name);
+			sizes.push_back(size);
+			iterations.push_back(nr_iterations);
+			times.push_back(total_time);
+			std::cerr << std::setw(40) << std::left << name << std::setw(12) << size << std::right
+			          << std::setw(12) << std::fixed << std::setprecision(3) << total_time/static_cast<double>(nr_iterations)*1e3 << " ms"
+			          << " (" << nr_iterations << " iterations)" << std::endl;
+		}
+
+		void writeJSON(std::ostream& os) const {
+			os << "{\n";
+			os << "  \"library\": \"MeteoIO " << getLibVersion() << "\",\n";
+			os << "  \"min_time\": " << min_time << ",\n";
+			os << "  \"benchmarks\": [\n";
+			for (size_t ii=0; ii<names.size(); ii++) {
+				os << "    {\"name\": \"" << names[ii] << "\", \"size\": \"" << sizes[ii] << "\", ";
+				os << "\"iterations\": " << iterations[ii] << ", ";
+				os << "\"time_ms\": " << std::setprecision(6) << times[ii]/static_cast<double>(iterations[ii])*1e3 << "}";
+				os << ((ii+1<names.size())? ",\n" : "\n");
+			}
+			os << "  ]\n";
+			os << "}\n";
+		}
+
+	private:
+		std::vector<std::string> names, sizes;
+		std::vector<size_t> iterations;
+		std::vector<double> times;
+};
+
+//run the benchmark's body repeatedly, timing only the body
+#define BENCH_LOOP(results, name, size, body) \
+	{ \
+		Timer timer; \
+		size_t nr_iterations = 0; \
+		do { \
+			timer.start(); \
+			body; \
+			timer.stop(); \
+			nr_iterations++; \
+		} while (timer.getElapsed()<min_time && nr_iterations<max_iterations); \
+		results.add(name, size, nr_iterations, timer.getElapsed()); \
+	}
+
+static std::string gridSize(const DEMObject& dem)
+{
+	std::ostringstream ss;
+	ss << dem.getNx() << "x" << dem.getNy();
+	return ss.str();
+}
+
+static void benchInterpol2D(Results& results, const size_t& n)
+{
+	DEMObject dem;
+	makeDEM(n, n, 100., dem);
+	const std::string size( gridSize(dem) );
+
+	std::vector<StationData> vecStations;
+	makeStations(30, dem, vecStations);
+	std::vector<double> vecTA, vecHNW;
+	makeStationValues(vecStations, MeteoData::TA, vecTA);
+	makeStationValues(vecStations, MeteoData::HNW, vecHNW);
+
+	Grid2DObject grid, ta, vw, dw;
+	BENCH_LOOP(results, "Interpol2D::constant", size, Interpol2D::constant(273.15, dem, grid));
+	BENCH_LOOP(results, "Interpol2D::stdPressure", size, Interpol2D::stdPressure(dem, grid));
+	BENCH_LOOP(results, "Interpol2D::IDW", size, Interpol2D::IDW(vecTA, vecStations, dem, grid));
+	BENCH_LOOP(results, "Interpol2D::LocalLapseIDW", size, Interpol2D::LocalLapseIDW(vecTA, vecStations, dem, 6, grid));
+
+	std::vector<double> distances, variances;
+	for (size_t ii=0; ii<20; ii++) {
+		distances.push_back( static_cast<double>(ii+1)*500. );
+		variances.push_back( 0.5 + 0.001*distances.back() );
+	}
+	const Fit1D variogram(Fit1D::LINVARIO, distances, variances);
+	BENCH_LOOP(results, "Interpol2D::ODKriging", size, Interpol2D::ODKriging(vecTA, vecStations, dem, variogram, grid));
+
+	Interpol2D::IDW(vecTA, vecStations, dem, ta);
+	vw = Grid2DObject(dem, 4.);
+	dw = Grid2DObject(dem, 270.);
+	BENCH_LOOP(results, "Interpol2D::ListonWind", size, Grid2DObject VW(vw); Grid2DObject DW(dw); Interpol2D::ListonWind(dem, VW, DW));
+	BENCH_LOOP(results, "Interpol2D::RyanWind", size, Grid2DObject VW(vw); Grid2DObject DW(dw); Interpol2D::RyanWind(dem, VW, DW));
+
+	Interpol2D::IDW(vecHNW, vecStations, dem, grid);
+	BENCH_LOOP(results, "Interpol2D::SteepSlopeRedistribution", size, Grid2DObject hnw(grid); Interpol2D::SteepSlopeRedistribution(dem, ta, hnw));
+	BENCH_LOOP(results, "Interpol2D::CurvatureCorrection", size, Grid2DObject hnw(grid); Interpol2D::CurvatureCorrection(dem, ta, hnw));
+	BENCH_LOOP(results, "Interpol2D::Winstral", size, Grid2DObject hnw(grid); Interpol2D::Winstral(dem, ta, 300., 270., hnw));
+}
+
+static void benchDEM(Results& results, const size_t& n)
+{
+	DEMObject dem;
+	makeDEM(n, n, 100., dem);
+	const std::string size( gridSize(dem) );
+
+	BENCH_LOOP(results, "DEMObject::update", size, dem.update());
+	BENCH_LOOP(results, "DEMObject::update(CORR)", size, dem.update(DEMObject::CORR));
+}
+
+static void benchMatrix(Results& results, const size_t& n)
+{
+	Matrix A, B, X;
+	makeMatrix(n, A);
+	makeMatrix(n, B);
+	std::ostringstream ss;
+	ss << n << "x" << n;
+
+	BENCH_LOOP(results, "Matrix::solve", ss.str(), Matrix::solve(A, B, X));
+	BENCH_LOOP(results, "Matrix::inv", ss.str(), Matrix M(A); M.inv());
+	BENCH_LOOP(results, "Matrix::operator*", ss.str(), X = A*B);
+	BENCH_LOOP(results, "Matrix::det", ss.str(), A.det());
+}
+
+static void benchIO(Results& results, const std::string& path, const size_t& nr_stations, const size_t& nr_days, const size_t& dem_size)
+{
+	//generate the input files
+	Config cfg;
+	makeConfig(path, nr_stations, cfg);
+	DEMObject dem;
+	makeDEM(dem_size, dem_size, 100., dem);
+	std::vector<StationData> vecStations;
+	makeStations(nr_stations, dem, vecStations);
+	const Date start_date(2009, 1, 1, 0, 0, 1.);
+	const Date end_date( start_date + static_cast<double>(nr_days) - 1./24. );
+	{
+		Config cfg_out; //without the input stations, since they don't exist yet
+		makeConfig(path, 0, cfg_out);
+		IOManager io(cfg_out);
+		std::vector< std::vector<MeteoData> > vecMeteo;
+		makeTimeSeries(vecStations, start_date, nr_days*24, 1./24., vecMeteo);
+		io.write2DGrid(dem, "dem.asc");
+		io.writeMeteoData(vecMeteo);
+	}
+
+	std::ostringstream ss_series;
+	ss_series << nr_stations << "x" << nr_days << "d";
+	const std::string series( ss_series.str() );
+
+	//parsing
+	BENCH_LOOP(results, "ARCIO::readDEM", gridSize(dem), IOManager io(cfg); DEMObject dem_in; io.readDEM(dem_in));
+	BENCH_LOOP(results, "SMETIO::readMeteoData", series,
+	           IOManager io(cfg); io.setProcessingLevel(IOManager::raw); std::vector< std::vector<MeteoData> > vecMeteo; io.getMeteoData(start_date, end_date, vecMeteo));
+
+	//buffering and filtering
+	BENCH_LOOP(results, "BufferedIOHandler::fillBuffer", series,
+	           IOManager io(cfg); io.setProcessingLevel(IOManager::resampled); std::vector< std::vector<MeteoData> > vecMeteo; io.getMeteoData(start_date, end_date, vecMeteo));
+
+	Config cfg_filters(cfg);
+	cfg_filters.addKey("TA::filter1", "Filters", "min_max");
+	cfg_filters.addKey("TA::arg1", "Filters", "230 330");
+	cfg_filters.addKey("TA::filter2", "Filters", "rate");
+	cfg_filters.addKey("TA::arg2", "Filters", "0.01");
+	cfg_filters.addKey("RH::filter1", "Filters", "min_max");
+	cfg_filters.addKey("RH::arg1", "Filters", "0.01 1.2");
+	cfg_filters.addKey("VW::filter1", "Filters", "mean_avg");
+	cfg_filters.addKey("VW::arg1", "Filters", "soft left 4 14400");
+	cfg_filters.addKey("ISWR::filter1", "Filters", "median_avg");
+	cfg_filters.addKey("ISWR::arg1", "Filters", "soft center 3 14400");
+	cfg_filters.addKey("HNW::filter1", "Filters", "min");
+	cfg_filters.addKey("HNW::arg1", "Filters", "soft 0.");
+	BENCH_LOOP(results, "MeteoProcessor::process", series,
+	           IOManager io(cfg_filters); io.setProcessingLevel(IOManager::filtered); std::vector< std::vector<MeteoData> > vecMeteo; io.getMeteoData(start_date, end_date, vecMeteo));
+
+	//resampling at half hours, so all the points have to be interpolated (skipping the first day, for the accumulation)
+	Config cfg_resampling(cfg);
+	cfg_resampling.addKey("TA::resample", "Interpolations1D", "linear");
+	cfg_resampling.addKey("RH::resample", "Interpolations1D", "linear");
+	cfg_resampling.addKey("HNW::resample", "Interpolations1D", "accumulate");
+	cfg_resampling.addKey("HNW::accumulate", "Interpolations1D", "3600");
+	BENCH_LOOP(results, "Meteo1DInterpolator::resampleData", series,
+	           IOManager io(cfg_resampling); io.setProcessingLevel(IOManager::resampled); std::vector<MeteoData> vecMeteo;
+	           for (Date date(start_date+1.+0.5/24.); date<end_date; date+=1./24.) io.getMeteoData(date, vecMeteo));
+}
+
+static void sunMeeus(const std::vector<StationData>& vecStations, const std::vector<double>& vecJulian)
+{
+	SunMeeus sun;
+	double azi, elev;
+	for (size_t ii=0; ii<vecStations.size(); ii++) {
+		for (size_t jj=0; jj<vecJulian.size(); jj++) {
+			sun.setAll(vecStations[ii].position.getLat(), vecStations[ii].position.getLon(), vecJulian[jj]);
+			sun.getHorizontalCoordinates(azi, elev);
+		}
+	}
+}
+
+static void sunEphemeris(const std::vector<StationData>& vecStations, const std::vector<double>& vecJulian)
+{
+	SunEphemeris ephemeris;
+	std::vector<double> azi, elev, ecc;
+	for (size_t ii=0; ii<vecStations.size(); ii++)
+		ephemeris.getHorizontalCoordinates(vecJulian, vecStations[ii].position.getLat(), vecStations[ii].position.getLon(), azi, elev, ecc);
+}
+
+//the Sun's position for many stations at the same dates, as done by the radiation generators
+static void benchSun(Results& results, const size_t& nr_stations, const size_t& nr_days)
+{
+	DEMObject dem;
+	makeDEM(50, 50, 100., dem);
+	std::vector<StationData> vecStations;
+	makeStations(nr_stations, dem, vecStations);
+	std::vector<double> vecJulian;
+	for (size_t ii=0; ii<nr_days*24; ii++) vecJulian.push_back(2454832.5 + static_cast<double>(ii)/24.);
+
+	std::ostringstream ss;
+	ss << nr_stations << "x" << nr_days << "d";
+	const std::string series( ss.str() );
+
+	BENCH_LOOP(results, "SunMeeus::setAll", series, sunMeeus(vecStations, vecJulian));
+	BENCH_LOOP(results, "SunEphemeris::getHorizontalCoordinates", series, sunEphemeris(vecStations, vecJulian));
+}
+
+static void fillMissing(const DataGenerator& generator, const std::vector< std::vector<MeteoData> >& vecMeteo)
+{
+	std::vector< std::vector<MeteoData> > vecFilled( vecMeteo );
+	generator.fillMissing(vecFilled);
+}
+
+//the data generators for the radiation and humidity, on the hourly time series of a network of stations
+static void benchGenerators(Results& results, const size_t& nr_stations, const size_t& nr_days)
+{
+	DEMObject dem;
+	makeDEM(50, 50, 100., dem);
+	std::vector<StationData> vecStations;
+	makeStations(nr_stations, dem, vecStations);
+	std::vector< std::vector<MeteoData> > vecMeteo;
+	makeTimeSeries(vecStations, Date(2009, 1, 1, 0, 0, 1.), nr_days*24, 1./24., vecMeteo);
+
+	Config cfg;
+	cfg.addKey("RH::generators", "Generators", "RELHUM CST");
+	cfg.addKey("RH::Cst", "Generators", "0.7");
+	cfg.addKey("ILWR::generators", "Generators", "ALLSKY_LW CLEARSKY_LW");
+	cfg.addKey("ILWR::allsky_lw", "Generators", "OMSTEDT");
+	cfg.addKey("ILWR::clearsky_lw", "Generators", "DILLEY");
+	cfg.addKey("ISWR::generators", "Generators", "POT_RADIATION");
+	const DataGenerator generator(cfg);
+
+	std::ostringstream ss;
+	ss << nr_stations << "x" << nr_days << "d";
+	const std::string series( ss.str() );
+
+	BENCH_LOOP(results, "DataGenerator::fillMissing", series, fillMissing(generator, vecMeteo));
+}
+
+//a windowed filter on a long, high resolution time series: the cost should not depend on the window's width
+static void benchFilter(Results& results, const std::vector<MeteoData>& vecMeteo, const MeteoData::Parameters& param,
+                        const std::string& block_name, const std::string& window, const std::string& series)
+{
+	std::vector<std::string> vec_args;
+	IOUtils::readLineToVec("soft center 3 "+window, vec_args);
+	ProcessingBlock *block = BlockFactory::getBlock(block_name, vec_args, "");
+	std::vector<MeteoData> vecFiltered;
+	BENCH_LOOP(results, block_name + "(" + window + "s)", series, block->process(param, vecMeteo, vecFiltered));
+	delete block;
+}
+
+static void benchFilters(Results& results, const size_t& nr_days)
+{
+	//one station at a one minute time resolution
+	DEMObject dem;
+	makeDEM(50, 50, 100., dem);
+	std::vector<StationData> vecStations;
+	makeStations(1, dem, vecStations);
+	std::vector< std::vector<MeteoData> > vecMeteo;
+	makeTimeSeries(vecStations, Date(2009, 1, 1, 0, 0, 1.), nr_days*1440, 1./1440., vecMeteo);
+
+	std::ostringstream ss;
+	ss << vecMeteo[0].size() << " pts";
+	const std::string series( ss.str() );
+
+	benchFilter(results, vecMeteo[0], MeteoData::TA, "MEAN_AVG", "3600", series);
+	benchFilter(results, vecMeteo[0], MeteoData::TA, "MEAN_AVG", "86400", series);
+	benchFilter(results, vecMeteo[0], MeteoData::TA, "STD_DEV", "86400", series);
+	benchFilter(results, vecMeteo[0], MeteoData::TA, "WMA_SMOOTHING", "86400", series);
+	benchFilter(results, vecMeteo[0], MeteoData::VW, "WIND_AVG", "86400", series);
+}
+
+int main(int argc, char** argv) {
+	std::string path(".");
+	std::string output;
+	bool quick = false;
+	for (int ii=1; ii<argc; ii++) {
+		if (strcmp(argv[ii], "--quick")==0) {
+			quick = true;
+		} else if (strcmp(argv[ii], "--path")==0 && ii+1<argc) {
+			path = argv[++ii];
+		} else if (strcmp(argv[ii], "--output")==0 && ii+1<argc) {
+			output = argv[++ii];
+		} else {
+			std::cout << "Usage: " << argv[0] << " [--quick] [--path dir] [--output results.json]\n";
+			std::cout << "\t--quick\t\tsmaller data sets and shorter runs, as a smoke test\n";
+			std::cout << "\t--path\t\tdirectory where to write the synthetic input files (default: current directory)\n";
+			std::cout << "\t--output\tfile where to write the JSON results (default: standard output)\n";
+			return EXIT_FAILURE;
+		}
+	}
+	if (quick) min_time = 0.05;
+
+	Results results;
+	try {
+		std::vector<size_t> grid_sizes;
+		grid_sizes.push_back(100);
+		if (!quick) {
+			grid_sizes.push_back(400);
+			grid_sizes.push_back(1000);
+		}
+		for (size_t ii=0; ii<grid_sizes.size(); ii++) {
+			benchInterpol2D(results, grid_sizes[ii]);
+			benchDEM(results, grid_sizes[ii]);
+		}
+
+		benchMatrix(results, 50);
+		if (!quick) benchMatrix(results, 200);
+
+		benchFilters(results, quick? 7 : 60);
+		benchSun(results, quick? 10 : 100, quick? 30 : 365);
+		benchGenerators(results, quick? 10 : 100, quick? 30 : 365);
+
+		if (quick) benchIO(results, path, 5, 30, 100);
+		else benchIO(results, path, 10, 365, 400);
+	} catch(const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (output.empty()) {
+		results.writeJSON(std::cout);
+	} else {
+		std::ofstream fout(output.c_str());
+		if (fout.fail()) {
+			std::cerr << "Can not open " << output << " for writing" << std::endl;
+			return EXIT_FAILURE;
+		}
+		results.writeJSON(fout);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+#include "generators.h"
+
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+using namespace mio;
+
+RandomGenerator::RandomGenerator(const unsigned long& seed) : state(seed) {}
+
+double RandomGenerator::uniform()
+{
+	//linear congruential generator (Numerical Recipes constants), only keeping 32 bits
+	state = (1664525UL*state + 1013904223UL) & 0xFFFFFFFFUL;
+	return static_cast<double>(state) / 4294967296.;
+}
+
+double RandomGenerator::uniform(const double& min, const double& max)
+{
+	return min + (max-min)*uniform();
+}
+
+double RandomGenerator::normal()
+{
+	//Box-Muller transform
+	const double u1 = 1. - uniform(); //so it is in ]0, 1]
+	const double u2 = uniform();
+	return sqrt(-2.*log(u1)) * cos(2.*Cst::PI*u2);
+}
+
+void makeDEM(const size_t& ncols, const size_t& nrows, const double& cellsize, DEMObject& dem)
+{
+	Coords llcorner("CH1903", "");
+	llcorner.setXY(600000., 100000., IOUtils::nodata);
+
+	//a few gaussian peaks on top of a gently tilted plane and some roughness
+	RandomGenerator rnd(42);
+	const size_t nr_peaks = 12;
+	vector<double> peak_i(nr_peaks), peak_j(nr_peaks), peak_height(nr_peaks), peak_width(nr_peaks);
+	for (size_t kk=0; kk<nr_peaks; kk++) {
+		peak_i[kk] = rnd.uniform(0., static_cast<double>(ncols));
+		peak_j[kk] = rnd.uniform(0., static_cast<double>(nrows));
+		peak_height[kk] = rnd.uniform(500., 2000.);
+		peak_width[kk] = rnd.uniform(0.05, 0.2) * static_cast<double>(std::max(ncols, nrows));
+	}
+
+	Array2D<double> altitudes(ncols, nrows);
+	for (size_t jj=0; jj<nrows; jj++) {
+		for (size_t ii=0; ii<ncols; ii++) {
+			double alt = 800. + 300.*static_cast<double>(ii)/static_cast<double>(ncols);
+			for (size_t kk=0; kk<nr_peaks; kk++) {
+				const double di = (static_cast<double>(ii)-peak_i[kk]) / peak_width[kk];
+				const double dj = (static_cast<double>(jj)-peak_j[kk]) / peak_width[kk];
+				alt += peak_height[kk] * exp(-0.5*(di*di + dj*dj));
+			}
+			altitudes(ii,jj) = alt + 5.*rnd.normal();
+		}
+	}
+
+	dem = DEMObject(ncols, nrows, cellsize, llcorner, altitudes, false);
+	dem.setUpdatePpt((DEMObject::update_type)(DEMObject::SLOPE|DEMObject::NORMAL|DEMObject::CURVATURE));
+	dem.update();
+}
+
+void makeStations(const size_t& nr_stations, const DEMObject& dem, vector<StationData>& vecStations)
+{
+	RandomGenerator rnd(7);
+	vecStations.clear();
+	const double width = static_cast<double>(dem.getNx())*dem.cellsize;
+	const double height = static_cast<double>(dem.getNy())*dem.cellsize;
+
+	for (size_t ii=0; ii<nr_stations; ii++) {
+		Coords position(dem.llcorner);
+		const double easting = dem.llcorner.getEasting() + rnd.uniform(0., width);
+		const double northing = dem.llcorner.getNorthing() + rnd.uniform(0., height);
+		position.setXY(easting, northing, IOUtils::nodata);
+		dem.gridify(position);
+		position.setAltitude(dem(static_cast<size_t>(position.getGridI()), static_cast<size_t>(position.getGridJ())), false);
+
+		ostringstream id;
+		id << "STA" << ii+1;
+		vecStations.push_back( StationData(position, id.str(), "Synthetic station "+id.str()) );
+	}
+}
+
+void makeStationValues(const vector<StationData>& vecStations, const MeteoData::Parameters& param, vector<double>& vecData)
+{
+	RandomGenerator rnd(11+param);
+	vecData.resize(vecStations.size());
+	for (size_t ii=0; ii<vecStations.size(); ii++) {
+		const double altitude = vecStations[ii].position.getAltitude();
+		double value;
+		if (param==MeteoData::RH) value = std::min(1., std::max(0.1, 0.6 + 0.0001*(altitude-1500.) + 0.1*rnd.normal()));
+		else if (param==MeteoData::VW) value = std::max(0., 3. + 0.002*(altitude-1500.) + rnd.normal());
+		else if (param==MeteoData::DW) value = fmod(270. + 30.*rnd.normal() + 360., 360.);
+		else if (param==MeteoData::HNW) value = std::max(0., 1. + 0.0005*(altitude-1500.) + 0.5*rnd.normal());
+		else value = 273.15 + 5. - 0.0065*(altitude-1500.) + rnd.normal(); //TA and all the others
+		vecData[ii] = value;
+	}
+}
+
+void makeTimeSeries(const vector<StationData>& vecStations, const Date& start_date,
+                    const size_t& nr_steps, const double& time_step, vector< vector<MeteoData> >& vecMeteo)
+{
+	RandomGenerator rnd(2014);
+	vecMeteo.clear();
+	vecMeteo.resize(vecStations.size());
+
+	for (size_t ii=0; ii<vecStations.size(); ii++) {
+		const double altitude = vecStations[ii].position.getAltitude();
+		double hs = 0.;
+		vecMeteo[ii].reserve(nr_steps);
+		for (size_t kk=0; kk<nr_steps; kk++) {
+			const Date date( start_date + static_cast<double>(kk)*time_step );
+			const double julian = date.getJulian();
+			const double day_phase = 2.*Cst::PI*(julian - floor(julian));
+			const double year_phase = 2.*Cst::PI*(julian - 2454832.5)/365.25; //starting around January 1st
+
+			MeteoData md(date, vecStations[ii]);
+			md(MeteoData::TA) = 273.15 + 5. - 0.0065*(altitude-1500.) - 10.*cos(year_phase) - 4.*cos(day_phase) + rnd.normal();
+			md(MeteoData::RH) = std::min(1., std::max(0.05, 0.7 + 0.15*cos(day_phase) + 0.1*rnd.normal()));
+			md(MeteoData::VW) = std::max(0., 3. + 1.5*rnd.normal());
+			md(MeteoData::DW) = fmod(270. + 40.*rnd.normal() + 360., 360.);
+			md(MeteoData::ISWR) = std::max(0., -800.*cos(day_phase)) * (0.7 + 0.3*rnd.uniform());
+			md(MeteoData::RSWR) = 0.6 * md(MeteoData::ISWR);
+			md(MeteoData::HNW) = (rnd.uniform()<0.1)? 2.*rnd.uniform() : 0.;
+			hs = std::max(0., hs + 0.01*md(MeteoData::HNW) - ((md(MeteoData::TA)>273.15)? 0.002 : 0.));
+			md(MeteoData::HS) = hs;
+			md(MeteoData::TSS) = std::min(273.15, md(MeteoData::TA) - 2.);
+			md(MeteoData::TSG) = 273.15;
+
+			//some gaps in the data, so the filters and resampling have something to do
+			if (rnd.uniform()<0.02) md(MeteoData::TA) = IOUtils::nodata;
+			if (rnd.uniform()<0.02) md(MeteoData::RH) = IOUtils::nodata;
+			vecMeteo[ii].push_back(md);
+		}
+	}
+}
+
+void makeMatrix(const size_t& n, Matrix& M)
+{
+	RandomGenerator rnd(99);
+	M.resize(n, n);
+	for (size_t ii=1; ii<=n; ii++) {
+		for (size_t jj=1; jj<=n; jj++)
+			M(ii,jj) = rnd.uniform(-1., 1.);
+		M(ii,ii) += static_cast<double>(n); //diagonally dominant, so it is well conditioned
+	}
+}
+
+void makeConfig(const string& path, const size_t& nr_stations, Config& cfg)
+{
+	cfg.addKey("BUFF_CHUNK_SIZE", "General", "370");
+	cfg.addKey("BUFF_BEFORE", "General", "1.5");
+
+	cfg.addKey("COORDSYS", "Input", "CH1903");
+	cfg.addKey("TIME_ZONE", "Input", "1");
+	cfg.addKey("DEM", "Input", "ARC");
+	cfg.addKey("DEMFILE", "Input", path+"/dem.asc");
+	cfg.addKey("GRID2D", "Input", "ARC");
+	cfg.addKey("GRID2DPATH", "Input", path);
+	cfg.addKey("METEO", "Input", "SMET");
+	cfg.addKey("METEOPATH", "Input", path);
+	for (size_t ii=0; ii<nr_stations; ii++) {
+		ostringstream key, value;
+		key << "STATION" << ii+1;
+		value << "STA" << ii+1;
+		cfg.addKey(key.str(), "Input", value.str());
+	}
+
+	cfg.addKey("COORDSYS", "Output", "CH1903");
+	cfg.addKey("TIME_ZONE", "Output", "1");
+	cfg.addKey("GRID2D", "Output", "ARC");
+	cfg.addKey("GRID2DPATH", "Output", path);
+	cfg.addKey("METEO", "Output", "SMET");
+	cfg.addKey("METEOPATH", "Output", path);
+}
@@ -0,0 +1,43 @@
+#ifndef __BENCHMARKS_GENERATORS_H__
+#define __BENCHMARKS_GENERATORS_H__
+
+#include <meteoio/MeteoIO.h>
+
+#include <string>
+#include <vector>
+
+//Synthetic data for the benchmarks. Everything is built from a fixed seed with our own
+//random numbers generator, so the data (and therefore the timings) are the same on all platforms
+
+class RandomGenerator {
+	public:
+		RandomGenerator(const unsigned long& seed=12345);
+		double uniform(); ///< in [0, 1[
+		double uniform(const double& min, const double& max);
+		double normal(); ///< mean 0, standard deviation 1
+
+	private:
+		unsigned long state;
+};
+
+//a mountainous DEM of ncols x nrows cells, in CH1903 coordinates
+void makeDEM(const size_t& ncols, const size_t& nrows, const double& cellsize, mio::DEMObject& dem);
+
+//stations randomly spread over the DEM, at the DEM's altitude
+void makeStations(const size_t& nr_stations, const mio::DEMObject& dem, std::vector<mio::StationData>& vecStations);
+
+//one value per station for a given parameter, following a lapse rate
+void makeStationValues(const std::vector<mio::StationData>& vecStations, const mio::MeteoData::Parameters& param,
+                       std::vector<double>& vecData);
+
+//hourly (or any time step) time series for all the stations, with daily and yearly cycles, noise and gaps
+void makeTimeSeries(const std::vector<mio::StationData>& vecStations, const mio::Date& start_date,
+                    const size_t& nr_steps, const double& time_step, std::vector< std::vector<mio::MeteoData> >& vecMeteo);
+
+//a well conditioned square matrix (diagonally dominant)
+void makeMatrix(const size_t& n, mio::Matrix& M);
+
+//a configuration reading SMET and ARC files from (and writing them to) the given directory
+void makeConfig(const std::string& path, const size_t& nr_stations, mio::Config& cfg);
+
+#endif
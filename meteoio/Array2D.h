@@ -150,6 +150,14 @@ template<class T> class Array2D {
 		void clear();
 		bool isEmpty() const;
 
+		/**
+		* @brief direct access to the underlying storage, where the values are stored row after row (ie: at index x + y*nx).
+		* This bypasses all checks and is only meant for performance critical algorithms processing whole rows at once.
+		* @return pointer to the first element (undefined if the array is empty)
+		*/
+		T* data();
+		const T* data() const;
+
 		/**
 		* @brief returns the minimum value contained in the grid
 		* @return minimum value
@@ -401,6 +409,14 @@ template<class T> bool Array2D<T>::isEmpty() const {
 	return (nx==0 && ny==0);
 }
 
+template<class T> T* Array2D<T>::data() {
+	return &vecData[0];
+}
+
+template<class T> const T* Array2D<T>::data() const {
+	return &vecData[0];
+}
+
 template<class T> const std::string Array2D<T>::toString() const {
 	std::ostringstream os;
 	os << "<array2d>\n";
@@ -16,6 +16,9 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/BufferedIOHandler.h>
+#include <meteoio/Profiler.h>
+
+#include <iostream>
 
 using namespace std;
 
@@ -23,13 +26,42 @@ namespace mio {
 
 BufferedIOHandler::BufferedIOHandler(IOHandler& in_iohandler, const Config& in_cfg)
 	: iohandler(in_iohandler), cfg(in_cfg), meteo_buffer(), mapBufferedGrids(), dem_buffer(),
-       IndexBufferedGrids(), buffer_start(), buffer_end(), chunk_size(), buff_before(), max_grids(10)
+       IndexBufferedGrids(), buffer_start(), buffer_end(), chunk_size(), buff_before(), max_grids(10), grids_float32(false),
+       meteo_stats("meteo buffer"), grids_stats("grids buffer"), prefetch_slots(), last_grid_dates(), mutex()
 {
 	setDfltBufferProperties();
+
+	size_t nr_prefetch = 0;
+	cfg.getValue("BUFF_GRIDS_PREFETCH", "General", nr_prefetch, IOUtils::nothrow);
+	std::string grid2d_plugin;
+	cfg.getValue("GRID2D", "Input", grid2d_plugin, IOUtils::nothrow);
+	IOUtils::toUpper(grid2d_plugin);
+	if (nr_prefetch>0 && grid2d_plugin=="NETCDF") { //libnetcdf is not thread safe
+		std::cerr << "[W] Grids prefetching is not supported with the NETCDF plugin, it is disabled\n";
+		nr_prefetch = 0;
+	}
+	for (size_t ii=0; ii<nr_prefetch; ii++)
+		prefetch_slots.push_back(new prefetch_slot);
+}
+
+#ifdef _POPC_
+BufferedIOHandler::~BufferedIOHandler()
+#else
+BufferedIOHandler::~BufferedIOHandler() throw()
+#endif
+{
+	stopPrefetching();
+	for (size_t ii=0; ii<prefetch_slots.size(); ii++) {
+		delete prefetch_slots[ii]->io;
+		delete prefetch_slots[ii];
+	}
 }
 
 BufferedIOHandler& BufferedIOHandler::operator=(const BufferedIOHandler& source) {
 	if(this != &source) {
+		ScopedLock lock(mutex);
+		stopPrefetching(); //the background reads are not copied, they would belong to the other buffer
+		last_grid_dates.clear();
 		iohandler = source.iohandler;
 		meteo_buffer = source.meteo_buffer;
 		mapBufferedGrids = source.mapBufferedGrids;
@@ -40,6 +72,9 @@ BufferedIOHandler& BufferedIOHandler::operator=(const BufferedIOHandler& source)
 		chunk_size = source.chunk_size;
 		buff_before = source.buff_before;
 		max_grids = source.max_grids;
+		grids_float32 = source.grids_float32;
+		meteo_stats = source.meteo_stats;
+		grids_stats = source.grids_stats;
 	}
 	return *this;
 }
@@ -48,30 +83,41 @@ void BufferedIOHandler::addToBuffer(const Grid2DObject& in_grid2Dobj, const std:
 {
 	if (max_grids==0) return;
 
-	if(IndexBufferedGrids.size() >= max_grids) { //we need to remove the oldest grid
-		mapBufferedGrids.erase( mapBufferedGrids.find( IndexBufferedGrids.front() ) );
+	const CompactGrid<Grid2DObject> compact_grid(in_grid2Dobj, grids_float32);
+	const size_t grid_size = compact_grid.getMemorySize();
+	//we need to remove the oldest grids, but the new one is always kept
+	while (!IndexBufferedGrids.empty()
+	       && (IndexBufferedGrids.size()>=max_grids || (grids_stats.max_bytes>0 && grids_stats.bytes+grid_size>grids_stats.max_bytes))) {
+		const std::map<std::string, CompactGrid<Grid2DObject> >::iterator it = mapBufferedGrids.find( IndexBufferedGrids.front() );
+		grids_stats.bytes -= it->second.getMemorySize();
+		grids_stats.evictions++;
+		mapBufferedGrids.erase( it );
 		IndexBufferedGrids.erase( IndexBufferedGrids.begin() );
 	}
-	mapBufferedGrids[ grid_hash ] = in_grid2Dobj;
+	mapBufferedGrids[ grid_hash ] = compact_grid;
 	IndexBufferedGrids.push_back( grid_hash  );
+	grids_stats.bytes += grid_size;
+	grids_stats.items = IndexBufferedGrids.size();
 }
 
-bool BufferedIOHandler::getFromBuffer(const std::string& grid_hash, Grid2DObject& grid) const
+bool BufferedIOHandler::getFromBuffer(const std::string& grid_hash, Grid2DObject& grid)
 {
-	if (IndexBufferedGrids.empty())
-		return false;
+	if (max_grids==0) return false;
 
-	const std::map<std::string, Grid2DObject>::const_iterator it = mapBufferedGrids.find( grid_hash );
+	const std::map<std::string, CompactGrid<Grid2DObject> >::const_iterator it = mapBufferedGrids.find( grid_hash );
 	if (it != mapBufferedGrids.end()) { //already in map
-		grid = (*it).second;
+		(*it).second.get(grid);
+		grids_stats.hits++;
 		return true;
 	}
 
+	grids_stats.misses++;
 	return false;
 }
 
 void BufferedIOHandler::read2DGrid(Grid2DObject& in_grid2Dobj, const std::string& in_filename)
 {
+	ScopedLock lock(mutex);
 	if (getFromBuffer(in_filename, in_grid2Dobj))
 		return;
 
@@ -79,22 +125,133 @@ void BufferedIOHandler::read2DGrid(Grid2DObject& in_grid2Dobj, const std::string
 	addToBuffer(in_grid2Dobj, in_filename);
 }
 
+const std::string BufferedIOHandler::getGridHash(const MeteoGrids::Parameters& parameter, const Date& date)
+{
+	char date_str[Date::max_str_len];
+	date.toString(Date::ISO, date_str, Date::max_str_len);
+	return date_str+("::"+MeteoGrids::getParameterName(parameter));
+}
+
 void BufferedIOHandler::read2DGrid(Grid2DObject& in_grid2Dobj, const MeteoGrids::Parameters& parameter, const Date& date)
 {
+	ScopedLock lock(mutex);
 	if (max_grids>0) {
-		const string grid_hash = date.toString(Date::ISO)+"::"+MeteoGrids::getParameterName(parameter);
-		if (getFromBuffer(grid_hash, in_grid2Dobj))
-			return;
-
-		iohandler.read2DGrid(in_grid2Dobj, parameter, date);
-		addToBuffer(in_grid2Dobj, grid_hash); //the STL containers make a copy
+		const string grid_hash( getGridHash(parameter, date) );
+		collectPrefetched(grid_hash);
+		if (!getFromBuffer(grid_hash, in_grid2Dobj)) {
+			iohandler.read2DGrid(in_grid2Dobj, parameter, date);
+			addToBuffer(in_grid2Dobj, grid_hash); //the STL containers make a copy
+		}
+		prefetch(parameter, date);
 	} else {
 		iohandler.read2DGrid(in_grid2Dobj, parameter, date);
 	}
 }
 
+//this runs in its own thread, so it only uses the slot that has been given to it
+void BufferedIOHandler::prefetchGrid(void* arg)
+{
+	prefetch_slot *slot = static_cast<prefetch_slot*>(arg);
+	bool failed = false;
+	try {
+		slot->io->read2DGrid(slot->grid, slot->parameter, slot->date);
+	} catch(...) { //the grid will be read again when requested, so the error is reported to the caller
+		failed = true;
+	}
+
+	ScopedLock lock(slot->lock);
+	slot->failed = failed;
+	slot->done = true;
+}
+
+/**
+* @brief Move the grids that have been read in the background into the buffer.
+* If the requested grid is still being read, wait for it.
+* @param grid_hash hash of the requested grid
+*/
+void BufferedIOHandler::collectPrefetched(const std::string& grid_hash)
+{
+	for (size_t ii=0; ii<prefetch_slots.size(); ii++) {
+		prefetch_slot *slot = prefetch_slots[ii];
+		if (slot->thread==NULL) continue;
+
+		bool done;
+		{
+			ScopedLock lock(slot->lock);
+			done = slot->done;
+		}
+		if (!done && slot->grid_hash!=grid_hash) continue;
+
+		slot->thread->join();
+		delete slot->thread;
+		slot->thread = NULL;
+		if (!slot->failed) addToBuffer(slot->grid, slot->grid_hash);
+		slot->grid = Grid2DObject(); //release the memory
+	}
+}
+
+/**
+* @brief Start reading in the background the grid that is expected to be requested next for this parameter.
+* The next date is predicted from the time step between the last two requests.
+* @param parameter requested parameter
+* @param date requested date
+*/
+void BufferedIOHandler::prefetch(const MeteoGrids::Parameters& parameter, const Date& date)
+{
+	if (prefetch_slots.empty()) return;
+
+	const std::map<MeteoGrids::Parameters, Date>::iterator it = last_grid_dates.find(parameter);
+	if (it==last_grid_dates.end()) {
+		last_grid_dates[parameter] = date;
+		return;
+	}
+	const Date last_date( it->second );
+	it->second = date;
+	if (date<=last_date) return; //only forward in time
+
+	const Date next_date( date + (date - last_date) );
+	const string next_hash( getGridHash(parameter, next_date) );
+	if (mapBufferedGrids.find(next_hash) != mapBufferedGrids.end()) return;
+
+	prefetch_slot *free_slot = NULL;
+	for (size_t ii=0; ii<prefetch_slots.size(); ii++) {
+		if (prefetch_slots[ii]->thread==NULL) {
+			if (free_slot==NULL) free_slot = prefetch_slots[ii];
+		} else if (prefetch_slots[ii]->grid_hash==next_hash) {
+			return; //already being read
+		}
+	}
+	if (free_slot==NULL) return; //all threads are busy, the grid will be read when requested
+
+	free_slot->grid_hash = next_hash;
+	free_slot->parameter = parameter;
+	free_slot->date = next_date;
+	free_slot->done = false;
+	free_slot->failed = false;
+	try {
+		if (free_slot->io==NULL) free_slot->io = new IOHandler(cfg);
+		free_slot->thread = new Thread(&prefetchGrid, free_slot);
+	} catch(const std::exception&) { //prefetching is only an optimization, the grid will be read when requested
+		free_slot->thread = NULL;
+	}
+}
+
+//wait for all the background reads and drop their grids
+void BufferedIOHandler::stopPrefetching()
+{
+	for (size_t ii=0; ii<prefetch_slots.size(); ii++) {
+		prefetch_slot *slot = prefetch_slots[ii];
+		if (slot->thread==NULL) continue;
+		slot->thread->join();
+		delete slot->thread;
+		slot->thread = NULL;
+		slot->grid = Grid2DObject();
+	}
+}
+
 void BufferedIOHandler::readDEM(DEMObject& demobj)
 {
+	ScopedLock lock(mutex);
 	if (max_grids>0) {
 		if (dem_buffer.size() == 1) {
 			//already in buffer. If the update properties have changed,
@@ -102,7 +259,7 @@ void BufferedIOHandler::readDEM(DEMObject& demobj)
 			const DEMObject::update_type in_ppt = (DEMObject::update_type)demobj.getUpdatePpt();
 			const DEMObject::slope_type in_slope_alg = (DEMObject::slope_type)demobj.getDefaultAlgorithm();
 
-			demobj = dem_buffer[0];
+			dem_buffer[0].get(demobj);
 			const DEMObject::update_type buff_ppt = (DEMObject::update_type)demobj.getUpdatePpt();
 			const DEMObject::slope_type buff_slope_alg = (DEMObject::slope_type)demobj.getDefaultAlgorithm();
 
@@ -116,7 +273,7 @@ void BufferedIOHandler::readDEM(DEMObject& demobj)
 		}
 
 		iohandler.readDEM(demobj);
-		dem_buffer.push_back(demobj); //the STL containers make a copy
+		dem_buffer.push_back( CompactGrid<DEMObject>(demobj, grids_float32) );
 	} else {
 		iohandler.readDEM(demobj);
 	}
@@ -124,6 +281,7 @@ void BufferedIOHandler::readDEM(DEMObject& demobj)
 
 void BufferedIOHandler::readLanduse(Grid2DObject& in_grid2Dobj)
 {
+	ScopedLock lock(mutex);
 	if (getFromBuffer("/:LANDUSE", in_grid2Dobj))
 		return;
 
@@ -134,8 +292,11 @@ void BufferedIOHandler::readLanduse(Grid2DObject& in_grid2Dobj)
 //HACK: manage buffering of assimilation grids! Why not considering them normal grids?
 void BufferedIOHandler::readAssimilationData(const Date& date, Grid2DObject& in_grid2Dobj)
 {
+	ScopedLock lock(mutex);
 	if(max_grids>0) {
-		const string grid_hash = "/:ASSIMILATIONDATA"+date.toString(Date::ISO);
+		char date_str[Date::max_str_len];
+		date.toString(Date::ISO, date_str, Date::max_str_len);
+		const string grid_hash = string("/:ASSIMILATIONDATA")+date_str;
 		if (getFromBuffer(grid_hash, in_grid2Dobj))
 			return;
 
@@ -162,6 +323,17 @@ void BufferedIOHandler::writeMeteoData(const std::vector< METEO_SET >& vecMeteo,
 	iohandler.writeMeteoData(vecMeteo, name);
 }
 
+#ifdef _POPC_
+void BufferedIOHandler::appendMeteoData(std::vector< METEO_SET >& vecMeteo,
+                                        const std::string& name)
+#else
+void BufferedIOHandler::appendMeteoData(const std::vector< METEO_SET >& vecMeteo,
+                                        const std::string& name)
+#endif
+{
+	iohandler.appendMeteoData(vecMeteo, name);
+}
+
 void BufferedIOHandler::setDfltBufferProperties()
 {
 	double chunk_size_days = 15.; //default chunk size value
@@ -196,10 +368,23 @@ void BufferedIOHandler::setDfltBufferProperties()
 
 	max_grids = 10; //default number of grids to keep in buffer
 	cfg.getValue("BUFF_GRIDS", "General", max_grids, IOUtils::nothrow);
+	grids_float32 = false;
+	cfg.getValue("BUFF_GRIDS_FLOAT32", "General", grids_float32, IOUtils::nothrow);
+
+	//memory limits, in MB
+	double max_memory = 0.;
+	cfg.getValue("BUFF_MEMORY", "General", max_memory, IOUtils::nothrow);
+	if (max_memory<0.) throw InvalidArgumentException("BUFF_MEMORY can not be negative", AT);
+	meteo_stats.max_bytes = static_cast<size_t>(max_memory*1024.*1024.);
+	max_memory = 0.;
+	cfg.getValue("BUFF_GRIDS_MEMORY", "General", max_memory, IOUtils::nothrow);
+	if (max_memory<0.) throw InvalidArgumentException("BUFF_GRIDS_MEMORY can not be negative", AT);
+	grids_stats.max_bytes = static_cast<size_t>(max_memory*1024.*1024.);
 }
 
 void BufferedIOHandler::setMinBufferRequirements(const double& i_chunk_size, const double& i_buff_before)
 {
+	ScopedLock lock(mutex);
 	if(i_buff_before!=IOUtils::nodata) {
 		const Duration app_buff_before(i_buff_before, 0);
 		if(app_buff_before>buff_before) buff_before = app_buff_before;
@@ -215,6 +400,7 @@ void BufferedIOHandler::setMinBufferRequirements(const double& i_chunk_size, con
 
 double BufferedIOHandler::getAvgSamplingRate() const
 {
+	ScopedLock lock(mutex);
 	if (!meteo_buffer.empty()){
 		const size_t nr_stations = meteo_buffer.size();
 		double sum = 0;
@@ -244,6 +430,7 @@ double BufferedIOHandler::getAvgSamplingRate() const
  */
 const std::vector< METEO_SET >& BufferedIOHandler::getFullBuffer(Date& start, Date& end)
 {
+	ScopedLock lock(mutex);
 	start = buffer_start;
 	end   = buffer_end;
 
@@ -288,6 +475,8 @@ void BufferedIOHandler::getFromBuffer(const Date& date_start, const Date& date_e
 void BufferedIOHandler::fillBuffer(const Date& date_start, const Date& date_end,
                                    const size_t& /*stationindex*/)
 {
+	ScopedLock lock(mutex);
+	MIO_PROFILE("BufferedIOHandler::fillBuffer");
 	const Date new_buffer_start(date_start-buff_before); //taking centering into account
 	Date new_buffer_end(new_buffer_start + chunk_size);
 
@@ -295,14 +484,17 @@ void BufferedIOHandler::fillBuffer(const Date& date_start, const Date& date_end,
 	//Try to buffer after the requested chunk for subsequent calls
 
 	//0. initialize if not already initialized
+	bool rebuffered = false;
 	if (meteo_buffer.empty()) {
 		iohandler.readMeteoData(new_buffer_start, new_buffer_end, meteo_buffer);
 		buffer_start = new_buffer_start;
 		buffer_end   = new_buffer_end;
+		rebuffered = true;
 	}
 
 	//1. Check whether data is in buffer already, and buffer it if not
 	if ((date_start < buffer_start) || (date_end > buffer_end)) {
+		rebuffered = true;
 		//rebuffer data
 		if ((new_buffer_end != buffer_end) || (new_buffer_start != buffer_start)) { //rebuffer for real
 			meteo_buffer.clear(); //the plugins do it internally anyway, but this is cheap and safe...
@@ -340,12 +532,48 @@ void BufferedIOHandler::fillBuffer(const Date& date_start, const Date& date_end,
 			buffer_end = new_buffer_end;
 		}
 	}
+
+	if (rebuffered) {
+		meteo_stats.misses++;
+		meteo_stats.refills++;
+		checkMemory(date_end);
+	} else {
+		meteo_stats.hits++;
+	}
+}
+
+//update the memory footprint of the time series buffer and, if it is above the limit, drop as much
+//of the data read ahead (ie after date_end) as necessary
+void BufferedIOHandler::checkMemory(const Date& date_end)
+{
+	meteo_stats.bytes = CacheStats::getMemorySize(meteo_buffer);
+	if (meteo_stats.max_bytes>0 && meteo_stats.bytes>meteo_stats.max_bytes && buffer_end>date_end) {
+		//the data is assumed to be evenly spread over the buffer's period
+		const double ratio = static_cast<double>(meteo_stats.max_bytes) / static_cast<double>(meteo_stats.bytes);
+		Date new_end( buffer_start + (buffer_end-buffer_start)*ratio );
+		if (new_end<date_end) new_end = date_end;
+
+		for (size_t ii=0; ii<meteo_buffer.size(); ii++) {
+			std::vector<MeteoData>& station = meteo_buffer[ii];
+			size_t keep = station.size();
+			while (keep>0 && station[keep-1].date>new_end) keep--;
+			meteo_stats.evictions += station.size()-keep;
+			std::vector<MeteoData>(station.begin(), station.begin()+keep).swap(station); //so the memory is really released
+		}
+		buffer_end = new_end;
+		meteo_stats.bytes = CacheStats::getMemorySize(meteo_buffer);
+	}
+
+	meteo_stats.items = 0;
+	for (size_t ii=0; ii<meteo_buffer.size(); ii++)
+		meteo_stats.items += meteo_buffer[ii].size();
 }
 
 void BufferedIOHandler::readMeteoData(const Date& date_start, const Date& date_end,
                                       std::vector< METEO_SET >& vecMeteo,
                                       const size_t& stationindex)
 {
+	ScopedLock lock(mutex);
 	fillBuffer(date_start, date_end, stationindex);
 	getFromBuffer(date_start, date_end, vecMeteo);
 }
@@ -361,6 +589,7 @@ void BufferedIOHandler::readMeteoData(const Date& date_start, const Date& date_e
 void BufferedIOHandler::push_meteo_data(const Date& date_start, const Date& date_end,
                                         const std::vector< METEO_SET >& vecMeteo)
 {
+	ScopedLock lock(mutex);
 	//perform check on date_start and date_end
 	if (date_end < date_start)
 		throw InvalidArgumentException("date_start cannot be greater than date_end", AT);
@@ -368,6 +597,8 @@ void BufferedIOHandler::push_meteo_data(const Date& date_start, const Date& date
 	buffer_start     = date_start;
 	buffer_end       = date_end;
 	meteo_buffer = vecMeteo;
+	meteo_stats.refills++;
+	checkMemory(date_end);
 }
 
 void BufferedIOHandler::readPOI(std::vector<Coords>& in_cpa)
@@ -386,15 +617,33 @@ void BufferedIOHandler::write2DGrid(const Grid2DObject& grid_in, const MeteoGrid
 }
 
 void BufferedIOHandler::clearBuffer() {
+	ScopedLock lock(mutex);
 	meteo_buffer.clear();
 	buffer_start = Date(0., 0.);
 	buffer_end = Date(0., 0.);
 	mapBufferedGrids.clear();
 	IndexBufferedGrids.clear();
+	meteo_stats.items = meteo_stats.bytes = 0;
+	grids_stats.items = grids_stats.bytes = 0;
+}
+
+void BufferedIOHandler::getCacheStats(std::vector<CacheStats>& vecStats) const
+{
+	ScopedLock lock(mutex);
+	vecStats.push_back(meteo_stats);
+
+	//the dem is kept next to the grids and counted with them
+	CacheStats grids(grids_stats);
+	for (size_t ii=0; ii<dem_buffer.size(); ii++) {
+		grids.items++;
+		grids.bytes += dem_buffer[ii].getMemorySize();
+	}
+	vecStats.push_back(grids);
 }
 
 const std::string BufferedIOHandler::toString() const
 {
+	ScopedLock lock(mutex);
 	std::ostringstream os;
 	os << "<BufferedIOHandler>\n";
 	os << "Config& cfg = " << hex << &cfg << dec << "\n";
@@ -402,6 +651,8 @@ const std::string BufferedIOHandler::toString() const
 
 	os << "Buffering " <<chunk_size.getJulian() << " day(s) with "
 	   << buff_before.getJulian() << " day(s) pre-buffering\n";
+	if (!prefetch_slots.empty())
+		os << "Prefetching grids with " << prefetch_slots.size() << " thread(s)\n";
 
 	os << "Current buffer content (" << meteo_buffer.size() << " stations, "
 	   << mapBufferedGrids.size() << " grids):\n";
@@ -415,10 +666,12 @@ const std::string BufferedIOHandler::toString() const
 		}
 	}
 
-	std::map<std::string, Grid2DObject>::const_iterator it1;
+	std::map<std::string, CompactGrid<Grid2DObject> >::const_iterator it1;
 	for (it1=mapBufferedGrids.begin(); it1 != mapBufferedGrids.end(); ++it1){
+		const Grid2DObject& geometry = (it1->second).getGeometry();
 		os << setw(10) << "Grid" << " = " << it1->first << ", ";
-		os << (it1->second).ncols << " x " << (it1->second).nrows << " @ " << (it1->second).cellsize << "m\n";
+		os << geometry.ncols << " x " << geometry.nrows << " @ " << geometry.cellsize << "m";
+		os << (((it1->second).isSinglePrecision())? " (float32)\n" : "\n");
 	}
 
 	os << "</BufferedIOHandler>\n";
@@ -20,6 +20,9 @@
 
 #include <meteoio/IOHandler.h>
 #include <meteoio/Config.h>
+#include <meteoio/CacheStats.h>
+#include <meteoio/CompactGrid.h>
+#include <meteoio/Mutex.h>
 #include <map>
 #include <vector>
 #include <string>
@@ -43,6 +46,36 @@ namespace mio {
  *                two centering option can be used.
  * - BUFF_GRIDS: how many grids to keep in the buffer. If more grids have to be read, the oldest ones will be removed from
  *               the buffer. (10 by default, 0 means no buffering for grids)
+ * - BUFF_GRIDS_MEMORY: maximum memory (in MB) used by the grids buffer. The oldest grids are removed when it is exceeded
+ *                      (the most recent grid is always kept). Optional, no limit by default;
+ * - BUFF_MEMORY: maximum memory (in MB) used by the time series buffer. When it is exceeded after reading new data, the data
+ *                that has been read ahead (after the requested period) is removed from the buffer. The requested period
+ *                itself is always kept. Optional, no limit by default;
+ * - BUFF_POINTS_MEMORY: maximum memory (in MB) used by the IOManager to keep the data already resampled at given time steps.
+ *                       When it is exceeded, the time steps the furthest away from the requested one are removed. Optional,
+ *                       100 MB by default.
+ * - BUFF_GRIDS_PREFETCH: how many grids can be read in the background (see below). Optional, 0 (no prefetching) by default.
+ * - BUFF_GRIDS_FLOAT32: keep the buffered grids and dem (including its slope, azimuth, curvature and normals) in single
+ *                       precision, which halves the memory they use. The grids are converted back to double precision
+ *                       when they are returned, so they only keep about 7 significant digits. Optional, false by default.
+ *
+ * @subsection buffereiohandler_prefetch Grids prefetching
+ * When the grids of a given parameter are requested at regular time steps (such as every hour), the grid of the next time step
+ * can be read in the background while the application processes the current one. The time step is taken as the difference
+ * between the last two dates requested for this parameter, so the first two requests are always read synchronously.
+ * BUFF_GRIDS_PREFETCH sets how many grids can be read at the same time, each one by its own thread with its own
+ * instance of the plugins (so it is most useful to set it to the number of parameters that are read at each time step).
+ * The prefetched grids are stored in the grids buffer, so BUFF_GRIDS should be at least twice the number of parameters
+ * read at each time step. If a prefetched grid is requested before it has been read, the request waits for it; if
+ * reading it failed, the grid is read again synchronously so the error is reported to the caller. Only the grids requested
+ * by parameter and date are prefetched (not the grids requested by file name).
+ *
+ * Since the plugins of the background IOHandler run at the same time as the plugins of the main thread, the plugins
+ * and the libraries they rely on must be thread safe. This is not the case of libnetcdf, so prefetching is disabled
+ * when GRID2D = NETCDF. Older versions of libproj (used for the PROJ4 coordinate systems) are not thread safe either.
+ *
+ * The usage of these buffers can be checked with IOManager::getCacheStats(). The buffers are protected by a mutex,
+ * so several threads can read data through the same BufferedIOHandler.
  *
  * @author Thomas Egger
  * @date   2009-07-25
@@ -71,9 +104,9 @@ class BufferedIOHandler : public IOInterface {
 		 */
 		BufferedIOHandler(IOHandler& in_iohandler, const Config& in_cfg);
 	#ifdef _POPC_
-		virtual ~BufferedIOHandler() {};
+		virtual ~BufferedIOHandler();
 	#else
-		virtual ~BufferedIOHandler() throw() {};
+		virtual ~BufferedIOHandler() throw();
 	#endif
 
 		BufferedIOHandler& operator=(const BufferedIOHandler&); ///<Assignement operator
@@ -108,9 +141,13 @@ class BufferedIOHandler : public IOInterface {
 #ifdef _POPC_
 		virtual void writeMeteoData(std::vector< METEO_SET >& vecMeteo,
 		                            const std::string& name="");
+		virtual void appendMeteoData(std::vector< METEO_SET >& vecMeteo,
+		                             const std::string& name="");
 #else
 		virtual void writeMeteoData(const std::vector< METEO_SET >& vecMeteo,
 		                            const std::string& name="");
+		virtual void appendMeteoData(const std::vector< METEO_SET >& vecMeteo,
+		                             const std::string& name="");
 #endif
 		virtual void write2DGrid(const Grid2DObject& grid_in, const std::string& options="");
 		virtual void write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date);
@@ -128,6 +165,12 @@ class BufferedIOHandler : public IOInterface {
 
 		const std::string toString() const;
 
+		/**
+		 * @brief Get the usage statistics of the time series buffer and of the grids buffer
+		 * @param vecStats the statistics of both buffers will be appended to this vector
+		 */
+		void getCacheStats(std::vector<CacheStats>& vecStats) const;
+
 		friend class IOManager;
 
 		/**
@@ -141,6 +184,22 @@ class BufferedIOHandler : public IOInterface {
 		void setMinBufferRequirements(const double& i_chunk_size, const double& i_buff_before);
 
 	private:
+		///a grid being read in the background by its own IOHandler
+		typedef struct PREFETCH_SLOT {
+			PREFETCH_SLOT() : io(NULL), thread(NULL), grid_hash(), parameter(), date(), grid(), lock(), done(false), failed(false) {}
+			IOHandler *io; ///< created on first use, so the plugins are only loaded if prefetching is used
+			Thread *thread; ///< NULL when the slot is free
+			std::string grid_hash;
+			MeteoGrids::Parameters parameter;
+			Date date;
+			Grid2DObject grid;
+			Mutex lock; ///< protects done and failed, that are written by the thread
+			bool done, failed;
+			private:
+				PREFETCH_SLOT(const PREFETCH_SLOT&); //a slot owns its thread, it can not be copied
+				PREFETCH_SLOT& operator=(const PREFETCH_SLOT&);
+		} prefetch_slot;
+
 		//private methods
 		void fillBuffer(const Date& dateStart, const Date& dateEnd,
 		                const size_t& stationindex=IOUtils::npos);
@@ -154,21 +213,33 @@ class BufferedIOHandler : public IOInterface {
 
 		void setDfltBufferProperties();
 		void addToBuffer(const Grid2DObject& in_grid2Dobj, const std::string& grid_hash);
-		bool getFromBuffer(const std::string& grid_hash, Grid2DObject& grid) const;
+		bool getFromBuffer(const std::string& grid_hash, Grid2DObject& grid);
+		void checkMemory(const Date& date_end);
+		static const std::string getGridHash(const MeteoGrids::Parameters& parameter, const Date& date);
+		static void prefetchGrid(void* arg);
+		void collectPrefetched(const std::string& grid_hash);
+		void prefetch(const MeteoGrids::Parameters& parameter, const Date& date);
+		void stopPrefetching();
 
 		//private members
 		IOHandler& iohandler;
 		const Config& cfg;
 
 		std::vector< METEO_SET > meteo_buffer; ///< This is the buffer for time series
-		std::map<std::string, Grid2DObject> mapBufferedGrids;
-		std::vector<DEMObject> dem_buffer;
+		std::map<std::string, CompactGrid<Grid2DObject> > mapBufferedGrids;
+		std::vector< CompactGrid<DEMObject> > dem_buffer;
 		std::vector<std::string> IndexBufferedGrids;
 
 		Date buffer_start, buffer_end;
 		Duration chunk_size; ///< How much data to read at once
 		Duration buff_before; ///< How much data to read before the requested date in buffer
 		size_t max_grids; ///< How many grids to buffer (grids, dems, landuse and assimilation grids together)
+		bool grids_float32; ///< keep the buffered grids in single precision?
+		CacheStats meteo_stats; ///< usage of the time series buffer
+		CacheStats grids_stats; ///< usage of the grids buffer (dems excepted)
+		std::vector<prefetch_slot*> prefetch_slots; ///< grids being read in the background
+		std::map<MeteoGrids::Parameters, Date> last_grid_dates; ///< last requested date for each parameter, to predict the next one
+		mutable Mutex mutex; ///< protects the buffers when several threads are reading
 };
 
 } //end namespace
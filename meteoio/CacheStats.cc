@@ -0,0 +1,116 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/CacheStats.h>
+
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+namespace mio {
+
+CacheStats::CacheStats(const std::string& i_name)
+           : name(i_name), items(0), bytes(0), max_bytes(0), hits(0), misses(0), evictions(0), refills(0) {}
+
+void CacheStats::resetCounters()
+{
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+	refills = 0;
+}
+
+double CacheStats::getHitRatio() const
+{
+	const size_t requests = hits + misses;
+	if (requests==0) return IOUtils::nodata;
+	return static_cast<double>(hits) / static_cast<double>(requests);
+}
+
+CacheStats& CacheStats::operator+=(const CacheStats& source)
+{
+	items += source.items;
+	bytes += source.bytes;
+	max_bytes += source.max_bytes;
+	hits += source.hits;
+	misses += source.misses;
+	evictions += source.evictions;
+	refills += source.refills;
+	return *this;
+}
+
+const std::string CacheStats::toString() const
+{
+	std::ostringstream os;
+	os << std::setw(22) << std::left << name << std::right;
+	os << std::setw(8) << items << " items, " << std::fixed << std::setprecision(3) << std::setw(10) << static_cast<double>(bytes)/(1024.*1024.) << " MB";
+	if (max_bytes>0) os << " (max " << static_cast<double>(max_bytes)/(1024.*1024.) << " MB)";
+	os << ", " << hits << " hits, " << misses << " misses, " << evictions << " evictions, " << refills << " refills\n";
+	return os.str();
+}
+
+static size_t getCells(const Array2D<double>& array)
+{
+	return array.getNx()*array.getNy();
+}
+
+//the sizes are estimated from the containers' content, the allocator's overhead is not taken into account
+size_t CacheStats::getMemorySize(const MeteoData& md)
+{
+	const size_t nr_params = md.getNrOfParameters();
+	const size_t extra_params = nr_params - MeteoData::nrOfParameters;
+	return sizeof(MeteoData) + nr_params*sizeof(double) + extra_params*(sizeof(std::string)+8)
+	       + md.meta.stationID.size() + md.meta.stationName.size();
+}
+
+size_t CacheStats::getMemorySize(const std::vector<MeteoData>& vecMeteo)
+{
+	//all the elements of a station's time series are assumed to have the same footprint as the first one
+	if (vecMeteo.empty()) return vecMeteo.capacity()*sizeof(MeteoData);
+	const size_t elem_size = getMemorySize(vecMeteo.front());
+	return vecMeteo.size()*elem_size + (vecMeteo.capacity()-vecMeteo.size())*sizeof(MeteoData);
+}
+
+size_t CacheStats::getMemorySize(const std::vector< std::vector<MeteoData> >& vecVecMeteo)
+{
+	size_t size = vecVecMeteo.capacity() * sizeof(std::vector<MeteoData>);
+	for (size_t ii=0; ii<vecVecMeteo.size(); ii++)
+		size += getMemorySize(vecVecMeteo[ii]);
+	return size;
+}
+
+size_t CacheStats::getMemorySize(const MeteoSnapshot& snapshot)
+{
+	const size_t nr_stations = snapshot.getNrStations();
+	const size_t columns = snapshot.getNrOfParameters() + 3; //the parameters, eastings, northings and altitudes
+	return sizeof(MeteoSnapshot) + getMemorySize(snapshot.getMeteoData()) + columns*nr_stations*sizeof(double);
+}
+
+size_t CacheStats::getMemorySize(const Grid2DObject& grid)
+{
+	return sizeof(Grid2DObject) + getCells(grid.grid2D)*sizeof(double);
+}
+
+size_t CacheStats::getMemorySize(const DEMObject& dem)
+{
+	const size_t cells = getCells(dem.grid2D) + getCells(dem.slope) + getCells(dem.azi) + getCells(dem.curvature)
+	                     + getCells(dem.Nx) + getCells(dem.Ny) + getCells(dem.Nz);
+	return sizeof(DEMObject) + cells*sizeof(double);
+}
+
+} //namespace
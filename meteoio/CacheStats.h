@@ -0,0 +1,87 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __CACHESTATS_H__
+#define __CACHESTATS_H__
+
+#include <meteoio/MeteoData.h>
+#include <meteoio/MeteoSnapshot.h>
+#include <meteoio/Grid2DObject.h>
+#include <meteoio/DEMObject.h>
+
+#include <string>
+#include <vector>
+
+namespace mio {
+
+/**
+ * @class CacheStats
+ * @brief Usage statistics of one of the caches or buffers of the IOManager.
+ * Besides the current content of the cache (number of items and estimated memory footprint), the counters keep
+ * track of how the cache has been used since it was created: how many requests could be served from the cache (hits),
+ * how many had to be computed or read (misses), how many items had to be removed (evictions) and how many
+ * times the cache had to be (re)filled. The memory footprint is an estimate based on the size of the data, it
+ * does not take the allocator's overhead into account.
+ * See IOManager::getCacheStats().
+ *
+ * @ingroup data_str
+ * @date   2014-05-06
+ */
+class CacheStats {
+	public:
+		CacheStats(const std::string& i_name="");
+
+		/**
+		* @brief Set the usage counters back to zero (the content information is kept)
+		*/
+		void resetCounters();
+
+		/**
+		* @brief Ratio of the requests that could be served from the cache
+		* @return hits/(hits+misses), or IOUtils::nodata if there has not been any request
+		*/
+		double getHitRatio() const;
+
+		const std::string toString() const;
+
+		/**
+		* @brief Add the statistics of another cache to this one (for example, to compute the total)
+		* @param source statistics to add
+		* @return reference to this object
+		*/
+		CacheStats& operator+=(const CacheStats& source);
+
+		static size_t getMemorySize(const MeteoData& md);
+		static size_t getMemorySize(const std::vector<MeteoData>& vecMeteo);
+		static size_t getMemorySize(const std::vector< std::vector<MeteoData> >& vecVecMeteo);
+		static size_t getMemorySize(const MeteoSnapshot& snapshot);
+		static size_t getMemorySize(const Grid2DObject& grid);
+		static size_t getMemorySize(const DEMObject& dem);
+
+		std::string name; ///< name of the cache
+		size_t items; ///< number of items (timesteps, grids, etc) currently in the cache
+		size_t bytes; ///< estimated memory footprint of the cache content
+		size_t max_bytes; ///< configured memory limit for this cache (0 if there is no limit)
+		size_t hits; ///< number of requests that have been served from the cache
+		size_t misses; ///< number of requests that could not be served from the cache
+		size_t evictions; ///< number of items removed from the cache because of its limits
+		size_t refills; ///< number of times the cache has been (re)filled
+};
+
+} //end namespace
+
+#endif
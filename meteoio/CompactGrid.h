@@ -0,0 +1,174 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __COMPACTGRID_H__
+#define __COMPACTGRID_H__
+
+#include <meteoio/Grid2DObject.h>
+#include <meteoio/DEMObject.h>
+#include <meteoio/CacheStats.h>
+
+#include <vector>
+
+namespace mio {
+
+/**
+ * @class CompactGrid
+ * @brief Copy of a Grid2DObject or of a DEMObject (with all its derived fields), as kept in the grids buffers.
+ * The values can be stored in single precision, which halves the memory that the copy uses. They are converted back to
+ * double precision when the grid is retrieved, so all the computations are still done in double precision (but the
+ * retrieved values only keep about 7 significant digits).
+ *
+ * @ingroup data_str
+ * @date   2014-06-12
+ */
+template<class G> class CompactGrid {
+	public:
+		CompactGrid() : grid(), fields(), single_precision(false) {}
+
+		/**
+		* @brief Keep a copy of a grid
+		* @param i_grid grid to copy
+		* @param i_single_precision should the values be stored as float?
+		*/
+		CompactGrid(const G& i_grid, const bool& i_single_precision);
+
+		/**
+		* @brief Get the stored grid
+		* @param o_grid grid to fill (it is completely overwritten)
+		*/
+		void get(G& o_grid) const;
+
+		const G& getGeometry() const {return grid;} ///< the stored grid, without its values if they are stored as float
+		bool isSinglePrecision() const {return single_precision;}
+		size_t getMemorySize() const;
+
+	private:
+		static void copyGeometry(const Grid2DObject& source, Grid2DObject& dest);
+		static void copyGeometry(const DEMObject& source, DEMObject& dest);
+		static void getFields(Grid2DObject& source, std::vector< Array2D<double>* >& vecFields);
+		static void getFields(DEMObject& source, std::vector< Array2D<double>* >& vecFields);
+
+		G grid; ///< the grid, its values are left empty when they are stored as float
+		std::vector< Array2D<float> > fields; ///< the values of the grid (and its derived fields), when they are stored as float
+		bool single_precision;
+};
+
+template<class G> CompactGrid<G>::CompactGrid(const G& i_grid, const bool& i_single_precision)
+                  : grid(), fields(), single_precision(i_single_precision)
+{
+	if (!single_precision) {
+		grid = i_grid;
+		return;
+	}
+
+	//the double precision values are never copied
+	copyGeometry(i_grid, grid);
+	std::vector< Array2D<double>* > vecFields;
+	getFields(const_cast<G&>(i_grid), vecFields); //the fields are only read
+	fields.resize(vecFields.size());
+	for (size_t ii=0; ii<vecFields.size(); ii++) {
+		const Array2D<double>& source = *vecFields[ii];
+		Array2D<float>& dest = fields[ii];
+		if (source.isEmpty()) continue;
+
+		dest.resize(source.getNx(), source.getNy());
+		dest.setKeepNodata(source.getKeepNodata());
+		const size_t nr_cells = source.getNx()*source.getNy();
+		const double *in = source.data();
+		float *out = dest.data();
+		for (size_t jj=0; jj<nr_cells; jj++)
+			out[jj] = static_cast<float>(in[jj]);
+	}
+}
+
+template<class G> void CompactGrid<G>::get(G& o_grid) const
+{
+	if (!single_precision) {
+		o_grid = grid;
+		return;
+	}
+
+	copyGeometry(grid, o_grid);
+	std::vector< Array2D<double>* > vecFields;
+	getFields(o_grid, vecFields);
+	for (size_t ii=0; ii<vecFields.size(); ii++) {
+		const Array2D<float>& source = fields[ii];
+		Array2D<double>& dest = *vecFields[ii];
+		if (source.isEmpty()) {
+			dest.clear();
+			continue;
+		}
+
+		dest.resize(source.getNx(), source.getNy());
+		dest.setKeepNodata(source.getKeepNodata());
+		const size_t nr_cells = source.getNx()*source.getNy();
+		const float *in = source.data();
+		double *out = dest.data();
+		for (size_t jj=0; jj<nr_cells; jj++)
+			out[jj] = static_cast<double>(in[jj]); //nodata is exactly represented as float
+	}
+}
+
+template<class G> size_t CompactGrid<G>::getMemorySize() const
+{
+	size_t size = CacheStats::getMemorySize(grid);
+	for (size_t ii=0; ii<fields.size(); ii++)
+		size += fields[ii].getNx()*fields[ii].getNy()*sizeof(float);
+	return size;
+}
+
+template<class G> void CompactGrid<G>::copyGeometry(const Grid2DObject& source, Grid2DObject& dest)
+{
+	dest.llcorner = source.llcorner;
+	dest.cellsize = source.cellsize;
+	dest.ncols = source.ncols;
+	dest.nrows = source.nrows;
+}
+
+template<class G> void CompactGrid<G>::copyGeometry(const DEMObject& source, DEMObject& dest)
+{
+	copyGeometry(static_cast<const Grid2DObject&>(source), static_cast<Grid2DObject&>(dest));
+	dest.min_altitude = source.min_altitude;
+	dest.min_slope = source.min_slope;
+	dest.min_curvature = source.min_curvature;
+	dest.max_altitude = source.max_altitude;
+	dest.max_slope = source.max_slope;
+	dest.max_curvature = source.max_curvature;
+	dest.setUpdatePpt( static_cast<DEMObject::update_type>(source.getUpdatePpt()) );
+	dest.setDefaultAlgorithm( static_cast<DEMObject::slope_type>(source.getDefaultAlgorithm()) );
+}
+
+template<class G> void CompactGrid<G>::getFields(Grid2DObject& source, std::vector< Array2D<double>* >& vecFields)
+{
+	vecFields.push_back(&source.grid2D);
+}
+
+template<class G> void CompactGrid<G>::getFields(DEMObject& source, std::vector< Array2D<double>* >& vecFields)
+{
+	getFields(static_cast<Grid2DObject&>(source), vecFields);
+	vecFields.push_back(&source.slope);
+	vecFields.push_back(&source.azi);
+	vecFields.push_back(&source.curvature);
+	vecFields.push_back(&source.Nx);
+	vecFields.push_back(&source.Ny);
+	vecFields.push_back(&source.Nz);
+}
+
+} //end namespace
+
+#endif
@@ -1027,6 +1027,7 @@ double DEMObject::safeGet(const int i, const int j)
 }
 
 std::iostream& operator<<(std::iostream& os, const DEMObject& dem) {
+	os << static_cast<const Grid2DObject&>(dem);
 	os << dem.slope;
 	os << dem.azi;
 	os << dem.curvature;
@@ -1047,6 +1048,7 @@ std::iostream& operator<<(std::iostream& os, const DEMObject& dem) {
 }
 
 std::iostream& operator>>(std::iostream& is, DEMObject& dem) {
+	is >> static_cast<Grid2DObject&>(dem);
 	is >> dem.slope;
 	is >> dem.azi;
 	is >> dem.curvature;
@@ -17,6 +17,7 @@
 */
 
 #include <meteoio/DataGenerator.h>
+#include <meteoio/Profiler.h>
 
 using namespace std;
 
@@ -74,10 +75,11 @@ DataGenerator& DataGenerator::operator=(const DataGenerator& source)
 void DataGenerator::fillMissing(METEO_SET& vecMeteo) const
 {
 	if(!generators_defined) return; //no generators defined by the end user
+	MIO_PROFILE("DataGenerator::fillMissing");
 
 	std::map< std::string, std::vector<GeneratorAlgorithm*> >::const_iterator it;
 	for(it=mapGenerators.begin(); it!=mapGenerators.end(); ++it) {
-		const std::vector<GeneratorAlgorithm*> vecGenerators( it->second );
+		const std::vector<GeneratorAlgorithm*>& vecGenerators( it->second );
 
 		for(size_t station=0; station<vecMeteo.size(); ++station) { //process this parameter on all stations
 			const size_t param = vecMeteo[station].getParameterIndex(it->first);
@@ -93,25 +95,16 @@ void DataGenerator::fillMissing(METEO_SET& vecMeteo) const
  * @brief generate data to fill missing data points.
  * This relies on data generators defined by the user for each meteo parameters.
  * This loops over the defined generators and stops as soon as all missing points
- * have been successfully replaced.
+ * have been successfully replaced. Each parameter is extracted as a column of values once
+ * per station and handed over to the generators, the stations being processed in parallel.
  * @param vecVecMeteo vector containing a timeserie for each station
  */
 void DataGenerator::fillMissing(std::vector<METEO_SET>& vecVecMeteo) const
 {
 	if(!generators_defined) return; //no generators defined by the end user
+	MIO_PROFILE("DataGenerator::fillMissing");
 
-	std::map< std::string, std::vector<GeneratorAlgorithm*> >::const_iterator it;
-	for(it=mapGenerators.begin(); it!=mapGenerators.end(); ++it) {
-		const std::vector<GeneratorAlgorithm*> vecGenerators( it->second );
-
-		for(size_t station=0; station<vecVecMeteo.size(); ++station) { //process this parameter on all stations
-			const size_t param = vecVecMeteo[station][0].getParameterIndex(it->first);
-			if(param==IOUtils::npos) continue;
-
-			size_t jj=0;
-			while (jj<vecGenerators.size() && vecGenerators[jj]->generate(param, vecVecMeteo[station]) != true) jj++;
-		}
-	}
+	processStations(mapGenerators, false, vecVecMeteo);
 }
 
 /**
@@ -124,10 +117,11 @@ void DataGenerator::fillMissing(std::vector<METEO_SET>& vecVecMeteo) const
 void DataGenerator::createParameters(METEO_SET& vecMeteo) const
 {
 	if(!creators_defined) return; //no creators defined by the end user
+	MIO_PROFILE("DataGenerator::createParameters");
 
 	std::map< std::string, std::vector<GeneratorAlgorithm*> >::const_iterator it;
 	for(it=mapCreators.begin(); it!=mapCreators.end(); ++it) {
-		const std::vector<GeneratorAlgorithm*> vecGenerators( it->second );
+		const std::vector<GeneratorAlgorithm*>& vecGenerators( it->second );
 
 		for(size_t station=0; station<vecMeteo.size(); ++station) { //process this parameter on all stations
 			const size_t param = vecMeteo[station].addParameter( it->first );
@@ -148,25 +142,94 @@ void DataGenerator::createParameters(METEO_SET& vecMeteo) const
 void DataGenerator::createParameters(std::vector<METEO_SET>& vecVecMeteo) const
 {
 	if(!creators_defined) return; //no creators defined by the end user
+	MIO_PROFILE("DataGenerator::createParameters");
 
-	std::map< std::string, std::vector<GeneratorAlgorithm*> >::const_iterator it;
-	for(it=mapCreators.begin(); it!=mapCreators.end(); ++it) {
-		const std::vector<GeneratorAlgorithm*> vecGenerators( it->second );
+	processStations(mapCreators, true, vecVecMeteo);
+}
 
-		for(size_t station=0; station<vecVecMeteo.size(); ++station) { //process this parameter on all stations
-			//create the new parameter
-			for(size_t ii=0; ii<vecVecMeteo[station].size(); ++ii) {
-				vecVecMeteo[station][ii].addParameter( it->first );
+/**
+ * @brief run the given algorithms on the time series of all stations, in parallel if possible.
+ * The stations are independent from each other, so each thread processes whole stations. The exceptions can not
+ * leave a parallel region, so the first one is kept and thrown again once all the stations have been processed.
+ * @param mapAlgorithms algorithms to run for each meteo parameter
+ * @param create_params should the parameters be created if they don't exist?
+ * @param vecVecMeteo vector containing a timeserie for each station
+ */
+void DataGenerator::processStations(const std::map< std::string, std::vector<GeneratorAlgorithm*> >& mapAlgorithms, const bool& create_params,
+                                    std::vector<METEO_SET>& vecVecMeteo)
+{
+	IOException *error = NULL;
+	const long nr_stations = static_cast<long>( vecVecMeteo.size() );
+
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+	#endif
+	for(long station=0; station<nr_stations; station++) {
+		try {
+			processStation(mapAlgorithms, create_params, vecVecMeteo[static_cast<size_t>(station)]);
+		} catch(const std::exception& e) {
+			#ifdef _OPENMP
+			#pragma omp critical(DataGenerator_error)
+			#endif
+			{
+				if(error==NULL) {
+					const IOException *io_error = dynamic_cast<const IOException*>(&e);
+					error = (io_error!=NULL)? new IOException(*io_error) : new IOException(e.what(), AT);
+				}
 			}
-			const size_t param = vecVecMeteo[station][0].getParameterIndex(it->first);
+		}
+	}
 
-			//fill the new parameter
-			size_t jj=0;
-			while (jj<vecGenerators.size() && vecGenerators[jj]->generate(param, vecVecMeteo[station]) != true) jj++;
+	if(error!=NULL) {
+		const IOException tmp( *error );
+		delete error;
+		throw tmp;
+	}
+}
+
+void DataGenerator::processStation(const std::map< std::string, std::vector<GeneratorAlgorithm*> >& mapAlgorithms, const bool& create_params,
+                                   METEO_SET& vecMeteo)
+{
+	if(vecMeteo.empty()) return;
+
+	std::vector<double> julian, values; //allocated once for all the parameters of the station
+	GeneratorAlgorithm::get_julian(vecMeteo, julian);
+
+	std::map< std::string, std::vector<GeneratorAlgorithm*> >::const_iterator it;
+	for(it=mapAlgorithms.begin(); it!=mapAlgorithms.end(); ++it) {
+		const std::vector<GeneratorAlgorithm*>& vecGenerators( it->second );
+
+		if(create_params) {
+			for(size_t ii=0; ii<vecMeteo.size(); ++ii)
+				vecMeteo[ii].addParameter( it->first );
 		}
+		const size_t param = vecMeteo[0].getParameterIndex(it->first);
+		if(param==IOUtils::npos) continue;
+
+		GeneratorAlgorithm::get_column(param, vecMeteo, values);
+		size_t jj=0;
+		while (jj<vecGenerators.size() && generate(*vecGenerators[jj], param, vecMeteo, julian, values) != true) jj++;
+
+		for(size_t ii=0; ii<vecMeteo.size(); ++ii)
+			vecMeteo[ii](param) = values[ii];
 	}
 }
 
+//run one generator on the column of values of a station
+bool DataGenerator::generate(GeneratorAlgorithm& generator, const size_t& param, METEO_SET& vecMeteo,
+                             const std::vector<double>& julian, std::vector<double>& values)
+{
+	if(generator.has_column())
+		return generator.generate_column(param, vecMeteo, julian, values);
+
+	//the generator only implements the MeteoData interface, so the values are put back in the data for it
+	for(size_t ii=0; ii<vecMeteo.size(); ++ii)
+		vecMeteo[ii](param) = values[ii];
+	const bool all_filled = generator.generate(param, vecMeteo);
+	GeneratorAlgorithm::get_column(param, vecMeteo, values);
+	return all_filled;
+}
+
 /** @brief build the generators for each meteo parameter
  * By reading the Config object build up a list of user configured algorithms
  * for each MeteoData::Parameters parameter (i.e. each member variable of MeteoData like ta, p, hnw, ...)
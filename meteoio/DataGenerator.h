@@ -62,6 +62,12 @@ namespace mio {
  * - bool generate(const size_t& param, MeteoData& md)
  * - bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
  *
+ * For better performances, the following methods should also be implemented (the generate method on a vector of MeteoData then
+ * simply returning generate_by_column(param, vecMeteo)):
+ * - bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo, const std::vector<double>& julian, std::vector<double>& values)
+ * - bool has_column() const, returning true. The DataGenerator only calls generate_column() on the generators that return true here,
+ *   the default generate_column() throwing an exception.
+ *
  * The constructor is responsible for parsing the arguments as a vector of strings and saving its own name internally, for
  * error messages, warnings, etc. It should set all internal variables it sees fit according to the parsed arguments. The
  * goal is <i>to not</i> do any parsing anywhere else (for performances reasons).
@@ -75,6 +81,11 @@ namespace mio {
  * If all missing data points could be generated (or if no data point required to be generated), it returns <i>true</i>,
  * and <i>false</i> otherwise.
  *
+ * The <i>generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo, const std::vector<double>& julian, std::vector<double>& values)</i>
+ * method does the same on a column of values (the values of the parameter for each timestamp, modified in place). The other parameters that the generator
+ * needs should be extracted once as columns (see GeneratorAlgorithm::get_column()) and not accessed in vecMeteo for each timestamp. Since the stations
+ * are processed in parallel, any state that the generator shares between the stations must be protected by a Mutex.
+ *
  * Finally, a new entry must be added in the object factory GeneratorAlgorithmFactory::getAlgorithm method at the top of file
  * GeneratorAlgorithms.cc.
  *
@@ -128,6 +139,12 @@ class DataGenerator {
 		                                const std::string& algorithm,
 		                                std::vector<std::string>& vecArgs);
 		static void setAlgorithms(const Config& cfg, const std::string& key_pattern, std::map< std::string, std::vector<GeneratorAlgorithm*> > &mapAlgorithms);
+		static void processStations(const std::map< std::string, std::vector<GeneratorAlgorithm*> >& mapAlgorithms, const bool& create_params,
+		                            std::vector<METEO_SET>& vecVecMeteo);
+		static void processStation(const std::map< std::string, std::vector<GeneratorAlgorithm*> >& mapAlgorithms, const bool& create_params,
+		                           METEO_SET& vecMeteo);
+		static bool generate(GeneratorAlgorithm& generator, const size_t& param, METEO_SET& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
 
 		std::map< std::string, std::vector<GeneratorAlgorithm*> > mapGenerators; //per parameter data generators algorithms
 		std::map< std::string, std::vector<GeneratorAlgorithm*> > mapCreators; //per parameter data creators algorithms
@@ -51,6 +51,7 @@ const float Date::MJD_offset = 2400000.5; ///<offset between julian date and mod
 const float Date::Unix_offset = 2440587.5; ///<offset between julian date and Unix Epoch time
 const float Date::Excel_offset = 2415018.5;  ///<offset between julian date and Excel dates (note that excel invented some days...)
 const float Date::Matlab_offset = 1721058.5; ///<offset between julian date and Matlab dates
+const size_t Date::max_str_len;
 
 const double Date::epsilon=1./(24.*3600.025); ///< minimum difference between two dates. 1 second in units of days. 3600.025 is intentional
 //NOTE: For the comparison operators, we assume that dates are positive so we can bypass a call to abs()
@@ -864,6 +865,11 @@ const string Date::toString(FORMATS type, const bool& gmt) const
 	if(undef==true)
 		throw UnknownValueException("Date object is undefined!", AT);
 
+	if(type!=FULL) { //the most common formats are handled without going through a stream
+		char tmp[max_str_len];
+		if(printDate(type, tmp, gmt)!=0) return string(tmp);
+	}
+
 	if(gmt) {
 		julian_out = gmt_julian;
 		year_out = gmt_year;
@@ -934,6 +940,161 @@ const string Date::toString(FORMATS type, const bool& gmt) const
 	return tmpstr.str();
 }
 
+//write a positive integer as a fixed width, zero padded, field
+static inline char* printPadded(char* p, int value, const int& width) {
+	for(int ii=width-1; ii>=0; ii--) {
+		p[ii] = static_cast<char>('0' + value%10);
+		value /= 10;
+	}
+	return p+width;
+}
+
+/**
+* @brief Write a nicely formated date into a user provided buffer.
+* This does the same as toString(FORMATS, const bool&) but without any memory allocation for the
+* most common formats, so it is suitable for building cache keys or writing timestamps in tight loops.
+* A buffer of Date::max_str_len characters is always large enough.
+* @param type select the formating to apply (see the definition of Date::FORMATS)
+* @param o_str buffer to write the formatted date into (it will be null terminated)
+* @param o_size size of the buffer
+* @param gmt convert returned value to GMT? (default: false)
+* @return number of characters written (without the terminating null character)
+*/
+size_t Date::toString(FORMATS type, char* o_str, const size_t& o_size, const bool& gmt) const
+{
+	if(undef==true)
+		throw UnknownValueException("Date object is undefined!", AT);
+	if(o_size<max_str_len)
+		throw InvalidArgumentException("The buffer provided for formatting a date is too small", AT);
+
+	const size_t len = printDate(type, o_str, gmt);
+	if(len!=0) return len;
+
+	//rare cases (FULL format, exotic years) are left to the streams
+	const std::string tmp( toString(type, gmt) );
+	if(tmp.size()>=o_size)
+		throw InvalidArgumentException("The buffer provided for formatting a date is too small", AT);
+	tmp.copy(o_str, tmp.size());
+	o_str[tmp.size()] = '\0';
+	return tmp.size();
+}
+
+//write the date into a buffer of at least max_str_len chars, return 0 if this must be done by the streams
+size_t Date::printDate(FORMATS type, char* o_str, const bool& gmt) const
+{
+	int year_out, month_out, day_out, hour_out, minute_out;
+	if(gmt) {
+		year_out = gmt_year;
+		month_out = gmt_month;
+		day_out = gmt_day;
+		hour_out = gmt_hour;
+		minute_out = gmt_minute;
+	} else {
+		calculateValues(GMTToLocal(gmt_julian), year_out, month_out, day_out, hour_out, minute_out);
+	}
+	if(year_out<0 || year_out>9999) return 0; //the streams pad these differently, let them handle it
+
+	char *p = o_str;
+	switch(type) {
+		case(ISO_TZ):
+		case(ISO):
+			p = printPadded(p, year_out, 4); *p++ = '-';
+			p = printPadded(p, month_out, 2); *p++ = '-';
+			p = printPadded(p, day_out, 2); *p++ = 'T';
+			p = printPadded(p, hour_out, 2); *p++ = ':';
+			p = printPadded(p, minute_out, 2);
+			if(type==ISO_TZ) {
+				int tz_h, tz_min;
+				if(timezone>=0.) {
+					tz_h = static_cast<int>(timezone);
+					tz_min = static_cast<int>( (timezone - (double)tz_h)*60. + .5 ); //round to closest
+					*p++ = '+';
+				} else {
+					tz_h = -static_cast<int>(timezone);
+					tz_min = -static_cast<int>( (timezone + (double)tz_h)*60. + .5 ); //round to closest
+					*p++ = '-';
+				}
+				if(tz_min<0 || tz_min>99) return 0;
+				p = printPadded(p, tz_h, 2); *p++ = ':';
+				p = printPadded(p, tz_min, 2);
+			}
+			break;
+		case(NUM):
+			p = printPadded(p, year_out, 4);
+			p = printPadded(p, month_out, 2);
+			p = printPadded(p, day_out, 2);
+			p = printPadded(p, hour_out, 2);
+			p = printPadded(p, minute_out, 2);
+			break;
+		case(DIN):
+			p = printPadded(p, day_out, 2); *p++ = '.';
+			p = printPadded(p, month_out, 2); *p++ = '.';
+			p = printPadded(p, year_out, 4); *p++ = ' ';
+			p = printPadded(p, hour_out, 2); *p++ = ':';
+			p = printPadded(p, minute_out, 2);
+			break;
+		default:
+			return 0;
+	}
+
+	*p = '\0';
+	return static_cast<size_t>(p - o_str);
+}
+
+//read exactly nr_digits digits, return false if this is not possible
+static inline bool parseDigits(const char*& p, const int& nr_digits, int& value) {
+	value = 0;
+	for(int ii=0; ii<nr_digits; ii++) {
+		const char c = *p;
+		if(c<'0' || c>'9') return false;
+		value = value*10 + (c-'0');
+		p++;
+	}
+	return true;
+}
+
+/**
+* @brief Quickly parse the most common ISO 8601 representations, without any memory allocation.
+* The following representations are recognized: YYYY-MM-DD, YYYY-MM-DDTHH:mm and YYYY-MM-DDTHH:mm:SS
+* (the 'T' might be replaced by a space and the seconds might be fractional, they are ignored).
+* Everything that follows (for example a time zone specification) is left to the caller, nr_chars
+* points to it. Any other format is rejected so the caller can fall back to a more general parser.
+* @param iso string to parse
+* @param year parsed year
+* @param month parsed month
+* @param day parsed day
+* @param hour parsed hour (0 if not provided)
+* @param minute parsed minutes (0 if not provided)
+* @param nr_chars number of characters that have been consumed
+* @return true if the string could be parsed
+*/
+bool Date::parseISO(const char* iso, int& year, int& month, int& day, int& hour, int& minute, size_t& nr_chars)
+{
+	const char *p = iso;
+	hour = 0; minute = 0;
+	if(!parseDigits(p, 4, year) || *p++!='-') return false;
+	if(!parseDigits(p, 2, month) || *p++!='-') return false;
+	if(!parseDigits(p, 2, day)) return false;
+
+	if((*p=='T' || *p==' ') && p[1]>='0' && p[1]<='9') {
+		p++;
+		if(!parseDigits(p, 2, hour) || *p++!=':') return false;
+		if(!parseDigits(p, 2, minute)) return false;
+		if(*p==':') { //seconds, currently not used
+			p++;
+			int second;
+			if(!parseDigits(p, 2, second)) return false;
+			if(*p=='.') {
+				p++;
+				while(*p>='0' && *p<='9') p++;
+			}
+		}
+	}
+
+	nr_chars = static_cast<size_t>(p - iso);
+	return true;
+}
+
 const std::string Date::toString() const {
 	std::ostringstream os;
 	os << "<date>\n";
@@ -998,30 +1159,36 @@ double Date::calculateJulianDate(const int& i_year, const int& i_month, const in
 
 void Date::calculateValues(const double& i_julian, int& o_year, int& o_month, int& o_day, int& o_hour, int& o_minute) const
 { //given a julian day, calculate the year, month, day, hours and minutes
- //see Fliegel, H. F. and van Flandern, T. C. 1968. Letters to the editor: a machine algorithm for processing calendar dates. Commun. ACM 11, 10 (Oct. 1968), 657. DOI= http://doi.acm.org/10.1145/364096.364097
 	//we round the given julian date to the closest minute since this is our current resolution
-	const double tmp_julian = rnd(i_julian, 60);
+	const double shifted_julian = i_julian + .5; //the julian date reference is at 12:00
+	long julday = Optim::floor(shifted_julian);
+	long minutes = Optim::round( (shifted_julian - static_cast<double>(julday)) * (24.*60.) );
+	if(minutes>=24*60) { //rounding brought us to the next day
+		julday++;
+		minutes -= 24*60;
+	}
+
+	civilFromJulianDayNumber(julday, o_year, o_month, o_day);
+	o_hour = static_cast<int>(minutes / 60);
+	o_minute = static_cast<int>(minutes % 60);
+}
 
-	const long julday = Optim::floor(tmp_julian+0.5);
-	long t1 = julday + 68569L;
-	const long t2 = 4L * t1 / 146097L;
-	t1 = t1 - ( 146097L * t2 + 3L ) / 4L;
-	const long yr = 4000L * ( t1 + 1L ) / 1461001L;
-	t1 = t1 - 1461L * yr / 4L + 31L;
-	const long mo = 80L * t1 / 2447L;
+void Date::civilFromJulianDayNumber(const long& jdn, int& o_year, int& o_month, int& o_day)
+{ //given a julian day number, calculate the year, month and day using only integer arithmetic
+ //see Hinnant, H. "chrono-Compatible Low-Level Date Algorithms", http://howardhinnant.github.io/date_algorithms.html
+	const long z = jdn - 2440588L + 719468L; //days since 0000-03-01
+	const long era = (z >= 0 ? z : z - 146096L) / 146097L;
+	const long doe = z - era * 146097L; //day of era, [0, 146096]
+	const long yoe = (doe - doe/1460L + doe/36524L - doe/146096L) / 365L; //year of era, [0, 399]
+	const long doy = doe - (365L*yoe + yoe/4L - yoe/100L); //day of year starting on March 1st, [0, 365]
+	const long mp = (5L*doy + 2L) / 153L; //month starting on March, [0, 11]
 
-	o_day = (int) ( t1 - 2447L * mo / 80L );
-	t1 = mo / 11L;
-	o_month = (int) ( mo + 2L - 12L * t1 );
-	o_year = (int) ( 100L * ( t2 - 49L ) + yr + t1 );
+	o_day = static_cast<int>( doy - (153L*mp + 2L)/5L + 1L );
+	o_month = static_cast<int>( (mp < 10L)? mp+3L : mp-9L );
+	o_year = static_cast<int>( yoe + era*400L + ((o_month <= 2)? 1L : 0L) );
 
 	// Correct for BC years -> astronomical year, that is from year -1 to year 0
 	if ( o_year <= 0 ) o_year--;
-
-	double integral;
-	const double frac = modf(tmp_julian+.5, &integral); //the julian date reference is at 12:00
-	o_minute = static_cast<int>(Optim::round(frac*24.0*60.0)) % 60;
-	o_hour = static_cast<int>(Optim::round( (24.*60.*frac-(double)o_minute) / 60.0 ));
 }
 
 bool Date::isLeapYear(const int& i_year) const {
@@ -1033,19 +1200,20 @@ bool Date::isLeapYear(const int& i_year) const {
 
 long Date::getJulianDayNumber(const int& i_year, const int& i_month, const int& i_day) const
 { //given year, month, day, calculate the matching julian day
- //see Fliegel, H. F. and van Flandern, T. C. 1968. Letters to the editor: a machine algorithm for processing calendar dates. Commun. ACM 11, 10 (Oct. 1968), 657. DOI= http://doi.acm.org/10.1145/364096.364097
-	const long lmonth = (long) i_month, lday = (long) i_day;
+ //see Hinnant, H. "chrono-Compatible Low-Level Date Algorithms", http://howardhinnant.github.io/date_algorithms.html
 	long lyear = (long) i_year;
+	const long lmonth = (long) i_month, lday = (long) i_day;
 
 	// Correct for BC years -> astronomical year, that is from year -1 to year 0
 	if ( lyear < 0 ) lyear++;
 
-	const long jdn = lday - 32075L +
-	                  1461L * ( lyear + 4800L + ( lmonth - 14L ) / 12L ) / 4L +
-	                  367L * ( lmonth - 2L - ( lmonth - 14L ) / 12L * 12L ) / 12L -
-	                  3L * ( ( lyear + 4900L + ( lmonth - 14L ) / 12L ) / 100L ) / 4L;
+	if (lmonth <= 2) lyear--; //the computation is done for years starting on March 1st
+	const long era = (lyear >= 0 ? lyear : lyear - 399L) / 400L;
+	const long yoe = lyear - era * 400L; //year of era, [0, 399]
+	const long doy = (153L*(lmonth + (lmonth > 2 ? -3L : 9L)) + 2L)/5L + lday - 1L; //day of year starting on March 1st, [0, 365]
+	const long doe = yoe * 365L + yoe/4L - yoe/100L + doy; //day of era, [0, 146096]
 
-	return jdn;
+	return era * 146097L + doe - 719468L + 2440588L;
 }
 
 void Date::plausibilityCheck(const int& in_year, const int& in_month, const int& in_day, const int& in_hour, const int& in_minute) const {
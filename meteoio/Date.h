@@ -89,6 +89,7 @@ class Date {
 		static const float Unix_offset;
 		static const float Excel_offset;
 		static const float Matlab_offset;
+		static const size_t max_str_len = 32; ///< buffer size that is always large enough for toString(FORMATS, char*, size_t)
 
 		Date();
 		Date(const double& julian_in, const double& in_timezone, const bool& in_dst=false);
@@ -134,6 +135,8 @@ class Date {
 
 		static std::string printFractionalDay(const double& fractional);
 		const std::string toString(FORMATS type, const bool& gmt=false) const;
+		size_t toString(FORMATS type, char* o_str, const size_t& o_size, const bool& gmt=false) const;
+		static bool parseISO(const char* iso, int& year, int& month, int& day, int& hour, int& minute, size_t& nr_chars);
 		const std::string toString() const;
 		friend std::iostream& operator<<(std::iostream& os, const Date& date);
 		friend std::iostream& operator>>(std::iostream& is, Date& date);
@@ -170,7 +173,9 @@ class Date {
 		double calculateJulianDate(const int& in_year, const int& in_month, const int& in_day, const int& in_hour, const int& in_minute) const;
 		void calculateValues(const double& i_julian, int& out_year, int& out_month, int& out_day, int& out_hour, int& out_minute) const;
 		long getJulianDayNumber(const int&, const int&, const int&) const;
+		static void civilFromJulianDayNumber(const long& jdn, int& o_year, int& o_month, int& o_day);
 		bool isLeapYear(const int&) const;
+		size_t printDate(FORMATS type, char* o_str, const bool& gmt) const;
 		void plausibilityCheck(const int& in_year, const int& in_month, const int& in_day, const int& in_hour, const int& in_minute) const;
 
 		static const double epsilon;
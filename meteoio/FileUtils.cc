@@ -155,6 +155,18 @@ bool fileExists(const std::string& filename)
 	return ( GetFileAttributes( filename.c_str() ) != INVALID_FILE_ATTRIBUTES );
 }
 
+double getModificationTime(const std::string& filename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (GetFileAttributesEx(filename.c_str(), GetFileExInfoStandard, &attributes) == 0)
+		return IOUtils::nodata;
+
+	//FILETIME counts 100ns intervals since 1601-01-01
+	const FILETIME& ft = attributes.ftLastWriteTime;
+	const double intervals = static_cast<double>(ft.dwHighDateTime)*4294967296. + static_cast<double>(ft.dwLowDateTime);
+	return intervals*1e-7 - 11644473600.;
+}
+
 void readDirectory(const std::string& path, std::list<std::string>& dirlist, const std::string& pattern)
 {
 	const size_t path_length = path.length();
@@ -199,6 +211,13 @@ bool fileExists(const std::string& filename)
 	return false;
 }
 
+double getModificationTime(const std::string& filename)
+{
+	struct stat buffer;
+	if (stat(filename.c_str(), &buffer)!=0) return IOUtils::nodata;
+	return static_cast<double>(buffer.st_mtime);
+}
+
 void readDirectory(const std::string& path, std::list<std::string>& dirlist, const std::string& pattern)
 {
 	DIR *dp = opendir(path.c_str());
@@ -50,6 +50,13 @@ namespace IOUtils {
 
 	bool fileExists(const std::string& filename);
 
+	/**
+	* @brief Returns the last modification time of a file or directory
+	* @param filename file to check
+	* @return modification time in seconds since the Unix epoch, IOUtils::nodata if the file does not exist
+	*/
+	double getModificationTime(const std::string& filename);
+
 	/**
 	* @brief Replace "\" by "/" in a string so that a path string is cross plateform, optionally resolve
 	* links, convert relative paths to absolute paths, etc
@@ -62,6 +62,61 @@ void GeneratorAlgorithm::parse_args(const std::vector<std::string>& vecArgs)
 	}
 }
 
+/**
+ * @brief Implementation of generate() on a time series for the generators that implement generate_column()
+ * @param param index of the parameter to generate
+ * @param vecMeteo time series of the station, modified in place
+ * @return true if all missing values could be filled
+ */
+bool GeneratorAlgorithm::generate_by_column(const size_t& param, std::vector<MeteoData>& vecMeteo)
+{
+	if(vecMeteo.empty()) return true;
+
+	std::vector<double> julian, values;
+	get_julian(vecMeteo, julian);
+	get_column(param, vecMeteo, values);
+	const bool all_filled = generate_column(param, vecMeteo, julian, values);
+
+	for(size_t ii=0; ii<vecMeteo.size(); ii++)
+		vecMeteo[ii](param) = values[ii];
+	return all_filled;
+}
+
+bool GeneratorAlgorithm::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& /*vecMeteo*/,
+                                         const std::vector<double>& /*julian*/, std::vector<double>& /*values*/)
+{
+	throw IOException("The generator algorithm '"+algo+"' can not generate a column of values", AT);
+}
+
+void GeneratorAlgorithm::get_column(const size_t& param, const std::vector<MeteoData>& vecMeteo, std::vector<double>& values)
+{
+	const size_t nr_elems = vecMeteo.size();
+	values.resize( nr_elems );
+	for(size_t ii=0; ii<nr_elems; ii++)
+		values[ii] = vecMeteo[ii](param);
+}
+
+//get a parameter by name, filling with nodata if it does not exist (all the elements are expected to have the same parameters)
+bool GeneratorAlgorithm::get_column(const std::string& parname, const std::vector<MeteoData>& vecMeteo, std::vector<double>& values)
+{
+	const size_t param = (vecMeteo.empty())? IOUtils::npos : vecMeteo.front().getParameterIndex(parname);
+	if(param==IOUtils::npos) {
+		values.assign(vecMeteo.size(), IOUtils::nodata);
+		return false;
+	}
+
+	get_column(param, vecMeteo, values);
+	return true;
+}
+
+void GeneratorAlgorithm::get_julian(const std::vector<MeteoData>& vecMeteo, std::vector<double>& julian)
+{
+	const size_t nr_elems = vecMeteo.size();
+	julian.resize( nr_elems );
+	for(size_t ii=0; ii<nr_elems; ii++)
+		julian[ii] = vecMeteo[ii].date.getJulian(true);
+}
+
 ////////////////////////////////////////////////////////////////////////
 
 void ConstGenerator::parse_args(const std::vector<std::string>& vecArgs)
@@ -85,10 +140,15 @@ bool ConstGenerator::generate(const size_t& param, MeteoData& md)
 
 bool ConstGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
 {
-	if(vecMeteo.empty()) return true;
+	return generate_by_column(param, vecMeteo);
+}
 
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		generate(param, vecMeteo[ii]);
+bool ConstGenerator::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& /*vecMeteo*/,
+                                     const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	for(size_t ii=0; ii<values.size(); ii++) {
+		if(values[ii] == IOUtils::nodata)
+			values[ii] = constant;
 	}
 
 	return true; //all missing values could be filled
@@ -118,37 +178,46 @@ void SinGenerator::parse_args(const std::vector<std::string>& vecArgs)
 bool SinGenerator::generate(const size_t& param, MeteoData& md)
 {
 	double &value = md(param);
-	if(value == IOUtils::nodata) {
-		double t; //also, the minimum must occur at 0 if phase=0
-		if(type=='y') {
-			t = (static_cast<double>(md.date.getJulianDayNumber()) - phase*365.25) / 366.25 - .25;
-		} else if(type=='d') {
-			const double julian = md.date.getJulian();
-			t = (julian - Optim::intPart(julian) - phase) + .25; //watch out: julian day starts at noon!
-		} else {
-			std::ostringstream ss;
-			ss << "Invalid period \"" << type << "\" specified for the " << algo << " generator";
-			throw InvalidArgumentException(ss.str(), AT);
-		}
-
-		const double w = 2.*Cst::PI;
-		value = amplitude * sin(w*t) + offset;
-	}
+	if(value == IOUtils::nodata)
+		value = getValue(md.date);
 
 	return true; //all missing values could be filled
 }
 
 bool SinGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
 {
-	if(vecMeteo.empty()) return true;
+	return generate_by_column(param, vecMeteo);
+}
 
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		generate(param, vecMeteo[ii]);
+bool SinGenerator::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& vecMeteo,
+                                   const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	for(size_t ii=0; ii<values.size(); ii++) {
+		if(values[ii] == IOUtils::nodata)
+			values[ii] = getValue(vecMeteo[ii].date);
 	}
 
 	return true; //all missing values could be filled
 }
 
+double SinGenerator::getValue(const Date& date) const
+{
+	double t; //also, the minimum must occur at 0 if phase=0
+	if(type=='y') {
+		t = (static_cast<double>(date.getJulianDayNumber()) - phase*365.25) / 366.25 - .25;
+	} else if(type=='d') {
+		const double julian = date.getJulian();
+		t = (julian - Optim::intPart(julian) - phase) + .25; //watch out: julian day starts at noon!
+	} else {
+		std::ostringstream ss;
+		ss << "Invalid period \"" << type << "\" specified for the " << algo << " generator";
+		throw InvalidArgumentException(ss.str(), AT);
+	}
+
+	const double w = 2.*Cst::PI;
+	return amplitude * sin(w*t) + offset;
+}
+
 
 bool StandardPressureGenerator::generate(const size_t& param, MeteoData& md)
 {
@@ -163,16 +232,22 @@ bool StandardPressureGenerator::generate(const size_t& param, MeteoData& md)
 }
 
 bool StandardPressureGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
+{
+	return generate_by_column(param, vecMeteo);
+}
+
+bool StandardPressureGenerator::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& vecMeteo,
+                                                const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(vecMeteo.empty()) return true;
 
 	const double altitude = vecMeteo.front().meta.position.getAltitude(); //if the stations move, this has to be in the loop
 	if(altitude==IOUtils::nodata) return false;
 
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		double &value = vecMeteo[ii](param);
-		if(value == IOUtils::nodata)
-			value = Atmosphere::stdAirPressure(altitude);
+	const double std_pressure = Atmosphere::stdAirPressure(altitude);
+	for(size_t ii=0; ii<values.size(); ii++) {
+		if(values[ii] == IOUtils::nodata)
+			values[ii] = std_pressure;
 	}
 
 	return true; //all missing values could be filled
@@ -209,34 +284,38 @@ bool RhGenerator::generate(const size_t& param, MeteoData& md)
 }
 
 bool RhGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
+{
+	return generate_by_column(param, vecMeteo);
+}
+
+bool RhGenerator::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& vecMeteo,
+                                  const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(vecMeteo.empty()) return true;
 
 	const double altitude = vecMeteo.front().meta.position.getAltitude(); //if the stations move, this has to be in the loop
 
+	std::vector<double> TA, TD, SH;
+	get_column(MeteoData::TA, vecMeteo, TA);
+	const bool has_TD = get_column("TD", vecMeteo, TD);
+	const bool has_SH = get_column("SH", vecMeteo, SH);
+
 	bool all_filled = true;
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		double &value = vecMeteo[ii](param);
+	for(size_t ii=0; ii<values.size(); ii++) {
+		double &value = values[ii];
 		if(value == IOUtils::nodata) {
-			const double TA = vecMeteo[ii](MeteoData::TA);
-			if (TA==IOUtils::nodata) { //nothing else we can do here
+			if (TA[ii]==IOUtils::nodata) { //nothing else we can do here
 				all_filled=false;
 				continue;
 			}
 
 			//first chance to compute RH
-			if (vecMeteo[ii].param_exists("TD")) {
-				const double TD = vecMeteo[ii]("TD");
-				if (TD!=IOUtils::nodata)
-					value = Atmosphere::DewPointtoRh(TD, TA, false);
-			}
+			if (has_TD && TD[ii]!=IOUtils::nodata)
+				value = Atmosphere::DewPointtoRh(TD[ii], TA[ii], false);
 
 			//second chance to try to compute RH
-			if (value==IOUtils::nodata && vecMeteo[ii].param_exists("SH")) {
-				const double SH = vecMeteo[ii]("SH");
-				if (SH!=IOUtils::nodata && altitude!=IOUtils::nodata)
-					value = Atmosphere::specToRelHumidity(altitude, TA, SH);
-			}
+			if (value==IOUtils::nodata && has_SH && SH[ii]!=IOUtils::nodata && altitude!=IOUtils::nodata)
+				value = Atmosphere::specToRelHumidity(altitude, TA[ii], SH[ii]);
 
 			if (value==IOUtils::nodata) all_filled=false;
 		}
@@ -271,37 +350,56 @@ bool ClearSkyLWGenerator::generate(const size_t& param, MeteoData& md)
 	if (value==IOUtils::nodata) {
 		const double TA=md(MeteoData::TA), RH=md(MeteoData::RH);
 		if (TA==IOUtils::nodata || RH==IOUtils::nodata) return false;
-
-		if (model==BRUTSAERT)
-			value = Atmosphere::Brutsaert_ilwr(RH, TA);
-		else if (model==DILLEY)
-			value = Atmosphere::Dilley_ilwr(RH, TA);
-		else if (model==PRATA)
-			value = Atmosphere::Prata_ilwr(RH, TA);
-		else if (model==CLARK)
-			value = Atmosphere::Clark_ilwr(RH, TA);
-		else if (model==TANG)
-			value = Atmosphere::Tang_ilwr(RH, TA);
-		else if (model==IDSO)
-			value = Atmosphere::Idso_ilwr(RH, TA);
+		value = getILWR(RH, TA);
 	}
 
 	return true; //all missing values could be filled
 }
 
 bool ClearSkyLWGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
+{
+	return generate_by_column(param, vecMeteo);
+}
+
+bool ClearSkyLWGenerator::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& vecMeteo,
+                                          const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(vecMeteo.empty()) return true;
 
+	std::vector<double> TA, RH;
+	get_column(MeteoData::TA, vecMeteo, TA);
+	get_column(MeteoData::RH, vecMeteo, RH);
+
 	bool all_filled = true;
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		const bool status = generate(param, vecMeteo[ii]);
-		if(status==false) all_filled=false;
+	for(size_t ii=0; ii<values.size(); ii++) {
+		if (values[ii]!=IOUtils::nodata) continue;
+		if (TA[ii]==IOUtils::nodata || RH[ii]==IOUtils::nodata) {
+			all_filled=false;
+			continue;
+		}
+		values[ii] = getILWR(RH[ii], TA[ii]);
 	}
 
 	return all_filled;
 }
 
+double ClearSkyLWGenerator::getILWR(const double& RH, const double& TA) const
+{
+	if (model==BRUTSAERT)
+		return Atmosphere::Brutsaert_ilwr(RH, TA);
+	else if (model==DILLEY)
+		return Atmosphere::Dilley_ilwr(RH, TA);
+	else if (model==PRATA)
+		return Atmosphere::Prata_ilwr(RH, TA);
+	else if (model==CLARK)
+		return Atmosphere::Clark_ilwr(RH, TA);
+	else if (model==TANG)
+		return Atmosphere::Tang_ilwr(RH, TA);
+	else if (model==IDSO)
+		return Atmosphere::Idso_ilwr(RH, TA);
+	return IOUtils::nodata; //this should never happen
+}
+
 
 const double AllSkyLWGenerator::soil_albedo = .23; //grass
 const double AllSkyLWGenerator::snow_albedo = .85; //snow
@@ -326,12 +424,10 @@ void AllSkyLWGenerator::parse_args(const std::vector<std::string>& vecArgs)
 	}
 }
 
-double AllSkyLWGenerator::getCloudiness(const MeteoData& md, SunObject& sun, bool &is_night)
+double AllSkyLWGenerator::getCloudiness(const double& TA, const double& RH, const double& HS, const double& RSWR, double ISWR,
+                                        SunObject& sun, bool &is_night) const
 {
 	//we know that TA and RH are available, otherwise we would not get called
-	const double TA=md(MeteoData::TA), RH=md(MeteoData::RH), HS=md(MeteoData::HS), RSWR=md(MeteoData::RSWR);
-	double ISWR=md(MeteoData::ISWR);
-
 	is_night = false;
 
 	double albedo = .5;
@@ -378,6 +474,38 @@ double AllSkyLWGenerator::getCloudiness(const MeteoData& md, SunObject& sun, boo
 		return IOUtils::nodata; //this should never happen
 }
 
+bool AllSkyLWGenerator::getLastCloudiness(const std::string& station_hash, std::pair<double, double>& last)
+{
+	ScopedLock lock(mutex);
+	const map< string, pair<double, double> >::const_iterator it = last_cloudiness.find(station_hash);
+	if (it==last_cloudiness.end()) return false;
+	last = it->second;
+	return true;
+}
+
+void AllSkyLWGenerator::setLastCloudiness(const std::string& station_hash, const std::pair<double, double>& last)
+{
+	ScopedLock lock(mutex);
+	last_cloudiness[station_hash] = last;
+}
+
+//run the ILWR parametrization
+double AllSkyLWGenerator::getILWR(const double& TA, const double& RH, const double& cloudiness, const Date& date) const
+{
+	if (model==OMSTEDT)
+		return Atmosphere::Omstedt_ilwr(RH, TA, cloudiness);
+	else if (model==KONZELMANN)
+		return Atmosphere::Konzelmann_ilwr(RH, TA, cloudiness);
+	else if (model==UNSWORTH)
+		return Atmosphere::Unsworth_ilwr(RH, TA, IOUtils::nodata, IOUtils::nodata, cloudiness);
+	else if (model==CRAWFORD) {
+		int year, month, day;
+		date.getDate(year, month, day);
+		return Atmosphere::Crawford_ilwr(RH, TA, IOUtils::nodata, IOUtils::nodata, static_cast<unsigned char>(month), cloudiness);
+	}
+	return IOUtils::nodata; //this should never happen
+}
+
 bool AllSkyLWGenerator::generate(const size_t& param, MeteoData& md)
 {
 	double &value = md(param);
@@ -397,55 +525,105 @@ bool AllSkyLWGenerator::generate(const size_t& param, MeteoData& md)
 			const double alt = md.meta.position.getAltitude();
 			SunObject sun;
 			sun.setLatLon(lat, lon, alt);
-			sun.setDate(julian_gmt, 0.);
+			{
+				ScopedLock lock(mutex);
+				sun.setDate(julian_gmt, 0., ephemeris);
+			}
 
 			bool is_night;
-			cloudiness = getCloudiness(md, sun, is_night);
+			cloudiness = getCloudiness(TA, RH, md(MeteoData::HS), md(MeteoData::RSWR), md(MeteoData::ISWR), sun, is_night);
 			if (cloudiness==IOUtils::nodata && !is_night) return false;
 
 			if (is_night) { //interpolate the cloudiness over the night
-				const map< string, pair<double, double> >::const_iterator it = last_cloudiness.find(station_hash);
-				if (it==last_cloudiness.end()) return false;
+				pair<double, double> last; //as <julian_gmt, cloudiness>
+				if (!getLastCloudiness(station_hash, last)) return false;
 
 				cloudiness_from_cache = true;
-				const double last_cloudiness_julian = it->second.first;
-				const double last_cloudiness_value = it->second.second;
-				if ((julian_gmt - last_cloudiness_julian) < 1.) cloudiness = last_cloudiness_value;
+				if ((julian_gmt - last.first) < 1.) cloudiness = last.second;
 				else return false;
 			}
 		}
 
-		//run the ILWR parametrization
-		if (model==OMSTEDT)
-			value = Atmosphere::Omstedt_ilwr(RH, TA, cloudiness);
-		else if (model==KONZELMANN)
-			value = Atmosphere::Konzelmann_ilwr(RH, TA, cloudiness);
-		else if (model==UNSWORTH)
-			value = Atmosphere::Unsworth_ilwr(RH, TA, IOUtils::nodata, IOUtils::nodata, cloudiness);
-		else if (model==CRAWFORD) {
-			int year, month, day;
-			md.date.getDate(year, month, day);
-			value = Atmosphere::Crawford_ilwr(RH, TA, IOUtils::nodata, IOUtils::nodata, static_cast<unsigned char>(month), cloudiness);
-		}
+		value = getILWR(TA, RH, cloudiness, md.date);
 
 		//save the last valid cloudiness
 		if (!cloudiness_from_cache)
-			last_cloudiness[station_hash] = pair<double,double>( julian_gmt, cloudiness );
+			setLastCloudiness(station_hash, pair<double,double>( julian_gmt, cloudiness ));
 	}
 
 	return true; //all missing values could be filled
 }
 
 bool AllSkyLWGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
+{
+	return generate_by_column(param, vecMeteo);
+}
+
+bool AllSkyLWGenerator::generate_column(const size_t& /*param*/, const std::vector<MeteoData>& vecMeteo,
+                                        const std::vector<double>& julian, std::vector<double>& values)
 {
 	if(vecMeteo.empty()) return true;
 
+	std::vector<double> TA, RH, HS, RSWR, ISWR, TAU_CLD;
+	get_column(MeteoData::TA, vecMeteo, TA);
+	get_column(MeteoData::RH, vecMeteo, RH);
+	get_column(MeteoData::HS, vecMeteo, HS);
+	get_column(MeteoData::RSWR, vecMeteo, RSWR);
+	get_column(MeteoData::ISWR, vecMeteo, ISWR);
+	const bool has_tau_cld = get_column("TAU_CLD", vecMeteo, TAU_CLD);
+
+	const StationData& meta = vecMeteo.front().meta; //if the stations move, this has to be in the loop
+	const string station_hash = meta.stationID + ":" + meta.stationName;
+	SunObject sun;
+	sun.setLatLon(meta.position.getLat(), meta.position.getLon(), meta.position.getAltitude());
+	std::vector<SunEphemeris::DateTerms> date_terms;
+	{
+		ScopedLock lock(mutex);
+		ephemeris.getDateTerms(julian, date_terms);
+	}
+
+	//the last valid cloudiness is only shared with the other calls at the end
+	pair<double, double> last; //as <julian_gmt, cloudiness>
+	bool has_last = getLastCloudiness(station_hash, last), last_changed = false;
+
 	bool all_filled = true;
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		const bool status = generate(param, vecMeteo[ii]);
-		if(status==false) all_filled=false;
+	for(size_t ii=0; ii<values.size(); ii++) {
+		if (values[ii]!=IOUtils::nodata) continue;
+		if (TA[ii]==IOUtils::nodata || RH[ii]==IOUtils::nodata) {
+			all_filled=false;
+			continue;
+		}
+		double cloudiness = (has_tau_cld)? Atmosphere::Kasten_cloudiness( TAU_CLD[ii] ) : IOUtils::nodata;
+		bool cloudiness_from_cache = false;
+
+		//try to get a cloudiness value
+		if (cloudiness==IOUtils::nodata) {
+			sun.setDate(date_terms[ii]);
+			bool is_night;
+			cloudiness = getCloudiness(TA[ii], RH[ii], HS[ii], RSWR[ii], ISWR[ii], sun, is_night);
+
+			//interpolate the cloudiness over the night
+			if ((cloudiness==IOUtils::nodata && !is_night) || (is_night && (!has_last || (julian[ii] - last.first) >= 1.))) {
+				all_filled=false;
+				continue;
+			}
+			if (is_night) {
+				cloudiness_from_cache = true;
+				cloudiness = last.second;
+			}
+		}
+
+		values[ii] = getILWR(TA[ii], RH[ii], cloudiness, vecMeteo[ii].date);
+
+		//save the last valid cloudiness
+		if (!cloudiness_from_cache) {
+			last = pair<double,double>( julian[ii], cloudiness );
+			has_last = true;
+			last_changed = true;
+		}
 	}
 
+	if (last_changed) setLastCloudiness(station_hash, last);
 	return all_filled;
 }
 
@@ -465,53 +643,31 @@ bool PotRadGenerator::generate(const size_t& param, MeteoData& md)
 {
 	double &value = md(param);
 	if(value == IOUtils::nodata) {
-		const double ISWR=md(MeteoData::ISWR), RSWR=md(MeteoData::RSWR), HS=md(MeteoData::HS);
-		double TA=md(MeteoData::TA), RH=md(MeteoData::RH), ILWR=md(MeteoData::ILWR);
-
 		const double lat = md.meta.position.getLat();
 		const double lon = md.meta.position.getLon();
 		const double alt = md.meta.position.getAltitude();
 		if(lat==IOUtils::nodata || lon==IOUtils::nodata || alt==IOUtils::nodata) return false;
 
-		double albedo = .5;
-		if(RSWR==IOUtils::nodata || ISWR==IOUtils::nodata) {
-			if(HS!=IOUtils::nodata) //no big deal if we can not adapt the albedo
-				albedo = (HS>=snow_thresh)? snow_albedo : soil_albedo;
-		} else if(ISWR>0. && RSWR>0.) { //this could happen if the user calls this generator for a copy parameter, etc
-			albedo = RSWR / ISWR;
-			if(albedo>=1.) albedo=0.99;
-			if(albedo<=0.) albedo=0.01;
-		}
-
-		if(TA==IOUtils::nodata || RH==IOUtils::nodata) {
-			//set TA & RH so the reduced precipitable water will get an average value
-			TA=274.98;
-			RH=0.666;
-			ILWR=IOUtils::nodata; //skip solarIndex correction
-		}
-
+		SunObject sun;
 		sun.setLatLon(lat, lon, alt);
-		sun.setDate(md.date.getJulian(true), 0.);
-		const double solarIndex = (ILWR!=IOUtils::nodata)? getSolarIndex(TA, RH, ILWR) : 1.;
-
-		const double P=md(MeteoData::P);
-		if(P==IOUtils::nodata)
-			sun.calculateRadiation(TA, RH, albedo);
-		else
-			sun.calculateRadiation(TA, RH, P, albedo);
-
-		double toa, direct, diffuse;
-		sun.getHorizontalRadiation(toa, direct, diffuse);
-		if(param!=MeteoData::RSWR)
-			value = (direct+diffuse)*solarIndex; //ISWR
-		else
-			value = (direct+diffuse)*albedo*solarIndex; //RSWR
+		{
+			ScopedLock lock(mutex);
+			sun.setDate(md.date.getJulian(true), 0., ephemeris);
+		}
+		value = getRadiation(param, sun, md(MeteoData::ISWR), md(MeteoData::RSWR), md(MeteoData::HS),
+		                     md(MeteoData::TA), md(MeteoData::RH), md(MeteoData::ILWR), md(MeteoData::P));
 	}
 
 	return true; //all missing values could be filled
 }
 
 bool PotRadGenerator::generate(const size_t& param, std::vector<MeteoData>& vecMeteo)
+{
+	return generate_by_column(param, vecMeteo);
+}
+
+bool PotRadGenerator::generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+                                      const std::vector<double>& julian, std::vector<double>& values)
 {
 	if(vecMeteo.empty()) return true;
 
@@ -519,54 +675,69 @@ bool PotRadGenerator::generate(const size_t& param, std::vector<MeteoData>& vecM
 	const double lon = vecMeteo.front().meta.position.getLon();
 	const double alt = vecMeteo.front().meta.position.getAltitude();
 	if(lat==IOUtils::nodata || lon==IOUtils::nodata || alt==IOUtils::nodata) return false;
+	SunObject sun;
 	sun.setLatLon(lat, lon, alt);
+	std::vector<SunEphemeris::DateTerms> date_terms;
+	{
+		ScopedLock lock(mutex);
+		ephemeris.getDateTerms(julian, date_terms);
+	}
 
-	bool all_filled = true;
-	for(size_t ii=0; ii<vecMeteo.size(); ii++) {
-		double &value = vecMeteo[ii](param);
-		if(value == IOUtils::nodata) {
-			const double ISWR=vecMeteo[ii](MeteoData::ISWR), RSWR=vecMeteo[ii](MeteoData::RSWR), HS=vecMeteo[ii](MeteoData::HS);
-			double TA=vecMeteo[ii](MeteoData::TA), RH=vecMeteo[ii](MeteoData::RH), ILWR=vecMeteo[ii](MeteoData::ILWR);
-
-			double albedo = .5;
-			if(RSWR==IOUtils::nodata || ISWR==IOUtils::nodata) {
-				if(HS!=IOUtils::nodata) //no big deal if we can not adapt the albedo
-					albedo = (HS>=snow_thresh)? snow_albedo : soil_albedo;
-			} else if(ISWR>0. && RSWR>0.) { //this could happen if the user calls this generator for a copy parameter, etc
-				albedo = RSWR / ISWR;
-				if(albedo>=1.) albedo=0.99;
-				if(albedo<=0.) albedo=0.01;
-			}
+	std::vector<double> ISWR, RSWR, HS, TA, RH, ILWR, P;
+	get_column(MeteoData::ISWR, vecMeteo, ISWR);
+	get_column(MeteoData::RSWR, vecMeteo, RSWR);
+	get_column(MeteoData::HS, vecMeteo, HS);
+	get_column(MeteoData::TA, vecMeteo, TA);
+	get_column(MeteoData::RH, vecMeteo, RH);
+	get_column(MeteoData::ILWR, vecMeteo, ILWR);
+	get_column(MeteoData::P, vecMeteo, P);
+
+	for(size_t ii=0; ii<values.size(); ii++) {
+		if(values[ii] != IOUtils::nodata) continue;
+		sun.setDate(date_terms[ii]);
+		values[ii] = getRadiation(param, sun, ISWR[ii], RSWR[ii], HS[ii], TA[ii], RH[ii], ILWR[ii], P[ii]);
+	}
 
-			if(TA==IOUtils::nodata || RH==IOUtils::nodata) {
-				//set TA & RH so the reduced precipitable water will get an average value
-				TA=274.98;
-				RH=0.666;
-				ILWR=IOUtils::nodata; //skip solarIndex correction
-			}
+	return true; //all missing values could be filled
+}
 
-			sun.setDate(vecMeteo[ii].date.getJulian(true), 0.);
-			const double solarIndex = (ILWR!=IOUtils::nodata)? getSolarIndex(TA, RH, ILWR) : 1.;
-
-			const double P=vecMeteo[ii](MeteoData::P);
-			if(P==IOUtils::nodata)
-				sun.calculateRadiation(TA, RH, albedo);
-			else
-				sun.calculateRadiation(TA, RH, P, albedo);
-
-			double toa, direct, diffuse;
-			sun.getHorizontalRadiation(toa, direct, diffuse);
-			if(param!=MeteoData::RSWR)
-				value = (direct+diffuse)*solarIndex; //ISWR
-			else
-				value = (direct+diffuse)*albedo*solarIndex; //RSWR
-		}
+//radiation for a sun object that has already been set to the right location and date
+double PotRadGenerator::getRadiation(const size_t& param, SunObject& sun, const double& ISWR, const double& RSWR, const double& HS,
+                                     double TA, double RH, double ILWR, const double& P) const
+{
+	double albedo = .5;
+	if(RSWR==IOUtils::nodata || ISWR==IOUtils::nodata) {
+		if(HS!=IOUtils::nodata) //no big deal if we can not adapt the albedo
+			albedo = (HS>=snow_thresh)? snow_albedo : soil_albedo;
+	} else if(ISWR>0. && RSWR>0.) { //this could happen if the user calls this generator for a copy parameter, etc
+		albedo = RSWR / ISWR;
+		if(albedo>=1.) albedo=0.99;
+		if(albedo<=0.) albedo=0.01;
 	}
 
-	return all_filled;
+	if(TA==IOUtils::nodata || RH==IOUtils::nodata) {
+		//set TA & RH so the reduced precipitable water will get an average value
+		TA=274.98;
+		RH=0.666;
+		ILWR=IOUtils::nodata; //skip solarIndex correction
+	}
+
+	const double solarIndex = (ILWR!=IOUtils::nodata)? getSolarIndex(TA, RH, ILWR) : 1.;
+
+	if(P==IOUtils::nodata)
+		sun.calculateRadiation(TA, RH, albedo);
+	else
+		sun.calculateRadiation(TA, RH, P, albedo);
+
+	double toa, direct, diffuse;
+	sun.getHorizontalRadiation(toa, direct, diffuse);
+	if(param!=MeteoData::RSWR)
+		return (direct+diffuse)*solarIndex; //ISWR
+	else
+		return (direct+diffuse)*albedo*solarIndex; //RSWR
 }
 
-double PotRadGenerator::getSolarIndex(const double& ta, const double& rh, const double& ilwr)
+double PotRadGenerator::getSolarIndex(const double& ta, const double& rh, const double& ilwr) const
 {// this is based on Kartsen cloudiness, Dilley clear sky emissivity and Unsworth ILWR
 //this means that this solar index is the ratio of iswr for clear sky on a horizontal
 //surface and the measured iswr
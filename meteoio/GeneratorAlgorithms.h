@@ -20,6 +20,7 @@
 
 #include <meteoio/MeteoData.h>
 #include <meteoio/meteolaws/Sun.h>
+#include <meteoio/Mutex.h>
 
 #include <vector>
 #include <set>
@@ -107,6 +108,13 @@ namespace mio {
  * a totally different approach: either generic data (constant value, etc) or generate the data from other
  * meteorological parameters (relying on a parametrization, like clear sky for ILWR).
  *
+ * A time series can be generated in two ways: either on a vector of MeteoData or on a column of values that is
+ * modified in place (this is how the DataGenerator calls the generators, so the values are only gathered and scattered
+ * once per station and parameter whatever the number of generators). Every generator must implement the MeteoData
+ * call, the generators that also implement generate_column() return true in has_column() and their MeteoData call
+ * simply calls generate_by_column(). The DataGenerator only calls generate_column() on these. The time series generators
+ * might be called in parallel for different stations, so they must protect any state that they share between the stations.
+ *
  * @ingroup meteolaws
  * @author Mathias Bavay
  * @date   2013-03-20
@@ -120,9 +128,29 @@ class GeneratorAlgorithm {
 		virtual bool generate(const size_t& param, MeteoData& md) = 0;
 		//fill one time series of MeteoData for one station
 		virtual bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo) = 0;
+		//does the generator implement generate_column()?
+		virtual bool has_column() const {return false;}
+
+		/**
+		 * @brief fill one time series for one station, given as a column of values
+		 * @param param index of the parameter to generate
+		 * @param vecMeteo time series of the station, providing the other parameters (its own param values are not used)
+		 * @param julian dates of the time series (GMT julian dates)
+		 * @param values values of the parameter to generate, modified in place
+		 * @return true if all missing values could be filled
+		 * The default implementation throws an exception, so it must be implemented by the generators
+		 * that return true in has_column().
+		 */
+		virtual bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                             const std::vector<double>& julian, std::vector<double>& values);
 		std::string getAlgo() const;
+
+		static void get_column(const size_t& param, const std::vector<MeteoData>& vecMeteo, std::vector<double>& values);
+		static bool get_column(const std::string& parname, const std::vector<MeteoData>& vecMeteo, std::vector<double>& values);
+		static void get_julian(const std::vector<MeteoData>& vecMeteo, std::vector<double>& julian);
  	protected:
 		virtual void parse_args(const std::vector<std::string>& i_vecArgs);
+		bool generate_by_column(const size_t& param, std::vector<MeteoData>& vecMeteo);
 		const std::string algo;
 };
 
@@ -146,6 +174,9 @@ class ConstGenerator : public GeneratorAlgorithm {
 			: GeneratorAlgorithm(vecArgs, i_algo), constant(IOUtils::nodata) { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 	private:
 		void parse_args(const std::vector<std::string>& vecArgs);
 		double constant;
@@ -170,8 +201,12 @@ class SinGenerator : public GeneratorAlgorithm {
 			: GeneratorAlgorithm(vecArgs, i_algo), amplitude(IOUtils::nodata), offset(IOUtils::nodata), phase(IOUtils::nodata), type(' ') { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 	private:
 		void parse_args(const std::vector<std::string>& vecArgs);
+		double getValue(const Date& date) const;
 		double amplitude, offset, phase;
 		char type;
 };
@@ -190,6 +225,9 @@ class StandardPressureGenerator : public GeneratorAlgorithm {
 			: GeneratorAlgorithm(vecArgs, i_algo) { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 };
 
 /**
@@ -207,6 +245,9 @@ class RhGenerator : public GeneratorAlgorithm {
 			: GeneratorAlgorithm(vecArgs, i_algo) { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 };
 
 
@@ -239,8 +280,12 @@ class ClearSkyLWGenerator : public GeneratorAlgorithm {
 			: GeneratorAlgorithm(vecArgs, i_algo), model(BRUTSAERT) { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 	private:
 		void parse_args(const std::vector<std::string>& vecArgs);
+		double getILWR(const double& RH, const double& TA) const;
 		typedef enum PARAMETRIZATION {
 			BRUTSAERT,
 			DILLEY,
@@ -287,12 +332,19 @@ class AllSkyLWGenerator : public GeneratorAlgorithm {
 	public:
 		AllSkyLWGenerator(const std::vector<std::string>& vecArgs, const std::string& i_algo)
 		               : GeneratorAlgorithm(vecArgs, i_algo), model(OMSTEDT), clf_model(KASTEN),
-		                 last_cloudiness() { parse_args(vecArgs); }
+		                 last_cloudiness(), ephemeris(), mutex() { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 	private:
 		void parse_args(const std::vector<std::string>& vecArgs);
-		double getCloudiness(const MeteoData& md, SunObject& sun, bool &is_night);
+		double getCloudiness(const double& TA, const double& RH, const double& HS, const double& RSWR, double ISWR,
+		                     SunObject& sun, bool &is_night) const;
+		bool getLastCloudiness(const std::string& station_hash, std::pair<double, double>& last);
+		void setLastCloudiness(const std::string& station_hash, const std::pair<double, double>& last);
+		double getILWR(const double& TA, const double& RH, const double& cloudiness, const Date& date) const;
 
 		typedef enum PARAMETRIZATION {
 			OMSTEDT,
@@ -309,6 +361,8 @@ class AllSkyLWGenerator : public GeneratorAlgorithm {
 		clf_parametrization clf_model;
 
 		std::map< std::string, std::pair<double, double> > last_cloudiness; //as < station_hash, <julian_gmt, cloudiness> >
+		SunEphemeris ephemeris; //shared by all the stations
+		Mutex mutex; ///< protects last_cloudiness and ephemeris when the stations are processed in parallel
 
 		static const double soil_albedo, snow_albedo, snow_thresh; //to try using rswr if not iswr is given
 };
@@ -330,13 +384,19 @@ class AllSkyLWGenerator : public GeneratorAlgorithm {
 class PotRadGenerator : public GeneratorAlgorithm {
 	public:
 		PotRadGenerator(const std::vector<std::string>& vecArgs, const std::string& i_algo)
-			: GeneratorAlgorithm(vecArgs, i_algo), sun() { parse_args(vecArgs); }
+			: GeneratorAlgorithm(vecArgs, i_algo), ephemeris(), mutex() { parse_args(vecArgs); }
 		bool generate(const size_t& param, MeteoData& md);
 		bool generate(const size_t& param, std::vector<MeteoData>& vecMeteo);
+		bool generate_column(const size_t& param, const std::vector<MeteoData>& vecMeteo,
+		                     const std::vector<double>& julian, std::vector<double>& values);
+		bool has_column() const {return true;}
 	private:
 		void parse_args(const std::vector<std::string>& vecArgs);
-		double getSolarIndex(const double& ta, const double& rh, const double& ilwr);
-		SunObject sun;
+		double getSolarIndex(const double& ta, const double& rh, const double& ilwr) const;
+		double getRadiation(const size_t& param, SunObject& sun, const double& ISWR, const double& RSWR, const double& HS,
+		                    double TA, double RH, double ILWR, const double& P) const;
+		SunEphemeris ephemeris; //shared by all the stations
+		Mutex mutex; ///< protects ephemeris when the stations are processed in parallel
 
 		static const double soil_albedo, snow_albedo, snow_thresh; //to try using rswr if not iswr is given
 };
@@ -290,15 +290,16 @@ void Color::HSVtoRGB(const double& h, const double& s, const double& v, double &
 const unsigned char Gradient::channel_max_color = 255;
 const unsigned char Gradient::reserved_idx = 5;
 const unsigned char Gradient::reserved_cols = 2;
+const size_t Gradient::lut_size = 4096;
 
 Gradient::Gradient(const Type& i_type, const double& i_min, const double& i_max, const bool& i_autoscale)
-          : min(i_min), max(i_max), delta(i_max - i_min), type(none), model(NULL), nr_unique_cols(0), autoscale(i_autoscale)
+          : min(i_min), max(i_max), delta(i_max - i_min), type(none), model(NULL), lut(), nr_unique_cols(0), autoscale(i_autoscale)
 {
 	setModel(i_type);
 }
 
 Gradient::Gradient(const Gradient& c)
-          : min(c.min), max(c.max), delta(c.delta), type(c.type), model(NULL), nr_unique_cols(c.nr_unique_cols), autoscale(c.autoscale)
+          : min(c.min), max(c.max), delta(c.delta), type(c.type), model(NULL), lut(), nr_unique_cols(c.nr_unique_cols), autoscale(c.autoscale)
 {
 	setModel(type);
 }
@@ -330,6 +331,9 @@ void Gradient::set(const Type& i_type, const double& i_min, const double& i_max,
 
 void Gradient::setModel(const Type& i_type)
 {
+	delete model;
+	model = NULL;
+
 	if(i_type==terrain) model = new gr_terrain(min, max, autoscale);
 	else if(i_type==slope) model = new gr_slope(min, max, autoscale);
 	else if(i_type==azi) model = new gr_azi(min, max, autoscale);
@@ -342,6 +346,25 @@ void Gradient::setModel(const Type& i_type)
 	else if(i_type==blue_pink) model = new gr_blue_pink(min, max, autoscale);
 	else if(i_type==pastel) model = new gr_pastel(min, max, autoscale);
 	else if(i_type==bg_isomorphic) model = new gr_bg_isomorphic(min, max, autoscale);
+
+	setLUT();
+}
+
+//the models are costly to evaluate, so we sample them once for all (they only depend on min, max and autoscale)
+void Gradient::setLUT()
+{
+	lut.clear();
+	if(model==NULL) return;
+
+	lut.resize(3*lut_size);
+	for(size_t ii=0; ii<lut_size; ii++) {
+		const double val_norm = static_cast<double>(ii) / static_cast<double>(lut_size-1);
+		double r_d, g_d, b_d;
+		model->getColor(val_norm, r_d, g_d, b_d);
+		lut[3*ii] = static_cast<unsigned char>(r_d*channel_max_color);
+		lut[3*ii+1] = static_cast<unsigned char>(g_d*channel_max_color);
+		lut[3*ii+2] = static_cast<unsigned char>(b_d*channel_max_color);
+	}
 }
 
 void Gradient::setNrOfLevels(const unsigned char& i_nr_unique_levels) {
@@ -394,6 +417,20 @@ void Gradient::getColor(const double& val, unsigned char& r, unsigned char& g, u
 	b = static_cast<unsigned char>(b_d*channel_max_color);
 }
 
+//palette index used for all pixels when the data is constant throughout the grid
+unsigned char Gradient::getConstantIndex() const
+{
+#ifndef NOSAFECHECKS
+	if((nr_unique_cols/2 + reserved_idx) > std::numeric_limits<unsigned char>::max()) {
+		std::ostringstream ss;
+		ss << "[E] Number of unique colors in gradient and/or reserved index too large to fit in index: ";
+		ss << (nr_unique_cols/2 + reserved_idx) << " when it should be at most " << std::numeric_limits<unsigned char>::max();
+		throw IndexOutOfBoundsException(ss.str(), AT);
+	}
+#endif
+	return static_cast<unsigned char>(nr_unique_cols/2 + reserved_idx);
+}
+
 void Gradient::getColor(const double& val, unsigned char& index) const
 {
 	if(model==NULL) {
@@ -413,15 +450,7 @@ void Gradient::getColor(const double& val, unsigned char& index) const
 		return;
 	}
 	if(delta==0) { //otherwise constant data throughout the grid makes a division by zero...
-#ifndef NOSAFECHECKS
-		if((nr_unique_cols/2 + reserved_idx) > std::numeric_limits<unsigned char>::max()) {
-			std::ostringstream ss;
-			ss << "[E] Number of unique colors in gradient and/or reserved index too large to fit in index: ";
-			ss << (nr_unique_cols/2 + reserved_idx) << " when it should be at most " << std::numeric_limits<unsigned char>::max();
-			throw IndexOutOfBoundsException(ss.str(), AT);
-		}
-#endif
-		index = static_cast<unsigned char>(nr_unique_cols/2 + reserved_idx);
+		index = getConstantIndex();
 		return;
 	}
 
@@ -435,6 +464,80 @@ void Gradient::getColor(const double& val, unsigned char& index) const
 	else index = static_cast<unsigned char>( static_cast<unsigned char>((val-min)/delta*(double)nr_unique_cols) + reserved_idx);
 }
 
+void Gradient::getColors(const double *vals, const size_t& nr_vals, unsigned char *rgb, const unsigned char& transparent) const
+{
+	if(model==NULL) {
+		throw UnknownValueException("Please set the color gradient before using it!", AT);
+	}
+
+	const bool constant_autoscale = (autoscale && delta==0); //constant data throughout the grid & autoscale are no friends...
+	const double lut_max = static_cast<double>(lut_size-1);
+	const double scale = (delta!=0.)? lut_max/delta : 0.;
+
+	for(size_t ii=0; ii<nr_vals; ii++) {
+		const double val = vals[ii];
+		unsigned char *px = rgb + 3*ii;
+
+		if(val==IOUtils::nodata) {
+			px[0] = px[1] = px[2] = transparent;
+			continue;
+		}
+		if(val==legend::bg_color) {
+			px[0] = px[1] = px[2] = static_cast<unsigned char>(channel_max_color-1);
+			continue;
+		}
+		if(val==legend::text_color) {
+			px[0] = px[1] = px[2] = 0;
+			continue;
+		}
+		if(constant_autoscale) {
+			px[0] = px[1] = px[2] = static_cast<unsigned char>(channel_max_color/2);
+			continue;
+		}
+
+		double pos = (val-min)*scale; //position in the lookup table
+		if(autoscale) {
+			if(val<min) pos = 0.;
+			else if(val>max) pos = lut_max;
+		}
+		if(pos>=0. && pos<=lut_max) {
+			const unsigned char *col = &lut[ 3*static_cast<size_t>(pos+.5) ];
+			px[0] = col[0]; px[1] = col[1]; px[2] = col[2];
+		} else { //out of range values might get special colors from the model (sea level, snow line, etc)
+			double r_d, g_d, b_d;
+			model->getColor((val-min)/delta, r_d, g_d, b_d);
+			px[0] = static_cast<unsigned char>(r_d*channel_max_color);
+			px[1] = static_cast<unsigned char>(g_d*channel_max_color);
+			px[2] = static_cast<unsigned char>(b_d*channel_max_color);
+		}
+	}
+}
+
+void Gradient::getColors(const double *vals, const size_t& nr_vals, unsigned char *index) const
+{
+	if(model==NULL) {
+		throw UnknownValueException("Please set the color gradient before using it!", AT);
+	}
+	if(delta!=0 && nr_unique_cols==0) {
+		throw UnknownValueException("Please define the number of colors for indexed gradients!", AT);
+	}
+
+	unsigned char constant_idx = 0;
+	if(delta==0) constant_idx = getConstantIndex();
+
+	for(size_t ii=0; ii<nr_vals; ii++) {
+		const double val = vals[ii];
+		if(val==IOUtils::nodata) index[ii] = 0;
+		else if(val==legend::bg_color) index[ii] = 1;
+		else if(val==legend::text_color) index[ii] = 2;
+		else if(delta==0) index[ii] = constant_idx;
+		//watch out!! the palette contains some reserved values at the begining
+		else if(val<min) index[ii] = reserved_idx-2;
+		else if(val>max) index[ii] = reserved_idx-1;
+		else index[ii] = static_cast<unsigned char>( static_cast<unsigned char>((val-min)/delta*(double)nr_unique_cols) + reserved_idx);
+	}
+}
+
 void Gradient::getPalette(std::vector<unsigned char> &palette, size_t &nr_colors) const
 {
 	if(model==NULL) {
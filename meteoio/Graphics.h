@@ -200,7 +200,7 @@ class Gradient {
 		* @brief Default Constructor.
 		* This should be followed by a call to set() before calling getColor
 		*/
-		Gradient() : min(0.), max(0.), delta(0.), type(none), model(NULL), nr_unique_cols(0), autoscale(true) { };
+		Gradient() : min(0.), max(0.), delta(0.), type(none), model(NULL), lut(), nr_unique_cols(0), autoscale(true) { };
 
 		/**
 		* @brief Constructor.
@@ -258,6 +258,26 @@ class Gradient {
 		*/
 		void getColor(const double& val, unsigned char& index) const;
 
+		/**
+		* @brief Get RGB values for an array of numeric values
+		* This gives the same colors as getColor(val, r, g, b, a) (within the resolution of the lookup table, see lut_size)
+		* but the gradient is only evaluated when the gradient is set, so this should be used when converting whole grids.
+		* @param vals numerical values to convert
+		* @param nr_vals number of values to convert
+		* @param rgb interlaced red, green and blue values (between 0 and 255), it must be able to contain 3*nr_vals values
+		* @param transparent value to use for all three channels of the transparent pixels
+		*/
+		void getColors(const double *vals, const size_t& nr_vals, unsigned char *rgb, const unsigned char& transparent) const;
+
+		/**
+		* @brief Get palette index values for an array of numeric values
+		* This gives the same indexes as getColor(val, index) but is faster when converting whole grids.
+		* @param vals numerical values to convert
+		* @param nr_vals number of values to convert
+		* @param index palette indexes, it must be able to contain nr_vals values
+		*/
+		void getColors(const double *vals, const size_t& nr_vals, unsigned char *index) const;
+
 		/**
 		* @brief Get palette colors for the selected gradient
 		* When building an indexed image, one needs to first retrieve the palette using this method. Afterwards, getColor(val, index)
@@ -270,12 +290,16 @@ class Gradient {
 		Gradient& operator=(const Gradient& source);
 
 		static const unsigned char channel_max_color; ///< nr of colors per channel of the generated gradients
+		static const size_t lut_size; ///< nr of entries of the color lookup table used by getColors
 	private:
 		void setModel(const Type& i_type);
+		void setLUT();
+		unsigned char getConstantIndex() const;
 
 		double min, max, delta;
 		Type type;
 		Gradient_model *model;
+		std::vector<unsigned char> lut; ///< interlaced rgb colors for normalized values regularly spaced between 0 and 1
 		unsigned char nr_unique_cols; ///< number of unique colors to generate for indexed images
 		static const unsigned char reserved_idx; ///< for indexed gradients, number of reserved indexes
 		static const unsigned char reserved_cols; ///< for non-indexed gradients, number of reserved colors
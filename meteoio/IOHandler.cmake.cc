@@ -17,6 +17,7 @@
 */
 
 #include <meteoio/IOHandler.h>
+#include <meteoio/Profiler.h>
 
 #cmakedefine PLUGIN_ARCIO
 #cmakedefine PLUGIN_A3DIO
@@ -34,6 +35,7 @@
 #cmakedefine PLUGIN_GSNIO
 #cmakedefine PLUGIN_NETCDFIO
 #cmakedefine PLUGIN_PSQLIO
+#cmakedefine PLUGIN_TILEDIO
 
 #include <meteoio/plugins/ARCIO.h>
 #include <meteoio/plugins/A3DIO.h>
@@ -76,6 +78,10 @@
 #include <meteoio/plugins/PSQLIO.h>
 #endif
 
+#ifdef PLUGIN_TILEDIO
+#include <meteoio/plugins/TiledIO.h>
+#endif
+
 using namespace std;
 
 namespace mio {
@@ -120,6 +126,7 @@ namespace mio {
  * <tr><td>\subpage psqlio "PSQL"</td><td>meteo</td><td>connects to PostgreSQL database</td><td><A HREF="http://www.postgresql.org/">PostgreSQL</A>'s libpq</td></tr>
  * <tr><td>\subpage smetio "SMET"</td><td>meteo, poi</td><td>SMET data files</td><td></td></tr>
  * <tr><td>\subpage snowpack "SNOWPACK"</td><td>meteo</td><td>original SNOWPACK meteo files</td><td></td></tr>
+ * <tr><td>\subpage tiled "TILED"</td><td>dem, landuse, grid2d</td><td>binary tiled grid files, parts of a grid can be read</td><td><A HREF="http://www.zlib.net/">zlib</A></td></tr>
  * </table></center>
  *
  * @section data_generators Data generators
@@ -184,12 +191,15 @@ void IOHandler::registerPlugins()
 #ifdef PLUGIN_PSQLIO
 	mapPlugins["PSQL"]      = IOPlugin("PSQLIO", NULL, &IOPlugin::createInstance<PSQLIO>);
 #endif
+#ifdef PLUGIN_TILEDIO
+	mapPlugins["TILED"]     = IOPlugin("TiledIO", NULL, &IOPlugin::createInstance<TiledIO>);
+#endif
 }
 
 //Copy constructor
 #ifdef _POPC_
 IOHandler::IOHandler(const IOHandler& aio)
-           : cfg(aio.cfg), mapPlugins(), copy_parameter(aio.copy_parameter), copy_name(aio.copy_name), enable_copying(aio.enable_copying)
+           : cfg(aio.cfg), mapPlugins(), copy_parameter(aio.copy_parameter), copy_name(aio.copy_name), mutex(), enable_copying(aio.enable_copying)
 {
 	//We might be on a different machine, even with different architecture -> rebuild plugins map
 	registerPlugins();
@@ -197,7 +207,7 @@ IOHandler::IOHandler(const IOHandler& aio)
 #else
 IOHandler::IOHandler(const IOHandler& aio)
            : IOInterface(), cfg(aio.cfg), mapPlugins(aio.mapPlugins), copy_parameter(aio.copy_parameter),
-             copy_name(aio.copy_name), enable_copying(aio.enable_copying)
+             copy_name(aio.copy_name), mutex(), enable_copying(aio.enable_copying)
 {
 
 }
@@ -205,10 +215,10 @@ IOHandler::IOHandler(const IOHandler& aio)
 
 #ifdef _POPC_
 IOHandler::IOHandler(const Config& cfgreader)
-           : cfg(cfgreader), mapPlugins(), copy_parameter(), copy_name(), enable_copying(false)
+           : cfg(cfgreader), mapPlugins(), copy_parameter(), copy_name(), mutex(), enable_copying(false)
 #else
 IOHandler::IOHandler(const Config& cfgreader)
-           : IOInterface(), cfg(cfgreader), mapPlugins(), copy_parameter(), copy_name(), enable_copying(false)
+           : IOInterface(), cfg(cfgreader), mapPlugins(), copy_parameter(), copy_name(), mutex(), enable_copying(false)
 #endif
 {
 	registerPlugins();
@@ -232,7 +242,8 @@ IOHandler::~IOHandler() throw(){
 }
 
 IOHandler& IOHandler::operator=(const IOHandler& source) {
-	if(this != &source) {
+	if(this != &source) { //the mutex is not copied, it protects this object
+		ScopedLock lock(mutex);
 		mapPlugins = source.mapPlugins;
 		copy_parameter = source.copy_parameter;
 		copy_name = source.copy_name;
@@ -263,32 +274,42 @@ IOInterface* IOHandler::getPlugin(const std::string& cfgkey, const std::string&
 
 void IOHandler::read2DGrid(Grid2DObject& grid_out, const std::string& i_filename)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("GRID2D", "Input");
+	MIO_PROFILE("plugin::read2DGrid");
 	plugin->read2DGrid(grid_out, i_filename);
 }
 
 void IOHandler::read2DGrid(Grid2DObject& grid_out, const MeteoGrids::Parameters& parameter, const Date& date)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("GRID2D", "Input");
+	MIO_PROFILE("plugin::read2DGrid");
 	plugin->read2DGrid(grid_out, parameter, date);
 }
 
 void IOHandler::readDEM(DEMObject& dem_out)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("DEM", "Input");
+	MIO_PROFILE("plugin::readDEM");
 	plugin->readDEM(dem_out);
 	dem_out.update();
 }
 
 void IOHandler::readLanduse(Grid2DObject& landuse_out)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("LANDUSE", "Input");
+	MIO_PROFILE("plugin::readLanduse");
 	plugin->readLanduse(landuse_out);
 }
 
 void IOHandler::readStationData(const Date& date, STATIONS_SET& vecStation)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("METEO", "Input");
+	MIO_PROFILE("plugin::readStationData");
 	plugin->readStationData(date, vecStation);
 }
 
@@ -328,7 +349,9 @@ void IOHandler::readMeteoData(const Date& dateStart, const Date& dateEnd,
                               std::vector<METEO_SET>& vecMeteo,
                               const size_t& stationindex)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("METEO", "Input");
+	MIO_PROFILE("plugin::readMeteoData");
 	plugin->readMeteoData(dateStart, dateEnd, vecMeteo, stationindex);
 	checkTimestamps(vecMeteo);
 
@@ -342,30 +365,54 @@ void IOHandler::writeMeteoData(const std::vector<METEO_SET>& vecMeteo,
                                const std::string& name)
 #endif
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("METEO", "Output");
+	MIO_PROFILE("plugin::writeMeteoData");
 	plugin->writeMeteoData(vecMeteo, name);
 }
 
+#ifdef _POPC_
+void IOHandler::appendMeteoData(std::vector<METEO_SET>& vecMeteo,
+                                const std::string& name)
+#else
+void IOHandler::appendMeteoData(const std::vector<METEO_SET>& vecMeteo,
+                                const std::string& name)
+#endif
+{
+	ScopedLock lock(mutex);
+	IOInterface *plugin = getPlugin("METEO", "Output");
+	MIO_PROFILE("plugin::appendMeteoData");
+	plugin->appendMeteoData(vecMeteo, name);
+}
+
 void IOHandler::readAssimilationData(const Date& date_in, Grid2DObject& da_out)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("DA", "Input");
+	MIO_PROFILE("plugin::readAssimilationData");
 	plugin->readAssimilationData(date_in, da_out);
 }
 
 void IOHandler::readPOI(std::vector<Coords>& pts) {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("POI", "Input");
+	MIO_PROFILE("plugin::readPOI");
 	plugin->readPOI(pts);
 }
 
 void IOHandler::write2DGrid(const Grid2DObject& grid_in, const std::string& name)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("GRID2D", "Output");
+	MIO_PROFILE("plugin::write2DGrid");
 	plugin->write2DGrid(grid_in, name);
 }
 
 void IOHandler::write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date)
 {
+	ScopedLock lock(mutex);
 	IOInterface *plugin = getPlugin("GRID2D", "Output");
+	MIO_PROFILE("plugin::write2DGrid");
 	plugin->write2DGrid(grid_in, parameter, date);
 }
 
@@ -443,6 +490,7 @@ const std::string IOHandler::toString()
 const std::string IOHandler::toString() const
 #endif
 {
+	ScopedLock lock(mutex);
 	std::ostringstream os;
 	os << "<IOHandler>\n";
 	os << "Config& cfg = " << hex << &cfg << dec << "\n";
@@ -21,6 +21,7 @@
 #include <meteoio/IOInterface.h>
 #include <meteoio/IOExceptions.h>
 #include <meteoio/IOPlugin.h>
+#include <meteoio/Mutex.h>
 
 #include <map>
 #include <string>
@@ -32,6 +33,7 @@ namespace mio {
 * @class IOHandler
 * @brief This class is the class to use for raw I/O operations. It is responsible for transparently loading the plugins
 * and it follows the interface defined by the IOInterface class with the addition of a few convenience methods.
+* Its methods can be called from several threads, the plugins then being called one at a time.
 */
 #ifdef _POPC_
 class IOHandler {
@@ -59,9 +61,13 @@ class IOHandler : public IOInterface {
 	#ifdef _POPC_
 		virtual void writeMeteoData(std::vector<METEO_SET>& vecMeteo,
 		                            const std::string& name="");
+		virtual void appendMeteoData(std::vector<METEO_SET>& vecMeteo,
+		                             const std::string& name="");
 	#else
 		virtual void writeMeteoData(const std::vector<METEO_SET>& vecMeteo,
 		                            const std::string& name="");
+		virtual void appendMeteoData(const std::vector<METEO_SET>& vecMeteo,
+		                             const std::string& name="");
 	#endif
 		virtual void readMeteoData(const Date& dateStart, const Date& dateEnd,
 		                           std::vector<METEO_SET>& vecMeteo,
@@ -89,6 +95,7 @@ class IOHandler : public IOInterface {
 		const Config& cfg;
 		std::map<std::string, IOPlugin> mapPlugins;
 		std::vector<std::string> copy_parameter, copy_name;
+		mutable Mutex mutex; ///< the plugins are not thread safe, so they are called one at a time
 		bool enable_copying;
 };
 
@@ -16,9 +16,15 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/IOInterface.h>
+#include <meteoio/IOExceptions.h>
 
 namespace mio {
 
 IOInterface::~IOInterface(){}
 
+void IOInterface::appendMeteoData(const std::vector< std::vector<MeteoData> >& /*vecMeteo*/, const std::string& /*name*/)
+{
+	throw IOException("This output plugin can not append data to its outputs", AT);
+}
+
 } //namespace
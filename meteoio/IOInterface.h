@@ -202,6 +202,19 @@ class IOInterface {
 		virtual void writeMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo,
 		                            const std::string& name="") = 0;
 
+		/**
+		* @brief Append vecMeteo time series to what has previously been written by writeMeteoData
+		* This is used to write long time series block by block (see IOManager::streamMeteoData). The data of each
+		* station must start after the data that has already been written for this station. A station that has not been
+		* written yet is written as by writeMeteoData. Plugins that can not append to their outputs don't have to
+		* implement this call, the default implementation throws an exception.
+		* @param vecMeteo    A vector of vector<MeteoData> objects to be appended
+		* @param name        (optional string) Identifier usefull for the output plugin (it could become part
+		*                    of a file name, a db table, etc)
+		*/
+		virtual void appendMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo,
+		                             const std::string& name="");
+
 		/**
 		* @brief Parse the assimilation data into a Grid2DObject for a certain date represented by the Date object
 		*
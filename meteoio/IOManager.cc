@@ -17,6 +17,18 @@
 */
 
 #include <meteoio/IOManager.h>
+#include <meteoio/Profiler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -25,10 +37,11 @@ namespace mio {
 IOManager::IOManager(const std::string& filename_in) : cfg(filename_in), rawio(cfg), bufferedio(rawio, cfg),
                                             meteoprocessor(cfg), interpolator(cfg), dataGenerator(cfg),
                                             v_params(), v_coords(), v_stations(),
-                                            proc_properties(), virtual_point_cache(), point_cache(), filtered_cache(),
+                                            proc_properties(), virtual_point_cache("virtual points"), point_cache("resampled points"), filtered_cache(),
                                             fcache_start(Date(0.0, 0.)), fcache_end(Date(0.0, 0.)), //this should not matter, since 0 is still way back before any real data...
+                                            filtered_stats("filtered data"),
                                             processing_level(IOManager::filtered | IOManager::resampled | IOManager::generated),
-                                            virtual_stations(false), skip_virtual_stations(false), interpol_use_full_dem(false)
+                                            virtual_stations(false), interpol_use_full_dem(false), profiling_report(false), state_file(), mutex(), processing_mutex()
 {
 	initIOManager();
 }
@@ -36,10 +49,11 @@ IOManager::IOManager(const std::string& filename_in) : cfg(filename_in), rawio(c
 IOManager::IOManager(const Config& i_cfg) : cfg(i_cfg), rawio(cfg), bufferedio(rawio, cfg),
                                             meteoprocessor(cfg), interpolator(cfg), dataGenerator(cfg),
                                             v_params(), v_coords(), v_stations(),
-                                            proc_properties(), virtual_point_cache(), point_cache(), filtered_cache(),
+                                            proc_properties(), virtual_point_cache("virtual points"), point_cache("resampled points"), filtered_cache(),
                                             fcache_start(Date(0.0, 0.)), fcache_end(Date(0.0, 0.)), //this should not matter, since 0 is still way back before any real data...
+                                            filtered_stats("filtered data"),
                                             processing_level(IOManager::filtered | IOManager::resampled | IOManager::generated),
-                                            virtual_stations(false), skip_virtual_stations(false), interpol_use_full_dem(false)
+                                            virtual_stations(false), interpol_use_full_dem(false), profiling_report(false), state_file(), mutex(), processing_mutex()
 {
 	initIOManager();
 }
@@ -52,6 +66,39 @@ void IOManager::initIOManager()
 	if(virtual_stations) {
 		initVirtualStations();
 	}
+	cfg.getValue("PROFILING_REPORT", "General", profiling_report, IOUtils::nothrow);
+
+	double max_memory = 100.; //in MB
+	cfg.getValue("BUFF_POINTS_MEMORY", "General", max_memory, IOUtils::nothrow);
+	if (max_memory<=0.) throw InvalidArgumentException("BUFF_POINTS_MEMORY must be greater than 0", AT);
+	point_cache.setMaxMemory( static_cast<size_t>(max_memory*1024.*1024.) );
+	virtual_point_cache.setMaxMemory( static_cast<size_t>(max_memory*1024.*1024.) );
+
+	cfg.getValue("STATE_FILE", "General", state_file, IOUtils::nothrow);
+	if (!state_file.empty() && IOUtils::fileExists(state_file)) {
+		bool restored = false;
+		try {
+			restored = readState(state_file);
+		} catch(const std::exception& e) { //for example, a corrupted state file
+			std::cerr << "[W] Could not read the state file " << state_file << ": " << e.what() << "\n";
+		}
+		if (!restored)
+			std::cerr << "[W] The state file " << state_file << " does not match the current configuration or input files, the data will be read again\n";
+	}
+}
+
+IOManager::~IOManager()
+{
+	if (!state_file.empty()) {
+		try {
+			writeState(state_file);
+		} catch(const std::exception& e) {
+			std::cerr << "[W] Could not write the state file " << state_file << ": " << e.what() << "\n";
+		}
+	}
+
+	if (profiling_report)
+		std::cout << Profiler::getReport();
 }
 
 void IOManager::initVirtualStations()
@@ -99,6 +146,7 @@ void IOManager::initVirtualStations()
 
 void IOManager::setProcessingLevel(const unsigned int& i_level)
 {
+	ScopedLock lock(processing_mutex);
 	if (i_level >= IOManager::num_of_levels)
 		throw InvalidArgumentException("The processing level is invalid", AT);
 
@@ -110,11 +158,13 @@ void IOManager::setProcessingLevel(const unsigned int& i_level)
 }
 
 void IOManager::setMinBufferRequirements(const double& buffer_size, const double& buff_before) {
+	ScopedLock lock(processing_mutex);
 	bufferedio.setMinBufferRequirements(buffer_size, buff_before);
 }
 
 double IOManager::getAvgSamplingRate() const
 {
+	ScopedLock lock(processing_mutex);
 	if (processing_level == IOManager::raw){
 		return IOUtils::nodata;
 	} else {
@@ -130,6 +180,7 @@ const Config IOManager::getConfig() const
 void IOManager::push_meteo_data(const ProcessingLevel& level, const Date& date_start, const Date& date_end,
                                 const std::vector< METEO_SET >& vecMeteo)
 {
+	ScopedLock lock(processing_mutex);
 	//perform check on date_start and date_end
 	if (date_end < date_start) {
 		std::ostringstream ss;
@@ -142,6 +193,7 @@ void IOManager::push_meteo_data(const ProcessingLevel& level, const Date& date_s
 		fcache_start   = date_start;
 		fcache_end     = date_end;
 		filtered_cache = vecMeteo;
+		filtered_stats.refills++;
 	} else if (level == IOManager::raw){
 		//push data into the BufferedIOHandler
 		fcache_start = fcache_end = Date(0.0, 0.);
@@ -151,6 +203,7 @@ void IOManager::push_meteo_data(const ProcessingLevel& level, const Date& date_s
 		throw InvalidArgumentException("The processing level is invalid (should be raw OR filtered)", AT);
 	}
 
+	ScopedLock cache_lock(mutex);
 	point_cache.clear(); //clear point cache, so that we don't return resampled values of deprecated data
 }
 
@@ -170,12 +223,16 @@ size_t IOManager::getStationData(const Date& date, STATIONS_SET& vecStation)
 //for an interval of data: decide whether data should be filtered or raw
 size_t IOManager::getMeteoData(const Date& dateStart, const Date& dateEnd, std::vector< METEO_SET >& vecVecMeteo)
 {
+	ScopedLock lock(processing_mutex);
+	MIO_PROFILE("IOManager::getMeteoData");
 	vecVecMeteo.clear();
 
 	if (processing_level == IOManager::raw){
 		rawio.readMeteoData(dateStart, dateEnd, vecVecMeteo);
 	} else {
 		const bool success = read_filtered_cache(dateStart, dateEnd, vecVecMeteo);
+		if (success) filtered_stats.hits++;
+		else filtered_stats.misses++;
 
 		if (!success){
 			vector< vector<MeteoData> > tmp_meteo;
@@ -212,6 +269,7 @@ void IOManager::fill_filtered_cache()
 		//ask the bufferediohandler for the whole buffer
 		const vector< METEO_SET >& buffer( bufferedio.getFullBuffer(fcache_start, fcache_end) );
 		meteoprocessor.process(buffer, filtered_cache);
+		filtered_stats.refills++;
 	}
 }
 
@@ -257,19 +315,340 @@ bool IOManager::read_filtered_cache(const Date& start_date, const Date& end_date
 
 void IOManager::add_to_cache(const Date& i_date, const METEO_SET& vecMeteo)
 {
-	//Check cache size, delete oldest elements if necessary
-	if (point_cache.size() > 2000) {
-		point_cache.clear();
-	}
-
-	point_cache[i_date] = vecMeteo;
+	ScopedLock lock(mutex);
+	point_cache.insert( MeteoSnapshot(i_date, vecMeteo) );
 }
 
 void IOManager::clear_cache()
 {
+	ScopedLock lock(mutex);
 	point_cache.clear();
 }
 
+void IOManager::getCacheStats(std::vector<CacheStats>& vecStats) const
+{
+	ScopedLock processing_lock(processing_mutex); //for the filtered cache
+	ScopedLock lock(mutex);
+	vecStats.clear();
+	vecStats.push_back(point_cache.getStats());
+	vecStats.push_back(virtual_point_cache.getStats());
+
+	CacheStats fstats(filtered_stats);
+	fstats.bytes = CacheStats::getMemorySize(filtered_cache);
+	fstats.items = 0;
+	for (size_t ii=0; ii<filtered_cache.size(); ii++)
+		fstats.items += filtered_cache[ii].size();
+	vecStats.push_back(fstats);
+
+	bufferedio.getCacheStats(vecStats);
+	vecStats.push_back(interpolator.getCacheStats());
+}
+
+size_t IOManager::getMemoryUsage() const
+{
+	std::vector<CacheStats> vecStats;
+	getCacheStats(vecStats);
+
+	size_t bytes = 0;
+	for (size_t ii=0; ii<vecStats.size(); ii++)
+		bytes += vecStats[ii].bytes;
+	return bytes;
+}
+
+//the state file is written in the machine's native binary format, the header makes sure it is read back by a compatible build
+static const std::string state_magic("MeteoIO_state");
+static const size_t state_version = 1;
+
+typedef std::vector< std::pair<std::string, double> > FILES_LIST; //file names and modification times
+
+static void writeString(std::iostream& os, const std::string& str)
+{
+	const size_t s_str = str.size();
+	os.write(reinterpret_cast<const char*>(&s_str), sizeof(size_t));
+	os.write(str.data(), static_cast<std::streamsize>(s_str));
+}
+
+//read an items count, the stream fails if the remaining file can not contain that many items of at least min_size bytes
+static void readCount(std::iostream& is, size_t& count, const size_t& min_size)
+{
+	count = 0;
+	is.read(reinterpret_cast<char*>(&count), sizeof(size_t));
+	if (is.fail()) return;
+
+	const std::streampos pos = is.tellg();
+	is.seekg(0, std::ios::end);
+	const std::streampos end = is.tellg();
+	is.seekg(pos);
+	if (is.fail() || pos<0 || end<pos) {
+		is.setstate(std::ios::failbit);
+		count = 0;
+		return;
+	}
+	const size_t remaining = static_cast<size_t>(end - pos);
+	if (count > remaining/min_size) { //corrupted or truncated file
+		is.setstate(std::ios::failbit);
+		count = 0;
+	}
+}
+
+static void readString(std::iostream& is, std::string& str)
+{
+	size_t s_str = 0;
+	is.read(reinterpret_cast<char*>(&s_str), sizeof(size_t));
+	if (is.fail() || s_str>65536) { //this can not be a file name or a grid hash
+		is.setstate(std::ios::failbit);
+		return;
+	}
+	str.resize(s_str);
+	if (s_str>0) is.read(&str[0], static_cast<std::streamsize>(s_str));
+}
+
+static void writeMeteoSets(std::iostream& os, const std::vector<METEO_SET>& vecMeteo)
+{
+	const size_t nr_stations = vecMeteo.size();
+	os.write(reinterpret_cast<const char*>(&nr_stations), sizeof(size_t));
+	for (size_t ii=0; ii<nr_stations; ii++) {
+		const size_t nr_timesteps = vecMeteo[ii].size();
+		os.write(reinterpret_cast<const char*>(&nr_timesteps), sizeof(size_t));
+		for (size_t jj=0; jj<nr_timesteps; jj++)
+			os << vecMeteo[ii][jj];
+	}
+}
+
+static void readMeteoSets(std::iostream& is, std::vector<METEO_SET>& vecMeteo)
+{
+	size_t nr_stations = 0;
+	readCount(is, nr_stations, sizeof(size_t));
+	if (is.fail()) return;
+	vecMeteo.resize(nr_stations);
+	for (size_t ii=0; ii<nr_stations && !is.fail(); ii++) {
+		size_t nr_timesteps = 0;
+		readCount(is, nr_timesteps, sizeof(size_t));
+		if (is.fail()) return;
+		vecMeteo[ii].resize(nr_timesteps);
+		for (size_t jj=0; jj<nr_timesteps && !is.fail(); jj++)
+			is >> vecMeteo[ii][jj];
+	}
+}
+
+static void writeFilesList(std::iostream& os, const FILES_LIST& files)
+{
+	const size_t nr_files = files.size();
+	os.write(reinterpret_cast<const char*>(&nr_files), sizeof(size_t));
+	for (size_t ii=0; ii<nr_files; ii++) {
+		writeString(os, files[ii].first);
+		os.write(reinterpret_cast<const char*>(&files[ii].second), sizeof(double));
+	}
+}
+
+static void readFilesList(std::iostream& is, FILES_LIST& files)
+{
+	size_t nr_files = 0;
+	readCount(is, nr_files, sizeof(size_t)+sizeof(double));
+	if (is.fail()) return;
+	files.resize(nr_files);
+	for (size_t ii=0; ii<nr_files && !is.fail(); ii++) {
+		readString(is, files[ii].first);
+		is.read(reinterpret_cast<char*>(&files[ii].second), sizeof(double));
+	}
+}
+
+//list the files and directories (with their content) given in the [Input] section, either for the DEM or for everything else
+static void getInputFiles(const Config& cfg, const bool& dem_files, const std::string& state_filename, FILES_LIST& files)
+{
+	const std::string state_name( IOUtils::getFilename(state_filename) );
+	files.clear();
+
+	std::vector<std::string> vecKeys;
+	cfg.findKeys(vecKeys, "", "Input");
+	for (size_t ii=0; ii<vecKeys.size(); ii++) {
+		const bool is_dem = (vecKeys[ii].compare(0, 3, "DEM")==0);
+		if (is_dem!=dem_files) continue;
+
+		std::string value;
+		cfg.getValue(vecKeys[ii], "Input", value, IOUtils::nothrow);
+		if (value.empty() || !IOUtils::fileExists(value)) continue; //not a file name
+		files.push_back( std::make_pair(value, IOUtils::getModificationTime(value)) );
+
+		std::list<std::string> dirlist;
+		try {
+			IOUtils::readDirectory(value, dirlist);
+		} catch(const std::exception&) {
+			continue; //this is a plain file
+		}
+		for (std::list<std::string>::const_iterator it=dirlist.begin(); it!=dirlist.end(); ++it) {
+			if (*it==state_name || *it==state_name+".tmp") continue;
+			const std::string filename( value + "/" + *it );
+			files.push_back( std::make_pair(filename, IOUtils::getModificationTime(filename)) );
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	files.erase( std::unique(files.begin(), files.end()), files.end() );
+}
+
+//the meteo data read from a database can change without any file being modified, so it can not be validated
+static bool hasDatabaseMeteo(const Config& cfg)
+{
+	std::string plugin;
+	cfg.getValue("METEO", "Input", plugin, IOUtils::nothrow);
+	IOUtils::toUpper(plugin);
+	return (plugin=="IMIS" || plugin=="GSN" || plugin=="PSQL");
+}
+
+void IOManager::writeState(const std::string& filename) const
+{
+	ScopedLock processing_lock(processing_mutex);
+	ScopedLock lock(mutex);
+	ScopedLock buffer_lock(bufferedio.mutex);
+
+	FILES_LIST dem_files, input_files;
+	getInputFiles(cfg, true, filename, dem_files);
+	getInputFiles(cfg, false, filename, input_files);
+
+	//write to a temporary file first, so an interrupted run does not leave a broken state file behind
+	const std::string tmp_filename( filename + ".tmp" );
+	std::fstream fout(tmp_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (fout.fail())
+		throw FileAccessException("Error opening state file \"" + tmp_filename + "\" for writing", AT);
+
+	writeString(fout, state_magic);
+	const size_t header[3] = {state_version, sizeof(size_t), sizeof(double)};
+	fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+	fout << cfg;
+	writeFilesList(fout, dem_files);
+	writeFilesList(fout, input_files);
+
+	const size_t nr_dems = bufferedio.dem_buffer.size();
+	fout.write(reinterpret_cast<const char*>(&nr_dems), sizeof(size_t));
+	for (size_t ii=0; ii<nr_dems; ii++) { //the state file always contains double precision grids
+		DEMObject dem;
+		bufferedio.dem_buffer[ii].get(dem);
+		fout << dem;
+	}
+
+	fout << bufferedio.buffer_start << bufferedio.buffer_end;
+	writeMeteoSets(fout, bufferedio.meteo_buffer);
+
+	const size_t nr_grids = bufferedio.IndexBufferedGrids.size();
+	fout.write(reinterpret_cast<const char*>(&nr_grids), sizeof(size_t));
+	for (size_t ii=0; ii<nr_grids; ii++) {
+		const std::string& grid_hash = bufferedio.IndexBufferedGrids[ii];
+		writeString(fout, grid_hash);
+		Grid2DObject grid;
+		bufferedio.mapBufferedGrids.find(grid_hash)->second.get(grid);
+		fout << grid;
+	}
+
+	fout << fcache_start << fcache_end;
+	writeMeteoSets(fout, filtered_cache);
+
+	const bool write_error = fout.fail();
+	fout.close();
+	if (write_error) {
+		std::remove(tmp_filename.c_str());
+		throw FileAccessException("Error writing state file \"" + tmp_filename + "\"", AT);
+	}
+	std::remove(filename.c_str()); //rename() does not overwrite an existing file on all systems
+	if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+		throw FileAccessException("Error renaming \"" + tmp_filename + "\" to \"" + filename + "\"", AT);
+}
+
+bool IOManager::readState(const std::string& filename)
+{
+	ScopedLock processing_lock(processing_mutex);
+	ScopedLock lock(mutex);
+	std::fstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+	if (fin.fail()) return false;
+
+	//the state must have been written by a compatible build, with the same configuration
+	std::string magic;
+	readString(fin, magic);
+	size_t header[3] = {0, 0, 0};
+	fin.read(reinterpret_cast<char*>(header), sizeof(header));
+	if (fin.fail() || magic!=state_magic || header[0]!=state_version || header[1]!=sizeof(size_t) || header[2]!=sizeof(double))
+		return false;
+
+	Config state_cfg;
+	fin >> state_cfg;
+	std::stringstream state_cfg_ss, cfg_ss;
+	state_cfg_ss << state_cfg;
+	cfg_ss << cfg;
+	if (fin.fail() || state_cfg_ss.str()!=cfg_ss.str()) return false;
+
+	//the DEM and the rest of the data are validated separately against their input files
+	FILES_LIST dem_files, input_files, state_dem_files, state_input_files;
+	getInputFiles(cfg, true, filename, dem_files);
+	getInputFiles(cfg, false, filename, input_files);
+	readFilesList(fin, state_dem_files);
+	readFilesList(fin, state_input_files);
+	const bool dem_valid = (state_dem_files==dem_files);
+	const bool data_valid = (state_input_files==input_files);
+
+	//everything is read into temporary objects, so nothing is changed if the file turns out to be corrupted
+	size_t nr_dems = 0;
+	readCount(fin, nr_dems, sizeof(size_t));
+	std::vector< CompactGrid<DEMObject> > dem_buffer( (fin.fail())? 0 : nr_dems );
+	for (size_t ii=0; ii<dem_buffer.size() && !fin.fail(); ii++) {
+		DEMObject dem;
+		fin >> dem;
+		dem_buffer[ii] = CompactGrid<DEMObject>(dem, bufferedio.grids_float32);
+	}
+
+	Date buffer_start, buffer_end;
+	std::vector<METEO_SET> meteo_buffer;
+	fin >> buffer_start >> buffer_end;
+	readMeteoSets(fin, meteo_buffer);
+
+	size_t nr_grids = 0;
+	readCount(fin, nr_grids, sizeof(size_t));
+	std::vector<std::string> grids_index( (fin.fail())? 0 : nr_grids );
+	std::map<std::string, CompactGrid<Grid2DObject> > grids;
+	for (size_t ii=0; ii<grids_index.size() && !fin.fail(); ii++) {
+		readString(fin, grids_index[ii]);
+		Grid2DObject grid;
+		fin >> grid;
+		grids[ grids_index[ii] ] = CompactGrid<Grid2DObject>(grid, bufferedio.grids_float32);
+	}
+
+	Date state_fcache_start, state_fcache_end;
+	std::vector<METEO_SET> state_filtered_cache;
+	fin >> state_fcache_start >> state_fcache_end;
+	readMeteoSets(fin, state_filtered_cache);
+	if (fin.fail()) return false;
+
+	ScopedLock buffer_lock(bufferedio.mutex);
+	if (dem_valid)
+		bufferedio.dem_buffer.swap(dem_buffer);
+
+	if (data_valid) {
+		if (!hasDatabaseMeteo(cfg)) {
+			bufferedio.buffer_start = buffer_start;
+			bufferedio.buffer_end = buffer_end;
+			bufferedio.meteo_buffer.swap(meteo_buffer);
+			bufferedio.meteo_stats.items = 0;
+			for (size_t ii=0; ii<bufferedio.meteo_buffer.size(); ii++)
+				bufferedio.meteo_stats.items += bufferedio.meteo_buffer[ii].size();
+			bufferedio.meteo_stats.bytes = CacheStats::getMemorySize(bufferedio.meteo_buffer);
+
+			fcache_start = state_fcache_start;
+			fcache_end = state_fcache_end;
+			filtered_cache.swap(state_filtered_cache);
+			point_cache.clear();
+			virtual_point_cache.clear();
+		}
+
+		bufferedio.IndexBufferedGrids.swap(grids_index);
+		bufferedio.mapBufferedGrids.swap(grids);
+		bufferedio.grids_stats.items = bufferedio.mapBufferedGrids.size();
+		bufferedio.grids_stats.bytes = 0;
+		for (std::map<std::string, CompactGrid<Grid2DObject> >::const_iterator it=bufferedio.mapBufferedGrids.begin(); it!=bufferedio.mapBufferedGrids.end(); ++it)
+			bufferedio.grids_stats.bytes += it->second.getMemorySize();
+	}
+
+	return (dem_valid && data_valid);
+}
+
 size_t IOManager::getTrueMeteoData(const Date& i_date, METEO_SET& vecMeteo)
 {
 	vecMeteo.clear();
@@ -288,16 +667,21 @@ size_t IOManager::getTrueMeteoData(const Date& i_date, METEO_SET& vecMeteo)
 	}
 
 	//2.  Check which data point is available, buffered locally
-	const map<Date, vector<MeteoData> >::const_iterator it = point_cache.find(i_date);
-	if (it != point_cache.end()){
-		vecMeteo = it->second;
-		return vecMeteo.size();
+	{
+		ScopedLock lock(mutex);
+		const MeteoSnapshot* snapshot = point_cache.peek(i_date);
+		if (snapshot){
+			vecMeteo = snapshot->getMeteoData();
+			return vecMeteo.size();
+		}
 	}
 
 	//Let's make sure we have the data we need, in the filtered_cache or in vec_cache
 	vector< vector<MeteoData> >* data = NULL; //reference to either filtered_cache or vec_cache
 	if ((IOManager::filtered & processing_level) == IOManager::filtered){
 		const bool cached = (fcache_start <= i_date-proc_properties.time_before) && (fcache_end >= i_date+proc_properties.time_after);
+		if (cached) filtered_stats.hits++;
+		else filtered_stats.misses++;
 		if (!cached) {
 			//explicit caching, this forces the bufferediohandler to rebuffer, if necessary
 			bufferedio.fillBuffer(i_date-proc_properties.time_before, i_date+proc_properties.time_after);
@@ -335,13 +719,6 @@ size_t IOManager::getVirtualMeteoData(const Date& i_date, METEO_SET& vecMeteo)
 {
 	vecMeteo.clear();
 
-	// Check if data is available in cache
-	const map<Date, vector<MeteoData> >::const_iterator it = virtual_point_cache.find(i_date);
-	if (it != virtual_point_cache.end()){
-		vecMeteo = it->second;
-		return vecMeteo.size();
-	}
-
 	//get data from real input stations
 	METEO_SET vecTrueMeteo;
 	getTrueMeteoData(i_date, vecTrueMeteo);
@@ -380,21 +757,53 @@ size_t IOManager::getVirtualMeteoData(const Date& i_date, METEO_SET& vecMeteo)
 //data can be raw or processed (filtered, resampled)
 size_t IOManager::getMeteoData(const Date& i_date, METEO_SET& vecMeteo)
 {
-	vecMeteo.clear();
+	vecMeteo = getMeteoSnapshot(i_date).getMeteoData();
+	return vecMeteo.size();
+}
+
+const MeteoSnapshot IOManager::getMeteoSnapshot(const Date& i_date)
+{
+	return readMeteoSnapshot(i_date, virtual_stations);
+}
 
-	if(!virtual_stations || skip_virtual_stations) {
+const MeteoSnapshot IOManager::getStationsSnapshot(const Date& i_date)
+{
+	return readMeteoSnapshot(i_date, false);
+}
+
+const MeteoSnapshot IOManager::readMeteoSnapshot(const Date& i_date, const bool& use_virtual)
+{
+	MIO_PROFILE("IOManager::getMeteoSnapshot");
+	PointCache& cache = (use_virtual)? virtual_point_cache : point_cache;
+
+	//raw data is always read again, the other processing levels are served from the cache
+	const bool use_cache = (processing_level != IOManager::raw);
+	if (use_cache) {
+		ScopedLock lock(mutex);
+		const MeteoSnapshot* cached = cache.find(i_date);
+		if (cached) return *cached;
+	}
+
+	//the missing data is computed one date at a time, without blocking the cache lookups of the other threads.
+	//The cache lock must not be held here, the computation takes it for its own lookups
+	ScopedLock processing_lock(processing_mutex);
+	if (use_cache) { //another thread might have computed it in the mean time
+		ScopedLock lock(mutex);
+		const MeteoSnapshot* cached = cache.peek(i_date);
+		if (cached) return *cached;
+	}
+
+	METEO_SET vecMeteo;
+	if (!use_virtual)
 		getTrueMeteoData(i_date, vecMeteo);
-		add_to_cache(i_date, vecMeteo); //Store result in the local cache
-	} else {
+	else
 		getVirtualMeteoData(i_date, vecMeteo);
-		//Store result in the local cache
-		if (virtual_point_cache.size() > 2000) {
-			virtual_point_cache.clear();
-		}
-		virtual_point_cache[i_date] = vecMeteo;
-	}
 
-	return vecMeteo.size();
+	//Store result in the local cache
+	const MeteoSnapshot snapshot(i_date, vecMeteo);
+	ScopedLock lock(mutex);
+	cache.insert(snapshot);
+	return snapshot;
 }
 
 void IOManager::writeMeteoData(const std::vector< METEO_SET >& vecMeteo, const std::string& name)
@@ -406,6 +815,125 @@ void IOManager::writeMeteoData(const std::vector< METEO_SET >& vecMeteo, const s
 	}
 }
 
+size_t IOManager::streamMeteoData(const Date& dateStart, const Date& dateEnd, const double& chunk_size,
+                                  const double& timestep, const std::string& name)
+{
+	ScopedLock lock(processing_mutex);
+	if (dateEnd < dateStart)
+		throw InvalidArgumentException("Trying to stream data from "+dateStart.toString(Date::ISO)+" to "+dateEnd.toString(Date::ISO), AT);
+	if (chunk_size<=0.)
+		throw InvalidArgumentException("The chunk size must be strictly positive", AT);
+	const bool resample = (timestep!=IOUtils::nodata);
+	if (resample && timestep<=0.)
+		throw InvalidArgumentException("The time step must be strictly positive", AT);
+
+	//when resampling, a chunk contains a whole number of time steps. The dates are always computed from
+	//dateStart (instead of being accumulated) so they don't drift over long periods
+	const size_t steps_per_chunk = (resample)? std::max(static_cast<size_t>(1), static_cast<size_t>(floor(chunk_size/timestep + 1e-6))) : 0;
+	const double chunk_length = (resample)? static_cast<double>(steps_per_chunk)*timestep : chunk_size;
+	const Duration epsilon(1./(24.*3600.), 0.); //the end of a chunk is excluded, it belongs to the next chunk
+
+	size_t nr_chunks = 0;
+	std::vector< METEO_SET > vecChunk;
+	try {
+		for (size_t kk=0; ; kk++) {
+			const Date chunk_start( dateStart + static_cast<double>(kk)*chunk_length );
+			if (chunk_start > dateEnd) break;
+			Date chunk_end( dateStart + static_cast<double>(kk+1)*chunk_length - epsilon );
+			if (chunk_end > dateEnd) chunk_end = dateEnd;
+
+			if (processing_level != IOManager::raw && !loadChunk(chunk_start, chunk_end)) {
+				releaseChunk();
+				continue; //no data in this chunk
+			}
+
+			if (!resample) {
+				getMeteoData(chunk_start, chunk_end, vecChunk);
+			} else {
+				std::map<std::string, size_t> station_index; //the stations are matched by ID between the timesteps
+				METEO_SET vecMeteo;
+				for (size_t ii=0; ii<steps_per_chunk; ii++) {
+					const Date date( dateStart + static_cast<double>(kk*steps_per_chunk+ii)*timestep );
+					if (date > dateEnd) break;
+					getMeteoData(date, vecMeteo);
+
+					for (size_t jj=0; jj<vecMeteo.size(); jj++) {
+						const std::string& stationID = vecMeteo[jj].meta.stationID;
+						const std::map<std::string, size_t>::const_iterator it = station_index.find(stationID);
+						size_t index;
+						if (it==station_index.end()) {
+							index = vecChunk.size();
+							station_index[stationID] = index;
+							vecChunk.push_back( METEO_SET() );
+							vecChunk.back().reserve(steps_per_chunk);
+						} else {
+							index = it->second;
+						}
+						vecChunk[index].push_back( vecMeteo[jj] );
+					}
+				}
+			}
+
+			if (nr_chunks==0) writeMeteoData(vecChunk, name);
+			else appendMeteoData(vecChunk, name); //the following chunks are added to the outputs of the first one
+			std::vector< METEO_SET >().swap(vecChunk); //release the memory before processing the next chunk
+			releaseChunk();
+			nr_chunks++;
+		}
+	} catch(...) {
+		releaseChunk();
+		throw;
+	}
+
+	return nr_chunks;
+}
+
+/**
+ * @brief Load one chunk of raw data into the buffers, with the margins required for filtering and resampling
+ * @param chunk_start start date of the chunk (inclusive)
+ * @param chunk_end end date of the chunk (inclusive)
+ * @return false if no station provided any data
+ */
+bool IOManager::loadChunk(const Date& chunk_start, const Date& chunk_end)
+{
+	//the data at the edges of the resampling window must itself be filtered with a full window.
+	//proc_properties only keeps the largest window of the filters and resampling, so it is taken twice
+	const Date buffer_start( chunk_start - proc_properties.time_before - proc_properties.time_before );
+	const Date buffer_end( chunk_end + proc_properties.time_after + proc_properties.time_after );
+
+	std::vector< METEO_SET > vecRaw;
+	rawio.readMeteoData(buffer_start, buffer_end, vecRaw);
+	if (vecRaw.empty()) return false;
+
+	push_meteo_data(IOManager::raw, buffer_start, buffer_end, vecRaw); //this also resets the caches
+	fill_filtered_cache();
+	return true;
+}
+
+void IOManager::appendMeteoData(const std::vector< METEO_SET >& vecMeteo, const std::string& name)
+{
+	if (processing_level == IOManager::raw){
+		rawio.appendMeteoData(vecMeteo, name);
+	} else {
+		bufferedio.appendMeteoData(vecMeteo, name);
+	}
+}
+
+/**
+ * @brief Release the memory used by the chunk that has been loaded by loadChunk()
+ */
+void IOManager::releaseChunk()
+{
+	std::vector< METEO_SET >().swap(filtered_cache);
+	fcache_start = fcache_end = Date(0.0, 0.);
+	{
+		ScopedLock lock(mutex);
+		point_cache.clear();
+		virtual_point_cache.clear();
+	}
+	bufferedio.push_meteo_data(Date(0.0, 0.), Date(0.0, 0.), std::vector< METEO_SET >());
+}
+
 bool IOManager::getMeteoData(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam,
                   Grid2DObject& result)
 {
@@ -419,9 +947,7 @@ bool IOManager::getMeteoData(const Date& date, const DEMObject& dem, const Meteo
 bool IOManager::getMeteoData(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam,
                   Grid2DObject& result, std::string& info_string)
 {
-	skip_virtual_stations = true;
 	interpolator.interpolate(date, dem, meteoparam, result, info_string);
-	skip_virtual_stations = false;
 	return (!result.isEmpty());
 }
 
@@ -437,9 +963,7 @@ void IOManager::interpolate(const Date& date, const DEMObject& dem, const MeteoD
 void IOManager::interpolate(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam,
                             const std::vector<Coords>& in_coords, std::vector<double>& result, std::string& info_string)
 {
-	skip_virtual_stations = true;
 	interpolator.interpolate(date, dem, meteoparam, in_coords, interpol_use_full_dem, result, info_string);
-	skip_virtual_stations = false;
 }
 
 void IOManager::read2DGrid(Grid2DObject& grid2D, const std::string& filename)
@@ -451,6 +975,76 @@ void IOManager::read2DGrid(Grid2DObject& grid2D, const std::string& filename)
 	}
 }
 
+size_t IOManager::interpolateGrids(const std::vector<Date>& vecDates, const DEMObject& dem,
+                                   const std::vector<MeteoData::Parameters>& vecParams)
+{
+	const size_t nr_params = vecParams.size();
+	std::vector<MeteoGrids::Parameters> vecGridParams(nr_params);
+	for (size_t pp=0; pp<nr_params; pp++)
+		vecGridParams[pp] = getGridParameter(vecParams[pp]);
+
+	#ifdef _OPENMP
+	const size_t nr_threads = static_cast<size_t>( omp_get_max_threads() );
+	#else
+	const size_t nr_threads = 1;
+	#endif
+	const size_t dates_per_block = 2*nr_threads; //enough (date, parameter) pairs to keep all threads busy
+
+	std::vector<Grid2DObject> vecGrids;
+	size_t nr_grids = 0;
+
+	for (size_t block_start=0; block_start<vecDates.size(); block_start+=dates_per_block) {
+		const size_t block_end = std::min(block_start+dates_per_block, vecDates.size());
+
+		//prefetch the stations' data, so the threads find it in the cache
+		for (size_t ii=block_start; ii<block_end; ii++)
+			getStationsSnapshot(vecDates[ii]);
+
+		//the interpolator creates its algorithms for each interpolation, so all threads can share it
+		const size_t nr_tasks = (block_end-block_start)*nr_params;
+		vecGrids.resize(nr_tasks);
+		std::string error_msg;
+		#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic, 1)
+		#endif
+		for (long task=0; task<static_cast<long>(nr_tasks); task++) {
+			const size_t date_idx = block_start + static_cast<size_t>(task)/nr_params;
+			const size_t param_idx = static_cast<size_t>(task)%nr_params;
+			try {
+				std::string info_string;
+				interpolator.interpolate(vecDates[date_idx], dem, vecParams[param_idx], vecGrids[task], info_string);
+			} catch(const std::exception& e) {
+				#ifdef _OPENMP
+				#pragma omp critical(interpolateGrids)
+				#endif
+				{
+					if (error_msg.empty()) error_msg = e.what();
+				}
+			}
+		}
+		if (!error_msg.empty()) throw IOException(error_msg, AT);
+
+		//hand the grids to the writer in order
+		for (size_t task=0; task<nr_tasks; task++) {
+			write2DGrid(vecGrids[task], vecGridParams[task%nr_params], vecDates[block_start + task/nr_params]);
+			nr_grids++;
+		}
+	}
+
+	return nr_grids;
+}
+
+MeteoGrids::Parameters IOManager::getGridParameter(const MeteoData::Parameters& meteoparam)
+{
+	const std::string& param_name = MeteoData::getParameterName(meteoparam);
+	for (size_t ii=0; ii<MeteoGrids::nrOfParameters; ii++) {
+		if (MeteoGrids::getParameterName(ii)==param_name)
+			return static_cast<MeteoGrids::Parameters>(ii);
+	}
+
+	throw InvalidArgumentException("No grid parameter matches meteo parameter "+param_name, AT);
+}
+
 void IOManager::read2DGrid(Grid2DObject& grid2D, const MeteoGrids::Parameters& parameter, const Date& date)
 {
 	if (processing_level == IOManager::raw){
@@ -515,6 +1109,8 @@ void IOManager::write2DGrid(const Grid2DObject& grid2D, const MeteoGrids::Parame
 }
 
 const std::string IOManager::toString() const {
+	ScopedLock processing_lock(processing_mutex);
+	ScopedLock lock(mutex);
 	ostringstream os;
 	os << "<IOManager>\n";
 	os << "Config cfg = " << hex << &cfg << dec << "\n";
@@ -525,42 +1121,7 @@ const std::string IOManager::toString() const {
 	os << interpolator.toString();
 
 	//display meteocache
-	size_t count=0;
-	size_t min_stations=std::numeric_limits<size_t>::max();
-	size_t max_stations=0;
-	std::map<Date, std::vector<MeteoData> >::const_iterator iter = point_cache.begin();
-	for (; iter != point_cache.end(); ++iter) {
-		const size_t nb_stations = iter->second.size();
-		if(nb_stations>max_stations) max_stations=nb_stations;
-		if(nb_stations<min_stations) min_stations=nb_stations;
-		count++;
-	}
-
-	if(count==0) {
-		os << "Resampled cache is empty\n";
-	}
-	if(count==1) {
-		os << "Resampled cache content (";
-		if(max_stations==min_stations)
-			os << min_stations;
-		else
-			os << min_stations << " to " << max_stations;
-		os << " station(s))\n";
-		os << point_cache.begin()->first.toString(Date::ISO) << " - 1 timestep\n";
-	}
-	if(count>1) {
-		const double avg_sampling = ( (point_cache.rbegin()->first.getJulian()) - (point_cache.begin()->first.getJulian()) ) / (double)(count-1);
-
-		os << "Resampled cache content (";
-		if(max_stations==min_stations)
-			os << min_stations;
-		else
-			os << min_stations << " to " << max_stations;
-		os << " station(s))\n";
-		os << point_cache.begin()->first.toString(Date::ISO);
-		os << " - " << point_cache.rbegin()->first.toString(Date::ISO);
-		os << " - " << count << " timesteps (" << setprecision(3) << fixed << avg_sampling*24.*3600. << " s sampling rate)";
-	}
+	os << point_cache.toString();
 
 	//display filtered_cache
 	os << "Filteredcache content (" << filtered_cache.size() << " stations)\n";
@@ -576,6 +1137,17 @@ const std::string IOManager::toString() const {
 	//display configured generators
 	os << dataGenerator.toString();
 
+	//display the caches' usage
+	std::vector<CacheStats> vecStats;
+	getCacheStats(vecStats);
+	os << "Caches usage:\n";
+	for (size_t ii=0; ii<vecStats.size(); ii++)
+		os << vecStats[ii].toString();
+
+	#ifdef MIO_PROFILING
+	os << Profiler::getReport();
+	#endif
+
 	os << "</IOManager>\n";
 	return os.str();
 }
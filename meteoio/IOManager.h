@@ -23,10 +23,46 @@
 #include <meteoio/BufferedIOHandler.h>
 #include <meteoio/MeteoProcessor.h>
 #include <meteoio/MeteoData.h>
+#include <meteoio/MeteoSnapshot.h>
+#include <meteoio/CacheStats.h>
+#include <meteoio/PointCache.h>
+#include <meteoio/Mutex.h>
 #include <meteoio/Coords.h>
 
 namespace mio {
 
+/**
+ * @class IOManager
+ * @brief This is the class to use to get processed data (filtered, resampled, generated or spatially interpolated).
+ *
+ * @section iomanager_threads Thread safety
+ * The same IOManager can be used by several threads at the same time (for example, to answer parallel requests
+ * with an IOManager that already has its caches filled). Its point caches are protected by a mutex that is only held
+ * for the short time of a cache lookup or insertion: the returned MeteoSnapshot objects are immutable and can then be
+ * used by each thread without further locking. The data that is not in the caches yet is computed one date at a time
+ * (since the filtered data cache and the processing keep some state) under a separate lock, so the threads that find
+ * their data in the caches are not blocked meanwhile. The spatial interpolations run concurrently: the interpolation
+ * algorithms are instantiated for each interpolation and work on the immutable snapshots of the stations' data, only
+ * the buffer of the interpolated grids being shared (and protected by its own lock). The grids are read through the
+ * buffers of the BufferedIOHandler that have their own lock. The methods can be called recursively (such as by the
+ * interpolation algorithms that call back the IOManager), but changing the configuration of the IOManager (for example
+ * with setProcessingLevel()) while other threads are reading data is not supported.
+ *
+ * @section iomanager_state Warm start
+ * The working state of the IOManager (the raw data and grids buffers, the DEM with its derivatives and the filtered data)
+ * can be written to a binary file and restored by the next run, so an operational run that is started again and again
+ * does not have to rebuild it from scratch (see writeState() and readState()). This is done automatically by
+ * setting the STATE_FILE key in the [General] section to the path of the state file: it is then read when the
+ * IOManager is constructed and written when it is destroyed. The state is only restored if it has been written with
+ * the same configuration and if the input files have not been modified since (all the files and directories given
+ * in the [Input] section are checked). The DEM is checked separately, so it can still be restored when the other
+ * input files have changed (for example when new data has been appended to the meteo files). Only files can be checked
+ * this way: when the meteo data comes from a database (IMIS, GSN or PSQL plugins), the meteo data buffers are never
+ * restored, since new data might have been added to the database. Other inputs that are not given as file or
+ * directory names (such as plugin specific URLs) are not checked either.
+ *
+ * @date   2014-05-12
+ */
 class IOManager {
 
 	public:
@@ -40,6 +76,7 @@ class IOManager {
 
 		IOManager(const std::string& filename_in);
 		IOManager(const Config& i_cfg);
+		~IOManager();
 
 		//Legacy support to support functionality of the IOInterface superclass:
 		void read2DGrid(Grid2DObject& grid_out, const std::string& parameter="");
@@ -103,6 +140,25 @@ class IOManager {
 		 */
 		size_t getMeteoData(const Date& i_date, METEO_SET& vecMeteo);
 
+		/**
+		 * @brief Returns all the stations' data at the instant indicated by a Date object as a MeteoSnapshot.
+		 * This provides the same data as getMeteoData(const Date&, METEO_SET&) but without copying it:
+		 * the snapshot is shared with the internal cache and all the other callers requesting the same date
+		 * (for example, all the spatial interpolation algorithms at a given timestep). It also provides
+		 * the data as one vector per meteo parameter as well as the stations' coordinates as vectors.
+		 * @param i_date      A Date object representing the date/time for the sought MeteoData objects
+		 * @return            snapshot of the data, empty if there is no data found for any station
+		 */
+		const MeteoSnapshot getMeteoSnapshot(const Date& i_date);
+
+		/**
+		 * @brief Same as getMeteoSnapshot() but always for the real stations, even if virtual stations have been configured.
+		 * This is what the spatial interpolation algorithms use.
+		 * @param i_date      A Date object representing the date/time for the sought MeteoData objects
+		 * @return            snapshot of the data, empty if there is no data found for any station
+		 */
+		const MeteoSnapshot getStationsSnapshot(const Date& i_date);
+
 		/**
 		 * @brief Push a vector of time series of MeteoData objects into the IOManager. This overwrites
 		 *        any internal buffers that are used and subsequent calls to getMeteoData or interpolate
@@ -152,6 +208,30 @@ class IOManager {
 		void interpolate(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam,
 				 const std::vector<Coords>& in_coords, std::vector<double>& result, std::string& info_string);
 
+		/**
+		 * @brief Spatially interpolate several parameters at several dates and write the resulting grids.
+		 * The stations' data is prefetched for a block of dates, then the (date, parameter) interpolations of
+		 * this block are computed in parallel (when compiled with OpenMP), each thread using its own interpolation
+		 * algorithms. The grids are then handed in order (by date, then by parameter as given in vecParams) to
+		 * write2DGrid, using the MeteoGrids parameter that has the same name.
+		 *
+		 * Example Usage:
+		 * @code
+		 * std::vector<Date> vecDates;
+		 * for (Date d=d1; d<=d2; d+=1./24.) vecDates.push_back(d); //hourly grids
+		 * std::vector<MeteoData::Parameters> vecParams;
+		 * vecParams.push_back(MeteoData::TA);
+		 * vecParams.push_back(MeteoData::RH);
+		 * io.interpolateGrids(vecDates, dem, vecParams);
+		 * @endcode
+		 * @param vecDates dates for which to interpolate
+		 * @param dem Digital Elevation Model on which to perform the interpolations
+		 * @param vecParams meteo parameters to interpolate
+		 * @return number of grids that have been written
+		 */
+		size_t interpolateGrids(const std::vector<Date>& vecDates, const DEMObject& dem,
+		                        const std::vector<MeteoData::Parameters>& vecParams);
+
 		/**
 		 * @brief Set the desired ProcessingLevel of the IOManager instance
 		 *        The processing level affects the way meteo data is read and processed
@@ -189,6 +269,37 @@ class IOManager {
 
 		void writeMeteoData(const std::vector< METEO_SET >& vecMeteo, const std::string& name="");
 
+		/**
+		 * @brief Process and write out a (long) period of data block by block.
+		 * Instead of loading the whole period in memory, the data is read one block at a time, together with the
+		 * margins that the filters and the resampling require (see ProcessingProperties). The block is then filtered,
+		 * resampled and generated according to the ProcessingLevel, written out and released before the next
+		 * block is processed. The peak memory usage is therefore bounded by the size of a block instead of the size of the
+		 * whole period. The first block is handed to writeMeteoData, the following ones to IOInterface::appendMeteoData,
+		 * so the output plugin must be able to append to its outputs (as SMET does).
+		 *
+		 * NOTE:
+		 * - the internal buffers are used for the processing, so any buffered or pushed data is dismissed;
+		 * - the filters' windows are only guaranteed in time: if they require a minimum number of points, these
+		 *   must fit within the time margins.
+		 *
+		 * Example Usage:
+		 * @code
+		 * IOManager io(Config("io.ini"));
+		 * //write one year of hourly data, processed 10 days at a time
+		 * io.streamMeteoData(Date(2008,10,01,00,00, 1.), Date(2009,10,01,00,00, 1.), 10., 1./24.);
+		 * @endcode
+		 * @param dateStart A Date object representing the beginning of the period (inclusive)
+		 * @param dateEnd   A Date object representing the end of the period (inclusive)
+		 * @param chunk_size size of the blocks, in days
+		 * @param timestep  resampling time step, in days. If set to IOUtils::nodata, the data is not resampled
+		 *                  but returned at its original sampling rate.
+		 * @param name      optional name to pass to the output plugin
+		 * @return number of blocks that have been written
+		 */
+		size_t streamMeteoData(const Date& dateStart, const Date& dateEnd, const double& chunk_size,
+		                       const double& timestep=IOUtils::nodata, const std::string& name="");
+
 		/**
 		 * @brief Returns a copy of the internal Config object.
 		 * This is convenient to clone an iomanager
@@ -198,6 +309,36 @@ class IOManager {
 
 		const std::string toString() const;
 
+		/**
+		 * @brief Get the usage statistics of all the caches and buffers.
+		 * This returns, in this order, the statistics of the resampled points cache, of the virtual stations
+		 * points cache, of the filtered data cache, of the raw time series buffer, of the grids buffer and of the
+		 * interpolated grids buffer. Their memory limits are set in the configuration, see BufferedIOHandler.
+		 * @param vecStats vector filled with the statistics of each cache
+		 */
+		void getCacheStats(std::vector<CacheStats>& vecStats) const;
+
+		/**
+		 * @brief Estimated memory footprint of all the caches and buffers
+		 * @return memory footprint in bytes
+		 */
+		size_t getMemoryUsage() const;
+
+		/**
+		 * @brief Write the working state (buffers, DEM and filtered data) to a file, for a later warm start
+		 * @param filename file to write the state to
+		 */
+		void writeState(const std::string& filename) const;
+
+		/**
+		 * @brief Restore the working state from a file written by writeState().
+		 * The state is only restored if it matches the current configuration and input files. The DEM is
+		 * checked separately from the rest of the data, so it might be the only part that is restored.
+		 * @param filename file to read the state from
+		 * @return true if the whole state has been restored
+		 */
+		bool readState(const std::string& filename);
+
 		/**
 		 * @brief Add a METEO_SET for a specific instance to the point cache. This is a way to manipulate
 		 * MeteoData variables and be sure that the manipulated values are later used for requests
@@ -221,6 +362,11 @@ class IOManager {
 		                         std::vector< METEO_SET >& vec_meteo);
 		size_t getTrueMeteoData(const Date& i_date, METEO_SET& vecMeteo);
 		size_t getVirtualMeteoData(const Date& i_date, METEO_SET& vecMeteo);
+		const MeteoSnapshot readMeteoSnapshot(const Date& i_date, const bool& use_virtual);
+		static MeteoGrids::Parameters getGridParameter(const MeteoData::Parameters& meteoparam);
+		bool loadChunk(const Date& chunk_start, const Date& chunk_end);
+		void appendMeteoData(const std::vector< METEO_SET >& vecMeteo, const std::string& name);
+		void releaseChunk();
 
 		const Config cfg; ///< we keep this Config object as full copy, so the original one can get out of scope/be destroyed
 		IOHandler rawio;
@@ -234,14 +380,18 @@ class IOManager {
 		std::vector<StationData> v_stations; ///< metadata for virtual stations
 
 		ProcessingProperties proc_properties; ///< buffer constraints in order to be able to compute the requested values
-		std::map<Date, METEO_SET > virtual_point_cache;  ///< stores already resampled virtual data points
-		std::map<Date, METEO_SET > point_cache;  ///< stores already resampled data points
+		PointCache virtual_point_cache;  ///< stores already resampled virtual data points
+		PointCache point_cache;  ///< stores already resampled data points
 		std::vector< METEO_SET > filtered_cache; ///< stores already filtered data intervals
 		Date fcache_start, fcache_end; ///< store the beginning and the end date of the filtered_cache
+		CacheStats filtered_stats; ///< usage statistics of the filtered_cache
 		unsigned int processing_level;
 		bool virtual_stations; ///< compute the meteo values at virtual stations
-		bool skip_virtual_stations; ///< skip virtual stations in subsequent calls to prevent recursive calls...
 		bool interpol_use_full_dem; ///< use full dem for point-wise spatial interpolations
+		bool profiling_report; ///< print the profiling report when being destroyed
+		std::string state_file; ///< read the state from this file at startup and write it back at the end
+		mutable Mutex mutex; ///< protects the point caches, only held for their lookups and insertions
+		mutable Mutex processing_mutex; ///< the data that is missing from the point caches is computed one date at a time
 };
 } //end namespace
 #endif
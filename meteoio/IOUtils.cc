@@ -396,6 +396,15 @@ template<> bool convertString<unsigned int>(unsigned int& t, const std::string&
 
 bool convertString(Date& t, const std::string& str, const double& time_zone, std::ios_base& (*f)(std::ios_base&))
 {
+	//fast path for the most common case: plain ISO timestamps (for example in SMET files)
+	int f_year, f_month, f_day, f_hour, f_minute;
+	size_t nr_chars;
+	if (Date::parseISO(str.c_str(), f_year, f_month, f_day, f_hour, f_minute, nr_chars) && nr_chars==str.size()) {
+		if(time_zone==nodata) return false;
+		t.setDate(f_year, f_month, f_day, f_hour, f_minute, time_zone);
+		return true;
+	}
+
 	std::string s(str);
 	trim(s); //delete trailing and leading whitespaces and tabs
 
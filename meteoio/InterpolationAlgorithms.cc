@@ -73,12 +73,14 @@ InterpolationAlgorithm* AlgorithmFactory::getAlgorithm(const std::string& i_algo
 size_t InterpolationAlgorithm::getData(const Date& i_date, const MeteoData::Parameters& i_param,
                                        std::vector<double>& o_vecData)
 {
-	iomanager.getMeteoData(i_date, vecMeteo);
+	snapshot = iomanager.getStationsSnapshot(i_date);
 	o_vecData.clear();
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		const double& val = vecMeteo[ii](i_param);
-		if (val != IOUtils::nodata) {
-			o_vecData.push_back(val);
+	if (snapshot.empty()) return 0;
+
+	const std::vector<double>& values = snapshot.getParameter(i_param);
+	for (size_t ii=0; ii<values.size(); ii++){
+		if (values[ii] != IOUtils::nodata) {
+			o_vecData.push_back(values[ii]);
 		}
 	}
 
@@ -88,14 +90,16 @@ size_t InterpolationAlgorithm::getData(const Date& i_date, const MeteoData::Para
 size_t InterpolationAlgorithm::getData(const Date& i_date, const MeteoData::Parameters& i_param,
                                        std::vector<double>& o_vecData, std::vector<StationData>& o_vecMeta)
 {
-	iomanager.getMeteoData(i_date, vecMeteo);
+	snapshot = iomanager.getStationsSnapshot(i_date);
 	o_vecData.clear();
 	o_vecMeta.clear();
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		const double& val = vecMeteo[ii](i_param);
-		if (val != IOUtils::nodata){
-			o_vecData.push_back(val);
-			o_vecMeta.push_back(vecMeteo[ii].meta);
+	if (snapshot.empty()) return 0;
+
+	const std::vector<double>& values = snapshot.getParameter(i_param);
+	for (size_t ii=0; ii<values.size(); ii++){
+		if (values[ii] != IOUtils::nodata){
+			o_vecData.push_back(values[ii]);
+			o_vecMeta.push_back(snapshot.getMeta(ii));
 		}
 	}
 
@@ -473,12 +477,15 @@ double RHAlgorithm::getQualityRating(const Date& i_date, const MeteoData::Parame
 	vecDataTA.clear(); vecDataRH.clear();
 
 	nrOfMeasurments = 0;
-	iomanager.getMeteoData(date, vecMeteo);
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		if ((vecMeteo[ii](MeteoData::RH) != IOUtils::nodata) && (vecMeteo[ii](MeteoData::TA) != IOUtils::nodata)){
-			vecDataTA.push_back(vecMeteo[ii](MeteoData::TA));
-			vecDataRH.push_back(vecMeteo[ii](MeteoData::RH));
-			vecMeta.push_back(vecMeteo[ii].meta);
+	snapshot = iomanager.getStationsSnapshot(date);
+	if (snapshot.empty()) return 0.0;
+	const std::vector<double>& TA = snapshot.getParameter(MeteoData::TA);
+	const std::vector<double>& RH = snapshot.getParameter(MeteoData::RH);
+	for (size_t ii=0; ii<snapshot.getNrStations(); ii++){
+		if ((RH[ii] != IOUtils::nodata) && (TA[ii] != IOUtils::nodata)){
+			vecDataTA.push_back(TA[ii]);
+			vecDataRH.push_back(RH[ii]);
+			vecMeta.push_back(snapshot.getMeta(ii));
 			nrOfMeasurments++;
 		}
 	}
@@ -539,10 +546,14 @@ double ILWRAlgorithm::getQualityRating(const Date& i_date, const MeteoData::Para
 	vecDataEA.clear();
 
 	nrOfMeasurments = 0;
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		if ((vecMeteo[ii](MeteoData::ILWR) != IOUtils::nodata) && (vecMeteo[ii](MeteoData::TA) != IOUtils::nodata)){
-			vecDataEA.push_back( Atmosphere::blkBody_Emissivity( vecMeteo[ii](MeteoData::ILWR), vecMeteo[ii](MeteoData::TA)) );
-			vecMeta.push_back(vecMeteo[ii].meta);
+	snapshot = iomanager.getStationsSnapshot(date);
+	if (snapshot.empty()) return 0.0;
+	const std::vector<double>& TA = snapshot.getParameter(MeteoData::TA);
+	const std::vector<double>& ILWR = snapshot.getParameter(MeteoData::ILWR);
+	for (size_t ii=0; ii<snapshot.getNrStations(); ii++){
+		if ((ILWR[ii] != IOUtils::nodata) && (TA[ii] != IOUtils::nodata)){
+			vecDataEA.push_back( Atmosphere::blkBody_Emissivity( ILWR[ii], TA[ii]) );
+			vecMeta.push_back(snapshot.getMeta(ii));
 			nrOfMeasurments++;
 		}
 	}
@@ -593,12 +604,15 @@ double ListonWindAlgorithm::getQualityRating(const Date& i_date, const MeteoData
 	vecDataVW.clear(); vecDataDW.clear();
 
 	nrOfMeasurments = 0;
-	iomanager.getMeteoData(date, vecMeteo);
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		if ((vecMeteo[ii](MeteoData::VW) != IOUtils::nodata) && (vecMeteo[ii](MeteoData::DW) != IOUtils::nodata)){
-			vecDataVW.push_back(vecMeteo[ii](MeteoData::VW));
-			vecDataDW.push_back(vecMeteo[ii](MeteoData::DW));
-			vecMeta.push_back(vecMeteo[ii].meta);
+	snapshot = iomanager.getStationsSnapshot(date);
+	if (snapshot.empty()) return 0.0;
+	const std::vector<double>& VW = snapshot.getParameter(MeteoData::VW);
+	const std::vector<double>& DW = snapshot.getParameter(MeteoData::DW);
+	for (size_t ii=0; ii<snapshot.getNrStations(); ii++){
+		if ((VW[ii] != IOUtils::nodata) && (DW[ii] != IOUtils::nodata)){
+			vecDataVW.push_back(VW[ii]);
+			vecDataDW.push_back(DW[ii]);
+			vecMeta.push_back(snapshot.getMeta(ii));
 			nrOfMeasurments++;
 		}
 	}
@@ -649,12 +663,15 @@ double RyanAlgorithm::getQualityRating(const Date& i_date, const MeteoData::Para
 	vecDataVW.clear(); vecDataDW.clear();
 
 	nrOfMeasurments = 0;
-	iomanager.getMeteoData(date, vecMeteo);
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		if ((vecMeteo[ii](MeteoData::VW) != IOUtils::nodata) && (vecMeteo[ii](MeteoData::DW) != IOUtils::nodata)){
-			vecDataVW.push_back(vecMeteo[ii](MeteoData::VW));
-			vecDataDW.push_back(vecMeteo[ii](MeteoData::DW));
-			vecMeta.push_back(vecMeteo[ii].meta);
+	snapshot = iomanager.getStationsSnapshot(date);
+	if (snapshot.empty()) return 0.0;
+	const std::vector<double>& VW = snapshot.getParameter(MeteoData::VW);
+	const std::vector<double>& DW = snapshot.getParameter(MeteoData::DW);
+	for (size_t ii=0; ii<snapshot.getNrStations(); ii++){
+		if ((VW[ii] != IOUtils::nodata) && (DW[ii] != IOUtils::nodata)){
+			vecDataVW.push_back(VW[ii]);
+			vecDataDW.push_back(DW[ii]);
+			vecMeta.push_back(snapshot.getMeta(ii));
 			nrOfMeasurments++;
 		}
 	}
@@ -865,9 +882,9 @@ void WinstralAlgorithm::calculate(const DEMObject& dem, Grid2DObject& grid)
 	double synoptic_bearing = user_synoptic_bearing;
 	if (synoptic_bearing==IOUtils::nodata) {
 		if (!ref_station.empty())
-			synoptic_bearing = getSynopticBearing(vecMeteo, ref_station, algo);
+			synoptic_bearing = getSynopticBearing(snapshot.getMeteoData(), ref_station, algo);
 		else
-			synoptic_bearing = getSynopticBearing(dem, vecMeteo);
+			synoptic_bearing = getSynopticBearing(dem, snapshot.getMeteoData());
 	}
 	info << "DW=" << synoptic_bearing << " - ";
 
@@ -891,8 +908,8 @@ std::string USERInterpolation::getGridFileName() const
 	const std::string ext(".asc");
 	std::string gridname = vecArgs[0] + "/";
 
-	if (!vecMeteo.empty()) {
-		const Date& timestep = vecMeteo.at(0).date;
+	if (!snapshot.empty()) {
+		const Date& timestep = snapshot.getDate();
 		gridname =  gridname + timestep.toString(Date::NUM) + "_" + MeteoData::getParameterName(param) + ext;
 	} else {
 		gridname = gridname + "Default" + "_" + MeteoData::getParameterName(param) + ext;
@@ -1010,45 +1027,42 @@ size_t OrdinaryKrigingAlgorithm::getTimeSeries(const bool& detrend_data, std::ve
 	Date d1 = date - daysBefore;
 
 	vecVecData.clear();
-	std::vector<MeteoData> Meteo;
-	iomanager.getMeteoData(d1, Meteo);
-	const size_t nrStations = Meteo.size();
+	MeteoSnapshot Meteo( iomanager.getStationsSnapshot(d1) );
+	const size_t nrStations = Meteo.getNrStations();
 	vecVecData.insert(vecVecData.begin(), nrStations, std::vector<double>()); //allocation for the vectors
 
 	//get the stations altitudes
 	vector<double> vecAltitudes;
+	const std::vector<double>& altitudes = Meteo.getAltitudes();
 	for (size_t ii=0; ii<nrStations; ii++){
-		const double& alt = Meteo[ii].meta.position.getAltitude();
-		if (alt != IOUtils::nodata) {
-			vecAltitudes.push_back(alt);
+		if (altitudes[ii] != IOUtils::nodata) {
+			vecAltitudes.push_back(altitudes[ii]);
 		}
 	}
 
 	//fill time series
 	for(; d1<=date; d1+=Tstep) {
-		iomanager.getMeteoData(d1, Meteo);
-		if (Meteo.size()!=nrStations) {
+		Meteo = iomanager.getStationsSnapshot(d1);
+		if (Meteo.getNrStations()!=nrStations) {
 			std::ostringstream ss;
-			ss << "Number of stations varying between " << nrStations << " and " << Meteo.size();
+			ss << "Number of stations varying between " << nrStations << " and " << Meteo.getNrStations();
 			ss << ". This is currently not supported for " << algo << "!";
 			throw InvalidArgumentException(ss.str(), AT);
 		}
+		if (nrStations==0) continue;
+		const std::vector<double>& values = Meteo.getParameter(param);
 
 		if (detrend_data) { //detrend data
 			//find trend
-			std::vector<double> vecDat;
-			for(size_t ii=0; ii<nrStations; ii++)
-				vecDat.push_back( Meteo[ii](param) );
-
 			Fit1D trend;
-			trend.setModel(Fit1D::NOISY_LINEAR, vecAltitudes, vecDat, false);
+			trend.setModel(Fit1D::NOISY_LINEAR, vecAltitudes, values, false);
 			const bool status = trend.fit();
 			if (!status)
 				throw InvalidArgumentException("Could not fit variogram model to the data", AT);
 
 			//detrend the data
 			for(size_t ii=0; ii<nrStations; ii++) {
-				double val = Meteo[ii](param);
+				double val = values[ii];
 				if(val!=IOUtils::nodata)
 					val -= trend( vecAltitudes[ii] );
 
@@ -1056,7 +1070,7 @@ size_t OrdinaryKrigingAlgorithm::getTimeSeries(const bool& detrend_data, std::ve
 			}
 		} else { //do not detrend data
 			for(size_t ii=0; ii<nrStations; ii++)
-				vecVecData.at(ii).push_back( Meteo[ii](param) );
+				vecVecData.at(ii).push_back( values[ii] );
 		}
 	}
 
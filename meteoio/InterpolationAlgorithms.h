@@ -20,6 +20,7 @@
 
 #include <meteoio/DEMObject.h>
 #include <meteoio/MeteoData.h>
+#include <meteoio/MeteoSnapshot.h>
 #include <meteoio/meteostats/libinterpol1D.h>
 #include <meteoio/meteostats/libinterpol2D.h>
 #include <meteoio/meteostats/libfit1D.h>
@@ -143,7 +144,7 @@ class InterpolationAlgorithm {
 		InterpolationAlgorithm(Meteo2DInterpolator& i_mi,
 		                       const std::vector<std::string>& i_vecArgs,
 		                       const std::string& i_algo, IOManager& iom) :
-		                      algo(i_algo), mi(i_mi), date(0.), vecArgs(i_vecArgs), vecMeteo(), vecData(),
+		                      algo(i_algo), mi(i_mi), date(0.), vecArgs(i_vecArgs), snapshot(), vecData(),
 		                      vecMeta(), info(), param(MeteoData::firstparam), nrOfMeasurments(0), iomanager(iom) {};
 		virtual ~InterpolationAlgorithm() {};
 		//if anything is not ok (wrong parameter for this algo, insufficient data, etc) -> return zero
@@ -166,7 +167,7 @@ class InterpolationAlgorithm {
 		Date date;
 		const std::vector<std::string> vecArgs; //we must keep our own copy, it is different for each algorithm!
 
-		std::vector<MeteoData> vecMeteo;
+		MeteoSnapshot snapshot; ///<all stations' data at the current date, shared with the IOManager and the other algorithms
 		std::vector<double> vecData; ///<store the measurement for the given parameter
 		std::vector<StationData> vecMeta; ///<store the station data for the given parameter
 		std::ostringstream info; ///<to store some extra information about the interplation process
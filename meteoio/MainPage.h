@@ -348,6 +348,11 @@ namespace mio {
  *    @code
  *    process(const unsigned int& index, const std::vector<MeteoData>& ivec, std::vector<MeteoData>& ovec)
  *    @endcode
+ *    -# Optionally, the <b>process_column</b> method processes in place the values of the parameter (with their dates as gmt julian
+ *    and the original MeteoData vector as context), so the data does not have to be copied for each element of the processing
+ *    stack. An element that implements it must return true in <b>has_column</b>, its process method then simply calling
+ *    process_by_column() (see "template.cc"). The processing stack only calls process_column on such elements, the default
+ *    implementation throwing an exception.
  *    -# The private <b>parse_args</b> method reads the arguments from a vector of strings, with the following declaration:
  *    @code
  *    parse_args(std::vector<std::string> vec_args)
@@ -21,11 +21,56 @@
 #include <cmath> //needed for fabs()
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+
+#ifdef BLAS
+extern "C" {
+	//Fortran BLAS/LAPACK interfaces. They work on column major matrices, so a row major matrix
+	//is seen as its transposed
+	void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+	            const double* alpha, const double* a, const int* lda, const double* b, const int* ldb,
+	            const double* beta, double* c, const int* ldc);
+	void dpotrf_(const char* uplo, const int* n, double* a, const int* lda, int* info);
+}
+#endif
 
 namespace mio {
 
 const double Matrix::epsilon = 1e-9; //for considering a determinant to be zero, etc
 const double Matrix::epsilon_mtr = 1e-6; //for comparing two matrix
+static const size_t block_size = 64; //so that three blocks of doubles fit in L1/L2 caches
+
+#ifndef BLAS
+//C += op(A)·B on row major arrays, op(A) being A (m×k) or A^T (A being then k×m).
+//When symmetric is set, only the upper half of C is computed.
+static void gemmBlocked(const double* A, const size_t& lda, const bool& transA,
+                        const double* B, const size_t& ldb, double* C, const size_t& ldc,
+                        const size_t& m, const size_t& n, const size_t& k, const bool& symmetric)
+{
+	for(size_t i0=0; i0<m; i0+=block_size) {
+		const size_t i1 = std::min(i0+block_size, m);
+		for(size_t p0=0; p0<k; p0+=block_size) {
+			const size_t p1 = std::min(p0+block_size, k);
+			for(size_t j0=0; j0<n; j0+=block_size) {
+				const size_t j1 = std::min(j0+block_size, n);
+				if(symmetric && j1<=i0) continue; //this block is fully below the diagonal
+
+				for(size_t i=i0; i<i1; i++) {
+					double* Ci = C + i*ldc;
+					const size_t jstart = (symmetric)? std::max(j0, i) : j0;
+					for(size_t p=p0; p<p1; p++) {
+						const double a = (transA)? A[p*lda+i] : A[i*lda+p];
+						if(a==0.) continue;
+						const double* Bp = B + p*ldb;
+						for(size_t j=jstart; j<j1; j++)
+							Ci[j] += a * Bp[j];
+					}
+				}
+			}
+		}
+	}
+}
+#endif
 
 Matrix::Matrix(const int& rows, const int& cols) : vecData(), ncols(0), nrows(0) {
 	if(rows<0 || cols<0) {
@@ -214,38 +259,78 @@ const Matrix Matrix::operator-(const double& rhs) const {
 }
 
 Matrix& Matrix::operator*=(const Matrix& rhs) {
+	Matrix result;
+	multiply(*this, rhs, result);
+
+	vecData.swap(result.vecData);
+	nrows = result.nrows;
+	ncols = result.ncols;
+	return *this;
+}
+
+const Matrix Matrix::operator*(const Matrix& rhs) const {
+	Matrix result;
+	multiply(*this, rhs, result);
+
+	return result;
+}
+
+void Matrix::multiply(const Matrix& A, const Matrix& B, Matrix& C) {
 	//check dimensions compatibility
-	if(ncols!=rhs.nrows) {
+	if(A.ncols!=B.nrows) {
 		std::ostringstream tmp;
 		tmp << "Trying to multiply two matrix with incompatible dimensions: ";
-		tmp << "(" << nrows << "," << ncols << ") * ";
-		tmp << "(" << rhs.nrows << "," << rhs.ncols << ")";
+		tmp << "(" << A.nrows << "," << A.ncols << ") * ";
+		tmp << "(" << B.nrows << "," << B.ncols << ")";
 		throw IOException(tmp.str(), AT);
 	}
+	if(&C==&A || &C==&B)
+		throw InvalidArgumentException("The result of a matrix product can not be stored in one of its operands", AT);
 
-	//create new matrix
-	Matrix result(nrows,rhs.ncols);
-
-	//fill product matrix
-	for(size_t i=1; i<=result.nrows; i++) {
-		for(size_t j=1; j<=result.ncols; j++) {
-			double sum=0.;
-			for(size_t idx=1; idx<=ncols; idx++) {
-				sum += operator()(i,idx) * rhs(idx,j);
-			}
-			result(i,j) = sum;
-		}
-	}
+	const size_t m = A.nrows, n = B.ncols, k = A.ncols;
+	C.resize(m, n, 0.);
+	if(m==0 || n==0 || k==0) return;
 
-	*this = result;
-	return *this;
+#ifdef BLAS
+	//row major C = A·B is column major C^T = B^T·A^T
+	const int M=(int)n, N=(int)m, K=(int)k;
+	const double alpha=1., beta=0.;
+	dgemm_("N", "N", &M, &N, &K, &alpha, &B.vecData[0], &M, &A.vecData[0], &K, &beta, &C.vecData[0], &M);
+#else
+	gemmBlocked(&A.vecData[0], k, false, &B.vecData[0], n, &C.vecData[0], n, m, n, k, false);
+#endif
 }
 
-const Matrix Matrix::operator*(const Matrix& rhs) const {
-	Matrix result = *this;
-	result *= rhs; //already implemented
-
-	return result;
+void Matrix::multiplyAtB(const Matrix& A, const Matrix& B, Matrix& C) {
+	//check dimensions compatibility
+	if(A.nrows!=B.nrows) {
+		std::ostringstream tmp;
+		tmp << "Trying to multiply two matrix with incompatible dimensions: ";
+		tmp << "(" << A.ncols << "," << A.nrows << ") * ";
+		tmp << "(" << B.nrows << "," << B.ncols << ")";
+		throw IOException(tmp.str(), AT);
+	}
+	if(&C==&A || &C==&B)
+		throw InvalidArgumentException("The result of a matrix product can not be stored in one of its operands", AT);
+
+	const size_t m = A.ncols, n = B.ncols, k = A.nrows;
+	C.resize(m, n, 0.);
+	if(m==0 || n==0 || k==0) return;
+
+#ifdef BLAS
+	//row major C = A^T·B is column major C^T = B^T·A
+	const int M=(int)n, N=(int)m, K=(int)k;
+	const double alpha=1., beta=0.;
+	dgemm_("N", "T", &M, &N, &K, &alpha, &B.vecData[0], &M, &A.vecData[0], &N, &beta, &C.vecData[0], &M);
+#else
+	const bool symmetric = (&A==&B);
+	gemmBlocked(&A.vecData[0], m, true, &B.vecData[0], n, &C.vecData[0], n, m, n, k, symmetric);
+	if(symmetric) { //fill the lower half from the upper half
+		for(size_t i=1; i<m; i++)
+			for(size_t j=0; j<i; j++)
+				C.vecData[i*n+j] = C.vecData[j*n+i];
+	}
+#endif
 }
 
 Matrix& Matrix::operator*=(const double& rhs) {
@@ -342,11 +427,15 @@ double Matrix::det() const {
 		tmp << "(" << nrows << "," << ncols << ") !";
 		throw IOException(tmp.str(), AT);
 	}
-	Matrix L,U;
-	if(LU(L,U)==false) return 0.;
+	Matrix LU(*this);
+	std::vector<size_t> pivot_idx;
+	if(LU.LUdecomposition(pivot_idx)==false) return 0.;
 
 	double product=1.;
-	for(size_t i=1; i<=nrows; i++) product *= U(i,i);
+	for(size_t i=0; i<nrows; i++) {
+		product *= LU.vecData[i*ncols+i];
+		if(pivot_idx[i]!=i) product = -product; //each row exchange changes the sign
+	}
 
 	return product;
 }
@@ -398,49 +487,16 @@ Matrix Matrix::getInv() const {
 		tmp << "(" << nrows << "," << ncols << ") !";
 		throw IOException(tmp.str(), AT);
 	}
-	const size_t n = nrows;
-
-	Matrix U;
-	Matrix L;
-	if(LU(L, U)==false) {
-		throw IOException("LU decomposition of given matrix not possible", AT);
-	}
 
-	//we solve AX=I with X=A-1. Since A=LU, then LUX = I
-	//we start by forward solving LY=I with Y=UX
-	Matrix Y(n, n);
-	for(size_t i=1; i<=n; i++) {
-		if(IOUtils::checkEpsilonEquality(L(i,i), 0., epsilon)) {
-			throw IOException("The given matrix can not be inversed", AT);
-		}
-		Y(i,i) = 1./L(i,i); //j==i
-		for(size_t j=1; j<i; j++) { //j<i
-			double sum=0.;
-			for(size_t k=i-1; k>=1; k--) { //equivalent to 1 -> i-1
-				sum += L(i,k) * Y(k,j);
-			}
-			Y(i,j) = -1./L(i,i) * sum;
-		}
-		for(size_t j=i+1; j<=n; j++) { //j>i
-			Y(i,j) = 0.;
-		}
-	}
-
-	//now, we backward solve UX=Y
-	Matrix X(n,n);
-	for(size_t i=n; i>=1; i--) { //lines
-		if(IOUtils::checkEpsilonEquality(U(i,i), 0., epsilon)) { //HACK: actually, only U(n,n) needs checking
-			throw IOException("The given matrix is singular and can not be inversed", AT);
-		}
-		for(size_t j=1; j<=n; j++) { //lines
-			double sum=0.;
-			for(size_t k=i+1; k<=n; k++) {
-				sum += U(i,k) * X(k,j);
-			}
-			X(i,j) = (Y(i,j) - sum) / U(i,i);
-		}
+	Matrix LU(*this);
+	std::vector<size_t> pivot_idx;
+	if(LU.LUdecomposition(pivot_idx)==false) {
+		throw IOException("The given matrix is singular and can not be inversed", AT);
 	}
 
+	//we solve AX=I with X=A-1
+	Matrix X(nrows, 1.);
+	LUsolve(LU, pivot_idx, X);
 	return X;
 }
 
@@ -452,120 +508,222 @@ bool Matrix::inv() {
 		tmp << "(" << nrows << "," << ncols << ") !";
 		throw IOException(tmp.str(), AT);
 	}
-	const size_t n = nrows;
 
-	Matrix U;
-	Matrix L;
-	if(LU(L, U)==false) {
+	Matrix LU(*this);
+	std::vector<size_t> pivot_idx;
+	if(LU.LUdecomposition(pivot_idx)==false) {
 		return false;
 	}
 
-	//we solve AX=I with X=A-1. Since A=LU, then LUX = I
-	//we start by forward solving LY=I with Y=UX
-	Matrix Y(n, n);
-	for(size_t i=1; i<=n; i++) {
-		if(IOUtils::checkEpsilonEquality(L(i,i), 0., epsilon)) {
-			return false;
-		}
-		Y(i,i) = 1./L(i,i); //j==i
-		for(size_t j=1; j<i; j++) { //j<i
-			double sum=0.;
-			for(size_t k=i-1; k>=1; k--) { //equivalent to 1 -> i-1
-				sum += L(i,k) * Y(k,j);
-			}
-			Y(i,j) = -1./L(i,i) * sum;
-		}
-		for(size_t j=i+1; j<=n; j++) { //j>i
-			Y(i,j) = 0.;
-		}
-	}
-
-	//now, we backward solve UX=Y
-	Matrix& X = *this; //we write the solution over the input matrix
-	for(size_t i=n; i>=1; i--) { //lines
-		if(IOUtils::checkEpsilonEquality(U(i,i), 0., epsilon)) { //actually, only U(n,n) needs checking
-			return false;
-		}
-		for(size_t j=1; j<=n; j++) { //lines
-			double sum=0.;
-			for(size_t k=i+1; k<=n; k++) {
-				sum += U(i,k) * X(k,j);
-			}
-			X(i,j) = (Y(i,j) - sum) / U(i,i);
-		}
-	}
-
+	//we solve AX=I with X=A-1, the solution is written over the input matrix
+	identity(LU.nrows, 1.);
+	LUsolve(LU, pivot_idx, *this);
 	return true;
 }
 
-bool Matrix::solve(const Matrix& A, const Matrix& B, Matrix& X) {
-//This uses an LU decomposition followed by backward and forward solving for A·X=B
-	size_t Anrows,Ancols, Bnrows, Bncols;
-	A.size(Anrows, Ancols);
-	if(Anrows!=Ancols) {
+void Matrix::checkSolveDimensions(const Matrix& A, const Matrix& B) {
+	if(A.nrows!=A.ncols) {
 		std::ostringstream tmp;
 		tmp << "Trying to solve A·X=B with A non square matrix ";
-		tmp << "(" << Anrows << "," << Ancols << ") !";
+		tmp << "(" << A.nrows << "," << A.ncols << ") !";
 		throw IOException(tmp.str(), AT);
 	}
-	B.size(Bnrows, Bncols);
-	if(Anrows!=Bnrows)  {
+	if(A.nrows!=B.nrows)  {
 		std::ostringstream tmp;
 		tmp << "Trying to solve A·X=B with A and B of incompatible dimensions ";
-		tmp << "(" << Anrows << "," << Ancols << ") and (";
-		tmp << "(" << Bnrows << "," << Bncols << ") !";
+		tmp << "(" << A.nrows << "," << A.ncols << ") and (";
+		tmp << "(" << B.nrows << "," << B.ncols << ") !";
 		throw IOException(tmp.str(), AT);
 	}
-	const size_t n = Anrows;
-	const size_t m = Bncols;
+}
 
-	Matrix U;
-	Matrix L;
-	if(A.LU(L, U)==false) {
+bool Matrix::solve(const Matrix& A, const Matrix& B, Matrix& X) {
+//This uses an LU decomposition followed by backward and forward solving for A·X=B
+	checkSolveDimensions(A, B);
+
+	Matrix LU(A);
+	std::vector<size_t> pivot_idx;
+	if(LU.LUdecomposition(pivot_idx)==false) {
 		return false;
 	}
 
-	//we solve AX=B. Since A=LU, then LUX = B
-	//we start by forward solving LY=B with Y=UX
-	Matrix Y(n, m);
-	for(size_t i=1; i<=n; i++) {
-		if(IOUtils::checkEpsilonEquality(L(i,i), 0., epsilon)) {
-			return false;
-		}
-		for(size_t j=1; j<=m; j++) {
-			double sum=0.;
-			for(size_t k=1; k<i; k++) {
-				sum += L(i,k) * Y(k,j);
+	X = B;
+	LUsolve(LU, pivot_idx, X);
+	return true;
+}
+
+Matrix Matrix::solve(const Matrix& A, const Matrix& B) {
+//This uses an LU decomposition followed by backward and forward solving for A·X=B
+	Matrix X;
+	if(!solve(A, B, X))
+		throw IOException("Matrix inversion failed!", AT);
+	return X;
+}
+
+bool Matrix::LUdecomposition(std::vector<size_t>& pivot_idx) {
+//Doolittle algorithm with partial pivoting, working directly on the row major storage
+	if(nrows!=ncols) {
+		std::ostringstream tmp;
+		tmp << "Trying to calculate the LU decomposition of a non-square matrix ";
+		tmp << "(" << nrows << "," << ncols << ") !";
+		throw IOException(tmp.str(), AT);
+	}
+
+	const size_t n = nrows;
+	pivot_idx.resize(n);
+	double* a = (n>0)? &vecData[0] : NULL;
+
+	for(size_t k=0; k<n; k++) {
+		//find the pivot
+		size_t p = k;
+		double max_val = fabs(a[k*n+k]);
+		for(size_t i=k+1; i<n; i++) {
+			const double val = fabs(a[i*n+k]);
+			if(val>max_val) {
+				max_val = val;
+				p = i;
 			}
-			Y(i,j) = (B(i,j) - sum) / L(i,i);
+		}
+		if(max_val<epsilon) return false; //singular matrix
+		pivot_idx[k] = p;
+		if(p!=k) std::swap_ranges(a+k*n, a+(k+1)*n, a+p*n);
+
+		//eliminate below the pivot
+		const double* Ak = a + k*n;
+		const double inv_pivot = 1./Ak[k];
+		for(size_t i=k+1; i<n; i++) {
+			double* Ai = a + i*n;
+			const double l = (Ai[k] *= inv_pivot);
+			if(l==0.) continue;
+			for(size_t j=k+1; j<n; j++)
+				Ai[j] -= l * Ak[j];
 		}
 	}
 
-	//now, we backward solve UX=Y
-	X.resize(n,m); //we need to ensure that X has the correct dimensions
-	for(size_t i=n; i>=1; i--) { //lines
-		if(IOUtils::checkEpsilonEquality(U(i,i), 0., epsilon)) { //actually, only U(n,n) needs checking
-			//singular matrix
-			return false;
+	return true;
+}
+
+void Matrix::LUsolve(const Matrix& LU, const std::vector<size_t>& pivot_idx, Matrix& X) {
+	checkSolveDimensions(LU, X);
+	const size_t n = LU.nrows;
+	const size_t m = X.ncols;
+	if(pivot_idx.size()!=n)
+		throw InvalidArgumentException("The pivots do not match the LU decomposition", AT);
+	if(n==0 || m==0) return;
+
+	const double* lu = &LU.vecData[0];
+	double* x = &X.vecData[0];
+
+	//apply the permutations
+	for(size_t k=0; k<n; k++) {
+		if(pivot_idx[k]!=k) std::swap_ranges(x+k*m, x+(k+1)*m, x+pivot_idx[k]*m);
+	}
+
+	//forward solve L·Y=B (L has a unit diagonal)
+	for(size_t i=1; i<n; i++) {
+		double* Xi = x + i*m;
+		for(size_t p=0; p<i; p++) {
+			const double l = lu[i*n+p];
+			if(l==0.) continue;
+			const double* Xp = x + p*m;
+			for(size_t j=0; j<m; j++) Xi[j] -= l * Xp[j];
 		}
-		for(size_t j=1; j<=m; j++) {
-			double sum = 0.;
-			for(size_t k=i+1; k<=n; k++) {
-				sum += U(i,k) * X(k,j);
-			}
-			X(i,j) = (Y(i,j) - sum) / U(i,i);
+	}
+
+	//backward solve U·X=Y
+	for(size_t i=n; i-- > 0; ) {
+		double* Xi = x + i*m;
+		for(size_t p=i+1; p<n; p++) {
+			const double u = lu[i*n+p];
+			if(u==0.) continue;
+			const double* Xp = x + p*m;
+			for(size_t j=0; j<m; j++) Xi[j] -= u * Xp[j];
 		}
+		const double inv_diag = 1./lu[i*n+i];
+		for(size_t j=0; j<m; j++) Xi[j] *= inv_diag;
 	}
+}
+
+bool Matrix::choleskyDecomposition() {
+	if(nrows!=ncols) {
+		std::ostringstream tmp;
+		tmp << "Trying to calculate the Cholesky decomposition of a non-square matrix ";
+		tmp << "(" << nrows << "," << ncols << ") !";
+		throw IOException(tmp.str(), AT);
+	}
+
+	const size_t n = nrows;
+	if(n==0) return true;
+	double* a = &vecData[0];
+
+#ifdef BLAS
+	//the lower half of the row major matrix is the upper half of the column major one
+	const int N = (int)n;
+	int info = 0;
+	dpotrf_("U", &N, a, &N, &info);
+	if(info!=0) return false;
+	for(size_t j=0; j<n; j++) {
+		if(a[j*n+j]*a[j*n+j]<=epsilon) return false; //same criteria as the embedded implementation
+	}
+#else
+	for(size_t j=0; j<n; j++) {
+		double* Aj = a + j*n;
+		double d = Aj[j];
+		for(size_t p=0; p<j; p++) d -= Aj[p]*Aj[p];
+		if(d<=epsilon) return false; //not positive definite
+		const double l_jj = sqrt(d);
+		Aj[j] = l_jj;
+
+		const double inv_l_jj = 1./l_jj;
+		for(size_t i=j+1; i<n; i++) {
+			double* Ai = a + i*n;
+			double sum = Ai[j];
+			for(size_t p=0; p<j; p++) sum -= Ai[p]*Aj[p];
+			Ai[j] = sum * inv_l_jj;
+		}
+	}
+#endif
+
+	//clean the upper half
+	for(size_t i=0; i<n; i++)
+		for(size_t j=i+1; j<n; j++)
+			a[i*n+j] = 0.;
 
 	return true;
 }
 
-Matrix Matrix::solve(const Matrix& A, const Matrix& B) {
-//This uses an LU decomposition followed by backward and forward solving for A·X=B
-	Matrix X;
-	if(!solve(A, B, X))
-		throw IOException("Matrix inversion failed!", AT);
-	return X;
+void Matrix::choleskySolve(const Matrix& L, Matrix& X) {
+	checkSolveDimensions(L, X);
+	const size_t n = L.nrows;
+	const size_t m = X.ncols;
+	if(n==0 || m==0) return;
+
+	const double* l = &L.vecData[0];
+	double* x = &X.vecData[0];
+
+	//forward solve L·Y=B
+	for(size_t i=0; i<n; i++) {
+		double* Xi = x + i*m;
+		for(size_t p=0; p<i; p++) {
+			const double l_ip = l[i*n+p];
+			const double* Xp = x + p*m;
+			for(size_t j=0; j<m; j++) Xi[j] -= l_ip * Xp[j];
+		}
+		const double inv_diag = 1./l[i*n+i];
+		for(size_t j=0; j<m; j++) Xi[j] *= inv_diag;
+	}
+
+	//backward solve L^T·X=Y
+	for(size_t i=n; i-- > 0; ) {
+		double* Xi = x + i*m;
+		for(size_t p=i+1; p<n; p++) {
+			const double l_pi = l[p*n+i];
+			const double* Xp = x + p*m;
+			for(size_t j=0; j<m; j++) Xi[j] -= l_pi * Xp[j];
+		}
+		const double inv_diag = 1./l[i*n+i];
+		for(size_t j=0; j<m; j++) Xi[j] *= inv_diag;
+	}
 }
 
 bool Matrix::TDMA_solve(const Matrix& A, const Matrix& B, Matrix& X)
@@ -33,8 +33,15 @@ namespace mio {
  * first line. Index go from 1 to nrows/ncols.
  *
  * It might not be the best ever such implementation, but the goal is to provide a standalone matrix class.
- * It might be later possible to chose between using the embedded implementation or to act as a
- * front end to BLAS for those who have it installed on their system.
+ * The heavy operations (matrix products, factorizations) work directly on the underlying storage with
+ * cache-blocked loops. If the compilation flag BLAS is used (this is set by cmake when the BLAS option is
+ * turned on and a system BLAS/LAPACK has been found), the matrix products and the Cholesky factorization are
+ * delegated to BLAS/LAPACK.
+ *
+ * When the same system has to be solved for several right hand sides (or several times), the factorizations
+ * can be computed once in place (see LUdecomposition() and choleskyDecomposition()) and reused by LUsolve()
+ * and choleskySolve(). Similarly, the products multiply() and multiplyAtB() write into a provided matrix so no
+ * temporaries are created (for example A<sup>T</sup>·A is computed without building the transposed matrix).
  *
  * If the compilation flag NOSAFECHECKS is used, bounds check is turned off (leading to increased performances).
  *
@@ -118,6 +125,24 @@ class Matrix {
 		*/
 		static double dot(const Matrix& A, const Matrix& B);
 
+		/**
+		* @brief Matrix product C = A·B.
+		* This does not allocate any temporary, C is resized if necessary.
+		* @param A A matrix
+		* @param B B matrix
+		* @param C result, it can not be the same object as A or B
+		*/
+		static void multiply(const Matrix& A, const Matrix& B, Matrix& C);
+
+		/**
+		* @brief Matrix product C = A<sup>T</sup>·B, computed without building the transpose of A.
+		* If A and B are the same object, the result is symmetric and only half of it is computed.
+		* @param A A matrix
+		* @param B B matrix
+		* @param C result, it can not be the same object as A or B
+		*/
+		static void multiplyAtB(const Matrix& A, const Matrix& B, Matrix& C);
+
 		/**
 		* @brief matrix transpose.
 		* @return transposed matrix
@@ -199,6 +224,38 @@ class Matrix {
 		*/
 		bool LU(Matrix& L, Matrix& U) const;
 
+		/**
+		* @brief in place LU decomposition with partial pivoting.
+		* The matrix is replaced by its L and U factors (L has a unit diagonal that is not stored), so that P·A = L·U.
+		* The decomposition can then be used as many times as necessary with LUsolve().
+		* @param pivot_idx row permutations: at step k, row k has been exchanged with row pivot_idx[k] (0 based)
+		* @return false if the matrix is singular (the matrix content is then undefined)
+		*/
+		bool LUdecomposition(std::vector<size_t>& pivot_idx);
+
+		/**
+		* @brief solve A·X=B, A being given by its LU decomposition (see LUdecomposition()).
+		* @param LU LU decomposition of A
+		* @param pivot_idx row permutations as returned by LUdecomposition()
+		* @param X contains B when calling, overwritten with the solution
+		*/
+		static void LUsolve(const Matrix& LU, const std::vector<size_t>& pivot_idx, Matrix& X);
+
+		/**
+		* @brief in place Cholesky decomposition A = L·L<sup>T</sup> of a symmetric, positive definite matrix.
+		* Only the lower half of the matrix is read, the matrix is replaced by L (its upper half being set to zero).
+		* The decomposition can then be used as many times as necessary with choleskySolve().
+		* @return false if the matrix is not positive definite (the matrix content is then undefined)
+		*/
+		bool choleskyDecomposition();
+
+		/**
+		* @brief solve A·X=B, A being given by its Cholesky decomposition (see choleskyDecomposition()).
+		* @param L Cholesky decomposition of A
+		* @param X contains B when calling, overwritten with the solution
+		*/
+		static void choleskySolve(const Matrix& L, Matrix& X);
+
 		/**
 		* @brief matrix partial pivoting.
 		* This reorders the rows so that each diagonal element is the maximum in its column
@@ -254,6 +311,7 @@ class Matrix {
 		size_t ncols;
 		size_t nrows;
 
+		static void checkSolveDimensions(const Matrix& A, const Matrix& B);
 		size_t findMaxInCol(const size_t &col);
 		size_t findMaxInRow(const size_t &row);
 		void swapRows(const size_t &i1, const size_t &i2);
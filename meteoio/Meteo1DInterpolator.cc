@@ -16,6 +16,7 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/Meteo1DInterpolator.h>
+#include <meteoio/Profiler.h>
 
 using namespace std;
 
@@ -58,6 +59,7 @@ void Meteo1DInterpolator::getWindowSize(ProcessingProperties& o_properties) cons
 
 bool Meteo1DInterpolator::resampleData(const Date& date, const std::vector<MeteoData>& vecM, MeteoData& md)
 {
+	MIO_PROFILE("Meteo1DInterpolator::resampleData");
 	if (vecM.empty()) //Deal with case of the empty vector
 		return false; //nothing left to do
 
@@ -17,6 +17,7 @@
 */
 
 #include <meteoio/Meteo2DInterpolator.h>
+#include <meteoio/Profiler.h>
 
 using namespace std;
 
@@ -24,7 +25,7 @@ namespace mio {
 
 Meteo2DInterpolator::Meteo2DInterpolator(const Config& i_cfg, IOManager& i_iom)
                     : cfg(i_cfg), iomanager(&i_iom), mapBufferedGrids(), IndexBufferedGrids(),
-                      mapAlgorithms(), max_grids(10), algorithms_ready(false)
+                      mapAlgorithms(), max_grids(10), grids_float32(false), grids_stats("interpolated grids"), mutex(), algorithms_ready(false)
 {
 	setDfltBufferProperties();
 	setAlgorithms();
@@ -32,7 +33,7 @@ Meteo2DInterpolator::Meteo2DInterpolator(const Config& i_cfg, IOManager& i_iom)
 
 Meteo2DInterpolator::Meteo2DInterpolator(const Config& i_cfg)
                     : cfg(i_cfg), iomanager(NULL), mapBufferedGrids(), IndexBufferedGrids(),
-                      mapAlgorithms(), max_grids(10), algorithms_ready(false)
+                      mapAlgorithms(), max_grids(10), grids_float32(false), grids_stats("interpolated grids"), mutex(), algorithms_ready(false)
 {
 	setDfltBufferProperties();
 	//setAlgorithms(); we can not call it since we don't have an iomanager yet!
@@ -40,23 +41,16 @@ Meteo2DInterpolator::Meteo2DInterpolator(const Config& i_cfg)
 
 Meteo2DInterpolator::Meteo2DInterpolator(const Meteo2DInterpolator& c)
                     : cfg(c.cfg), iomanager(c.iomanager), mapBufferedGrids(c.mapBufferedGrids), IndexBufferedGrids(c.IndexBufferedGrids),
-                      mapAlgorithms(c.mapAlgorithms), max_grids(c.max_grids), algorithms_ready(c.algorithms_ready) {}
+                      mapAlgorithms(c.mapAlgorithms), max_grids(c.max_grids), grids_float32(c.grids_float32), grids_stats(c.grids_stats), mutex(), algorithms_ready(c.algorithms_ready) {}
 
-Meteo2DInterpolator::~Meteo2DInterpolator()
-{
-	std::map<std::string, std::vector<InterpolationAlgorithm*> >::iterator iter;
-	for (iter = mapAlgorithms.begin(); iter != mapAlgorithms.end(); ++iter) {
-		const vector<InterpolationAlgorithm*>& vecAlgs = iter->second;
-		for (size_t ii=0; ii<vecAlgs.size(); ++ii)
-			delete vecAlgs[ii];
-	}
-}
+Meteo2DInterpolator::~Meteo2DInterpolator() {}
 
 Meteo2DInterpolator& Meteo2DInterpolator::operator=(const Meteo2DInterpolator& source)
 {
 	//since this uses an IOManager on a given machine/node, since the pointers point to entry points
 	//in the compiled code, they should remain valid and therefore can be copied
 	if (this != &source) {
+		ScopedLock lock(mutex);
 		//cfg: can not be copied
 		iomanager = source.iomanager;
 		mapBufferedGrids = source.mapBufferedGrids;
@@ -64,6 +58,8 @@ Meteo2DInterpolator& Meteo2DInterpolator::operator=(const Meteo2DInterpolator& s
 		mapAlgorithms = source.mapAlgorithms;
 		algorithms_ready = source.algorithms_ready;
 		max_grids = source.max_grids;
+		grids_float32 = source.grids_float32;
+		grids_stats = source.grids_stats;
 	}
 	return *this;
 }
@@ -72,40 +68,73 @@ void Meteo2DInterpolator::setDfltBufferProperties()
 {
 	max_grids = 10; //default number of grids to keep in buffer
 	cfg.getValue("BUFF_GRIDS", "Interpolations2D", max_grids, IOUtils::nothrow);
+	grids_float32 = false;
+	cfg.getValue("BUFF_GRIDS_FLOAT32", "Interpolations2D", grids_float32, IOUtils::nothrow);
+
+	double max_memory = 0.; //in MB
+	cfg.getValue("BUFF_GRIDS_MEMORY", "Interpolations2D", max_memory, IOUtils::nothrow);
+	if (max_memory<0.) throw InvalidArgumentException("BUFF_GRIDS_MEMORY can not be negative", AT);
+	grids_stats.max_bytes = static_cast<size_t>(max_memory*1024.*1024.);
 }
 
 void Meteo2DInterpolator::addToBuffer(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam, const Grid2DObject& grid)
 {
 	if (max_grids==0) return;
 
-	if (IndexBufferedGrids.size() >= max_grids) { //we need to remove the oldest grid
-		mapBufferedGrids.erase( mapBufferedGrids.find( IndexBufferedGrids.front() ) );
+	const std::string grid_hash( getGridHash(date, dem, meteoparam) );
+	if (mapBufferedGrids.find(grid_hash) != mapBufferedGrids.end()) return; //computed at the same time by another thread
+
+	const CompactGrid<Grid2DObject> compact_grid(grid, grids_float32);
+	const size_t grid_size = compact_grid.getMemorySize();
+	//we need to remove the oldest grids, but the new one is always kept
+	while (!IndexBufferedGrids.empty()
+	       && (IndexBufferedGrids.size()>=max_grids || (grids_stats.max_bytes>0 && grids_stats.bytes+grid_size>grids_stats.max_bytes))) {
+		const std::map<std::string, CompactGrid<Grid2DObject> >::iterator it = mapBufferedGrids.find( IndexBufferedGrids.front() );
+		grids_stats.bytes -= it->second.getMemorySize();
+		grids_stats.evictions++;
+		mapBufferedGrids.erase( it );
 		IndexBufferedGrids.erase( IndexBufferedGrids.begin() );
 	}
 
-	std::ostringstream ss;
-	ss << dem.getNx() << "x" << dem.getNy() << " @" << dem.cellsize << "::" << date.toString(Date::ISO) << "::" << MeteoData::getParameterName(meteoparam);
-	mapBufferedGrids[ ss.str() ] = grid;
-	IndexBufferedGrids.push_back( ss.str()  );
+	mapBufferedGrids[ grid_hash ] = compact_grid;
+	IndexBufferedGrids.push_back( grid_hash );
+	grids_stats.bytes += grid_size;
+	grids_stats.items = IndexBufferedGrids.size();
 }
 
-bool Meteo2DInterpolator::getFromBuffer(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam, Grid2DObject& grid) const
+bool Meteo2DInterpolator::getFromBuffer(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam, Grid2DObject& grid)
 {
-	if (IndexBufferedGrids.empty())
-		return false;
+	if (max_grids==0) return false;
 
-	std::ostringstream ss;
-	ss << dem.getNx() << "x" << dem.getNy() << " @" << dem.cellsize << "::" << date.toString(Date::ISO) << "::" << MeteoData::getParameterName(meteoparam);
-	const std::map<std::string, Grid2DObject>::const_iterator it = mapBufferedGrids.find( ss.str() );
+	const std::map<std::string, CompactGrid<Grid2DObject> >::const_iterator it = mapBufferedGrids.find( getGridHash(date, dem, meteoparam) );
 	if (it != mapBufferedGrids.end()) { //already in map
-		grid = (*it).second;
+		(*it).second.get(grid);
+		grids_stats.hits++;
 		return true;
 	}
 
+	grids_stats.misses++;
 	return false;
 }
 
+const CacheStats Meteo2DInterpolator::getCacheStats() const
+{
+	ScopedLock lock(mutex);
+	return grids_stats;
+}
+
+std::string Meteo2DInterpolator::getGridHash(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam)
+{
+	char date_str[Date::max_str_len];
+	date.toString(Date::ISO, date_str, Date::max_str_len);
+
+	std::ostringstream ss;
+	ss << dem.getNx() << "x" << dem.getNy() << " @" << dem.cellsize << "::" << date_str << "::" << MeteoData::getParameterName(meteoparam);
+	return ss.str();
+}
+
 void Meteo2DInterpolator::setIOManager(IOManager& i_iomanager) {
+	ScopedLock lock(mutex);
 	iomanager = &i_iomanager;
 }
 
@@ -125,15 +154,15 @@ void Meteo2DInterpolator::setAlgorithms()
 		std::vector<std::string> tmpAlgorithms;
 		const size_t nrOfAlgorithms = getAlgorithmsForParameter(cfg, parname, tmpAlgorithms);
 
-		std::vector<InterpolationAlgorithm*> vecAlgorithms(nrOfAlgorithms);
+		//the algorithms are instantiated for each interpolation, this only checks their arguments
 		for (size_t jj=0; jj<nrOfAlgorithms; jj++) {
 			std::vector<std::string> vecArgs;
 			getArgumentsForAlgorithm(parname, tmpAlgorithms[jj], vecArgs);
-			vecAlgorithms[jj] = AlgorithmFactory::getAlgorithm( tmpAlgorithms[jj], *this, vecArgs, *iomanager);
+			delete AlgorithmFactory::getAlgorithm( tmpAlgorithms[jj], *this, vecArgs, *iomanager);
 		}
 
 		if (nrOfAlgorithms>0) {
-			mapAlgorithms[parname] = vecAlgorithms;
+			mapAlgorithms[parname] = tmpAlgorithms;
 		}
 	}
 	algorithms_ready = true;
@@ -166,31 +195,40 @@ void Meteo2DInterpolator::interpolate(const Date& date, const DEMObject& dem, co
 void Meteo2DInterpolator::interpolate(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam,
                                       Grid2DObject& result, std::string& InfoString)
 {
-	if (iomanager==NULL)
-		throw IOException("No IOManager reference has been set!", AT);
-	if (!algorithms_ready)
-		setAlgorithms();
-
-	//Get grid from buffer if it exists
-	if (getFromBuffer(date, dem, meteoparam, result))
-		return;
-
-	//Show algorithms to be used for this parameter
 	const string param_name = MeteoData::getParameterName(meteoparam);
-	const map<string, vector<InterpolationAlgorithm*> >::iterator it = mapAlgorithms.find(param_name);
-	if (it==mapAlgorithms.end()) {
-		throw IOException("No interpolation algorithms configured for parameter "+param_name, AT);
+	std::vector<std::string> vecAlgorithms;
+	{
+		ScopedLock lock(mutex); //only the buffer and the list of algorithms are shared between the interpolations
+		if (iomanager==NULL)
+			throw IOException("No IOManager reference has been set!", AT);
+		if (!algorithms_ready)
+			setAlgorithms();
+
+		//Get grid from buffer if it exists
+		if (getFromBuffer(date, dem, meteoparam, result))
+			return;
+
+		const map<string, vector<string> >::const_iterator it = mapAlgorithms.find(param_name);
+		if (it==mapAlgorithms.end()) {
+			throw IOException("No interpolation algorithms configured for parameter "+param_name, AT);
+		}
+		vecAlgorithms = it->second;
 	}
+	MIO_PROFILE("Meteo2DInterpolator::interpolate");
 
-	//look for algorithm with the highest quality rating
-	const vector<InterpolationAlgorithm*>& vecAlgs = it->second;
+	//look for algorithm with the highest quality rating. The algorithms keep the state of the interpolation,
+	//so each interpolation uses its own instances and several interpolations can run at the same time
+	std::auto_ptr<InterpolationAlgorithm> bestalgorithm;
 	double maxQualityRating = -1.;
-	size_t bestalgorithm = 0;
-	for (size_t ii=0; ii < vecAlgs.size(); ++ii){
-		const double rating = vecAlgs[ii]->getQualityRating(date, meteoparam);
+	for (size_t ii=0; ii < vecAlgorithms.size(); ++ii){
+		std::vector<std::string> vecArgs;
+		getArgumentsForAlgorithm(param_name, vecAlgorithms[ii], vecArgs);
+		std::auto_ptr<InterpolationAlgorithm> algorithm( AlgorithmFactory::getAlgorithm(vecAlgorithms[ii], *this, vecArgs, *iomanager) );
+		MIO_PROFILE(algorithm->algo+"::getQualityRating");
+		const double rating = algorithm->getQualityRating(date, meteoparam);
 		if ((rating != 0.0) && (rating > maxQualityRating)) {
 			//we use ">" so that in case of equality, the first choice will be kept
-			bestalgorithm = ii;
+			bestalgorithm = algorithm;
 			maxQualityRating = rating;
 		}
 	}
@@ -198,8 +236,11 @@ void Meteo2DInterpolator::interpolate(const Date& date, const DEMObject& dem, co
 	//finally execute the algorithm with the best quality rating or throw an exception
 	if (maxQualityRating<=0.0)
 		throw IOException("No interpolation algorithm with quality rating >0 found for parameter "+param_name+" on "+date.toString(Date::ISO_TZ), AT);
-	vecAlgs[bestalgorithm]->calculate(dem, result);
-	InfoString = vecAlgs[bestalgorithm]->getInfo();
+	{
+		MIO_PROFILE(bestalgorithm->algo+"::calculate");
+		bestalgorithm->calculate(dem, result);
+	}
+	InfoString = bestalgorithm->getInfo();
 
 	//Run soft min/max filter for RH, HNW and HS
 	if (meteoparam == MeteoData::RH){
@@ -212,10 +253,10 @@ void Meteo2DInterpolator::interpolate(const Date& date, const DEMObject& dem, co
 		Meteo2DInterpolator::checkMinMax(0.0, 10000.0, result);
 	}
 
+	ScopedLock lock(mutex);
 	addToBuffer(date, dem, meteoparam, result);
 }
 
-//HACK make sure that skip_virtual_stations = true before calling this method when using virtual stations!
 void Meteo2DInterpolator::interpolate(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam,
                             const std::vector<Coords>& in_coords, const bool& use_full_dem, std::vector<double>& result, std::string& info_string)
 {
@@ -328,24 +369,25 @@ void Meteo2DInterpolator::check_projections(const DEMObject& dem, const std::vec
 
 
 const std::string Meteo2DInterpolator::toString() const {
+	ScopedLock lock(mutex);
 	ostringstream os;
 	os << "<Meteo2DInterpolator>\n";
 	os << "Config& cfg = " << hex << &cfg << dec << "\n";
 	os << "IOManager& iomanager = "  << hex << &iomanager << dec << "\n";
 
 	os << "Spatial resampling algorithms:\n";
-	std::map<std::string, std::vector<InterpolationAlgorithm*> >::const_iterator iter;
+	std::map<std::string, std::vector<std::string> >::const_iterator iter;
 	for (iter = mapAlgorithms.begin(); iter != mapAlgorithms.end(); ++iter) {
 		os << setw(10) << iter->first << "::";
 		for (size_t jj=0; jj<iter->second.size(); jj++) {
-			os << iter->second[jj]->algo << " ";
+			os << iter->second[jj] << " ";
 		}
 		os << "\n";
 	}
 
 	//cache content
 	os << "Current buffer content (" << mapBufferedGrids.size() << " grids):\n";
-	std::map<std::string, Grid2DObject>::const_iterator it1;
+	std::map<std::string, CompactGrid<Grid2DObject> >::const_iterator it1;
 	for (it1=mapBufferedGrids.begin(); it1 != mapBufferedGrids.end(); ++it1){
 		os << setw(10) << "Grid " << it1->first << "\n";
 	}
@@ -24,6 +24,9 @@
 #include <meteoio/MeteoData.h>
 #include <meteoio/DEMObject.h>
 #include <meteoio/InterpolationAlgorithms.h>
+#include <meteoio/CacheStats.h>
+#include <meteoio/CompactGrid.h>
+#include <meteoio/Mutex.h>
 
 #include <memory>
 #include <vector>
@@ -74,6 +77,10 @@ class IOManager; //forward declaration
  * interpolation process (such as a regression coefficient or error estimate) to the InterpolationAlgorithm::info
  * stringstream (which will be made available to external programs, such as GUIs).
  *
+ * A new instance of the algorithm is created for each interpolation, so the algorithm can keep the state of the interpolation
+ * in its members. But several interpolations may run at the same time in different threads, so the algorithm must not
+ * modify any static or shared data.
+ *
  * The new class and its associated end user key must be used and its constructor called in AlgorithmFactory::getAlgorithm.
  * It is recommended that any generic statistical
  * spatial processing be implemented as a static class in libinterpol2D.cc so that it could be reused by other
@@ -90,6 +97,13 @@ class IOManager; //forward declaration
 /**
  * @class Meteo2DInterpolator
  * @brief A class to spatially interpolate meteo parameters. For more, see \ref interpol2d
+ * The interpolated grids are kept in a buffer, so requesting the same grid again does not trigger a new interpolation.
+ * This buffer is configured with the following keys in the [Interpolations2D] section:
+ * - BUFF_GRIDS: how many grids to keep (10 by default, 0 means no buffering);
+ * - BUFF_GRIDS_MEMORY: maximum memory (in MB) used by the buffered grids, the oldest ones being removed when it is
+ *                      exceeded. Optional, no limit by default.
+ * - BUFF_GRIDS_FLOAT32: keep the buffered grids in single precision, which halves the memory they use (the interpolations
+ *                       themselves are still computed in double precision). Optional, false by default.
  *
  * @ingroup stats
  * @author Mathias Bavay and Thomas Egger
@@ -156,23 +170,33 @@ class Meteo2DInterpolator {
 		Meteo2DInterpolator& operator=(const Meteo2DInterpolator& source);
 		const std::string toString() const;
 
+		/**
+		 * @brief Get the usage statistics of the interpolated grids buffer
+		 * @return statistics of the buffer
+		 */
+		const CacheStats getCacheStats() const;
+
 	private:
 		static void checkMinMax(const double& minval, const double& maxval, Grid2DObject& gridobj);
 		static void check_projections(const DEMObject& dem, const std::vector<MeteoData>& vec_meteo);
 		static size_t get_parameters(const Config& cfg, std::set<std::string>& set_parameters);
 		static size_t getAlgorithmsForParameter(const Config& cfg, const std::string& parname, std::vector<std::string>& vecAlgorithms);
 
+		static std::string getGridHash(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam);
 		void addToBuffer(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam, const Grid2DObject& grid);
-		bool getFromBuffer(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam, Grid2DObject& grid) const;
+		bool getFromBuffer(const Date& date, const DEMObject& dem, const MeteoData::Parameters& meteoparam, Grid2DObject& grid);
 		void setDfltBufferProperties();
 		void setAlgorithms();
 
 		const Config& cfg; ///< Reference to Config object, initialized during construction
 		IOManager *iomanager; ///< Reference to IOManager object, used for callbacks, initialized during construction
-		std::map<std::string, Grid2DObject> mapBufferedGrids; ///< Buffer interpolated grids
+		std::map<std::string, CompactGrid<Grid2DObject> > mapBufferedGrids; ///< Buffer interpolated grids
 		std::vector<std::string> IndexBufferedGrids; ///< Keep position information for easy erase fo specific grids
-		std::map< std::string, std::vector<InterpolationAlgorithm*> > mapAlgorithms; //per parameter interpolation algorithms
+		std::map< std::string, std::vector<std::string> > mapAlgorithms; //per parameter interpolation algorithms
 		size_t max_grids; ///< How many grids to buffer
+		bool grids_float32; ///< keep the buffered grids in single precision?
+		CacheStats grids_stats; ///< usage of the grids buffer
+		mutable Mutex mutex; ///< protects the grids buffer, the interpolations themselves run concurrently
 		bool algorithms_ready; ///< Have the algorithms objects been constructed?
 };
 
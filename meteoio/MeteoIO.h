@@ -32,6 +32,8 @@
 #include <meteoio/Array3D.h>
 #include <meteoio/Array4D.h>
 #include <meteoio/BufferedIOHandler.h>
+#include <meteoio/CacheStats.h>
+#include <meteoio/CompactGrid.h>
 #include <meteoio/Config.h>
 #include <meteoio/Coords.h>
 #include <meteoio/DataGenerator.h>
@@ -69,17 +71,22 @@
 #include <meteoio/meteolaws/Atmosphere.h>
 #include <meteoio/meteolaws/Meteoconst.h>
 #include <meteoio/meteolaws/Sun.h>
+#include <meteoio/meteolaws/SunEphemeris.h>
 #include <meteoio/meteolaws/Suntrajectory.h>
 
 #include <meteoio/MeteoProcessor.h>
+#include <meteoio/MeteoSnapshot.h>
 //#include <meteoio/meteostats/libfit1DCore.h>
 #include <meteoio/meteostats/libfit1D.h>
 #include <meteoio/meteostats/libinterpol1D.h>
 #include <meteoio/meteostats/libinterpol2D.h>
+#include <meteoio/Mutex.h>
 
 //skip all plugins' implementations header files
 #include <meteoio/plugins/libsmet.h>
 
+#include <meteoio/PointCache.h>
+#include <meteoio/Profiler.h>
 #include <meteoio/ResamplingAlgorithms.h>
 #include <meteoio/ResamplingAlgorithms2D.h>
 #include <meteoio/StationData.h>
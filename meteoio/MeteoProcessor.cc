@@ -16,6 +16,7 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/MeteoProcessor.h>
+#include <meteoio/Profiler.h>
 
 using namespace std;
 
@@ -83,20 +84,11 @@ void MeteoProcessor::compareProperties(const ProcessingProperties& newprop, Proc
 void MeteoProcessor::process(const std::vector< std::vector<MeteoData> >& ivec,
                              std::vector< std::vector<MeteoData> >& ovec, const bool& second_pass)
 {
-	//call the different processing stacks
-	std::vector< std::vector<MeteoData> > vec_tmp;
-
-	for (map<string, ProcessingStack*>::const_iterator it=processing_stack.begin(); it != processing_stack.end(); ++it){
-		if (it==processing_stack.begin()){
-			(*(it->second)).process(ivec, ovec, second_pass);
-		} else {
-			(*(it->second)).process(vec_tmp, ovec, second_pass);
-		}
-		vec_tmp = ovec;
-	}
-
-	if (processing_stack.empty())
-		ovec = ivec;
+	MIO_PROFILE("MeteoProcessor::process");
+	//call the different processing stacks, each of them only modifies its own parameter
+	ovec = ivec;
+	for (map<string, ProcessingStack*>::const_iterator it=processing_stack.begin(); it != processing_stack.end(); ++it)
+		(*(it->second)).process(ovec, second_pass);
 }
 
 bool MeteoProcessor::resample(const Date& date, const std::vector<MeteoData>& ivec, MeteoData& md)
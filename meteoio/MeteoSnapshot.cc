@@ -0,0 +1,177 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/MeteoSnapshot.h>
+#include <meteoio/Mutex.h>
+
+using namespace std;
+
+namespace mio {
+
+const std::vector<double> MeteoSnapshot::empty_vector;
+const METEO_SET MeteoSnapshot::empty_set;
+const Date MeteoSnapshot::empty_date;
+
+static Mutex ref_count_mutex; //the snapshots can be shared by any kind of threads, not only OpenMP's
+
+MeteoSnapshot::SnapshotData::SnapshotData(const Date& i_date, const METEO_SET& i_vecMeteo)
+                           : date(i_date), vecMeteo(i_vecMeteo), columns(), eastings(), northings(), altitudes(), ref_count(1)
+{
+	const size_t nr_stations = vecMeteo.size();
+	size_t nr_params = 0;
+	for (size_t ii=0; ii<nr_stations; ii++) {
+		const size_t station_params = vecMeteo[ii].getNrOfParameters();
+		if (station_params>nr_params) nr_params = station_params;
+	}
+
+	columns.resize(nr_params, vector<double>(nr_stations, IOUtils::nodata));
+	eastings.resize(nr_stations);
+	northings.resize(nr_stations);
+	altitudes.resize(nr_stations);
+	for (size_t ii=0; ii<nr_stations; ii++) {
+		const MeteoData& md = vecMeteo[ii];
+		const size_t station_params = md.getNrOfParameters();
+		for (size_t param=0; param<station_params; param++)
+			columns[param][ii] = md(param);
+
+		const Coords& position = md.meta.position;
+		eastings[ii] = position.getEasting();
+		northings[ii] = position.getNorthing();
+		altitudes[ii] = position.getAltitude();
+	}
+}
+
+MeteoSnapshot::MeteoSnapshot() : data(NULL) {}
+
+MeteoSnapshot::MeteoSnapshot(const Date& i_date, const METEO_SET& vecMeteo)
+               : data(new SnapshotData(i_date, vecMeteo)) {}
+
+MeteoSnapshot::MeteoSnapshot(const MeteoSnapshot& source) : data(source.data)
+{
+	acquire();
+}
+
+MeteoSnapshot::~MeteoSnapshot()
+{
+	release();
+}
+
+MeteoSnapshot& MeteoSnapshot::operator=(const MeteoSnapshot& source)
+{
+	if (this!=&source && data!=source.data) {
+		release();
+		data = source.data;
+		acquire();
+	}
+	return *this;
+}
+
+//the reference counting is protected, so snapshots can be shared between threads
+void MeteoSnapshot::acquire()
+{
+	if (data==NULL) return;
+	ScopedLock lock(ref_count_mutex);
+	data->ref_count++;
+}
+
+void MeteoSnapshot::release()
+{
+	if (data==NULL) return;
+	bool last_reference;
+	{
+		ScopedLock lock(ref_count_mutex);
+		last_reference = (--(data->ref_count)==0);
+	}
+	if (last_reference) delete data;
+	data = NULL;
+}
+
+bool MeteoSnapshot::empty() const
+{
+	return (data==NULL || data->vecMeteo.empty());
+}
+
+size_t MeteoSnapshot::getNrStations() const
+{
+	return (data==NULL)? 0 : data->vecMeteo.size();
+}
+
+size_t MeteoSnapshot::getNrOfParameters() const
+{
+	return (data==NULL)? 0 : data->columns.size();
+}
+
+const Date& MeteoSnapshot::getDate() const
+{
+	return (data==NULL)? empty_date : data->date;
+}
+
+const METEO_SET& MeteoSnapshot::getMeteoData() const
+{
+	return (data==NULL)? empty_set : data->vecMeteo;
+}
+
+const MeteoData& MeteoSnapshot::operator[](const size_t& station) const
+{
+	if (station>=getNrStations())
+		throw IndexOutOfBoundsException("Trying to access a station that does not exist in the snapshot", AT);
+	return data->vecMeteo[station];
+}
+
+const StationData& MeteoSnapshot::getMeta(const size_t& station) const
+{
+	return operator[](station).meta;
+}
+
+const std::vector<double>& MeteoSnapshot::getParameter(const size_t& param) const
+{
+	if (data==NULL) return empty_vector;
+	if (param>=data->columns.size())
+		throw IndexOutOfBoundsException("Trying to access a parameter that does not exist in the snapshot", AT);
+	return data->columns[param];
+}
+
+const std::vector<double>& MeteoSnapshot::getEastings() const
+{
+	return (data==NULL)? empty_vector : data->eastings;
+}
+
+const std::vector<double>& MeteoSnapshot::getNorthings() const
+{
+	return (data==NULL)? empty_vector : data->northings;
+}
+
+const std::vector<double>& MeteoSnapshot::getAltitudes() const
+{
+	return (data==NULL)? empty_vector : data->altitudes;
+}
+
+const std::string MeteoSnapshot::toString() const
+{
+	std::ostringstream os;
+	os << "<MeteoSnapshot>\n";
+	if (data==NULL) {
+		os << "empty\n";
+	} else {
+		os << data->date.toString(Date::ISO) << " - " << getNrStations() << " station(s), ";
+		os << getNrOfParameters() << " parameter(s), shared " << data->ref_count << " time(s)\n";
+	}
+	os << "</MeteoSnapshot>\n";
+	return os.str();
+}
+
+} //namespace
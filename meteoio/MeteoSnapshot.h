@@ -0,0 +1,109 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __METEOSNAPSHOT_H__
+#define __METEOSNAPSHOT_H__
+
+#include <meteoio/MeteoData.h>
+#include <meteoio/Date.h>
+
+#include <vector>
+
+namespace mio {
+
+/**
+ * @class MeteoSnapshot
+ * @brief An immutable view of all the stations' data at one point in time.
+ * Besides the METEO_SET itself, the snapshot contains the data reorganized as one array per meteo parameter
+ * (with IOUtils::nodata for the stations that don't provide it) as well as the stations' eastings, northings
+ * and altitudes, all indexed by station. The underlying data is reference counted, so copying a snapshot
+ * (for example when the IOManager returns it out of its cache) does not copy any data. Since the data can
+ * not be modified once built, all copies can safely be read at the same time by the various interpolation
+ * algorithms, including from several threads (the reference counting is protected).
+ *
+ * @ingroup data_str
+ * @date   2014-03-18
+ */
+class MeteoSnapshot {
+	public:
+		/**
+		* @brief The default constructor builds an empty snapshot
+		*/
+		MeteoSnapshot();
+
+		/**
+		* @brief Build a snapshot of the provided stations' data
+		* @param i_date date of the snapshot
+		* @param vecMeteo data of all the stations at this date
+		*/
+		MeteoSnapshot(const Date& i_date, const METEO_SET& vecMeteo);
+
+		MeteoSnapshot(const MeteoSnapshot& source);
+		~MeteoSnapshot();
+		MeteoSnapshot& operator=(const MeteoSnapshot& source);
+
+		bool empty() const;
+		size_t getNrStations() const;
+
+		/**
+		* @brief Returns the number of parameters that are available as columns.
+		* This is the largest number of parameters found among the stations (extra parameters included).
+		* @return number of parameters
+		*/
+		size_t getNrOfParameters() const;
+
+		const Date& getDate() const;
+		const METEO_SET& getMeteoData() const;
+		const MeteoData& operator[](const size_t& station) const;
+		const StationData& getMeta(const size_t& station) const;
+
+		/**
+		* @brief Returns the values of one parameter for all stations
+		* @param param index of the parameter (see MeteoData::Parameters)
+		* @return one value per station, IOUtils::nodata if missing
+		*/
+		const std::vector<double>& getParameter(const size_t& param) const;
+		const std::vector<double>& getEastings() const;
+		const std::vector<double>& getNorthings() const;
+		const std::vector<double>& getAltitudes() const;
+
+		const std::string toString() const;
+
+	private:
+		class SnapshotData {
+			public:
+				SnapshotData(const Date& i_date, const METEO_SET& i_vecMeteo);
+
+				const Date date;
+				const METEO_SET vecMeteo;
+				std::vector< std::vector<double> > columns; ///< one vector per parameter, indexed by station
+				std::vector<double> eastings, northings, altitudes;
+				size_t ref_count;
+		};
+
+		void acquire();
+		void release();
+
+		SnapshotData *data;
+		static const std::vector<double> empty_vector;
+		static const METEO_SET empty_set;
+		static const Date empty_date;
+};
+
+} //end namespace
+
+#endif
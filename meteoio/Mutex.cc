@@ -0,0 +1,155 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/Mutex.h>
+
+#if defined _WIN32 || defined __MINGW32__
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
+
+#include <meteoio/IOExceptions.h>
+
+namespace mio {
+
+//what the system's thread has to run
+typedef struct THREAD_TASK {
+	Thread::thread_function function;
+	void* arg;
+} thread_task;
+
+//the Windows critical sections are always recursive
+#if defined _WIN32 || defined __MINGW32__
+Mutex::Mutex() : handle(new CRITICAL_SECTION)
+{
+	InitializeCriticalSection( static_cast<CRITICAL_SECTION*>(handle) );
+}
+
+Mutex::~Mutex()
+{
+	DeleteCriticalSection( static_cast<CRITICAL_SECTION*>(handle) );
+	delete static_cast<CRITICAL_SECTION*>(handle);
+}
+
+void Mutex::lock()
+{
+	EnterCriticalSection( static_cast<CRITICAL_SECTION*>(handle) );
+}
+
+void Mutex::unlock()
+{
+	LeaveCriticalSection( static_cast<CRITICAL_SECTION*>(handle) );
+}
+
+static DWORD WINAPI runThread(LPVOID arg)
+{
+	const thread_task* task = static_cast<const thread_task*>(arg);
+	task->function(task->arg);
+	return 0;
+}
+
+Thread::Thread(thread_function function, void* arg) : handle(NULL), task(NULL)
+{
+	thread_task *tmp = new thread_task;
+	tmp->function = function;
+	tmp->arg = arg;
+	task = tmp;
+
+	handle = CreateThread(NULL, 0, &runThread, task, 0, NULL);
+	if (handle==NULL) {
+		delete tmp;
+		throw IOException("Could not create a thread", AT);
+	}
+}
+
+void Thread::join()
+{
+	if (handle==NULL) return;
+	WaitForSingleObject(static_cast<HANDLE>(handle), INFINITE);
+	CloseHandle(static_cast<HANDLE>(handle));
+	handle = NULL;
+	delete static_cast<thread_task*>(task);
+	task = NULL;
+}
+#else
+Mutex::Mutex() : handle(new pthread_mutex_t)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(static_cast<pthread_mutex_t*>(handle), &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+Mutex::~Mutex()
+{
+	pthread_mutex_destroy( static_cast<pthread_mutex_t*>(handle) );
+	delete static_cast<pthread_mutex_t*>(handle);
+}
+
+void Mutex::lock()
+{
+	pthread_mutex_lock( static_cast<pthread_mutex_t*>(handle) );
+}
+
+void Mutex::unlock()
+{
+	pthread_mutex_unlock( static_cast<pthread_mutex_t*>(handle) );
+}
+
+static void* runThread(void* arg)
+{
+	const thread_task* task = static_cast<const thread_task*>(arg);
+	task->function(task->arg);
+	return NULL;
+}
+
+Thread::Thread(thread_function function, void* arg) : handle(new pthread_t), task(NULL)
+{
+	thread_task *tmp = new thread_task;
+	tmp->function = function;
+	tmp->arg = arg;
+	task = tmp;
+
+	if (pthread_create(static_cast<pthread_t*>(handle), NULL, &runThread, task) != 0) {
+		delete static_cast<pthread_t*>(handle);
+		delete tmp;
+		throw IOException("Could not create a thread", AT);
+	}
+}
+
+void Thread::join()
+{
+	if (handle==NULL) return;
+	pthread_join(*static_cast<pthread_t*>(handle), NULL);
+	delete static_cast<pthread_t*>(handle);
+	handle = NULL;
+	delete static_cast<thread_task*>(task);
+	task = NULL;
+}
+#endif
+
+Thread::~Thread()
+{
+	join();
+}
+
+} //namespace
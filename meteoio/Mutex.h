@@ -0,0 +1,109 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __MUTEX_H__
+#define __MUTEX_H__
+
+namespace mio {
+
+/**
+ * @class Mutex
+ * @brief A recursive mutex, based on the system's threads (pthreads or Windows critical sections).
+ * It works with any kind of threads (OpenMP or the application's own threads) and can be locked
+ * several times by the same thread, so a locked method can call other locked methods of the same object
+ * (for example, an interpolation algorithm calling back the IOManager that is running it).
+ * It is normally used through a ScopedLock, so it gets unlocked even if an exception is thrown:
+ * @code
+ * void MyClass::myMethod() {
+ * 	ScopedLock lock(mutex);
+ * 	//...the rest of the method is protected
+ * }
+ * @endcode
+ *
+ * @ingroup data_str
+ * @date   2014-05-12
+ */
+class Mutex {
+	public:
+		Mutex();
+		~Mutex();
+
+		void lock();
+		void unlock();
+
+	private:
+		Mutex(const Mutex&); //a mutex can not be copied
+		Mutex& operator=(const Mutex&);
+
+		void *handle; ///< system's mutex, kept opaque so the system's headers don't have to be included
+};
+
+/**
+ * @class ScopedLock
+ * @brief Lock a Mutex for the lifetime of this object
+ *
+ * @ingroup data_str
+ * @date   2014-05-12
+ */
+class ScopedLock {
+	public:
+		ScopedLock(Mutex& i_mutex) : mutex(i_mutex) { mutex.lock(); }
+		~ScopedLock() { mutex.unlock(); }
+
+	private:
+		ScopedLock(const ScopedLock&);
+		ScopedLock& operator=(const ScopedLock&);
+
+		Mutex& mutex;
+};
+
+/**
+ * @class Thread
+ * @brief Run a function in a system thread (pthreads or Windows threads), in the background of the calling thread.
+ * The thread is started by the constructor and waited for by join() (or by the destructor). The function must not
+ * let any exception escape, since it could not be caught by the calling thread.
+ * @code
+ * static void work(void* arg) { ... }
+ *
+ * Thread thread(&work, &data);
+ * //...do something else meanwhile
+ * thread.join(); //data can now be used
+ * @endcode
+ *
+ * @ingroup data_str
+ * @date   2014-06-02
+ */
+class Thread {
+	public:
+		typedef void (*thread_function)(void* arg);
+
+		Thread(thread_function function, void* arg);
+		~Thread();
+
+		void join();
+
+	private:
+		Thread(const Thread&); //a thread can not be copied
+		Thread& operator=(const Thread&);
+
+		void *handle; ///< system's thread, kept opaque so the system's headers don't have to be included
+		void *task; ///< function and argument given to the system's thread
+};
+
+} //end namespace
+
+#endif
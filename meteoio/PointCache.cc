@@ -0,0 +1,316 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/PointCache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+namespace mio {
+
+const double PointCache::time_tolerance = 1./(24.*3600.); //1 second
+const size_t PointCache::min_slots = 64;
+const size_t PointCache::max_slots = 8192;
+
+static bool sortByDate(const MeteoSnapshot& snap1, const MeteoSnapshot& snap2)
+{
+	return snap1.getDate() < snap2.getDate();
+}
+
+PointCache::PointCache(const std::string& name)
+           : ring(), used(), irregular(), stats(name), origin(0.), step(0.), first_index(0) {}
+
+void PointCache::setMaxMemory(const size_t& max_bytes)
+{
+	stats.max_bytes = max_bytes;
+}
+
+const CacheStats& PointCache::getStats() const
+{
+	return stats;
+}
+
+size_t PointCache::size() const
+{
+	return stats.items;
+}
+
+//get the index of the time step matching the given date, returns false if it does not match any time step
+bool PointCache::getIndex(const double& julian, long& index) const
+{
+	if (step<=0.) return false;
+
+	const double rounded = floor( (julian-origin)/step + 0.5 );
+	if (fabs(julian - (origin + rounded*step)) > time_tolerance) return false;
+	index = static_cast<long>(rounded);
+	return true;
+}
+
+size_t PointCache::getSlot(const long& index) const
+{
+	const long nr_slots = static_cast<long>(ring.size());
+	return static_cast<size_t>( ((index % nr_slots) + nr_slots) % nr_slots );
+}
+
+const MeteoSnapshot* PointCache::find(const Date& date)
+{
+	const MeteoSnapshot* snapshot = peek(date);
+	if (snapshot) stats.hits++;
+	else stats.misses++;
+	return snapshot;
+}
+
+const MeteoSnapshot* PointCache::peek(const Date& date) const
+{
+	long index;
+	if (getIndex(date.getJulian(true), index)) {
+		if (index>=first_index && index<first_index+static_cast<long>(ring.size())) {
+			const size_t slot = getSlot(index);
+			if (used[slot]) return &ring[slot];
+		}
+		return NULL;
+	}
+
+	const std::map<Date, MeteoSnapshot>::const_iterator it = irregular.find(date);
+	if (it != irregular.end()) return &it->second;
+	return NULL;
+}
+
+void PointCache::insert(const MeteoSnapshot& snapshot)
+{
+	const double julian = snapshot.getDate().getJulian(true);
+	const size_t snapshot_size = CacheStats::getMemorySize(snapshot);
+
+	if (step<=0.) {
+		//the time step is given by the first two different dates
+		if (!irregular.empty()) {
+			const double first = irregular.begin()->first.getJulian(true);
+			if (fabs(julian-first) > time_tolerance)
+				initRing(first, fabs(julian-first), snapshot_size);
+		}
+	} else {
+		long index;
+		if (!getIndex(julian, index)) refineStep(julian);
+	}
+
+	//store the new snapshot
+	long index;
+	if (getIndex(julian, index)) {
+		moveWindow(index);
+		const size_t slot = getSlot(index);
+		if (used[slot]) {
+			stats.bytes -= CacheStats::getMemorySize(ring[slot]);
+		} else {
+			used[slot] = true;
+			stats.items++;
+		}
+		ring[slot] = snapshot;
+	} else {
+		const std::map<Date, MeteoSnapshot>::iterator it = irregular.find(snapshot.getDate());
+		if (it != irregular.end()) {
+			stats.bytes -= CacheStats::getMemorySize(it->second);
+			it->second = snapshot;
+		} else {
+			irregular[ snapshot.getDate() ] = snapshot;
+			stats.items++;
+		}
+	}
+	stats.bytes += snapshot_size;
+
+	//enforce the memory limit, the new snapshot is always kept
+	while (stats.max_bytes>0 && stats.bytes>stats.max_bytes && stats.items>1) {
+		if (!evictFurthest(julian)) break;
+	}
+}
+
+void PointCache::clear()
+{
+	//the time step is kept, it is most probably still the same
+	std::fill(ring.begin(), ring.end(), MeteoSnapshot());
+	std::fill(used.begin(), used.end(), false);
+	irregular.clear();
+	stats.items = 0;
+	stats.bytes = 0;
+}
+
+//(re)build the ring buffer for the given time step and move all the cached snapshots that fit into it
+void PointCache::initRing(const double& i_origin, const double& i_step, const size_t& snapshot_size)
+{
+	std::vector<MeteoSnapshot> vecSnapshots;
+	getSnapshots(vecSnapshots);
+	clear();
+
+	size_t nr_slots = max_slots;
+	if (stats.max_bytes>0 && snapshot_size>0)
+		nr_slots = std::min(max_slots, std::max(min_slots, stats.max_bytes/snapshot_size + 1));
+	ring.assign(nr_slots, MeteoSnapshot());
+	used.assign(nr_slots, false);
+	origin = i_origin;
+	step = i_step;
+	first_index = 0;
+
+	for (size_t ii=0; ii<vecSnapshots.size(); ii++)
+		insert(vecSnapshots[ii]); //the snapshots that don't fit in the new window are evicted
+}
+
+//if the date falls between the time steps at an integer fraction of the time step, use this smaller time step
+bool PointCache::refineStep(const double& julian)
+{
+	const double rounded = floor( (julian-origin)/step + 0.5 );
+	const double delta = fabs(julian - (origin + rounded*step));
+	const double nr_intervals = floor(step/delta + 0.5);
+	if (nr_intervals<2. || fabs(step/nr_intervals - delta) > time_tolerance) return false;
+
+	initRing(origin, step/nr_intervals, (stats.items>0)? stats.bytes/stats.items : 0);
+	return true;
+}
+
+//move the ring buffer's window so it contains the given index, evicting the time steps that fall out of it
+void PointCache::moveWindow(const long& index)
+{
+	const long nr_slots = static_cast<long>(ring.size());
+	if (index>=first_index+nr_slots) {
+		const long new_first = index - nr_slots + 1;
+		const long last_evicted = std::min(new_first, first_index+nr_slots);
+		for (long ii=first_index; ii<last_evicted; ii++) evictIndex(ii);
+		first_index = new_first;
+	} else if (index<first_index) {
+		const long new_first = index;
+		const long first_evicted = std::max(new_first+nr_slots, first_index);
+		for (long ii=first_evicted; ii<first_index+nr_slots; ii++) evictIndex(ii);
+		first_index = new_first;
+	}
+}
+
+void PointCache::evictIndex(const long& index)
+{
+	const size_t slot = getSlot(index);
+	if (!used[slot]) return;
+
+	stats.bytes -= CacheStats::getMemorySize(ring[slot]);
+	stats.items--;
+	stats.evictions++;
+	ring[slot] = MeteoSnapshot();
+	used[slot] = false;
+}
+
+//evict the snapshot that is the furthest away from the given date, returns false if there is none
+bool PointCache::evictFurthest(const double& julian)
+{
+	double max_dist = time_tolerance;
+	long ring_index = 0;
+	bool found_ring = false;
+	std::map<Date, MeteoSnapshot>::iterator irregular_it = irregular.end();
+
+	//in the ring buffer, only the first and last filled time steps are candidates
+	const long nr_slots = static_cast<long>(ring.size());
+	for (long ii=first_index; ii<first_index+nr_slots; ii++) {
+		if (!used[getSlot(ii)]) continue;
+		const double dist = fabs(origin + static_cast<double>(ii)*step - julian);
+		if (dist>max_dist) { max_dist = dist; ring_index = ii; found_ring = true; }
+		break;
+	}
+	for (long ii=first_index+nr_slots-1; ii>=first_index; ii--) {
+		if (!used[getSlot(ii)]) continue;
+		const double dist = fabs(origin + static_cast<double>(ii)*step - julian);
+		if (dist>max_dist) { max_dist = dist; ring_index = ii; found_ring = true; }
+		break;
+	}
+
+	if (!irregular.empty()) {
+		std::map<Date, MeteoSnapshot>::iterator it = irregular.begin();
+		double dist = fabs(it->first.getJulian(true) - julian);
+		if (dist>max_dist) { max_dist = dist; irregular_it = it; }
+		it = irregular.end();
+		--it;
+		dist = fabs(it->first.getJulian(true) - julian);
+		if (dist>max_dist) { max_dist = dist; irregular_it = it; }
+	}
+
+	if (irregular_it != irregular.end()) {
+		stats.bytes -= CacheStats::getMemorySize(irregular_it->second);
+		stats.items--;
+		stats.evictions++;
+		irregular.erase(irregular_it);
+		return true;
+	}
+	if (found_ring) {
+		evictIndex(ring_index);
+		return true;
+	}
+	return false;
+}
+
+//all the cached snapshots, sorted by date
+void PointCache::getSnapshots(std::vector<MeteoSnapshot>& vecSnapshots) const
+{
+	vecSnapshots.clear();
+	vecSnapshots.reserve(stats.items);
+	for (size_t ii=0; ii<ring.size(); ii++)
+		if (used[ii]) vecSnapshots.push_back(ring[ii]);
+	for (std::map<Date, MeteoSnapshot>::const_iterator it=irregular.begin(); it!=irregular.end(); ++it)
+		vecSnapshots.push_back(it->second);
+	std::sort(vecSnapshots.begin(), vecSnapshots.end(), sortByDate);
+}
+
+const std::string PointCache::toString() const
+{
+	std::vector<MeteoSnapshot> vecSnapshots;
+	getSnapshots(vecSnapshots);
+	const size_t count = vecSnapshots.size();
+
+	size_t min_stations = std::numeric_limits<size_t>::max();
+	size_t max_stations = 0;
+	for (size_t ii=0; ii<count; ii++) {
+		const size_t nb_stations = vecSnapshots[ii].getNrStations();
+		if (nb_stations>max_stations) max_stations = nb_stations;
+		if (nb_stations<min_stations) min_stations = nb_stations;
+	}
+
+	std::ostringstream os;
+	if (count==0) {
+		os << "Resampled cache is empty\n";
+		return os.str();
+	}
+
+	os << "Resampled cache content (";
+	if (max_stations==min_stations)
+		os << min_stations;
+	else
+		os << min_stations << " to " << max_stations;
+	os << " station(s))\n";
+
+	const Date& first = vecSnapshots.front().getDate();
+	const Date& last = vecSnapshots.back().getDate();
+	if (count==1) {
+		os << first.toString(Date::ISO) << " - 1 timestep\n";
+	} else {
+		const double avg_sampling = (last.getJulian() - first.getJulian()) / static_cast<double>(count-1);
+		os << first.toString(Date::ISO) << " - " << last.toString(Date::ISO);
+		os << " - " << count << " timesteps (" << setprecision(3) << fixed << avg_sampling*24.*3600. << " s sampling rate";
+		if (step>0.) os << ", indexed every " << step*24.*3600. << " s";
+		os << ")\n";
+	}
+	return os.str();
+}
+
+} //namespace
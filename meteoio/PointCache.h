@@ -0,0 +1,107 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __POINTCACHE_H__
+#define __POINTCACHE_H__
+
+#include <meteoio/MeteoSnapshot.h>
+#include <meteoio/CacheStats.h>
+#include <meteoio/Date.h>
+
+#include <map>
+#include <vector>
+#include <string>
+
+namespace mio {
+
+/**
+ * @class PointCache
+ * @brief Time indexed cache of MeteoSnapshot objects, as used by the IOManager for the resampled data.
+ * The data is most often requested at regular time steps (the simulation's time step), so the snapshots are stored
+ * in a ring buffer indexed by the number of time steps since the first cached date: looking up or inserting a date is
+ * then done in constant time. When the simulation advances, the ring buffer's window moves forward and the time
+ * steps that fall out of it are evicted one by one. The time step is detected from the first dates that are inserted
+ * and refined if a date falls between the time steps (for example when the first requests are every 6 hours
+ * and later ones every hour). The dates that still don't fit (irregular requests) are kept in a map.
+ *
+ * The memory footprint is kept below the limit given to setMaxMemory(), by evicting the snapshots that are the
+ * furthest away from the last inserted one.
+ *
+ * @ingroup data_str
+ * @date   2014-05-09
+ */
+class PointCache {
+	public:
+		PointCache(const std::string& name="");
+
+		/**
+		* @brief Look for the snapshot of a given date
+		* @param date date to look for
+		* @return pointer to the cached snapshot (valid until the cache is modified) or NULL if it is not in the cache
+		*/
+		const MeteoSnapshot* find(const Date& date);
+
+		/**
+		* @brief Same as find(), but without updating the usage statistics
+		* @param date date to look for
+		* @return pointer to the cached snapshot or NULL if it is not in the cache
+		*/
+		const MeteoSnapshot* peek(const Date& date) const;
+
+		/**
+		* @brief Add a snapshot to the cache, replacing the one that might already be cached for the same date
+		* @param snapshot snapshot to add (its date is used as key)
+		*/
+		void insert(const MeteoSnapshot& snapshot);
+
+		void clear();
+		size_t size() const;
+
+		/**
+		* @brief Set the maximum memory footprint of the cache
+		* @param max_bytes memory limit, in bytes
+		*/
+		void setMaxMemory(const size_t& max_bytes);
+
+		const CacheStats& getStats() const;
+		const std::string toString() const;
+
+	private:
+		bool getIndex(const double& julian, long& index) const;
+		size_t getSlot(const long& index) const;
+		void initRing(const double& i_origin, const double& i_step, const size_t& snapshot_size);
+		void moveWindow(const long& index);
+		void evictIndex(const long& index);
+		bool evictFurthest(const double& julian);
+		bool refineStep(const double& julian);
+		void getSnapshots(std::vector<MeteoSnapshot>& vecSnapshots) const;
+
+		static const double time_tolerance; ///< dates closer than this (in days) are considered equal
+		static const size_t min_slots, max_slots;
+
+		std::vector<MeteoSnapshot> ring; ///< snapshots at regular time steps
+		std::vector<bool> used; ///< is a given slot of the ring filled?
+		std::map<Date, MeteoSnapshot> irregular; ///< snapshots that are not on the regular time steps
+		CacheStats stats;
+		double origin; ///< julian date (GMT) of the time step of index 0
+		double step; ///< time step in days, 0 as long as it is unknown
+		long first_index; ///< index of the first time step in the ring's window
+};
+
+} //end namespace
+
+#endif
@@ -0,0 +1,194 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/Profiler.h>
+#include <meteoio/IOUtils.h>
+
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+//thread local storage, for any kind of threads (the C++98 standard does not provide it)
+#if defined _MSC_VER
+	#define MIO_THREAD_LOCAL __declspec(thread)
+#else
+	#define MIO_THREAD_LOCAL __thread
+#endif
+
+namespace mio {
+
+std::vector<Profiler::thread_profile*> Profiler::profiles;
+Mutex Profiler::profiles_mutex;
+
+Profiler::Zone::Zone(const char* name) : timer(), node(Profiler::enter(name))
+{
+	timer.start();
+}
+
+Profiler::Zone::Zone(const std::string& name) : timer(), node(Profiler::enter(name))
+{
+	timer.start();
+}
+
+Profiler::Zone::~Zone()
+{
+	timer.stop();
+	Profiler::leave(node, timer.getElapsed());
+}
+
+bool Profiler::isEnabled()
+{
+#ifdef MIO_PROFILING
+	return true;
+#else
+	return false;
+#endif
+}
+
+//each thread gets its own tree, so recording a zone never has to wait for another thread
+Profiler::thread_profile& Profiler::getThreadProfile()
+{
+	static MIO_THREAD_LOCAL thread_profile* profile = NULL;
+
+	if (profile==NULL) {
+		profile = new thread_profile;
+		ScopedLock lock(profiles_mutex);
+		profiles.push_back(profile);
+	}
+	return *profile;
+}
+
+size_t Profiler::enter(const std::string& name)
+{
+	return enter(name.c_str());
+}
+
+size_t Profiler::enter(const char* name)
+{
+	thread_profile& profile = getThreadProfile();
+	ScopedLock lock(profile.mutex);
+	const size_t parent = profile.current;
+	const std::vector<size_t>& children = profile.nodes[parent].children;
+	for (size_t ii=0; ii<children.size(); ii++) {
+		if (profile.nodes[ children[ii] ].name==name) {
+			profile.current = children[ii];
+			return children[ii];
+		}
+	}
+
+	const size_t idx = profile.nodes.size();
+	profile.nodes.push_back( node_t(name, parent) );
+	profile.nodes[parent].children.push_back(idx);
+	profile.current = idx;
+	return idx;
+}
+
+void Profiler::leave(const size_t& node, const double& elapsed)
+{
+	thread_profile& profile = getThreadProfile();
+	ScopedLock lock(profile.mutex);
+	node_t& zone = profile.nodes[node];
+	zone.calls++;
+	zone.elapsed += elapsed;
+	profile.current = zone.parent;
+}
+
+void Profiler::reset()
+{
+	ScopedLock lock(profiles_mutex);
+	//the trees are kept, since some zones might currently be open
+	for (size_t ii=0; ii<profiles.size(); ii++) {
+		ScopedLock profile_lock(profiles[ii]->mutex);
+		std::vector<node_t>& nodes = profiles[ii]->nodes;
+		for (size_t jj=0; jj<nodes.size(); jj++) {
+			nodes[jj].calls = 0;
+			nodes[jj].elapsed = 0.;
+		}
+	}
+}
+
+//add the children of profile.nodes[src] to the children of merged[dest], matching them by name
+void Profiler::merge(const thread_profile& profile, const size_t& src, std::vector<node_t>& merged, const size_t& dest)
+{
+	const std::vector<size_t>& children = profile.nodes[src].children;
+	for (size_t ii=0; ii<children.size(); ii++) {
+		const node_t& child = profile.nodes[ children[ii] ];
+
+		size_t idx = IOUtils::npos;
+		for (size_t jj=0; jj<merged[dest].children.size(); jj++) {
+			if (merged[ merged[dest].children[jj] ].name==child.name) {
+				idx = merged[dest].children[jj];
+				break;
+			}
+		}
+		if (idx==IOUtils::npos) {
+			idx = merged.size();
+			merged.push_back( node_t(child.name, dest) );
+			merged[dest].children.push_back(idx);
+		}
+
+		merged[idx].calls += child.calls;
+		merged[idx].elapsed += child.elapsed;
+		merge(profile, children[ii], merged, idx);
+	}
+}
+
+void Profiler::printNode(const std::vector<node_t>& merged, const size_t& idx, const size_t& depth, std::ostream& os)
+{
+	const node_t& zone = merged[idx];
+	const double parent_time = merged[zone.parent].elapsed;
+	const double ratio = (parent_time>0.)? zone.elapsed/parent_time*100. : 100.;
+
+	os << std::left << std::setw(50) << (std::string(2*depth, ' ') + zone.name) << std::right;
+	os << std::setw(10) << zone.calls << std::setw(14) << std::fixed << std::setprecision(6) << zone.elapsed;
+	os << std::setw(10) << std::setprecision(1) << ratio << "\n";
+
+	for (size_t ii=0; ii<zone.children.size(); ii++)
+		printNode(merged, zone.children[ii], depth+1, os);
+}
+
+const std::string Profiler::getReport()
+{
+	std::vector<node_t> merged(1, node_t("", 0));
+	{
+		ScopedLock lock(profiles_mutex);
+		for (size_t ii=0; ii<profiles.size(); ii++) {
+			ScopedLock profile_lock(profiles[ii]->mutex);
+			merge(*profiles[ii], 0, merged, 0);
+		}
+	}
+
+	//the root gets the total time of the top level zones, so they are given as a fraction of the total
+	for (size_t ii=0; ii<merged[0].children.size(); ii++)
+		merged[0].elapsed += merged[ merged[0].children[ii] ].elapsed;
+
+	std::ostringstream os;
+	os << "<Profiler>\n";
+	if (!isEnabled()) {
+		os << "Profiling has not been compiled in (see the PROFILE_ZONES option)\n";
+	} else {
+		os << std::left << std::setw(50) << "zone" << std::right << std::setw(10) << "calls";
+		os << std::setw(14) << "time [s]" << std::setw(10) << "% parent" << "\n";
+		for (size_t ii=0; ii<merged[0].children.size(); ii++)
+			printNode(merged, merged[0].children[ii], 0, os);
+	}
+	os << "</Profiler>\n";
+	return os.str();
+}
+
+} //namespace
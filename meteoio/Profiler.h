@@ -0,0 +1,129 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <meteoio/Timer.h>
+#include <meteoio/Mutex.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @def MIO_PROFILE(name)
+ * @brief Time the rest of the current scope as a profiling zone called "name".
+ * This expands to nothing (and "name" is not even evaluated) unless MeteoIO has been compiled
+ * with the PROFILE_ZONES option (that defines MIO_PROFILING), so it can be left in the hot paths.
+ */
+#ifdef MIO_PROFILING
+	#define MIO_PROFILE_CONCAT2(a, b) a##b
+	#define MIO_PROFILE_CONCAT(a, b) MIO_PROFILE_CONCAT2(a, b)
+	#define MIO_PROFILE(name) mio::Profiler::Zone MIO_PROFILE_CONCAT(mio_profile_zone_, __LINE__)(name)
+#else
+	#define MIO_PROFILE(name)
+#endif
+
+namespace mio {
+
+/**
+ * @class Profiler
+ * @brief Hierarchical timing of the processing stages.
+ * The time spent in each zone (see MIO_PROFILE) is accumulated together with the number of calls. Zones
+ * opened while another zone is open are recorded as its children, so the report shows for example how much of
+ * the buffering time was spent in the plugin and how much in the filters. Each thread (OpenMP or system threads, such
+ * as the grids prefetching threads) accumulates into its own tree, protected by its own lock that is only contended
+ * while a report is being built. The trees are merged when building the report. Therefore, the time of the zones
+ * that run in parallel is the sum over all threads.
+ *
+ * The report is available through getReport(), it is also appended to IOManager::toString() and printed when
+ * an IOManager is destroyed if PROFILING_REPORT is set to true in the [General] section.
+ *
+ * @ingroup data_str
+ * @date   2014-05-02
+ */
+class Profiler {
+	public:
+		/**
+		* @class Zone
+		* @brief Scoped profiling zone: it is timed from its construction until its destruction.
+		* It should not be used directly but through the MIO_PROFILE macro.
+		*/
+		class Zone {
+			public:
+				Zone(const char* name);
+				Zone(const std::string& name);
+				~Zone();
+
+			private:
+				Zone(const Zone&); //no copies
+				Zone& operator=(const Zone&);
+
+				Timer timer;
+				size_t node;
+		};
+
+		/**
+		* @brief Is the profiling compiled in?
+		* @return true if the zones are recorded
+		*/
+		static bool isEnabled();
+
+		/**
+		* @brief Build a report of all the zones recorded so far, merged over all the threads
+		* @return the report, as a tree of zones with their number of calls and time
+		*/
+		static const std::string getReport();
+
+		/**
+		* @brief Set all the counters back to zero.
+		* This must not be called while some other threads are recording zones.
+		*/
+		static void reset();
+
+	private:
+		typedef struct NODE {
+			NODE(const std::string& i_name, const size_t& i_parent) : name(i_name), parent(i_parent), children(), calls(0), elapsed(0.) {}
+			std::string name;
+			size_t parent;
+			std::vector<size_t> children;
+			size_t calls;
+			double elapsed;
+		} node_t;
+
+		typedef struct THREAD_PROFILE {
+			THREAD_PROFILE() : nodes(1, node_t("", 0)), current(0), mutex() {} //the first node is the root
+			std::vector<node_t> nodes;
+			size_t current;
+			Mutex mutex; ///< the tree is only shared with the report and reset
+		} thread_profile;
+
+		static thread_profile& getThreadProfile();
+		static size_t enter(const std::string& name);
+		static size_t enter(const char* name);
+		static void leave(const size_t& node, const double& elapsed);
+
+		static void merge(const thread_profile& profile, const size_t& src, std::vector<node_t>& merged, const size_t& dest);
+		static void printNode(const std::vector<node_t>& merged, const size_t& idx, const size_t& depth, std::ostream& os);
+
+		static std::vector<thread_profile*> profiles; ///< all the threads' trees, for the report
+		static Mutex profiles_mutex; ///< protects the list of trees
+};
+
+} //end namespace mio
+
+#endif
@@ -485,7 +485,7 @@ const double Daily_solar::snow_thresh = .1; //if snow height greater than this t
 const size_t Daily_solar::samples_per_day = 24*3; //every 20 minutes
 
 Daily_solar::Daily_solar(const std::string& i_algoname, const std::string& i_parname, const double& dflt_window_size, const std::vector<std::string>& vecArgs)
-            : ResamplingAlgorithms(i_algoname, i_parname, dflt_window_size, vecArgs), radiation(), station_index(), dateStart(), dateEnd(), loss_factor()
+            : ResamplingAlgorithms(i_algoname, i_parname, dflt_window_size, vecArgs), radiation(), station_index(), dateStart(), dateEnd(), loss_factor(), ephemeris()
 {
 	const size_t nr_args = vecArgs.size();
 	if(nr_args>0) {
@@ -548,7 +548,7 @@ double Daily_solar::compRadiation(const double& lat, const double& lon, const do
 	size_t index=0;
 	for(Date date(dateStart[stat_idx]); date<dateEnd[stat_idx]; date += 1./double(samples_per_day)) {
 		//compute potential solar radiation at this time step
-		sun.setDate(date.getJulian(), date.getTimeZone());
+		sun.setDate(date.getJulian(), date.getTimeZone(), ephemeris);
 		sun.calculateRadiation(TA, RH, P, albedo);
 		double toa, direct, diffuse;
 		sun.getHorizontalRadiation(toa, direct, diffuse);
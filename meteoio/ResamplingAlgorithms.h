@@ -21,6 +21,7 @@
 #include <meteoio/MeteoData.h>
 #include <meteoio/StationData.h>
 #include <meteoio/meteostats/libinterpol1D.h>
+#include <meteoio/meteolaws/SunEphemeris.h>
 
 #include <iostream>
 #include <string>
@@ -250,6 +251,7 @@ class Daily_solar : public ResamplingAlgorithms {
 		std::vector<std::string> station_index;
 		std::vector<Date> dateStart, dateEnd;
 		std::vector<double> loss_factor;
+		SunEphemeris ephemeris; //the same days are computed for all the stations
 
 		static const double soil_albedo, snow_albedo, snow_thresh;
 		static const size_t samples_per_day;
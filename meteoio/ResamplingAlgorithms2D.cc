@@ -20,6 +20,8 @@
 #include <meteoio/ResamplingAlgorithms2D.h>
 #include <cmath>
 #include <sstream>
+#include <limits>
+#include <algorithm>
 
 using namespace std;
 
@@ -120,31 +122,70 @@ const Array2D<double> ResamplingAlgorithms2D::cubicBSplineResampling(const Array
 ///////////////////////////////////////////////////////////////////////
 //Private Methods
 ///////////////////////////////////////////////////////////////////////
+//for each destination index along one axis, compute the matching source index and the normalized distance to it (between 0 and 1)
+void ResamplingAlgorithms2D::buildAxis(const size_t &org_n, const size_t &dest_n, std::vector<size_t> &org_idx, std::vector<double> &weight)
+{
+	const double scale = (double)dest_n / (double)org_n;
+	org_idx.resize(dest_n);
+	weight.resize(dest_n);
+	for (size_t ii=0; ii<dest_n; ii++) {
+		const double org = (double)ii/scale;
+		org_idx[ii] = static_cast<size_t>( org );
+		weight[ii] = org - (double)org_idx[ii];
+	}
+}
+
+void ResamplingAlgorithms2D::findNodataRows(const Array2D<double> &i_grid, std::vector<char> &has_nodata)
+{
+	const size_t nx = i_grid.getNx(), ny = i_grid.getNy();
+	const double *data = i_grid.data();
+	has_nodata.assign(ny, 0);
+	for (size_t jj=0; jj<ny; jj++) {
+		const double *row = data + jj*nx;
+		for (size_t ii=0; ii<nx; ii++) {
+			if (row[ii]==IOUtils::nodata) {
+				has_nodata[jj] = 1;
+				break;
+			}
+		}
+	}
+}
+
 void ResamplingAlgorithms2D::NearestNeighbour(Array2D<double> &o_grid, const Array2D<double> &i_grid)
 {
 	const size_t org_nx = i_grid.getNx(), org_ny = i_grid.getNy();
 	const size_t dest_nx = o_grid.getNx(), dest_ny = o_grid.getNy();
+	if (dest_nx==0 || dest_ny==0) return;
 	const double scale_x = (double)dest_nx / (double)org_nx;
 	const double scale_y = (double)dest_ny / (double)org_ny;
 
-	for (size_t jj=0; jj<dest_ny; jj++) {
+	std::vector<size_t> org_ii(dest_nx);
+	for (size_t ii=0; ii<dest_nx; ii++)
+		org_ii[ii] = std::min( (size_t) Optim::floor( (double)ii/scale_x ) , org_nx-1 );
+
+	const double *src = i_grid.data();
+	double *dest = o_grid.data();
+	const long nr_rows = static_cast<long>(dest_ny);
+	#ifdef _OPENMP
+	#pragma omp parallel for
+	#endif
+	for (long jj=0; jj<nr_rows; jj++) {
 		const size_t org_jj = std::min( (size_t) Optim::floor( (double)jj/scale_y ) , org_ny-1 );
-
-		for (size_t ii=0; ii<dest_nx; ii++) {
-			const size_t org_ii = std::min( (size_t) Optim::floor( (double)ii/scale_x ) , org_nx-1 );
-			o_grid(ii,jj) = i_grid(org_ii, org_jj);
-		}
+		const double *src_row = src + org_jj*org_nx;
+		double *dest_row = dest + static_cast<size_t>(jj)*dest_nx;
+		for (size_t ii=0; ii<dest_nx; ii++)
+			dest_row[ii] = src_row[ org_ii[ii] ];
 	}
 }
 
-double ResamplingAlgorithms2D::bilinear_pixel(const Array2D<double> &i_grid, const size_t &org_ii, const size_t &org_jj, const size_t &org_nx, const size_t &org_ny, const double &x, const double &y)
+double ResamplingAlgorithms2D::bilinear_pixel(const double *i_grid, const size_t &org_ii, const size_t &org_jj, const size_t &org_nx, const size_t &org_ny, const double &x, const double &y)
 {
-	if(org_jj>=(org_ny-1) || org_ii>=(org_nx-1)) return i_grid(org_ii, org_jj);
+	if(org_jj>=(org_ny-1) || org_ii>=(org_nx-1)) return i_grid[org_ii + org_jj*org_nx];
 
-	const double f_0_0 = i_grid(org_ii, org_jj);
-	const double f_1_0 = i_grid(org_ii+1, org_jj);
-	const double f_0_1 = i_grid(org_ii, org_jj+1);
-	const double f_1_1 = i_grid(org_ii+1, org_jj+1);
+	const double f_0_0 = i_grid[org_ii + org_jj*org_nx];
+	const double f_1_0 = i_grid[org_ii+1 + org_jj*org_nx];
+	const double f_0_1 = i_grid[org_ii + (org_jj+1)*org_nx];
+	const double f_1_1 = i_grid[org_ii+1 + (org_jj+1)*org_nx];
 
 	double avg_value = 0.;
 	unsigned int avg_count = 0;
@@ -188,20 +229,43 @@ void ResamplingAlgorithms2D::Bilinear(Array2D<double> &o_grid, const Array2D<dou
 {
 	const size_t org_nx = i_grid.getNx(), org_ny = i_grid.getNy();
 	const size_t dest_nx = o_grid.getNx(), dest_ny = o_grid.getNy();
-	const double scale_x = (double)dest_nx / (double)org_nx;
-	const double scale_y = (double)dest_ny / (double)org_ny;
-
-	for (size_t jj=0; jj<dest_ny; jj++) {
-		const double org_y = (double)jj/scale_y;
-		const size_t org_jj = static_cast<size_t>( org_y );
-		const double y = org_y - (double)org_jj; //normalized y, between 0 and 1
-
-		for (size_t ii=0; ii<dest_nx; ii++) {
-			const double org_x = (double)ii/scale_x;
-			const size_t org_ii = static_cast<size_t>( org_x );
-			const double x = org_x - (double)org_ii; //normalized x, between 0 and 1
-
-			o_grid(ii,jj) = bilinear_pixel(i_grid, org_ii, org_jj, org_nx, org_ny, x, y);
+	if (dest_nx==0 || dest_ny==0) return;
+
+	std::vector<size_t> org_ii, org_jj;
+	std::vector<double> wx, wy;
+	buildAxis(org_nx, dest_nx, org_ii, wx);
+	buildAxis(org_ny, dest_ny, org_jj, wy);
+	std::vector<char> has_nodata;
+	findNodataRows(i_grid, has_nodata);
+
+	//the last source column has no right neighbour: these pixels simply take the source value
+	size_t inner_nx = dest_nx;
+	while (inner_nx>0 && org_ii[inner_nx-1]>=(org_nx-1)) inner_nx--;
+
+	const double *src = i_grid.data();
+	double *dest = o_grid.data();
+	const long nr_rows = static_cast<long>(dest_ny);
+	#ifdef _OPENMP
+	#pragma omp parallel for
+	#endif
+	for (long jj=0; jj<nr_rows; jj++) {
+		const size_t row_jj = org_jj[jj];
+		const double y = wy[jj]; //normalized y, between 0 and 1
+		double *dest_row = dest + static_cast<size_t>(jj)*dest_nx;
+
+		if (row_jj<(org_ny-1) && !has_nodata[row_jj] && !has_nodata[row_jj+1]) { //fast path: no nodata checks
+			const double *row0 = src + row_jj*org_nx;
+			const double *row1 = row0 + org_nx;
+			for (size_t ii=0; ii<inner_nx; ii++) {
+				const size_t i0 = org_ii[ii];
+				const double x = wx[ii]; //normalized x, between 0 and 1
+				dest_row[ii] = row0[i0] * (1.-x)*(1.-y) + row0[i0+1] * x*(1.-y) + row1[i0] * (1.-x)*y + row1[i0+1] *x*y;
+			}
+			for (size_t ii=inner_nx; ii<dest_nx; ii++)
+				dest_row[ii] = row0[ org_ii[ii] ];
+		} else {
+			for (size_t ii=0; ii<dest_nx; ii++)
+				dest_row[ii] = bilinear_pixel(src, org_ii[ii], row_jj, org_nx, org_ny, wx[ii], y);
 		}
 	}
 }
@@ -220,27 +284,67 @@ void ResamplingAlgorithms2D::cubicBSpline(Array2D<double> &o_grid, const Array2D
 {//see http://paulbourke.net/texture_colour/imageprocess/
 	const size_t org_nx = i_grid.getNx(), org_ny = i_grid.getNy();
 	const size_t dest_nx = o_grid.getNx(), dest_ny = o_grid.getNy();
-	const double scale_x = (double)dest_nx / (double)org_nx;
-	const double scale_y = (double)dest_ny / (double)org_ny;
-
+	if (dest_nx==0 || dest_ny==0) return;
+
+	std::vector<size_t> org_ii, org_jj;
+	std::vector<double> dx, dy;
+	buildAxis(org_nx, dest_nx, org_ii, dx);
+	buildAxis(org_ny, dest_ny, org_jj, dy);
+	std::vector<char> has_nodata;
+	findNodataRows(i_grid, has_nodata);
+
+	//the B-Spline weights are separable: 4 weights per destination column and 4 weights per destination row
+	std::vector<double> wx(4*dest_nx), wy(4*dest_ny);
+	for (size_t ii=0; ii<dest_nx; ii++) {
+		for (short m=-1; m<=2; m++) wx[4*ii+m+1] = BSpline_weight(m-dx[ii]);
+	}
 	for (size_t jj=0; jj<dest_ny; jj++) {
-		const double org_y = (double)jj/scale_y;
-		const size_t org_jj = static_cast<size_t>( org_y );
-		const double dy = org_y - (double)org_jj; //normalized y, between 0 and 1
+		for (short n=-1; n<=2; n++) wy[4*jj+n+1] = BSpline_weight(dy[jj]-n);
+	}
+
+	const double *src = i_grid.data();
+	double *dest = o_grid.data();
+	const long nr_rows = static_cast<long>(dest_ny);
+	#ifdef _OPENMP
+	#pragma omp parallel for
+	#endif
+	for (long jj=0; jj<nr_rows; jj++) {
+		const size_t row_jj = org_jj[jj];
+		double *dest_row = dest + static_cast<size_t>(jj)*dest_nx;
+		const double *w_y = &wy[4*jj];
+
+		//all 16 neighbours within the grid and without nodata?
+		const bool rows_ok = (row_jj>=1 && row_jj+2<org_ny && !has_nodata[row_jj-1] && !has_nodata[row_jj] && !has_nodata[row_jj+1] && !has_nodata[row_jj+2]);
 
 		for (size_t ii=0; ii<dest_nx; ii++) {
-			const double org_x = (double)ii/scale_x;
-			const size_t org_ii = static_cast<size_t>( org_x );
-			const double dx = org_x - (double)org_ii; //normalized x, between 0 and 1
+			const size_t col_ii = org_ii[ii];
+			const double *w_x = &wx[4*ii];
+
+			if (rows_ok && col_ii>=1 && col_ii+2<org_nx) { //fast path: normal bicubic
+				double F = 0., max=-std::numeric_limits<double>::max(), min=std::numeric_limits<double>::max();
+				for (size_t n=0; n<4; n++) {
+					const double *src_row = src + (row_jj+n-1)*org_nx + col_ii-1;
+					for (size_t m=0; m<4; m++) {
+						const double pixel = src_row[m];
+						F += pixel * w_x[m] * w_y[n];
+						if (pixel>max) max=pixel;
+						if (pixel<min) min=pixel;
+					}
+				}
+				if (F>max) F=max; //try to limit overshoot
+				else if (F<min) F=min; //try to limit overshoot
+				dest_row[ii] = F;
+				continue;
+			}
 
 			double F = 0., max=-std::numeric_limits<double>::max(), min=std::numeric_limits<double>::max();
 			unsigned int avg_count = 0;
 			for(short n=-1; n<=2; n++) {
 				for(short m=-1; m<=2; m++) {
-					if (((signed)org_ii+m)<0 || ((signed)org_ii+m)>=(signed)org_nx || ((signed)org_jj+n)<0 || ((signed)org_jj+n)>=(signed)org_ny) continue;
-					const double pixel = i_grid(org_ii+m, org_jj+n);
+					if (((signed)col_ii+m)<0 || ((signed)col_ii+m)>=(signed)org_nx || ((signed)row_jj+n)<0 || ((signed)row_jj+n)>=(signed)org_ny) continue;
+					const double pixel = src[(col_ii+m) + (row_jj+n)*org_nx];
 					if (pixel!=IOUtils::nodata) {
-						F += pixel * BSpline_weight(m-dx) * BSpline_weight(dy-n);
+						F += pixel * w_x[m+1] * w_y[n+1];
 						avg_count++;
 						if (pixel>max) max=pixel;
 						if (pixel<min) min=pixel;
@@ -249,17 +353,14 @@ void ResamplingAlgorithms2D::cubicBSpline(Array2D<double> &o_grid, const Array2D
 			}
 
 			if (avg_count==16) { //normal bicubic
-				o_grid(ii,jj) = F*(16/avg_count);
-				if (o_grid(ii,jj)>max) o_grid(ii,jj)=max; //try to limit overshoot
-				else if (o_grid(ii,jj)<min) o_grid(ii,jj)=min; //try to limit overshoot
-			} else if (avg_count==0) o_grid(ii,jj) = IOUtils::nodata; //nodata-> nodata
+				if (F>max) F=max; //try to limit overshoot
+				else if (F<min) F=min; //try to limit overshoot
+				dest_row[ii] = F;
+			} else if (avg_count==0) dest_row[ii] = IOUtils::nodata; //nodata-> nodata
 			else //not enought data points -> bilinear for this pixel
-				o_grid(ii,jj) = bilinear_pixel(i_grid, org_ii, org_jj, org_nx, org_ny, dx, dy);
-
+				dest_row[ii] = bilinear_pixel(src, col_ii, row_jj, org_nx, org_ny, dx[ii], dy[jj]);
 		}
 	}
-
 }
 
 } //namespace
-
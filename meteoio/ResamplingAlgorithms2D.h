@@ -21,12 +21,17 @@
 #include <meteoio/Grid2DObject.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace mio {
 
 /**
  * @class ResamplingAlgorithms2D
  * @brief Spatial resampling algorithms
+ * Since the destination grid is aligned with the source grid, the source indices and interpolation weights are separable:
+ * they are computed once per destination column and once per destination row. The rows of source data that do not
+ * contain any nodata are processed without any nodata checks and the destination rows are computed in parallel
+ * when MeteoIO has been compiled with OpenMP.
  *
  * @ingroup stats
  * @author Mathias Bavay
@@ -48,8 +53,11 @@ class ResamplingAlgorithms2D {
 		static void Bilinear(Array2D<double> &o_grid, const Array2D<double> &i_grid);
 		static void NearestNeighbour(Array2D<double> &o_grid, const Array2D<double> &i_grid);
 
-		static double bilinear_pixel(const Array2D<double> &i_grid, const size_t &org_ii, const size_t &org_jj, const size_t &org_ncols, const size_t &org_nrows, const double &x, const double &y);
+		static double bilinear_pixel(const double *i_grid, const size_t &org_ii, const size_t &org_jj, const size_t &org_ncols, const size_t &org_nrows, const double &x, const double &y);
 		static double BSpline_weight(const double &x);
+
+		static void buildAxis(const size_t &org_n, const size_t &dest_n, std::vector<size_t> &org_idx, std::vector<double> &weight);
+		static void findNodataRows(const Array2D<double> &i_grid, std::vector<char> &has_nodata);
 };
 } //end namespace
 
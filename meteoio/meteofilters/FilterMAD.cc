@@ -37,24 +37,29 @@ FilterMAD::FilterMAD(const std::vector<std::string>& vec_args, const std::string
 void FilterMAD::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
                         std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ivec, get a window
-		double& value = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterMAD::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                               const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	const std::vector<double> ivalues( values ); //the statistics are computed on the original data
+	for (size_t ii=0; ii<values.size(); ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 		if(value==IOUtils::nodata) continue;
 
 		size_t start, end;
 		if( get_window_specs(ii, ivec, start, end) ) {
-			MAD_filter_point(ivec, param, start, end, value);
+			MAD_filter_point(ivalues, start, end, value);
 		} else if(!is_soft) value = IOUtils::nodata;
 	}
 }
 
-void FilterMAD::MAD_filter_point(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end, double &value)
+void FilterMAD::MAD_filter_point(const std::vector<double>& ivec, const size_t& start, const size_t& end, double &value)
 {
 	const double K = 1. / 0.6745;
 
-	std::vector<double> data( end-start+1 );
-	for(size_t ii=start; ii<=end; ii++) data[ii-start] = ivec[ii](param);
+	std::vector<double> data( ivec.begin()+start, ivec.begin()+end+1 );
 
 	//Calculate MAD
 	const double median = Interpol1D::getMedian(data);
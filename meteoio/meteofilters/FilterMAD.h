@@ -47,9 +47,12 @@ class FilterMAD : public WindowedFilter {
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;}
 
 	private:
-		void MAD_filter_point(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end, double &value);
+		static void MAD_filter_point(const std::vector<double>& ivec, const size_t& start, const size_t& end, double &value);
 		void parse_args(std::vector<std::string> vec_args);
 };
 
@@ -16,6 +16,7 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/meteofilters/FilterMeanAvg.h>
+#include <meteoio/meteofilters/SlidingWindow.h>
 #include <cmath>
 
 using namespace std;
@@ -36,34 +37,25 @@ FilterMeanAvg::FilterMeanAvg(const std::vector<std::string>& vec_args, const std
 void FilterMeanAvg::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
                             std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ivec, get a window
-		double& value = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterMeanAvg::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                                   const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	const std::vector<double> ivalues( values ); //the averages are computed on the original data
+	SlidingMean window( ivalues );
+	for (size_t ii=0; ii<values.size(); ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 
 		size_t start, end;
 		if( get_window_specs(ii, ivec, start, end) ) {
-			value = calc_avg(ivec, param, start, end);
+			window.setWindow(start, end);
+			value = window.getMean();
 		} else if(!is_soft) value = IOUtils::nodata;
 	}
 }
 
-double FilterMeanAvg::calc_avg(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end)
-{
-	double sum = 0;
-	size_t counter = 0;
-	for (size_t ii=start; ii<=end; ii++){
-		const double& value = ivec[ii](param);
-		if (value != IOUtils::nodata){
-			sum += value;
-			counter++;
-		}
-	}
-
-	if (counter == 0) return IOUtils::nodata;
-
-	return (sum / (double)counter);
-}
-
 void FilterMeanAvg::parse_args(std::vector<std::string> vec_args)
 {
 	vector<double> filter_args;
@@ -31,9 +31,14 @@ FilterMin::FilterMin(const std::vector<std::string>& vec_args, const std::string
 void FilterMin::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
                         std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){
-		double& tmp = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterMin::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& /*ivec*/,
+                               const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	for (size_t ii=0; ii<values.size(); ii++){
+		double& tmp = values[ii];
 		if (tmp == IOUtils::nodata) continue; //preserve nodata values
 
 		if (tmp < min_val){
@@ -48,6 +48,9 @@ class FilterMin : public FilterBlock {
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;}
 
 	private:
 		void parse_args(std::vector<std::string> vec_args);
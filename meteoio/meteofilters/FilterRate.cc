@@ -30,14 +30,19 @@ FilterRate::FilterRate(const std::vector<std::string>& vec_args, const std::stri
 }
 
 void FilterRate::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                           std::vector<MeteoData>& ovec)
+                         std::vector<MeteoData>& ovec)
+{
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterRate::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& /*ivec*/,
+                                const std::vector<double>& julian, std::vector<double>& values)
 {
-	ovec = ivec;
 	size_t last_good = IOUtils::npos;
 
 	//Find first point that is not IOUtils::nodata
-	for (size_t ii=0; ii<ovec.size(); ii++){
-		if (ovec[ii](param) != IOUtils::nodata){
+	for (size_t ii=0; ii<values.size(); ii++){
+		if (values[ii] != IOUtils::nodata){
 			last_good = ii;
 			break;
 		}
@@ -46,11 +51,11 @@ void FilterRate::process(const unsigned int& param, const std::vector<MeteoData>
 	if (last_good == IOUtils::npos) //can not find a good point to start
 		return;
 
-	for (size_t ii=(last_good+1); ii<ovec.size(); ii++) {
-		double& curr_value       = ovec[ii](param);
-		const double& prev_value = ovec[last_good](param);
-		const double curr_time   = ovec[ii].date.getJulian();
-		const double prev_time   = ovec[last_good].date.getJulian();
+	for (size_t ii=(last_good+1); ii<values.size(); ii++) {
+		double& curr_value       = values[ii];
+		const double& prev_value = values[last_good];
+		const double curr_time   = julian[ii];
+		const double prev_time   = julian[last_good];
 
 		if (curr_value == IOUtils::nodata)
 			continue;
@@ -16,6 +16,7 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/meteofilters/FilterStdDev.h>
+#include <meteoio/meteofilters/SlidingWindow.h>
 #include <cmath>
 
 using namespace std;
@@ -38,9 +39,16 @@ FilterStdDev::FilterStdDev(const std::vector<std::string>& vec_args, const std::
 void FilterStdDev::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
                            std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ivec, get a window
-		double& value = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterStdDev::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                                  const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	const std::vector<double> ivalues( values ); //the statistics are computed on the original data
+	SlidingVariance window( ivalues );
+	for (size_t ii=0; ii<values.size(); ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 		if(value==IOUtils::nodata) continue;
 
 		//Calculate deviation
@@ -49,7 +57,9 @@ void FilterStdDev::process(const unsigned int& param, const std::vector<MeteoDat
 
 		size_t start, end;
 		if( get_window_specs(ii, ivec, start, end) ) {
-			getStat(ivec, param, start, end, std_dev, mean);
+			window.setWindow(start, end);
+			std_dev = window.getStdDev();
+			if(std_dev!=IOUtils::nodata) mean = window.getMean();
 		}  else if(!is_soft) {
 			value = IOUtils::nodata;
 			continue;
@@ -66,40 +76,6 @@ void FilterStdDev::process(const unsigned int& param, const std::vector<MeteoDat
 	}
 }
 
-void FilterStdDev::getStat(const std::vector<MeteoData>& ivec, const unsigned int& param,
-                           const size_t& start, const size_t& end, double& stddev, double& mean)
-{
-	size_t count=0;
-	double sum=0.;
-
-	for(size_t ii=start; ii<=end; ii++) {
-		const double& value = ivec[ii](param);
-		if(value!=IOUtils::nodata) {
-			sum += value;
-			count++;
-		}
-	}
-
-	if(count<=1) {
-		mean = IOUtils::nodata;
-		stddev = IOUtils::nodata;
-	} else {
-		//compensated variance algorithm, see https://secure.wikimedia.org/wikipedia/en/wiki/Algorithms_for_calculating_variance
-		mean = sum/(double)count;
-		double sum2=0., sum3=0.;
-		for(size_t ii=start; ii<=end; ii++) {
-			const double& value = ivec[ii](param);
-			if(value!=IOUtils::nodata) {
-				const double delta = value - mean;
-				sum2 += delta*delta;
-				sum3 += delta;
-			}
-		}
-		const double variance = (sum2 - sum3*sum3/static_cast<double>(count)) / static_cast<double>(count - 1);
-		stddev = sqrt(variance);
-	}
-}
-
 void FilterStdDev::parse_args(std::vector<std::string> vec_args)
 {
 	vector<double> filter_args;
@@ -48,11 +48,12 @@ class FilterStdDev : public WindowedFilter {
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;}
 
 	private:
 		void parse_args(std::vector<std::string> vec_args);
-		void getStat(const std::vector<MeteoData>& ivec, const unsigned int& param,
-		             const size_t& start, const size_t& end, double& stddev, double& mean);
 		static const double sigma; ///<How many times the stddev allowed for valid points
 };
 
@@ -29,11 +29,16 @@ FilterSuppr::FilterSuppr(const std::vector<std::string>& vec_args, const std::st
 }
 
 void FilterSuppr::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                          std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){
-		ovec[ii](param) = IOUtils::nodata;
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterSuppr::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& /*ivec*/,
+                                 const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	for (size_t ii=0; ii<values.size(); ii++){
+		values[ii] = IOUtils::nodata;
 	}
 }
 
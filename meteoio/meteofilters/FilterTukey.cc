@@ -37,18 +37,24 @@ FilterTukey::FilterTukey(const std::vector<std::string>& vec_args, const std::st
 }
 
 void FilterTukey::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                           std::vector<MeteoData>& ovec)
+                          std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ivec, get a window
-		double& value = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterTukey::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                                 const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	const std::vector<double> ivalues( values ); //the statistics are computed on the original data
+	for (size_t ii=0; ii<values.size(); ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 
 		size_t start, end;
 		if( get_window_specs(ii, ivec, start, end) ) {
 			//Calculate std deviation
-			const double std_dev  = getStdDev(ivec, param, start, end);
+			const double std_dev  = getStdDev(ivalues, start, end);
 
-			const double u3 = getU3(ivec, ii, param);
+			const double u3 = getU3(ivalues, ii);
 			if(std_dev!=IOUtils::nodata && u3!=IOUtils::nodata) {
 				if( abs(value-u3) > k*std_dev ) {
 					value = IOUtils::nodata;
@@ -58,13 +64,13 @@ void FilterTukey::process(const unsigned int& param, const std::vector<MeteoData
 	}
 }
 
-double FilterTukey::getStdDev(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end)
+double FilterTukey::getStdDev(const std::vector<double>& ivec, const size_t& start, const size_t& end)
 {
 	size_t count=0;
 	double sum=0.;
 
 	for(size_t ii=start; ii<=end; ii++) {
-		const double& value = ivec[ii](param);
+		const double& value = ivec[ii];
 		if(value!=IOUtils::nodata) {
 			sum += value;
 			count++;
@@ -79,7 +85,7 @@ double FilterTukey::getStdDev(const std::vector<MeteoData>& ivec, const unsigned
 	const double mean = sum/(double)count;
 	double sum2=0., sum3=0.;
 	for(size_t ii=start; ii<=end; ii++) {
-		const double& value = ivec[ii](param);
+		const double& value = ivec[ii];
 		if(value!=IOUtils::nodata) {
 			const double delta = value - mean;
 			sum2 += delta*delta;
@@ -91,7 +97,7 @@ double FilterTukey::getStdDev(const std::vector<MeteoData>& ivec, const unsigned
 	return sqrt(variance);
 }
 
-double FilterTukey::getU3(const std::vector<MeteoData>& ivec, const size_t& i, const unsigned int& param)
+double FilterTukey::getU3(const std::vector<double>& ivec, const size_t& i)
 {
 	//exit if we don't have the required data points
 	if( i<4 || i>=(ivec.size()-4) ) {
@@ -106,7 +112,7 @@ double FilterTukey::getU3(const std::vector<MeteoData>& ivec, const size_t& i, c
 			std::vector<double> u;
 			for(char kk=-2; kk<=2; kk++) {
 				const size_t index = (i + (kk + jj + ii));
-				const double value = ivec[index](param);
+				const double value = ivec[index];
 				if(value!=IOUtils::nodata)
 					u.push_back( value );
 			}
@@ -49,11 +49,14 @@ class FilterTukey : public WindowedFilter {
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;}
 
 	private:
 		void parse_args(std::vector<std::string> vec_args);
-		double getStdDev(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end);
-		double getU3(const std::vector<MeteoData>& ivec, const size_t& i, const unsigned int& param);
+		static double getStdDev(const std::vector<double>& ivec, const size_t& start, const size_t& end);
+		static double getU3(const std::vector<double>& ivec, const size_t& i);
 		static const double k; ///<How many times the stddev allowed as deviation to the smooth signal for valid points
 };
 
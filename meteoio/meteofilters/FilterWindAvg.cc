@@ -17,6 +17,7 @@
 */
 #include <cmath>
 #include <meteoio/meteofilters/FilterWindAvg.h>
+#include <meteoio/meteofilters/SlidingWindow.h>
 #include <meteoio/meteolaws/Meteoconst.h>
 
 using namespace std;
@@ -36,6 +37,12 @@ FilterWindAvg::FilterWindAvg(const std::vector<std::string>& vec_args, const std
 
 void FilterWindAvg::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
                             std::vector<MeteoData>& ovec)
+{
+	process_by_column(param, ivec, ovec);
+}
+
+void FilterWindAvg::process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                   const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(param!=MeteoData::VW && param!=MeteoData::DW) {
 		ostringstream ss;
@@ -43,37 +50,39 @@ void FilterWindAvg::process(const unsigned int& param, const std::vector<MeteoDa
 		throw InvalidArgumentException(ss.str(), AT);
 	}
 
-	ovec = ivec;
+	//compute the wind components once, their sums are then updated as the window moves
+	const size_t nr_elems = values.size();
+	std::vector<double> ve(nr_elems), vn(nr_elems);
+	for (size_t ii=0; ii<nr_elems; ii++) {
+		const double VW = (param==MeteoData::VW)? values[ii] : ivec[ii](MeteoData::VW);
+		const double DW = (param==MeteoData::DW)? values[ii] : ivec[ii](MeteoData::DW);
+		if(VW!=IOUtils::nodata && DW!=IOUtils::nodata) {
+			ve[ii] = VW * sin(DW*Cst::to_rad);
+			vn[ii] = VW * cos(DW*Cst::to_rad);
+		} else {
+			ve[ii] = vn[ii] = IOUtils::nodata;
+		}
+	}
 
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ivec, get a window
-		double& value = ovec[ii](param);
+	SlidingVectorSum window(ve, vn);
+	for (size_t ii=0; ii<nr_elems; ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 
 		size_t start, end;
 		if( get_window_specs(ii, ivec, start, end) ) {
-			value = calc_avg(ivec, param, start, end);
+			window.setWindow(start, end);
+			value = calc_avg(window, param);
 		} if(!is_soft) value = IOUtils::nodata;
 	}
 }
 
-double FilterWindAvg::calc_avg(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end)
+double FilterWindAvg::calc_avg(const SlidingVectorSum& window, const unsigned int& param)
 {
-	//calculate ve and vn
-	double ve=0.0, vn=0.0;
-	size_t count=0;
-	for (size_t ii=start; ii<=end; ii++) {
-		const double VW = ivec[ii](MeteoData::VW);
-		const double DW = ivec[ii](MeteoData::DW);
-		if(VW!=IOUtils::nodata && DW!=IOUtils::nodata) {
-			ve += VW * sin(DW*Cst::to_rad);
-			vn += VW * cos(DW*Cst::to_rad);
-			count++;
-		}
-	}
-
+	const size_t count = window.getCount();
 	if(count==0) return IOUtils::nodata;
 
-	ve /= static_cast<double>(count);
-	vn /= static_cast<double>(count);
+	const double ve = window.getSumU() / static_cast<double>(count);
+	const double vn = window.getSumV() / static_cast<double>(count);
 
 	if(param==MeteoData::VW) {
 		const double meanspeed = sqrt(ve*ve + vn*vn);
@@ -19,6 +19,7 @@
 #define __FILTERWINDAVG_H__
 
 #include <meteoio/meteofilters/WindowedFilter.h>
+#include <meteoio/meteofilters/SlidingWindow.h>
 #include <vector>
 #include <string>
 
@@ -58,10 +59,13 @@ class FilterWindAvg : public WindowedFilter {
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;}
 
 	private:
 		void parse_args(std::vector<std::string> vec_args);
-		double calc_avg(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end);
+		static double calc_avg(const SlidingVectorSum& window, const unsigned int& param);
 };
 
 } //end namespace
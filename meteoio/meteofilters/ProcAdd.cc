@@ -30,40 +30,44 @@ ProcAdd::ProcAdd(const std::vector<std::string>& vec_args, const std::string& na
 }
 
 void ProcAdd::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                      std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
+	process_by_column(param, ivec, ovec);
+}
 
+void ProcAdd::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                             const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
 	if (type=='c') {
-		for (size_t ii=0; ii<ovec.size(); ii++){
-			double& tmp = ovec[ii](param);
+		for (size_t ii=0; ii<values.size(); ii++){
+			double& tmp = values[ii];
 			if (tmp == IOUtils::nodata) continue; //preserve nodata values
 
 			tmp += offset;
 		}
 	} else if (type=='m') {
 		int year, month, day;
-		for (size_t ii=0; ii<ovec.size(); ii++){
-			double& tmp = ovec[ii](param);
+		for (size_t ii=0; ii<values.size(); ii++){
+			double& tmp = values[ii];
 			if (tmp == IOUtils::nodata) continue; //preserve nodata values
 
-			ovec[ii].date.getDate(year, month, day);
+			ivec[ii].date.getDate(year, month, day);
 			tmp += vecOffsets[ month-1 ]; //indices start at 0
 		}
 	} else if (type=='d') {
-		for (size_t ii=0; ii<ovec.size(); ii++){
-			double& tmp = ovec[ii](param);
+		for (size_t ii=0; ii<values.size(); ii++){
+			double& tmp = values[ii];
 			if (tmp == IOUtils::nodata) continue; //preserve nodata values
 
-			tmp += vecOffsets[ ovec[ii].date.getJulianDayNumber() ];
+			tmp += vecOffsets[ ivec[ii].date.getJulianDayNumber() ];
 		}
 	} else if (type=='h') {
 		int year, month, day, hour;
-		for (size_t ii=0; ii<ovec.size(); ii++){
-			double& tmp = ovec[ii](param);
+		for (size_t ii=0; ii<values.size(); ii++){
+			double& tmp = values[ii];
 			if (tmp == IOUtils::nodata) continue; //preserve nodata values
 
-			ovec[ii].date.getDate(year, month, day, hour);
+			ivec[ii].date.getDate(year, month, day, hour);
 			tmp += vecOffsets[ hour ];
 		}
 	}
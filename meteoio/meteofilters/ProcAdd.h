@@ -50,6 +50,9 @@ class ProcAdd : public ProcessingBlock {
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;}
 
 	protected:
 		static void readCorrections(const std::string& filter, const std::string& filename, const char& c_type, std::vector<double> &corrections);
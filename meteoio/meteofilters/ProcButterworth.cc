@@ -32,20 +32,25 @@ ProcButterworth::ProcButterworth(const std::vector<std::string>& vec_args, const
 }
 
 void ProcButterworth::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                              std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	if(ivec.size()<2 || cutoff==0.) return;
+	process_by_column(param, ivec, ovec);
+}
+
+void ProcButterworth::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& /*ivec*/,
+                                     const std::vector<double>& julian, std::vector<double>& values)
+{
+	if(values.size()<2 || cutoff==0.) return;
 
-	const double days = ivec.back().date.getJulian() - ivec.front().date.getJulian();
-	const size_t nr_data_pts = ivec.size();
+	const double days = julian.back() - julian.front();
+	const size_t nr_data_pts = values.size();
 	const double sampling_rate = static_cast<double>(nr_data_pts-1) / (days*24.*3600.); //in Hz
 
 	double A[3], B[3];
 	computeCoefficients(sampling_rate, 1./cutoff, A, B);
 
-	for (size_t ii=0; ii<ovec.size(); ++ii){
-		const double& raw_val = ivec[ii](param);
+	for (size_t ii=0; ii<values.size(); ++ii){
+		const double raw_val = values[ii]; //X keeps the raw values, so values can be overwritten
 
 		//propagate in X and Y
 		X[2] = X[1]; X[1] = X[0]; X[0] = raw_val;
@@ -54,7 +59,7 @@ void ProcButterworth::process(const unsigned int& param, const std::vector<Meteo
 		if(Y[2]==IOUtils::nodata || Y[1]==IOUtils::nodata) continue;
 
 		Y[0] = A[0]*X[0] + A[1]*X[1] + A[2]*X[2] - ( B[1]*Y[1] + B[2]*Y[2] );
-		ovec[ii](param) = Y[0];
+		values[ii] = Y[0];
 	}
 
 }
@@ -35,21 +35,26 @@ ProcExpSmoothing::ProcExpSmoothing(const std::vector<std::string>& vec_args, con
 }
 
 void ProcExpSmoothing::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                            std::vector<MeteoData>& ovec)
+                               std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ivec, get a window
-		double& value = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void ProcExpSmoothing::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                                      const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	const std::vector<double> ivalues( values ); //the smoothing is computed on the original data
+	for (size_t ii=0; ii<values.size(); ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 
 		size_t start, end;
 		if( get_window_specs(ii, ivec, start, end) ) {
-			value = calcExpSmoothing(ivec, param, start, end, ii);
+			value = calcExpSmoothing(ivalues, start, end, ii);
 		} else if(!is_soft) value = IOUtils::nodata;
 	}
-
 }
 
-double ProcExpSmoothing::calcExpSmoothing(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end, const size_t& pos)
+double ProcExpSmoothing::calcExpSmoothing(const std::vector<double>& ivec, const size_t& start, const size_t& end, const size_t& pos) const
 {
 	const size_t max_len = max(pos-start, end-pos);
 	bool initCompleted = false;
@@ -57,8 +62,8 @@ double ProcExpSmoothing::calcExpSmoothing(const std::vector<MeteoData>& ivec, co
 
 	for (size_t ii=1; ii<=max_len; ii++) {
 		//getting values left and right of the current point
-		const double val1 = ( pos>=ii && (pos-ii)>=start )? ivec[pos-ii](param) : IOUtils::nodata;
-		const double val2 = ( (pos+ii)<=end )? ivec[pos+ii](param) : IOUtils::nodata;
+		const double val1 = ( pos>=ii && (pos-ii)>=start )? ivec[pos-ii] : IOUtils::nodata;
+		const double val2 = ( (pos+ii)<=end )? ivec[pos+ii] : IOUtils::nodata;
 
 		//computing the average (centered window) or take the proper point (left or right window)
 		double val;
@@ -35,16 +35,21 @@ ProcUndercatch_Forland::ProcUndercatch_Forland(const std::vector<std::string>& v
 }
 
 void ProcUndercatch_Forland::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                                     std::vector<MeteoData>& ovec)
+{
+	process_by_column(param, ivec, ovec);
+}
+
+void ProcUndercatch_Forland::process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                            const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(param!=MeteoData::HNW)
 		throw InvalidArgumentException("Trying to use "+getName()+" filter on " + MeteoData::getParameterName(param) + " but it can only be applied to precipitation!!" + getName(), AT);
-	ovec = ivec;
 
-	for (size_t ii=0; ii<ovec.size(); ii++){
-		double& tmp = ovec[ii](param);
-		const double VW = ovec[ii](MeteoData::VW);
-		const double TA = ovec[ii](MeteoData::TA);
+	for (size_t ii=0; ii<values.size(); ii++){
+		double& tmp = values[ii];
+		const double VW = ivec[ii](MeteoData::VW);
+		const double TA = ivec[ii](MeteoData::TA);
 
 		if (tmp == IOUtils::nodata || tmp==0. || VW==IOUtils::nodata || TA==IOUtils::nodata) {
 			continue; //preserve nodata values and no precip or purely liquid precip
@@ -54,12 +59,12 @@ void ProcUndercatch_Forland::process(const unsigned int& param, const std::vecto
 			tmp *= solidPrecipitation(TA, VW);
 		else {
 			if(ii==0) {
-				cerr << "[W] Could not correct " << ovec[0].getNameForParameter(param) << ": ";
-				cerr << "not enough data for accumulation period at date " << ovec[0].date.toString(Date::ISO) << "\n";
+				cerr << "[W] Could not correct " << ivec[0].getNameForParameter(param) << ": ";
+				cerr << "not enough data for accumulation period at date " << ivec[0].date.toString(Date::ISO) << "\n";
 				continue;
 			}
-			const Date timestep = ovec[ii].date - ovec[ii-1].date;
-			const double Pint = ovec[ii](MeteoData::HNW) / (timestep.getJulian(true)*24.);
+			const Date timestep = ivec[ii].date - ivec[ii-1].date;
+			const double Pint = values[ii] / (timestep.getJulian(true)*24.);
 			const double krain = liquidPrecipitation(Pint, VW);
 			if(TA>=Train_WMO) {
 				tmp *= krain;
@@ -31,18 +31,23 @@ ProcUndercatch_Hamon::ProcUndercatch_Hamon(const std::vector<std::string>& vec_a
 }
 
 void ProcUndercatch_Hamon::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                                   std::vector<MeteoData>& ovec)
+{
+	process_by_column(param, ivec, ovec);
+}
+
+void ProcUndercatch_Hamon::process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                          const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(param!=MeteoData::HNW)
 		throw InvalidArgumentException("Trying to use "+getName()+" filter on " + MeteoData::getParameterName(param) + " but it can only be applied to precipitation!!" + getName(), AT);
-	ovec = ivec;
 
-	for (size_t ii=0; ii<ovec.size(); ii++){
-		double& tmp = ovec[ii](param);
-		double VW = ovec[ii](MeteoData::VW);
+	for (size_t ii=0; ii<values.size(); ii++){
+		double& tmp = values[ii];
+		double VW = ivec[ii](MeteoData::VW);
 		if(VW==IOUtils::nodata) continue; //we MUST have wind speed in order to filter
 		VW = Atmosphere::windLogProfile(VW, 10., 2.); //impact seems minimal
-		double t = ovec[ii](MeteoData::TA);
+		double t = ivec[ii](MeteoData::TA);
 		if(t==IOUtils::nodata) continue; //we MUST have air temperature in order to filter
 		t = K_TO_C(t); //t in celsius
 		double k=0.;
@@ -34,17 +34,22 @@ ProcUndercatch_WMO::ProcUndercatch_WMO(const std::vector<std::string>& vec_args,
 }
 
 void ProcUndercatch_WMO::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                                 std::vector<MeteoData>& ovec)
+{
+	process_by_column(param, ivec, ovec);
+}
+
+void ProcUndercatch_WMO::process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                        const std::vector<double>& /*julian*/, std::vector<double>& values)
 {
 	if(param!=MeteoData::HNW)
 		throw InvalidArgumentException("Trying to use "+getName()+" filter on " + MeteoData::getParameterName(param) + " but it can only be applied to precipitation!!" + getName(), AT);
-	ovec = ivec;
 
-	for (size_t ii=0; ii<ovec.size(); ii++){
-		double& tmp = ovec[ii](param);
-		double VW = ovec[ii](MeteoData::VW);
+	for (size_t ii=0; ii<values.size(); ii++){
+		double& tmp = values[ii];
+		double VW = ivec[ii](MeteoData::VW);
 		if(VW!=IOUtils::nodata) VW = Atmosphere::windLogProfile(VW, 10., 2.); //impact seems minimal
-		double t = ovec[ii](MeteoData::TA);
+		double t = ivec[ii](MeteoData::TA);
 		if(t==IOUtils::nodata) continue; //we MUST have air temperature in order to filter
 		t=K_TO_C(t); //t in celsius
 		precip_type precip = (t<=Tsnow)? snow : (t>=Train)? rain : mixed;
@@ -84,11 +89,11 @@ void ProcUndercatch_WMO::process(const unsigned int& param, const std::vector<Me
 			tmp *= 100./k;
 		} else if(type==rt3_jp) {
 			if(VW==IOUtils::nodata) continue;
-			const double rh = ovec[ii](MeteoData::RH);
-			const double alt = ovec[ii].meta.position.getAltitude();
+			const double rh = ivec[ii](MeteoData::RH);
+			const double alt = ivec[ii].meta.position.getAltitude();
 			double k=100.;
 			if(rh!=IOUtils::nodata && alt!=IOUtils::nodata) {
-				const double t_wb = K_TO_C(Atmosphere::wetBulbTemperature(ovec[ii](MeteoData::TA), rh, alt));
+				const double t_wb = K_TO_C(Atmosphere::wetBulbTemperature(ivec[ii](MeteoData::TA), rh, alt));
 				double ts_rate;
 				if(t_wb<1.1) ts_rate = 1. - .5*exp(-2.2*pow(1.1-t_wb, 1.3));
 				else ts_rate = .5*exp(-2.2*pow(t_wb-1.1, 1.3));
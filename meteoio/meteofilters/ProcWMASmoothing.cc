@@ -16,7 +16,9 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/meteofilters/ProcWMASmoothing.h>
+#include <meteoio/meteofilters/SlidingWindow.h>
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 
@@ -34,53 +36,70 @@ ProcWMASmoothing::ProcWMASmoothing(const std::vector<std::string>& vec_args, con
 }
 
 void ProcWMASmoothing::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                            std::vector<MeteoData>& ovec)
+                               std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){ //for every element in ovec, get a window
-		double& value = ovec[ii](param);
+	process_by_column(param, ivec, ovec);
+}
+
+void ProcWMASmoothing::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& ivec,
+                                      const std::vector<double>& /*julian*/, std::vector<double>& values)
+{
+	//The weights decrease linearly with the distance to the current point, so the weighted sums are updated incrementally
+	//on both sides of the current point. In a centered window, the points at the same distance on both sides are
+	//averaged together: this is done by removing half of the contributions of the part of the window that has
+	//points on both sides. The valid points whose symmetric point is nodata are then given back their full contributions.
+	const std::vector<double> ivalues( values ); //the smoothing is computed on the original data
+	SlidingLinearSum sum_left( ivalues ), sum_right( ivalues ), inner_left( ivalues ), inner_right( ivalues );
+	std::vector<size_t> gaps;
+	for (size_t ii=0; ii<ivalues.size(); ii++)
+		if(ivalues[ii]==IOUtils::nodata) gaps.push_back(ii);
+
+	for (size_t ii=0; ii<values.size(); ii++){ //for every element in ivec, get a window
+		double& value = values[ii];
 
 		size_t start, end;
-		if( get_window_specs(ii, ivec, start, end) ) {
-			value = calcWMASmoothing(ivec, param, start, end, ii);
-		} else if(!is_soft) value = IOUtils::nodata;
-	}
-}
+		if( !get_window_specs(ii, ivec, start, end) ) {
+			if(!is_soft) value = IOUtils::nodata;
+			continue;
+		}
 
-double ProcWMASmoothing::calcWMASmoothing(const std::vector<MeteoData>& ivec, const unsigned int& param, const size_t& start, const size_t& end, const size_t& pos)
-{ //such as WMA = 1*X1 + 2*X2 + ... + n*Xn and then normalized by the sum of weights = (1+2+3+...+n)
-	const size_t max_len = max(pos-start, end-pos);
-	double wma = 0.;
-	size_t norm = 0;
-
-	for (size_t ii=0; ii<=max_len; ii++) {
-		//getting values left and right of the current point
-		const double val1 = ( pos>=ii && (pos-ii)>=start )? ivec[pos-ii](param) : IOUtils::nodata;
-		const double val2 = ( (pos+ii)<=end )? ivec[pos+ii](param) : IOUtils::nodata;
-
-		//computing the average (centered window) or take the proper point (left or right window)
-		double val;
-		if(val1!=IOUtils::nodata && val2!=IOUtils::nodata) {
-			val = (val1+val2) * .5;
-		} else if(val1!=IOUtils::nodata) {
-			val = val1;
-		} else if(val2!=IOUtils::nodata) {
-			val = val2;
-		} else
-			val = IOUtils::nodata;
-
-		//compute the WMA contribution and normalization factor
-		if(val!=IOUtils::nodata) {
-			const size_t weight = max_len-ii+1;
-			wma += static_cast<double>(weight)*val;
-			norm += weight;
+		const size_t max_len = max(ii-start, end-ii);
+		const size_t inner_len = min(ii-start, end-ii);
+		const double pos = static_cast<double>(ii), len = static_cast<double>(max_len);
+		sum_left.setWindow(start, ii);
+		sum_right.setWindow(ii+1, end);
+		if(sum_left.getCount()+sum_right.getCount() == 0) {
+			value = IOUtils::nodata;
+			continue;
 		}
-	}
 
-	if (norm > 0)
-		return wma / static_cast<double>(norm);
-	else
-		return IOUtils::nodata;
+		//weights: index-(pos-max_len)+1 on the left side, (pos+max_len+1)-index on the right side
+		double wma_left, norm_left, wma_right, norm_right;
+		sum_left.getLinear(len-pos+1., 1., wma_left, norm_left);
+		sum_right.getLinear(pos+len+1., -1., wma_right, norm_right);
+		double wma = wma_left + wma_right, norm = norm_left + norm_right;
+
+		if(inner_len>0) {
+			inner_left.setWindow(ii-inner_len, ii-1);
+			inner_right.setWindow(ii+1, ii+inner_len);
+			inner_left.getLinear(len-pos+1., 1., wma_left, norm_left);
+			inner_right.getLinear(pos+len+1., -1., wma_right, norm_right);
+			wma -= .5*(wma_left + wma_right);
+			norm -= .5*(norm_left + norm_right);
+
+			std::vector<size_t>::const_iterator it = lower_bound(gaps.begin(), gaps.end(), ii-inner_len);
+			for (; it!=gaps.end() && *it<=ii+inner_len; ++it) {
+				if(*it==ii) continue;
+				const double partner = ivalues[2*ii - *it];
+				if(partner==IOUtils::nodata) continue;
+				const double weight = len - fabs(static_cast<double>(*it)-pos) + 1.;
+				wma += .5*weight*partner;
+				norm += .5*weight;
+			}
+		}
+
+		value = wma / norm;
+	}
 }
 
 void ProcWMASmoothing::parse_args(std::vector<std::string> vec_args)
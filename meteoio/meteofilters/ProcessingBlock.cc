@@ -169,6 +169,47 @@ ProcessingBlock* BlockFactory::getBlock(const std::string& blockname, const std:
 ProcessingBlock::ProcessingBlock(const std::string& name) : properties(), block_name(name)
 {}
 
+bool ProcessingBlock::has_column() const
+{
+	return false;
+}
+
+void ProcessingBlock::process_column(const unsigned int& /*param*/, const std::vector<MeteoData>& /*ivec*/,
+                                     const std::vector<double>& /*julian*/, std::vector<double>& /*values*/)
+{
+	throw IOException("The processing block \""+getName()+"\" can not process a column of values", AT);
+}
+
+/**
+ * @brief Implementation of process() for the blocks that implement process_column()
+ * @param param index of the parameter to process
+ * @param ivec the station's data
+ * @param ovec a copy of ivec, with the processed parameter
+ */
+void ProcessingBlock::process_by_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                        std::vector<MeteoData>& ovec)
+{
+	std::vector<double> julian, values;
+	get_column(param, ivec, julian, values);
+	process_column(param, ivec, julian, values);
+
+	ovec = ivec;
+	for (size_t ii=0; ii<ovec.size(); ii++)
+		ovec[ii](param) = values[ii];
+}
+
+void ProcessingBlock::get_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                 std::vector<double>& julian, std::vector<double>& values)
+{
+	const size_t nr_elems = ivec.size();
+	julian.resize( nr_elems );
+	values.resize( nr_elems );
+	for (size_t ii=0; ii<nr_elems; ii++) {
+		julian[ii] = ivec[ii].date.getJulian(true);
+		values[ii] = ivec[ii](param);
+	}
+}
+
 void ProcessingBlock::convert_args(const size_t& min_nargs, const size_t& max_nargs,
                                const std::vector<std::string>& vec_args, std::vector<double>& dbl_args) const
 {
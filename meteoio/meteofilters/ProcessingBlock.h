@@ -56,6 +56,12 @@ class ProcessingProperties {
 /**
  * @class  ProcessingBlock
  * @brief  An abstract class
+ * @details A processing block can be called in two ways: either on a vector of MeteoData (the processed parameter
+ * is modified in a copy of the input vector) or on a column of values that is modified in place (this is how the
+ * ProcessingStack calls the blocks, so the whole MeteoData vector does not have to be copied for each block).
+ * Every block must implement process(). The blocks that can work on a column of values also implement process_column()
+ * and return true in has_column(), their process() simply calling process_by_column(). The ProcessingStack only calls
+ * process_column() on these blocks, which avoids all the copies, the other blocks being called through process().
  * @author Thomas Egger
  * @date   2011-01-02
  */
@@ -66,6 +72,25 @@ class ProcessingBlock {
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec) = 0;
 
+		/**
+		 * @brief Does the block implement process_column()?
+		 * @return true if the block can be called through process_column()
+		 */
+		virtual bool has_column() const;
+
+		/**
+		 * @brief Process in place the values of one parameter for one station
+		 * @param param index of the parameter to process
+		 * @param ivec the station's data, only used as context (dates, other parameters, metadata). The processed
+		 * parameter must be read from values since the previous blocks of the stack might have modified it.
+		 * @param julian dates of the data points (gmt julian)
+		 * @param values values of the parameter to process, modified in place
+		 * The default implementation throws an exception, so it must be implemented by the blocks
+		 * that return true in has_column().
+		 */
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+
 		std::string getName() const;
 		const ProcessingProperties& getProperties() const;
 		const std::string toString() const;
@@ -78,6 +103,12 @@ class ProcessingBlock {
 
 		static bool is_soft(std::vector<std::string>& vec_args);
 
+		void process_by_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                       std::vector<MeteoData>& ovec);
+
+		static void get_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                       std::vector<double>& julian, std::vector<double>& values);
+
 		static void readCorrections(const std::string& filter, const std::string& filename, const char& c_type, const double& init, std::vector<double> &corrections);
 
 		ProcessingProperties properties;
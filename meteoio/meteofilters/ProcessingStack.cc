@@ -16,6 +16,7 @@
     along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <meteoio/meteofilters/ProcessingStack.h>
+#include <meteoio/Profiler.h>
 
 using namespace std;
 
@@ -73,66 +74,96 @@ void ProcessingStack::getWindowSize(ProcessingProperties& o_properties)
 //(as defined in the constructor)
 void ProcessingStack::process(const std::vector< std::vector<MeteoData> >& ivec,
                               std::vector< std::vector<MeteoData> >& ovec, const bool& second_pass)
+{
+	ovec = ivec;
+	process(ovec, second_pass);
+}
+
+void ProcessingStack::process(std::vector< std::vector<MeteoData> >& vec, const bool& second_pass)
 {
 	const size_t nr_of_filters = filter_stack.size();
-	const size_t nr_stations = ivec.size();
-	ovec.resize( nr_stations );
+	const size_t nr_stations = vec.size();
+	std::vector<double> julian, values;
 
 	for (size_t ii=0; ii<nr_stations; ii++){ //for every station
-		if( ivec[ii].empty() ) continue; //no data, nothing to do!
+		if( vec[ii].empty() ) continue; //no data, nothing to do!
 
 		//pick one element and check whether the param_name parameter exists
-		const size_t param = ivec[ii].front().getParameterIndex(param_name);
-		if (param != IOUtils::npos){
-			//since all filters start with ovec=ivec, maybe we could just swap pointers instead for copying
-			std::vector<MeteoData> tmp( ivec[ii] );
-
-			//Now call the filters one after another for the current station and parameter
-			bool appliedFilter = false;
-			for (size_t jj=0; jj<nr_of_filters; jj++){
-				const ProcessingProperties::proc_stage& filter_stage = filter_stack[jj]->getProperties().stage;
-				if ( second_pass && ((filter_stage==ProcessingProperties::first) || (filter_stage==ProcessingProperties::none)) )
-					continue;
-
-				if ( !second_pass && ((filter_stage==ProcessingProperties::second) || (filter_stage==ProcessingProperties::none)) )
-					continue;
-
-				appliedFilter = true;
-				(*filter_stack[jj]).process(static_cast<unsigned int>(param), tmp, ovec[ii]);
-
-				if (tmp.size() == ovec[ii].size()){
-					#ifdef DATA_QA
-					for(size_t kk=0; kk<ovec[ii].size(); kk++) {
-						const double orig = tmp[kk](param);
-						const double filtered = ovec[ii][kk](param);
-						if(orig!=filtered) {
-							const string parname = tmp[kk].getNameForParameter(param);
-							const string filtername = (*filter_stack[jj]).getName();
-							cout << "[DATA_QA] Filtering " << parname << "::" << filtername << " " << tmp[kk].date.toString(Date::ISO_TZ) << "\n";
-						}
-					}
-					#endif
-					if ((jj+1) != nr_of_filters){//after the last filter not necessary
-						for (size_t kk=0; kk<ovec[ii].size(); kk++){
-							tmp[kk](param) = ovec[ii][kk](param);
-						}
-					}
-				} else {
-					ostringstream ss;
-					ss << "The filter \"" << (*filter_stack[jj]).getName() << "\" received " << tmp.size();
-					ss << " timestamps and returned " << ovec[ii].size() << " timestamps!";
-					throw IndexOutOfBoundsException(ss.str(), AT);
+		const size_t param = vec[ii].front().getParameterIndex(param_name);
+		if (param == IOUtils::npos) continue;
+
+		//the parameter is extracted once and all the filters work on this column
+		bool column_ready = false;
+		const size_t nr_elems = vec[ii].size();
+
+		//Now call the filters one after another for the current station and parameter
+		for (size_t jj=0; jj<nr_of_filters; jj++){
+			const ProcessingProperties::proc_stage& filter_stage = filter_stack[jj]->getProperties().stage;
+			if ( second_pass && ((filter_stage==ProcessingProperties::first) || (filter_stage==ProcessingProperties::none)) )
+				continue;
+
+			if ( !second_pass && ((filter_stage==ProcessingProperties::second) || (filter_stage==ProcessingProperties::none)) )
+				continue;
+
+			if (!column_ready) {
+				julian.resize( nr_elems );
+				values.resize( nr_elems );
+				for (size_t kk=0; kk<nr_elems; kk++) {
+					julian[kk] = vec[ii][kk].date.getJulian(true);
+					values[kk] = vec[ii][kk](param);
 				}
+				column_ready = true;
 			}
 
-			if (!appliedFilter) //if not a single filter was applied
-				ovec[ii] = ivec[ii]; //just copy input to output
-		} else {
-			ovec[ii] = ivec[ii]; //just copy input to output
+			MIO_PROFILE(param_name+"::"+filter_stack[jj]->getName());
+			#ifdef DATA_QA
+			const std::vector<double> orig_values( values );
+			#endif
+			if ((*filter_stack[jj]).has_column())
+				(*filter_stack[jj]).process_column(static_cast<unsigned int>(param), vec[ii], julian, values);
+			else
+				process_records(*filter_stack[jj], static_cast<unsigned int>(param), vec[ii], values);
+
+			if (values.size() != nr_elems) {
+				ostringstream ss;
+				ss << "The filter \"" << (*filter_stack[jj]).getName() << "\" received " << nr_elems;
+				ss << " timestamps and returned " << values.size() << " timestamps!";
+				throw IndexOutOfBoundsException(ss.str(), AT);
+			}
+			#ifdef DATA_QA
+			for(size_t kk=0; kk<nr_elems; kk++) {
+				if(orig_values[kk]!=values[kk]) {
+					const string parname = vec[ii][kk].getNameForParameter(param);
+					const string filtername = (*filter_stack[jj]).getName();
+					cout << "[DATA_QA] Filtering " << parname << "::" << filtername << " " << vec[ii][kk].date.toString(Date::ISO_TZ) << "\n";
+				}
+			}
+			#endif
+		}
+
+		if (column_ready) {
+			for (size_t kk=0; kk<nr_elems; kk++)
+				vec[ii][kk](param) = values[kk];
 		}
 	}
 }
 
+//the block only implements the MeteoData interface, so the data has to be rebuilt for it
+void ProcessingStack::process_records(ProcessingBlock& block, const unsigned int& param, const std::vector<MeteoData>& ivec,
+                                      std::vector<double>& values)
+{
+	std::vector<MeteoData> tmp( ivec );
+	for (size_t ii=0; ii<tmp.size(); ii++)
+		tmp[ii](param) = values[ii];
+
+	std::vector<MeteoData> ovec;
+	block.process(param, tmp, ovec);
+
+	values.resize( ovec.size() ); //a size mismatch is reported by the caller
+	for (size_t ii=0; ii<ovec.size(); ii++)
+		values[ii] = ovec[ii](param);
+}
+
 const std::string ProcessingStack::toString() const
 {
 	std::ostringstream os;
@@ -43,11 +43,21 @@ class ProcessingStack {
 		void process(const std::vector< std::vector<MeteoData> >& ivec,
 		             std::vector< std::vector<MeteoData> >& ovec, const bool& second_pass=false);
 
+		/**
+		 * @brief Apply the filter stack in place: only the stack's parameter is modified in vec
+		 * @param vec data to process, for all the stations
+		 * @param second_pass is it the second processing pass?
+		 */
+		void process(std::vector< std::vector<MeteoData> >& vec, const bool& second_pass=false);
+
 		void getWindowSize(ProcessingProperties& o_properties);
 
 		const std::string toString() const;
 
 	private:
+		static void process_records(ProcessingBlock& block, const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            std::vector<double>& values);
+
 		std::vector<ProcessingBlock*> filter_stack; //for now: strictly linear chain of processing blocks
 		const std::string param_name;
 };
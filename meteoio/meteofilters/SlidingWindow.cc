@@ -0,0 +1,221 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/meteofilters/SlidingWindow.h>
+#include <meteoio/IOUtils.h>
+
+#include <cmath>
+#include <limits>
+
+namespace mio {
+
+void CompensatedSum::add(const double& value)
+{
+	const double tmp = sum + value;
+	if (tmp-tmp != 0.) { //overflow or non finite value: the sum is not finite anymore, there is nothing to compensate
+		sum = tmp;
+		return;
+	}
+	if (fabs(sum) >= fabs(value))
+		compensation += (sum - tmp) + value;
+	else
+		compensation += (value - tmp) + sum;
+	sum = tmp;
+}
+
+const size_t SlidingWindow::resync_interval = 4096;
+
+//check if a sum can still be trusted after a point has been removed: the point must not be orders of magnitude larger than the remaining sum
+static bool isAccurate(const double& removed, const double& remaining)
+{
+	static const double precision_ratio = 1e8;
+	return fabs(removed) <= precision_ratio * fabs(remaining);
+}
+
+void SlidingWindow::setWindow(const size_t& start, const size_t& end)
+{
+	if (end<start) { //empty window
+		if (!is_empty) {
+			reset();
+			count = 0;
+			is_empty = true;
+		}
+		return;
+	}
+
+	if (!is_empty && start<=win_end && end>=win_start && nr_updates<=resync_interval) {
+		//only process the points that enter or leave the window
+		while (win_start<start) { remove(win_start); win_start++; nr_updates++; }
+		while (win_start>start) { win_start--; add(win_start); nr_updates++; }
+		while (win_end<end) { win_end++; add(win_end); nr_updates++; }
+		while (win_end>end) { remove(win_end); win_end--; nr_updates++; }
+	}
+
+	if (is_empty || start!=win_start || end!=win_end || need_rebuild) {
+		//the new window does not overlap the previous one (or the accumulated rounding errors have to be cleared)
+		reset();
+		count = 0;
+		nr_updates = 0;
+		need_rebuild = false;
+		for (size_t ii=start; ii<=end; ii++) add(ii);
+	}
+
+	win_start = start;
+	win_end = end;
+	is_empty = false;
+}
+
+double SlidingMean::getMean() const
+{
+	if (count==0) return IOUtils::nodata;
+	return sum.getSum() / static_cast<double>(count);
+}
+
+void SlidingMean::reset()
+{
+	sum.reset();
+}
+
+void SlidingMean::add(const size_t& index)
+{
+	const double& value = data[index];
+	if (value==IOUtils::nodata) return;
+	sum.add(value);
+	count++;
+}
+
+void SlidingMean::remove(const size_t& index)
+{
+	const double& value = data[index];
+	if (value==IOUtils::nodata) return;
+	sum.add(-value);
+	count--;
+	if (!isAccurate(value, sum.getSum())) need_rebuild = true;
+}
+
+double SlidingVariance::getMean() const
+{
+	if (count==0) return IOUtils::nodata;
+	return mean;
+}
+
+double SlidingVariance::getStdDev() const
+{
+	if (count<=1) return IOUtils::nodata;
+	const double variance = (m2>0.)? m2 / static_cast<double>(count - 1) : 0.; //m2 could be slightly negative because of rounding
+	return sqrt(variance);
+}
+
+void SlidingVariance::reset()
+{
+	mean = 0.;
+	m2 = 0.;
+}
+
+void SlidingVariance::add(const size_t& index)
+{
+	const double& value = data[index];
+	if (value==IOUtils::nodata) return;
+	count++;
+	const double delta = value - mean;
+	mean += delta / static_cast<double>(count);
+	m2 += delta * (value - mean);
+}
+
+void SlidingVariance::remove(const size_t& index)
+{
+	const double& value = data[index];
+	if (value==IOUtils::nodata) return;
+	count--;
+	if (count==0) {
+		reset();
+		return;
+	}
+	const double delta = value - mean;
+	mean -= delta / static_cast<double>(count);
+	m2 -= delta * (value - mean);
+	//the rounding error on m2 is of the order of epsilon*delta^2, it must remain negligible compared to m2
+	if (delta*delta*std::numeric_limits<double>::epsilon() > 1e-8*m2) need_rebuild = true;
+}
+
+void SlidingLinearSum::getLinear(const double& a, const double& b, double& sum, double& norm) const
+{
+	//a + b*index = (a + b*origin) + b*(index-origin)
+	const double a_origin = a + b*static_cast<double>(origin);
+	sum = a_origin*sum0.getSum() + b*sum1.getSum();
+	norm = a_origin*static_cast<double>(count) + b*norm1;
+}
+
+void SlidingLinearSum::reset()
+{
+	sum0.reset();
+	sum1.reset();
+	norm1 = 0.;
+	has_origin = false;
+}
+
+void SlidingLinearSum::add(const size_t& index)
+{
+	if (!has_origin) { //the first point after a reset gives the origin
+		origin = index;
+		has_origin = true;
+	}
+	const double& value = data[index];
+	if (value==IOUtils::nodata) return;
+	const double rel_index = static_cast<double>(index) - static_cast<double>(origin);
+	sum0.add(value);
+	sum1.add(rel_index*value);
+	norm1 += rel_index;
+	count++;
+}
+
+void SlidingLinearSum::remove(const size_t& index)
+{
+	const double& value = data[index];
+	if (value==IOUtils::nodata) return;
+	const double rel_index = static_cast<double>(index) - static_cast<double>(origin);
+	sum0.add(-value);
+	sum1.add(-rel_index*value);
+	norm1 -= rel_index;
+	count--;
+	if (!isAccurate(value, sum0.getSum()) || !isAccurate(rel_index*value, sum1.getSum())) need_rebuild = true;
+}
+
+void SlidingVectorSum::reset()
+{
+	sum_u.reset();
+	sum_v.reset();
+}
+
+void SlidingVectorSum::add(const size_t& index)
+{
+	if (u[index]==IOUtils::nodata || v[index]==IOUtils::nodata) return;
+	sum_u.add(u[index]);
+	sum_v.add(v[index]);
+	count++;
+}
+
+void SlidingVectorSum::remove(const size_t& index)
+{
+	if (u[index]==IOUtils::nodata || v[index]==IOUtils::nodata) return;
+	sum_u.add(-u[index]);
+	sum_v.add(-v[index]);
+	count--;
+	if (!isAccurate(u[index], sum_u.getSum()) || !isAccurate(v[index], sum_v.getSum())) need_rebuild = true;
+}
+
+} //end namespace
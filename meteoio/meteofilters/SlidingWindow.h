@@ -0,0 +1,177 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __SLIDINGWINDOW_H__
+#define __SLIDINGWINDOW_H__
+
+#include <vector>
+#include <cstddef>
+
+namespace mio {
+
+/**
+ * @class CompensatedSum
+ * @brief Sum of doubles with Neumaier's compensation of the rounding errors, so that adding and then removing
+ * values (by adding their opposite) does not accumulate errors.
+ * @date   2014-05-14
+ */
+class CompensatedSum {
+	public:
+		CompensatedSum() : sum(0.), compensation(0.) {}
+		void add(const double& value);
+		void reset() {sum=0.; compensation=0.;}
+		double getSum() const {return sum+compensation;}
+
+	private:
+		double sum, compensation;
+};
+
+/**
+ * @class SlidingWindow
+ * @brief Base class for the statistics that are computed on a moving window over a column of data.
+ * When the window moves, only the points that enter or leave the window are processed so walking through
+ * the data with a window of any size is O(n). Since some rounding errors could accumulate after many updates,
+ * the statistics are recomputed from scratch every few thousand updates. They are also recomputed when a point that
+ * is much larger than the remaining ones leaves the window (for example a spike), since the remaining ones could
+ * then not be accurately represented anymore. The nodata values are skipped.
+ * The window bounds are given as indices in the data (usually obtained from WindowedFilter::get_window_specs()).
+ * @date   2014-05-14
+ */
+class SlidingWindow {
+	public:
+		virtual ~SlidingWindow() {}
+
+		/**
+		* @brief Move the window to [start, end] (both included), an empty window is given by end<start
+		* @param start index of the first point of the window
+		* @param end index of the last point of the window
+		*/
+		void setWindow(const size_t& start, const size_t& end);
+
+		size_t getCount() const {return count;} ///< number of valid (ie not nodata) points in the window
+
+	protected:
+		SlidingWindow() : count(0), need_rebuild(false), win_start(0), win_end(0), nr_updates(0), is_empty(true) {}
+
+		virtual void reset() = 0;
+		virtual void add(const size_t& index) = 0; ///< add the point at index, if it is valid
+		virtual void remove(const size_t& index) = 0; ///< remove the point at index, if it is valid
+
+		static const size_t resync_interval; ///< after this many updates, the statistics are recomputed from scratch
+		size_t count;
+		bool need_rebuild; ///< set by remove() when the remaining statistics might have lost their precision
+
+	private:
+		size_t win_start, win_end, nr_updates;
+		bool is_empty;
+};
+
+/**
+ * @class SlidingMean
+ * @brief Moving window sum, count and arithmetic mean
+ */
+class SlidingMean : public SlidingWindow {
+	public:
+		SlidingMean(const std::vector<double>& i_data) : data(i_data), sum() {}
+		double getSum() const {return sum.getSum();}
+		double getMean() const; ///< nodata if there are no valid points
+
+	protected:
+		virtual void reset();
+		virtual void add(const size_t& index);
+		virtual void remove(const size_t& index);
+
+	private:
+		const std::vector<double>& data;
+		CompensatedSum sum;
+};
+
+/**
+ * @class SlidingVariance
+ * @brief Moving window mean and variance, using Welford's algorithm (extended for the removal of points)
+ */
+class SlidingVariance : public SlidingWindow {
+	public:
+		SlidingVariance(const std::vector<double>& i_data) : data(i_data), mean(0.), m2(0.) {}
+		double getMean() const; ///< nodata if there are no valid points
+		double getStdDev() const; ///< sample standard deviation, nodata if there are less than two valid points
+
+	protected:
+		virtual void reset();
+		virtual void add(const size_t& index);
+		virtual void remove(const size_t& index);
+
+	private:
+		const std::vector<double>& data;
+		double mean, m2;
+};
+
+/**
+ * @class SlidingLinearSum
+ * @brief Moving window sums of the data weighted by a linear function of the index, a + b*index.
+ * The sums are kept relative to an origin that moves with the window, so the weights remain small numbers.
+ */
+class SlidingLinearSum : public SlidingWindow {
+	public:
+		SlidingLinearSum(const std::vector<double>& i_data) : data(i_data), origin(0), sum0(), sum1(), norm1(0.), has_origin(false) {}
+
+		/**
+		* @brief Get the weighted sum of the valid points in the window and the sum of their weights
+		* @param a constant part of the weights
+		* @param b slope of the weights (per index)
+		* @param sum sum of (a + b*index)*data[index]
+		* @param norm sum of (a + b*index)
+		*/
+		void getLinear(const double& a, const double& b, double& sum, double& norm) const;
+
+	protected:
+		virtual void reset();
+		virtual void add(const size_t& index);
+		virtual void remove(const size_t& index);
+
+	private:
+		const std::vector<double>& data;
+		size_t origin;
+		CompensatedSum sum0, sum1; ///< sum of data and of (index-origin)*data
+		double norm1; ///< sum of (index-origin), this is an exact integer
+		bool has_origin;
+};
+
+/**
+ * @class SlidingVectorSum
+ * @brief Moving window sums of 2D vectors given by their components, only the points where both components are valid are used
+ */
+class SlidingVectorSum : public SlidingWindow {
+	public:
+		SlidingVectorSum(const std::vector<double>& i_u, const std::vector<double>& i_v) : u(i_u), v(i_v), sum_u(), sum_v() {}
+		double getSumU() const {return sum_u.getSum();}
+		double getSumV() const {return sum_v.getSum();}
+
+	protected:
+		virtual void reset();
+		virtual void add(const size_t& index);
+		virtual void remove(const size_t& index);
+
+	private:
+		const std::vector<double>& u;
+		const std::vector<double>& v;
+		CompensatedSum sum_u, sum_v;
+};
+
+} //end namespace
+
+#endif
@@ -28,14 +28,20 @@ TEMPLATE::TEMPLATE(const std::vector<std::string>& vec_args, const std::string&
 	properties.stage = ProcessingProperties::first; //for the rest: default values
 }
 
+//when a filter implements process_column(), process() simply calls it through process_by_column()
 void TEMPLATE::process(const unsigned int& param, const std::vector<MeteoData>& ivec,
-                        std::vector<MeteoData>& ovec)
+                       std::vector<MeteoData>& ovec)
 {
-	ovec = ivec;
-	for (size_t ii=0; ii<ovec.size(); ii++){
+	process_by_column(param, ivec, ovec);
+}
+
+void TEMPLATE::process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+                              const std::vector<double>& julian, std::vector<double>& values)
+{
+	for (size_t ii=0; ii<values.size(); ii++){
 		//here, implement what has to be done on each data point
 		//for example:
-		double& tmp = ovec[ii](param);
+		double& tmp = values[ii];
 		if (tmp == IOUtils::nodata) continue; //preserve nodata values
 
 		if (tmp < 0.){ //delete all values less than zero
@@ -46,6 +46,10 @@ class TEMPLATE : public FilterBlock { //use this one for simple filter that only
 
 		virtual void process(const unsigned int& param, const std::vector<MeteoData>& ivec,
 		                     std::vector<MeteoData>& ovec);
+		//the values of the parameter are processed in place, ivec only provides the context (dates, other parameters, etc)
+		virtual void process_column(const unsigned int& param, const std::vector<MeteoData>& ivec,
+		                            const std::vector<double>& julian, std::vector<double>& values);
+		virtual bool has_column() const {return true;} //only return true when process_column() is implemented
 
 	private:
 		void parse_args(std::vector<std::string> vec_args);
@@ -50,6 +50,34 @@ SunObject::SunObject(const double& i_latitude, const double& i_longitude, const
 }
 
 void SunObject::setDate(const double& i_julian, const double& TZ)
+{
+	if(setJulian(i_julian, TZ)) update();
+}
+
+/**
+ * @brief Set the date, getting the date dependent terms of the Sun's position from an ephemeris.
+ * This is much faster when the same dates are used for many locations (the ephemeris should then be
+ * shared between them), the results being identical.
+ * @param i_julian local julian date
+ * @param TZ time zone
+ * @param ephemeris cache of the date dependent terms
+ */
+void SunObject::setDate(const double& i_julian, const double& TZ, SunEphemeris& ephemeris)
+{
+	if(setJulian(i_julian, TZ)) position.setAll(latitude, longitude, ephemeris.getDateTerms(julian_gmt));
+}
+
+/**
+ * @brief Set the date from the date dependent terms of the Sun's position, as given by SunEphemeris::getDateTerms()
+ * @param date_terms date dependent terms, their date being GMT
+ */
+void SunObject::setDate(const SunEphemeris::DateTerms& date_terms)
+{
+	if(setJulian(date_terms.julian_gmt, 0.)) position.setAll(latitude, longitude, date_terms);
+}
+
+//set the date, returns true if the position has to be updated
+bool SunObject::setJulian(const double& i_julian, const double& TZ)
 {
 	const double i_julian_gmt = i_julian - TZ/24.;
 
@@ -60,10 +88,8 @@ void SunObject::setDate(const double& i_julian, const double& TZ)
 	}
 
 	//if the date was new or if the previous date had not lead to an update -> update now
-	if(latitude!=IOUtils::nodata && longitude!=IOUtils::nodata && altitude!=IOUtils::nodata &&
-	  (beam_toa==IOUtils::nodata || beam_direct==IOUtils::nodata || beam_diffuse==IOUtils::nodata)) {
-		update();
-	}
+	return (latitude!=IOUtils::nodata && longitude!=IOUtils::nodata && altitude!=IOUtils::nodata &&
+	       (beam_toa==IOUtils::nodata || beam_direct==IOUtils::nodata || beam_diffuse==IOUtils::nodata));
 }
 
 void SunObject::setLatLon(const double& i_latitude, const double& i_longitude, const double& i_altitude)
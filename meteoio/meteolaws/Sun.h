@@ -25,6 +25,7 @@
 
 #include <meteoio/IOUtils.h>
 #include <meteoio/meteolaws/Suntrajectory.h>
+#include <meteoio/meteolaws/SunEphemeris.h>
 
 namespace mio {
 
@@ -51,6 +52,8 @@ class SunObject {
 
 		//local julian date and timezone
 		void setDate(const double& i_julian, const double& TZ=0.);
+		void setDate(const double& i_julian, const double& TZ, SunEphemeris& ephemeris);
+		void setDate(const SunEphemeris::DateTerms& date_terms);
 		void setLatLon(const double& i_latitude, const double& i_longitude, const double& i_altitude);
 		void setElevationThresh(const double& i_elevation_threshold);
 
@@ -71,6 +74,7 @@ class SunObject {
 
 		const std::string toString() const;
 	private:
+		bool setJulian(const double& i_julian, const double& TZ);
 		void update();
 		void getBeamPotential(const double& sun_elevation, const double& Eccentricity_corr,
 		                      const double& ta, const double& rh, const double& pressure, const double& mean_albedo,
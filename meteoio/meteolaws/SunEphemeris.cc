@@ -0,0 +1,176 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <meteoio/meteolaws/SunEphemeris.h>
+#include <meteoio/meteolaws/Meteoconst.h> //for math constants
+
+#include <cmath>
+#include <algorithm>
+
+namespace mio {
+
+const size_t SunEphemeris::max_dates = 100000;
+
+static bool earlierThan(const SunEphemeris::DateTerms& date_terms, const double& julian_gmt)
+{
+	return date_terms.julian_gmt < julian_gmt;
+}
+
+const SunEphemeris::DateTerms& SunEphemeris::getDateTerms(const double& julian_gmt)
+{
+	//the dates are most often requested in sequence: first try the last returned date and the next one
+	if (last_index<terms.size() && terms[last_index].julian_gmt==julian_gmt)
+		return terms[last_index];
+	if (last_index+1<terms.size() && terms[last_index+1].julian_gmt==julian_gmt)
+		return terms[++last_index];
+
+	std::vector<DateTerms>::iterator it = std::lower_bound(terms.begin(), terms.end(), julian_gmt, earlierThan);
+	if (it==terms.end() || it->julian_gmt!=julian_gmt) {
+		if (terms.size()>=max_dates) {
+			terms.clear();
+			it = terms.end();
+		}
+		DateTerms date_terms;
+		computeDateTerms(julian_gmt, date_terms);
+		it = terms.insert(it, date_terms);
+	}
+
+	last_index = static_cast<size_t>(it - terms.begin());
+	return *it;
+}
+
+void SunEphemeris::getDateTerms(const std::vector<double>& julian_gmt, std::vector<DateTerms>& date_terms)
+{
+	const size_t nr_dates = julian_gmt.size();
+	date_terms.resize(nr_dates);
+	for (size_t ii=0; ii<nr_dates; ii++)
+		date_terms[ii] = getDateTerms(julian_gmt[ii]);
+}
+
+void SunEphemeris::clear()
+{
+	terms.clear();
+	last_index = 0;
+}
+
+void SunEphemeris::getHorizontalCoordinates(const std::vector<double>& julian_gmt, const double& latitude, const double& longitude,
+                                            std::vector<double>& azimuth, std::vector<double>& elevation, std::vector<double>& eccentricity)
+{
+	const size_t nr_dates = julian_gmt.size();
+	azimuth.resize(nr_dates);
+	elevation.resize(nr_dates);
+	eccentricity.resize(nr_dates);
+
+	const double sin_lat = sin(latitude*Cst::to_rad);
+	const double cos_lat = cos(latitude*Cst::to_rad);
+	for (size_t ii=0; ii<nr_dates; ii++) {
+		const DateTerms& date_terms = getDateTerms(julian_gmt[ii]);
+		double hour_angle;
+		computePosition(date_terms, longitude, sin_lat, cos_lat, hour_angle, azimuth[ii], elevation[ii]);
+		eccentricity[ii] = date_terms.eccentricity;
+	}
+}
+
+void SunEphemeris::getHorizontalCoordinates(const double& julian_gmt, const std::vector<double>& latitude, const std::vector<double>& longitude,
+                                            std::vector<double>& azimuth, std::vector<double>& elevation)
+{
+	const size_t nr_stations = std::min(latitude.size(), longitude.size());
+	azimuth.resize(nr_stations);
+	elevation.resize(nr_stations);
+
+	const DateTerms& date_terms = getDateTerms(julian_gmt);
+	for (size_t ii=0; ii<nr_stations; ii++) {
+		double hour_angle;
+		computePosition(date_terms, longitude[ii], sin(latitude[ii]*Cst::to_rad), cos(latitude[ii]*Cst::to_rad), hour_angle, azimuth[ii], elevation[ii]);
+	}
+}
+
+void SunEphemeris::computeDateTerms(const double& julian, DateTerms& date_terms)
+{
+	date_terms.julian_gmt = julian;
+	date_terms.gmt_time = ((julian + 0.5) - floor(julian + 0.5))*24.; //in hours
+	const double julian_century = (julian - 2451545.)/36525.;
+
+	//parameters of the orbits of the Earth and Sun
+	const double geomMeanLongSun = fmod( 280.46646 + julian_century*(36000.76983 + julian_century*0.0003032) , 360.);
+	const double geomMeanAnomSun = 357.52911 + julian_century*(35999.05029 - 0.0001537*julian_century);
+	const double eccentricityEarth = 0.016708634 - julian_century*(0.000042037 + 0.0001537*julian_century);
+	const double SunEqOfCtr =   sin(1.*geomMeanAnomSun*Cst::to_rad)*( 1.914602-julian_century*(0.004817+0.000014*julian_century))
+	             + sin(2.*geomMeanAnomSun*Cst::to_rad)*(0.019993 - 0.000101*julian_century)
+	             + sin(3.*geomMeanAnomSun*Cst::to_rad)*(0.000289);
+
+	const double SunTrueLong = geomMeanLongSun + SunEqOfCtr;
+
+	const double SunAppLong = SunTrueLong - 0.00569 - 0.00478*sin( (125.04-1934.136*julian_century)*Cst::to_rad );
+	const double MeanObliqueEcl = 23. + (26.+
+	                 (21.448-julian_century*(46.815+julian_century*(0.00059-julian_century*0.001813))) / 60. )
+	                 / 60.;
+
+	const double ObliqueCorr = MeanObliqueEcl + 0.00256*cos( (125.04-1934.136*julian_century)*Cst::to_rad );
+
+	//Sun's position in the equatorial coordinate system
+	date_terms.right_ascension = atan2(
+	                    cos(SunAppLong*Cst::to_rad) ,
+	                    cos(ObliqueCorr*Cst::to_rad) * sin(SunAppLong*Cst::to_rad)
+	                    ) * Cst::to_deg;
+
+	const double SunDeclination = asin( sin(ObliqueCorr*Cst::to_rad) * sin(SunAppLong*Cst::to_rad) ) * Cst::to_deg;
+	date_terms.declination = SunDeclination;
+	date_terms.sin_declination = sin(SunDeclination*Cst::to_rad);
+	date_terms.cos_declination = cos(SunDeclination*Cst::to_rad);
+	date_terms.tan_declination = tan(SunDeclination*Cst::to_rad);
+
+	//time calculations
+	const double var_y = tan( 0.5*ObliqueCorr*Cst::to_rad ) * tan( 0.5*ObliqueCorr*Cst::to_rad );
+	date_terms.equation_of_time = 4. * ( var_y*sin(2.*geomMeanLongSun*Cst::to_rad)
+	                 - 2.*eccentricityEarth*sin(geomMeanAnomSun*Cst::to_rad) +
+	                 4.*eccentricityEarth*var_y*sin(geomMeanAnomSun*Cst::to_rad) * cos(2.*geomMeanLongSun*Cst::to_rad)
+	                 - 0.5*var_y*var_y*sin(4.*geomMeanLongSun*Cst::to_rad)
+	                 - 1.25*eccentricityEarth*eccentricityEarth*sin(2.*geomMeanAnomSun*Cst::to_rad)
+	                 )*Cst::to_deg;
+	date_terms.eccentricity = eccentricityEarth;
+}
+
+//Sun's position in the horizontal coordinate system (see http://en.wikipedia.org/wiki/Horizontal_coordinate_system)
+void SunEphemeris::computePosition(const DateTerms& date_terms, const double& longitude, const double& sin_lat, const double& cos_lat,
+                                   double& hour_angle, double& azimuth, double& elevation)
+{
+	const double lst_TZ = longitude*1./15.;
+	const double lst_hours = (date_terms.gmt_time+longitude*1./15.); //Local Sidereal Time
+	const double TrueSolarTime = fmod( lst_hours*60. + date_terms.equation_of_time + 4.*longitude - 60.*lst_TZ , 1440. ); //in LST time
+	if( TrueSolarTime<0. )
+		hour_angle = TrueSolarTime/4.+180.;
+	else
+		hour_angle = TrueSolarTime/4.-180.;
+
+	const double SolarZenithAngle = acos(
+	                   sin_lat * date_terms.sin_declination
+	                   + cos_lat * date_terms.cos_declination * cos(hour_angle*Cst::to_rad)
+	                   )*Cst::to_deg;
+
+	elevation = 90. - SolarZenithAngle;
+
+	const double cos_SAA = (sin_lat*cos(SolarZenithAngle*Cst::to_rad) - date_terms.sin_declination) /
+	                       (cos_lat*sin(SolarZenithAngle*Cst::to_rad));
+	if( hour_angle>0. ) {
+		azimuth = fmod( acos( std::min( 1., std::max(-1., cos_SAA) ) )*Cst::to_deg + 180., 360. );
+	} else {
+		azimuth = fmod( 540. - acos( std::min( 1., std::max(-1., cos_SAA) ) )*Cst::to_deg,  360. );
+	}
+}
+
+} //namespace
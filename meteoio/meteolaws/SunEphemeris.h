@@ -0,0 +1,107 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __SUNEPHEMERIS_H__
+#define __SUNEPHEMERIS_H__
+
+#include <vector>
+#include <cstddef>
+
+namespace mio {
+
+/**
+ * @class SunEphemeris
+ * @brief Cache of the date dependent terms of the Sun's position (Meeus algorithm, see SunMeeus).
+ * Most of the cost of computing the Sun's position lies in the terms that only depend on the date (the orbital
+ * parameters leading to the declination, the equation of time and the Earth's eccentricity). When the same dates are
+ * used for many stations (for example when generating the radiation at each station), these terms are computed only
+ * once per date and kept in this cache. The station dependent part (hour angle, elevation and azimuth) is then cheap
+ * and can be computed for a whole time series or a whole set of stations at once.
+ *
+ * The results are identical to the ones given by SunMeeus. This class is not thread safe, each thread should
+ * use its own ephemeris.
+ * @ingroup meteolaws
+ * @date   2014-05-15
+ */
+class SunEphemeris {
+	public:
+		/// the terms of the Sun's position that only depend on the date
+		typedef struct DATE_TERMS {
+			double julian_gmt; ///< julian date, GMT
+			double gmt_time; ///< time of the day, in hours
+			double eccentricity; ///< eccentricity of the Earth's orbit
+			double right_ascension, declination; ///< in degrees
+			double sin_declination, cos_declination, tan_declination;
+			double equation_of_time; ///< in minutes
+		} DateTerms;
+
+		SunEphemeris() : terms(), last_index(0) {}
+
+		/**
+		* @brief Get the date dependent terms for a given date, computing them if they are not in the cache yet
+		* @param julian_gmt julian date, GMT
+		* @return date dependent terms (valid until the next call)
+		*/
+		const DateTerms& getDateTerms(const double& julian_gmt);
+
+		/**
+		* @brief Get the date dependent terms for a series of dates
+		* @param julian_gmt julian dates, GMT
+		* @param date_terms date dependent terms for each date
+		*/
+		void getDateTerms(const std::vector<double>& julian_gmt, std::vector<DateTerms>& date_terms);
+
+		/**
+		* @brief Sun's position for one station over a time series
+		* @param julian_gmt julian dates, GMT
+		* @param latitude latitude of the station (in degrees)
+		* @param longitude longitude of the station (in degrees)
+		* @param azimuth Sun's azimuth for each date (in degrees, bearing)
+		* @param elevation Sun's TRUE elevation for each date (in degrees)
+		* @param eccentricity Earth's eccentricity for each date
+		*/
+		void getHorizontalCoordinates(const std::vector<double>& julian_gmt, const double& latitude, const double& longitude,
+		                              std::vector<double>& azimuth, std::vector<double>& elevation, std::vector<double>& eccentricity);
+
+		/**
+		* @brief Sun's position for a set of stations at one date
+		* @param julian_gmt julian date, GMT
+		* @param latitude latitudes of the stations (in degrees)
+		* @param longitude longitudes of the stations (in degrees)
+		* @param azimuth Sun's azimuth for each station (in degrees, bearing)
+		* @param elevation Sun's TRUE elevation for each station (in degrees)
+		*/
+		void getHorizontalCoordinates(const double& julian_gmt, const std::vector<double>& latitude, const std::vector<double>& longitude,
+		                              std::vector<double>& azimuth, std::vector<double>& elevation);
+
+		void clear();
+		size_t size() const {return terms.size();}
+
+		static void computeDateTerms(const double& julian_gmt, DateTerms& date_terms);
+		static void computePosition(const DateTerms& date_terms, const double& longitude, const double& sin_lat, const double& cos_lat,
+		                            double& hour_angle, double& azimuth, double& elevation);
+
+	private:
+		static const size_t max_dates; ///< the cache is cleared when it reaches this size
+
+		std::vector<DateTerms> terms; ///< sorted by date
+		size_t last_index; ///< index of the last returned terms, the dates are most often requested in sequence
+};
+
+} //end namespace
+
+#endif
@@ -316,55 +316,33 @@ void SunMeeus::getEquatorialSunVector(double& sunx, double& suny, double& sunz)
 	sunz =  sin( SolarElevation );
 }
 
+void SunMeeus::setAll(const double& i_latitude, const double& i_longitude, const SunEphemeris::DateTerms& date_terms)
+{
+	latitude = i_latitude;
+	longitude = i_longitude;
+	julian_gmt = date_terms.julian_gmt;
+	update(date_terms);
+}
+
 void SunMeeus::update() {
-	//calculating various time representations
-	const double julian = julian_gmt;
-	const double lst_TZ = longitude*1./15.;
-	const double gmt_time = ((julian + 0.5) - floor(julian + 0.5))*24.; //in hours
-	const double lst_hours=(gmt_time+longitude*1./15.); //Local Sidereal Time
-	const double julian_century = (julian - 2451545.)/36525.;
-
-	//parameters of the orbits of the Earth and Sun
-	const double geomMeanLongSun = fmod( 280.46646 + julian_century*(36000.76983 + julian_century*0.0003032) , 360.);
-	const double geomMeanAnomSun = 357.52911 + julian_century*(35999.05029 - 0.0001537*julian_century);
-	eccentricityEarth = 0.016708634 - julian_century*(0.000042037 + 0.0001537*julian_century);
-	const double SunEqOfCtr =   sin(1.*geomMeanAnomSun*Cst::to_rad)*( 1.914602-julian_century*(0.004817+0.000014*julian_century))
-	             + sin(2.*geomMeanAnomSun*Cst::to_rad)*(0.019993 - 0.000101*julian_century)
-	             + sin(3.*geomMeanAnomSun*Cst::to_rad)*(0.000289);
-
-	const double SunTrueLong = geomMeanLongSun + SunEqOfCtr;
-	/*const double SunTrueAnom = geomMeanAnomSun + SunEqOfCtr;*/
-	/*const double SunRadVector =   ( 1.000001018 * (1. - eccentricityEarth*eccentricityEarth) )
-	               / ( 1. + eccentricityEarth*cos(SunTrueAnom*Cst::to_rad) );*/
-
-	const double SunAppLong = SunTrueLong - 0.00569 - 0.00478*sin( (125.04-1934.136*julian_century)*Cst::to_rad );
-	const double MeanObliqueEcl = 23. + (26.+
-	                 (21.448-julian_century*(46.815+julian_century*(0.00059-julian_century*0.001813))) / 60. )
-	                 / 60.;
-
-	const double ObliqueCorr = MeanObliqueEcl + 0.00256*cos( (125.04-1934.136*julian_century)*Cst::to_rad );
-
-	//Sun's position in the equatorial coordinate system
-	SunRightAscension = atan2(
-	                    cos(SunAppLong*Cst::to_rad) ,
-	                    cos(ObliqueCorr*Cst::to_rad) * sin(SunAppLong*Cst::to_rad)
-	                    ) * Cst::to_deg;
-
-	SunDeclination = asin( sin(ObliqueCorr*Cst::to_rad) * sin(SunAppLong*Cst::to_rad) ) * Cst::to_deg;
+	SunEphemeris::DateTerms date_terms;
+	SunEphemeris::computeDateTerms(julian_gmt, date_terms);
+	update(date_terms);
+}
 
-	//time calculations
-	const double var_y = tan( 0.5*ObliqueCorr*Cst::to_rad ) * tan( 0.5*ObliqueCorr*Cst::to_rad );
-	const double EquationOfTime = 4. * ( var_y*sin(2.*geomMeanLongSun*Cst::to_rad)
-	                 - 2.*eccentricityEarth*sin(geomMeanAnomSun*Cst::to_rad) +
-	                 4.*eccentricityEarth*var_y*sin(geomMeanAnomSun*Cst::to_rad) * cos(2.*geomMeanLongSun*Cst::to_rad)
-	                 - 0.5*var_y*var_y*sin(4.*geomMeanLongSun*Cst::to_rad)
-	                 - 1.25*eccentricityEarth*eccentricityEarth*sin(2.*geomMeanAnomSun*Cst::to_rad)
-	                 )*Cst::to_deg;
+void SunMeeus::update(const SunEphemeris::DateTerms& date_terms) {
+	//the date dependent terms
+	eccentricityEarth = date_terms.eccentricity;
+	SunRightAscension = date_terms.right_ascension;
+	SunDeclination = date_terms.declination;
+	const double EquationOfTime = date_terms.equation_of_time;
 
+	//time calculations
+	const double lst_TZ = longitude*1./15.;
 	SolarNoon = (720. - 4.*longitude - EquationOfTime + lst_TZ*60.)/1440.; //in days, in LST time
 
-	const double cos_HAsunrise = cos(90.833*Cst::to_rad) / (cos(latitude*Cst::to_rad) * cos(SunDeclination*Cst::to_rad))
-	             - tan(latitude*Cst::to_rad)*tan(SunDeclination*Cst::to_rad);
+	const double cos_HAsunrise = cos(90.833*Cst::to_rad) / (cos(latitude*Cst::to_rad) * date_terms.cos_declination)
+	             - tan(latitude*Cst::to_rad)*date_terms.tan_declination;
 
 	if(cos_HAsunrise>=-1. && cos_HAsunrise<=1.) {
 		const double HA_sunrise = acos( cos_HAsunrise ) * Cst::to_deg;
@@ -381,19 +359,9 @@ void SunMeeus::update() {
 		SunlightDuration = 0.;
 	}
 
-	//Sun's position in the horizontal coordinate system (see http://en.wikipedia.org/wiki/Horizontal_coordinate_system)
-	const double TrueSolarTime = fmod( lst_hours*60. + EquationOfTime + 4.*longitude - 60.*lst_TZ , 1440. ); //in LST time
-	if( TrueSolarTime<0. )
-		HourAngle = TrueSolarTime/4.+180.;
-	else
-		HourAngle = TrueSolarTime/4.-180.;
-
-	const double SolarZenithAngle = acos(
-	                   sin(latitude*Cst::to_rad) * sin(SunDeclination*Cst::to_rad)
-	                   + cos(latitude*Cst::to_rad) * cos(SunDeclination*Cst::to_rad) * cos(HourAngle*Cst::to_rad)
-	                   )*Cst::to_deg;
-
-	SolarElevation = 90. - SolarZenithAngle;
+	//Sun's position in the horizontal coordinate system
+	SunEphemeris::computePosition(date_terms, longitude, sin(latitude*Cst::to_rad), cos(latitude*Cst::to_rad),
+	                              HourAngle, SolarAzimuthAngle, SolarElevation);
 
 	double AtmosphericRefraction;
 	if( SolarElevation>85. ) {
@@ -412,13 +380,6 @@ void SunMeeus::update() {
 	AtmosphericRefraction /= 3600.;
 
 	SolarElevationAtm = SolarElevation + AtmosphericRefraction; //correction for the effects of the atmosphere
-	const double cos_SAA = (sin(latitude*Cst::to_rad)*cos(SolarZenithAngle*Cst::to_rad) - sin(SunDeclination*Cst::to_rad)) /
-	                       (cos(latitude*Cst::to_rad)*sin(SolarZenithAngle*Cst::to_rad));
-	if( HourAngle>0. ) {
-		SolarAzimuthAngle = fmod( acos( std::min( 1., std::max(-1., cos_SAA) ) )*Cst::to_deg + 180., 360. );
-	} else {
-		SolarAzimuthAngle = fmod( 540. - acos( std::min( 1., std::max(-1., cos_SAA) ) )*Cst::to_deg,  360. );
-	}
 }
 
 } //namespace
@@ -19,6 +19,7 @@
 #define __SUNTAJECTORY_H__
 
 #include <meteoio/IOUtils.h>
+#include <meteoio/meteolaws/SunEphemeris.h>
 
 namespace mio {
 
@@ -111,6 +112,7 @@ class SunMeeus : public SunTrajectory {
 		void setDate(const double& i_julian, const double& TZ=0.);
 		void setLatLon(const double& i_latitude, const double& i_longitude);
 		void setAll(const double& i_latitude, const double& i_longitude, const double& i_julian, const double& TZ=0.);
+		void setAll(const double& i_latitude, const double& i_longitude, const SunEphemeris::DateTerms& date_terms);
 		void reset();
 
 		void getHorizontalCoordinates(double& azimuth, double& elevation) const;
@@ -121,6 +123,7 @@ class SunMeeus : public SunTrajectory {
 	private:
 		void private_init();
 		void update();
+		void update(const SunEphemeris::DateTerms& date_terms);
 
 	private:
 		double SolarElevationAtm;
@@ -143,6 +143,7 @@ bool FitLeastSquare::computeFit() {
 
 	Matrix A(nPts, nParam);
 	Matrix dBeta(nPts, (size_t)1);
+	Matrix AtA; //A^T·A, replaced by its Cholesky decomposition
 
 	unsigned int iter = 0;
 	do {
@@ -160,10 +161,16 @@ bool FitLeastSquare::computeFit() {
 			dBeta(m,1) = Y[m-1] - f(X[m-1]); //X and Y are vectors
 		}
 
-		//calculate parameters deltas
-		const Matrix a = A.getT() * A;
-		const Matrix b = A.getT() * dBeta;
-		if(!Matrix::solve(a, b, dLambda)) return false;
+		//calculate parameters deltas: A^T·A is symmetric, positive definite when the problem is well posed
+		Matrix::multiplyAtB(A, A, AtA);
+		Matrix::multiplyAtB(A, dBeta, dLambda);
+		if(AtA.choleskyDecomposition()) {
+			Matrix::choleskySolve(AtA, dLambda);
+		} else { //nearly singular system, the LU decomposition might still solve it
+			Matrix::multiplyAtB(A, A, AtA);
+			const Matrix AtdBeta(dLambda);
+			if(!Matrix::solve(AtA, AtdBeta, dLambda)) return false;
+		}
 
 		//apply the deltas to the parameters, record maximum delta
 		max_delta = 0.;
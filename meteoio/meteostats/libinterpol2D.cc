@@ -860,6 +860,7 @@ void Interpol2D::ODKriging(const std::vector<double>& vecData, const std::vector
 	Ginv.inv();
 
 	Matrix G0(nrOfMeasurments+1, (size_t)1);
+	Matrix lambda; //reused for all the cells
 	//now, calculate each point
 	for(size_t j=0; j<grid.nrows; j++) {
 		for(size_t i=0; i<grid.ncols; i++) {
@@ -878,7 +879,7 @@ void Interpol2D::ODKriging(const std::vector<double>& vecData, const std::vector
 			}
 			G0(nrOfMeasurments+1,1) = 1.; //last value is always 1
 
-			const Matrix lambda = Ginv*G0;
+			Matrix::multiply(Ginv, G0, lambda);
 
 			//calculate local parameter interpolation
 			double p = 0.;
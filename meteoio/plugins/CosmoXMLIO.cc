@@ -19,11 +19,12 @@
 #include <meteoio/meteolaws/Atmosphere.h>
 
 #include <sstream>
+#include <cstdio>
+#include <cstring>
 
 #include <libxml/parserInternals.h>
-#include <libxml/xpathInternals.h>
-#if !defined(LIBXML_XPATH_ENABLED) || !defined(LIBXML_SAX1_ENABLED)
-	#error Please enable XPATH and SAX1 in your version of libxml!
+#if !defined(LIBXML_PUSH_ENABLED)
+	#error Please enable the push parser in your version of libxml!
 #endif
 
 using namespace std;
@@ -36,6 +37,8 @@ namespace mio {
  * The files are written out by COSMO in Grib format and preprocessed by FieldExtra (MeteoSwiss) to get XML files.
  * It requires <A HREF="http://xmlsoft.org/">libxml2</A> to compile and run. It also assumes that the station IDs are unique
  * (ie two data sets with the same station ID are considered to belong to the same station).
+ * Each file is read in one single pass, without loading the whole document in memory. When several files must be read, they
+ * are read in parallel if MeteoIO has been compiled with OpenMP.
  *
  * @section cosmo_partners COSMO Group
  * This plugin has been developed primarily for reading XML files produced by COSMO (http://www.cosmo-model.org/) at MeteoSwiss.
@@ -107,13 +110,11 @@ namespace mio {
 const double CosmoXMLIO::in_tz = 0.; //Plugin specific timezone
 const xmlChar* CosmoXMLIO::xml_attribute = (const xmlChar *)"id";
 const xmlChar* CosmoXMLIO::xml_namespace = (const xmlChar *)"http://www.meteoswiss.ch/xmlns/modeltemplate/2";
-const xmlChar* CosmoXMLIO::xml_namespace_abrev = (const xmlChar*)"ns";
-const std::string CosmoXMLIO::StationData_xpath = "//ns:datainformation/ns:data-tables/ns:data/ns:row/ns:col";
-const std::string CosmoXMLIO::MeteoData_xpath = "//ns:valueinformation/ns:values-tables/ns:data/ns:row/ns:col";
+const size_t CosmoXMLIO::chunk_size = 65536;
 
 CosmoXMLIO::CosmoXMLIO(const std::string& configfile)
-           : cache_meteo_files(), xml_stations_id(), input_id(),
-             meteo_prefix(), meteo_ext(".xml"), plugin_nodata(-999.), imis_stations(false), use_model_loc(true), in_doc(NULL), in_xpathCtx(NULL),
+           : cache_meteo_files(), input_id(),
+             meteo_prefix(), meteo_ext(".xml"), plugin_nodata(-999.), imis_stations(false), use_model_loc(true),
              in_encoding(XML_CHAR_ENCODING_NONE), coordin(), coordinparam()
 {
 	Config cfg(configfile);
@@ -121,8 +122,8 @@ CosmoXMLIO::CosmoXMLIO(const std::string& configfile)
 }
 
 CosmoXMLIO::CosmoXMLIO(const Config& cfg)
-           : cache_meteo_files(), xml_stations_id(), input_id(),
-             meteo_prefix(), meteo_ext(".xml"), plugin_nodata(-999.), imis_stations(false), use_model_loc(true), in_doc(NULL), in_xpathCtx(NULL),
+           : cache_meteo_files(), input_id(),
+             meteo_prefix(), meteo_ext(".xml"), plugin_nodata(-999.), imis_stations(false), use_model_loc(true),
              in_encoding(XML_CHAR_ENCODING_NONE), coordin(), coordinparam()
 {
 	init(cfg);
@@ -184,24 +185,7 @@ void CosmoXMLIO::init(const Config& cfg)
 	}
 }
 
-CosmoXMLIO& CosmoXMLIO::operator=(const CosmoXMLIO& source) {
-	if(this != &source) {
-		cache_meteo_files = source.cache_meteo_files;
-		xml_stations_id = source.xml_stations_id;
-		input_id = source.input_id;
-		plugin_nodata = source.plugin_nodata;
-		in_doc = NULL;
-		in_xpathCtx = NULL;
-		coordin = source.coordin;
-		coordinparam = source.coordinparam;
-	}
-	return *this;
-}
-
-CosmoXMLIO::~CosmoXMLIO() throw()
-{
-	closeIn_XML();
-}
+CosmoXMLIO::~CosmoXMLIO() throw() {}
 
 void CosmoXMLIO::scanMeteoPath(const std::string& meteopath_in,  std::vector< std::pair<Date,std::string> > &meteo_files) const
 {
@@ -232,49 +216,147 @@ void CosmoXMLIO::scanMeteoPath(const std::string& meteopath_in,  std::vector< st
 	}
 }
 
-void CosmoXMLIO::openIn_XML(const std::string& in_meteofile)
-{
-	if(in_doc!=NULL) return; //the file has already been read
+//the elements leading to the data, all the other elements are ignored
+enum { elem_other, elem_datainformation, elem_valueinformation, elem_datatables, elem_valuestables, elem_data, elem_row, elem_col };
 
-	xmlInitParser();
-	xmlKeepBlanksDefault(0);
+//which section does the row ending at depth row_depth of the open elements belong to? (elem_other if this is not a row of interest)
+static int rowSection(const std::vector<int>& elements, const size_t& row_depth)
+{
+	if(row_depth<4 || elements[row_depth-1]!=elem_row || elements[row_depth-2]!=elem_data) return elem_other;
+	if(elements[row_depth-4]==elem_datainformation && elements[row_depth-3]==elem_datatables) return elem_datainformation;
+	if(elements[row_depth-4]==elem_valueinformation && elements[row_depth-3]==elem_valuestables) return elem_valueinformation;
+	return elem_other;
+}
 
-	if(in_encoding==XML_CHAR_ENCODING_NONE) {
-		in_doc = xmlParseFile(in_meteofile.c_str());
-	} else {
-		xmlParserCtxtPtr ctxt = xmlCreateFileParserCtxt( in_meteofile.c_str() );
-		xmlSwitchEncoding( ctxt, in_encoding);
-		xmlParseDocument( ctxt);
-		in_doc = ctxt->myDoc;
+void CosmoXMLIO::xml_startElement(void* ctx, const xmlChar* localname, const xmlChar* /*prefix*/, const xmlChar* URI,
+                                  int /*nb_namespaces*/, const xmlChar** /*namespaces*/, int nb_attributes, int /*nb_defaulted*/, const xmlChar** attributes)
+{
+	xml_reader& reader = *static_cast<xml_reader*>(ctx);
+
+	int element = elem_other;
+	if(URI!=NULL && xmlStrEqual(URI, xml_namespace)) {
+		if(xmlStrEqual(localname, (const xmlChar*)"col")) element = elem_col;
+		else if(xmlStrEqual(localname, (const xmlChar*)"row")) element = elem_row;
+		else if(xmlStrEqual(localname, (const xmlChar*)"data")) element = elem_data;
+		else if(xmlStrEqual(localname, (const xmlChar*)"data-tables")) element = elem_datatables;
+		else if(xmlStrEqual(localname, (const xmlChar*)"values-tables")) element = elem_valuestables;
+		else if(xmlStrEqual(localname, (const xmlChar*)"datainformation")) element = elem_datainformation;
+		else if(xmlStrEqual(localname, (const xmlChar*)"valueinformation")) element = elem_valueinformation;
 	}
-
-	if (in_doc == NULL) {
-		throw FileNotFoundException("Could not open/parse file \""+in_meteofile+"\"", AT);
+	reader.elements.push_back(element);
+
+	if(element==elem_col) {
+		if(rowSection(reader.elements, reader.elements.size()-1)==elem_other) return;
+		reader.in_col = true;
+		reader.col_id.clear();
+		reader.col_text.clear();
+		for(int ii=0; ii<nb_attributes; ii++) { //for each attribute: localname, prefix, URI, value start and value end
+			const xmlChar** attribute = attributes + 5*ii;
+			if(attribute[2]==NULL && xmlStrEqual(attribute[0], xml_attribute))
+				reader.col_id.assign((const char*)attribute[3], static_cast<size_t>(attribute[4]-attribute[3]));
+		}
+	} else if(element==elem_row) {
+		reader.row.clear();
+	} else if(element==elem_valueinformation && reader.metadata_only) { //all the metadata has been read
+		reader.stopped = true;
+		xmlStopParser(reader.ctxt);
 	}
+}
 
-	if(in_xpathCtx != NULL) xmlXPathFreeContext(in_xpathCtx); //free variable if this was not freed before
-	in_xpathCtx = xmlXPathNewContext(in_doc);
-	if(in_xpathCtx == NULL) {
-		closeIn_XML();
-		throw IOException("Unable to create new XPath context", AT);
+void CosmoXMLIO::xml_endElement(void* ctx, const xmlChar* /*localname*/, const xmlChar* /*prefix*/, const xmlChar* /*URI*/)
+{
+	xml_reader& reader = *static_cast<xml_reader*>(ctx);
+	if(reader.elements.empty()) return;
+
+	const int element = reader.elements.back();
+	if(element==elem_col && reader.in_col) {
+		reader.in_col = false;
+		if(!reader.col_text.empty()) reader.row.push_back( std::make_pair(reader.col_id, reader.col_text) );
+	} else if(element==elem_row) {
+		try {
+			const int section = rowSection(reader.elements, reader.elements.size());
+			if(section==elem_datainformation) reader.plugin->parseStationData(reader);
+			else if(section==elem_valueinformation) reader.plugin->parseMeteoData(reader);
+		} catch(const std::exception& e) {
+			reader.error = e.what();
+			xmlStopParser(reader.ctxt);
+		}
 	}
+	reader.elements.pop_back();
+}
 
-	if(xmlXPathRegisterNs(in_xpathCtx,  xml_namespace_abrev, xml_namespace) != 0) {
-		throw IOException("Unable to register namespace with prefix", AT);
-	}
+void CosmoXMLIO::xml_characters(void* ctx, const xmlChar* ch, int len)
+{
+	xml_reader& reader = *static_cast<xml_reader*>(ctx);
+	if(reader.in_col) reader.col_text.append((const char*)ch, static_cast<size_t>(len));
 }
 
-void CosmoXMLIO::closeIn_XML() throw()
+/**
+* @brief Read the stations' metadata and (if reader.metadata_only is false) data from a file.
+* The file is read in one pass with libxml's SAX2 push parser, so it is never fully loaded in memory. The rows of
+* metadata and data are given to parseStationData() and parseMeteoData() as soon as they have been read.
+* @param in_meteofile file to read
+* @param reader parsing state, containing the results once the file has been parsed
+*/
+void CosmoXMLIO::parseFile(const std::string& in_meteofile, xml_reader& reader) const
 {
-	if(in_xpathCtx!=NULL) {
-		xmlXPathFreeContext(in_xpathCtx);
-		in_xpathCtx = NULL;
+	for(size_t ii=0; ii<input_id.size(); ii++) {
+		const std::string& station_id = input_id[ii];
+		const std::string abbreviation = (imis_stations)? station_id.substr(0, station_id.find_first_of("0123456789")) : station_id;
+		reader.abbreviations[abbreviation].push_back(ii);
+	}
+
+	FILE *fp = fopen(in_meteofile.c_str(), "rb");
+	if(fp==NULL)
+		throw FileNotFoundException("Could not open/parse file \""+in_meteofile+"\"", AT);
+
+	xmlSAXHandler handler;
+	memset(&handler, 0, sizeof(handler));
+	handler.initialized = XML_SAX2_MAGIC;
+	handler.startElementNs = &xml_startElement;
+	handler.endElementNs = &xml_endElement;
+	handler.characters = &xml_characters;
+
+	reader.ctxt = xmlCreatePushParserCtxt(&handler, &reader, NULL, 0, in_meteofile.c_str());
+	if(reader.ctxt==NULL) {
+		fclose(fp);
+		throw IOException("Unable to create a parser for file \""+in_meteofile+"\"", AT);
+	}
+	if(in_encoding!=XML_CHAR_ENCODING_NONE) xmlSwitchEncoding(reader.ctxt, in_encoding);
+
+	std::vector<char> buffer(chunk_size);
+	bool parse_error = false;
+	size_t len;
+	while(!parse_error && (len=fread(&buffer[0], 1, chunk_size, fp))>0)
+		parse_error = (xmlParseChunk(reader.ctxt, &buffer[0], static_cast<int>(len), 0)!=0);
+	if(!parse_error) parse_error = (xmlParseChunk(reader.ctxt, NULL, 0, 1)!=0);
+
+	xmlFreeParserCtxt(reader.ctxt);
+	reader.ctxt = NULL;
+	fclose(fp);
+
+	if(!reader.error.empty())
+		throw IOException(reader.error, AT);
+	if(parse_error && !reader.stopped)
+		throw FileNotFoundException("Could not open/parse file \""+in_meteofile+"\"", AT);
+
+	for(size_t ii=0; ii<input_id.size(); ii++) {
+		const std::string& station_id = input_id[ii];
+		if(reader.nr_metadata[ii]==0)
+			throw NoAvailableDataException("No metadata found for station \""+station_id+"\"", AT);
+		if(reader.nr_metadata[ii]>1)
+			throw InvalidFormatException("Multiple definition of metadata for station \""+station_id+"\"", AT);
+		if(!reader.located[ii])
+			throw NoAvailableDataException("Some station location information is missing for station \""+station_id+"\"", AT);
+		if(reader.xml_id[ii].empty())
+			throw NoAvailableDataException("XML station id missing for station \""+station_id+"\"", AT);
 	}
-	if(in_doc!=NULL) {
-		xmlFreeDoc(in_doc);
-		in_doc = NULL;
+
+	if(reader.metadata_only) return;
+	for(size_t ii=0; ii<input_id.size(); ii++) {
+		if(!reader.data_found[ii])
+			throw NoAvailableDataException("No data found for station \""+reader.xml_id[ii]+"\"", AT);
 	}
-	xmlCleanupParser();
 }
 
 void CosmoXMLIO::read2DGrid(Grid2DObject& /*grid_out*/, const std::string& /*_name*/)
@@ -307,107 +389,95 @@ void CosmoXMLIO::readAssimilationData(const Date& /*date_in*/, Grid2DObject& /*d
 	throw IOException("Nothing implemented here", AT);
 }
 
-bool CosmoXMLIO::parseStationData(const std::string& station_id, const xmlXPathContextPtr& xpathCtx, StationData &sd)
+//a row of the metadata section has been read
+void CosmoXMLIO::parseStationData(xml_reader& reader) const
 {
-	//match something like "//ns:valueinformation/ns:values-tables/ns:data/ns:row/ns:col[@id='station_abbreviation' and text()='ATT']/.."
-	//the namespace "ns" has been previously defined
-	const std::string xpath_id = (imis_stations)? station_id.substr(0, station_id.find_first_of("0123456789")) : station_id;
-	const std::string xpath = StationData_xpath+"[@id='station_abbreviation' and text()='"+xpath_id+"']/.."; //and we take the parent node <row>
-
-	xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression((const xmlChar*)xpath.c_str(), xpathCtx);
-	if(xpathObj == NULL) return false;
-
-	//check the number of matches
-	const xmlNodeSetPtr &metadata = xpathObj->nodesetval;
-	const int nr_metadata = (metadata) ? metadata->nodeNr : 0;
-	if(nr_metadata==0)
-		throw NoAvailableDataException("No metadata found for station \""+station_id+"\"", AT);
-	if(nr_metadata>1)
-		throw InvalidFormatException("Multiple definition of metadata for station \""+station_id+"\"", AT);
+	const xml_row& row = reader.row;
 
-	//collect all the data fields
-	std::string xml_id;
-	double altitude = IOUtils::nodata, latitude = IOUtils::nodata, longitude = IOUtils::nodata;
-	//start from the first child until the last one
-	for (xmlNode *cur_node = metadata->nodeTab[0]->children; cur_node; cur_node = cur_node->next) {
-		if (cur_node->type == XML_ELEMENT_NODE) {
-			xmlChar *att = xmlGetProp(cur_node, xml_attribute);
-			const std::string field( (const char*)(att) );
-			xmlFree(att);
-
-			if (cur_node->children->type == XML_TEXT_NODE) {
-				const std::string value( (const char*)(cur_node->children->content) );
-
-				if(field=="identifier") xml_id = value;
-				//else if(field=="station_abbreviation") sd.stationID = value;
-				else if(field=="station_name") sd.stationName = value;
-				else if(field=="missing_value_code") IOUtils::convertString(plugin_nodata, value);
-
-				if(use_model_loc) {
-					if(field=="station_height") IOUtils::convertString(altitude, value);
-					else if(field=="station_latitude") IOUtils::convertString(latitude, value);
-					else if(field=="station_longitude") IOUtils::convertString(longitude, value);
-				} else {
-					if(field=="model_station_height") IOUtils::convertString(altitude, value);
-					else if(field=="model_station_latitude") IOUtils::convertString(latitude, value);
-					else if(field=="model_station_longitude") IOUtils::convertString(longitude, value);
-				}
-			}
+	std::map< std::string, std::vector<size_t> >::const_iterator it = reader.abbreviations.end();
+	for(size_t jj=0; jj<row.size(); jj++) {
+		if(row[jj].first=="station_abbreviation") {
+			it = reader.abbreviations.find(row[jj].second);
+			break;
 		}
 	}
+	if(it==reader.abbreviations.end()) return; //this station has not been requested
+
+	for(size_t kk=0; kk<it->second.size(); kk++) {
+		const size_t ii = it->second[kk];
+		if(++reader.nr_metadata[ii]>1) continue; //this will be reported once the whole file has been read
+
+		//collect all the data fields
+		StationData &sd = reader.vecStation[ii];
+		std::string xml_id;
+		double altitude = IOUtils::nodata, latitude = IOUtils::nodata, longitude = IOUtils::nodata;
+		for(size_t jj=0; jj<row.size(); jj++) {
+			const std::string& field = row[jj].first;
+			const std::string& value = row[jj].second;
+
+			if(field=="identifier") xml_id = value;
+			//else if(field=="station_abbreviation") sd.stationID = value;
+			else if(field=="station_name") sd.stationName = value;
+			else if(field=="missing_value_code") IOUtils::convertString(reader.plugin_nodata, value);
+
+			if(use_model_loc) {
+				if(field=="station_height") IOUtils::convertString(altitude, value);
+				else if(field=="station_latitude") IOUtils::convertString(latitude, value);
+				else if(field=="station_longitude") IOUtils::convertString(longitude, value);
+			} else {
+				if(field=="model_station_height") IOUtils::convertString(altitude, value);
+				else if(field=="model_station_latitude") IOUtils::convertString(latitude, value);
+				else if(field=="model_station_longitude") IOUtils::convertString(longitude, value);
+			}
+		}
 
-	sd.stationID = station_id;
-
-	if(latitude==IOUtils::nodata || longitude==IOUtils::nodata || altitude==IOUtils::nodata)
-		throw NoAvailableDataException("Some station location information is missing for station \""+station_id+"\"", AT);
-	sd.position.setProj(coordin, coordinparam);
-	sd.position.setLatLon(latitude, longitude, altitude);
+		sd.stationID = input_id[ii];
 
-	if(xml_id.empty())
-		throw NoAvailableDataException("XML station id missing for station \""+station_id+"\"", AT);
-	xml_stations_id[station_id] = xml_id;
+		if(latitude!=IOUtils::nodata && longitude!=IOUtils::nodata && altitude!=IOUtils::nodata) {
+			sd.position.setProj(coordin, coordinparam);
+			sd.position.setLatLon(latitude, longitude, altitude);
+			reader.located[ii] = true;
+		}
 
-	xmlXPathFreeObject(xpathObj);
-	return true;
+		if(!xml_id.empty()) {
+			reader.xml_id[ii] = xml_id;
+			reader.stations[xml_id].push_back(ii);
+		}
+	}
 }
 
-CosmoXMLIO::MeteoReadStatus CosmoXMLIO::parseMeteoDataPoint(const Date& dateStart, const Date& dateEnd, const xmlNodePtr &element, MeteoData &md) const
+CosmoXMLIO::MeteoReadStatus CosmoXMLIO::parseMeteoDataPoint(const Date& dateStart, const Date& dateEnd, const xml_row& row, const size_t& first_col,
+                                                            const double& nodata, MeteoData &md) const
 {
 	double iswr_dir = IOUtils::nodata, iswr_diff = IOUtils::nodata;
 
 	//collect all the data fields
-	for (xmlNode *cur_node = element; cur_node; cur_node = cur_node->next) {
-		if (cur_node->type == XML_ELEMENT_NODE) {
-			xmlChar *att = xmlGetProp(cur_node, xml_attribute);
-			const std::string field( (const char*)(att) );
-			xmlFree(att);
-
-			if (cur_node->children->type == XML_TEXT_NODE) {
-				const std::string value( (const char*)(cur_node->children->content) );
-				if(field=="reference_ts") {
-					IOUtils::convertString(md.date, value, in_tz);
-					if(md.date<dateStart) return read_continue;
-					if(md.date>dateEnd) return read_stop;
-				} else {
-					double tmp;
-					IOUtils::convertString(tmp, value);
-					tmp = IOUtils::standardizeNodata(tmp, plugin_nodata);
-
-					//for now, we hard-code the fields mapping
-					if(field=="108005") md(MeteoData::TA) = tmp;
-					else if(field=="108014") md(MeteoData::RH) = tmp/100.;
-					else if(field=="108015") md(MeteoData::VW) = tmp;
-					else if(field=="108017") md(MeteoData::DW) = tmp;
-					else if(field=="108018") md(MeteoData::VW_MAX) = tmp;
-					else if(field=="108023") md(MeteoData::HNW) = tmp;
-					else if(field=="108060") md(MeteoData::HS) = tmp/100.;
-					else if(field=="108062") md(MeteoData::TSS) = tmp;
-					else if(field=="108064") iswr_diff = tmp;
-					else if(field=="108065") iswr_dir = tmp;
-					else if(field=="108066") md(MeteoData::RSWR) = tmp;
-					else if(field=="108067") md(MeteoData::ILWR) = tmp; //108068=olwr
-				}
-			}
+	for(size_t jj=first_col; jj<row.size(); jj++) {
+		const std::string& field = row[jj].first;
+		const std::string& value = row[jj].second;
+
+		if(field=="reference_ts") {
+			IOUtils::convertString(md.date, value, in_tz);
+			if(md.date<dateStart) return read_continue;
+			if(md.date>dateEnd) return read_stop;
+		} else {
+			double tmp;
+			IOUtils::convertString(tmp, value);
+			tmp = IOUtils::standardizeNodata(tmp, nodata);
+
+			//for now, we hard-code the fields mapping
+			if(field=="108005") md(MeteoData::TA) = tmp;
+			else if(field=="108014") md(MeteoData::RH) = tmp/100.;
+			else if(field=="108015") md(MeteoData::VW) = tmp;
+			else if(field=="108017") md(MeteoData::DW) = tmp;
+			else if(field=="108018") md(MeteoData::VW_MAX) = tmp;
+			else if(field=="108023") md(MeteoData::HNW) = tmp;
+			else if(field=="108060") md(MeteoData::HS) = tmp/100.;
+			else if(field=="108062") md(MeteoData::TSS) = tmp;
+			else if(field=="108064") iswr_diff = tmp;
+			else if(field=="108065") iswr_dir = tmp;
+			else if(field=="108066") md(MeteoData::RSWR) = tmp;
+			else if(field=="108067") md(MeteoData::ILWR) = tmp; //108068=olwr
 		}
 	}
 
@@ -449,45 +519,36 @@ void CosmoXMLIO::readStationData(const Date& station_date, std::vector<StationDa
 	vecStation.clear();
 
 	const std::string meteofile( cache_meteo_files[ getFileIdx(station_date) ].second );
-	openIn_XML(meteofile);
-
-	//read all the stations' metadata
-	for(size_t ii=0; ii<input_id.size(); ii++) {
-		StationData sd;
-		if(!parseStationData(input_id[ii], in_xpathCtx, sd)) {
-			closeIn_XML();
-			throw IOException("Unable to evaluate xpath expression for station \""+input_id[ii]+"\"", AT);
-		}
-		vecStation.push_back(sd);
-	}
+	xml_reader reader(this, input_id.size(), Date(), Date(), true, plugin_nodata);
+	parseFile(meteofile, reader);
 
-	closeIn_XML();
+	plugin_nodata = reader.plugin_nodata;
+	vecStation = reader.vecStation;
 }
 
-bool CosmoXMLIO::parseMeteoData(const Date& dateStart, const Date& dateEnd, const std::string& station_id, const StationData& sd, const xmlXPathContextPtr& xpathCtx, std::vector<MeteoData> &vecMeteo) const
+//a row of the data section has been read: it is given to all the stations using its identifier
+void CosmoXMLIO::parseMeteoData(xml_reader& reader) const
 {
-	const std::string xpath = MeteoData_xpath+"[@id='identifier' and text()='"+station_id+"']";
+	const xml_row& row = reader.row;
 
-	xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression((const xmlChar*)xpath.c_str(), xpathCtx);
-	if(xpathObj == NULL) return false;
+	for(size_t jj=0; jj<row.size(); jj++) {
+		if(row[jj].first!="identifier") continue;
 
-	//check the number of matches
-	const xmlNodeSetPtr &data = xpathObj->nodesetval;
-	const int nr_data = (data) ? data->nodeNr : 0;
-	if(nr_data==0)
-		throw NoAvailableDataException("No data found for station \""+station_id+"\"", AT);
+		const std::map< std::string, std::vector<size_t> >::const_iterator it = reader.stations.find(row[jj].second);
+		if(it==reader.stations.end()) return; //this station has not been requested
 
-	//loop over all data for this station_id
-	for(int ii=0; ii<nr_data; ii++) {
-		MeteoData md( Date(), sd);
+		for(size_t kk=0; kk<it->second.size(); kk++) {
+			const size_t ii = it->second[kk];
+			reader.data_found[ii] = true;
+			if(reader.data_stop[ii]) continue;
 
-		const MeteoReadStatus status = parseMeteoDataPoint(dateStart, dateEnd, data->nodeTab[ii], md);
-		if(status==read_stop) break;
-		if(status==read_ok) vecMeteo.push_back( md );
+			MeteoData md( Date(), reader.vecStation[ii] );
+			const MeteoReadStatus status = parseMeteoDataPoint(reader.dateStart, reader.dateEnd, row, jj+1, reader.plugin_nodata, md);
+			if(status==read_stop) reader.data_stop[ii] = true;
+			if(status==read_ok) reader.vecMeteo[ii].push_back( md );
+		}
+		return;
 	}
-
-	xmlXPathFreeObject(xpathObj);
-	return true;
 }
 
 void CosmoXMLIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
@@ -499,57 +560,55 @@ void CosmoXMLIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
 	size_t file_idx = getFileIdx(dateStart);
 	Date nextDate;
 
+	std::vector<xml_reader*> readers; //a reader is bound to its parsing context, so it is never copied
+	std::vector<size_t> files;
 	do {
 		//since files contain overlapping data, we will only read the non-overlapping part
 		//ie from start to the start date of the next file
 		nextDate = ((file_idx+1)<nr_files)? cache_meteo_files[file_idx+1].first - 1./3600. : dateEnd;
+		readers.push_back( new xml_reader(this, input_id.size(), dateStart, nextDate, false, plugin_nodata) );
+		files.push_back(file_idx);
 
-		const std::string meteofile( cache_meteo_files[file_idx].second );
-		openIn_XML(meteofile);
+		file_idx++;
+	} while (file_idx<nr_files && nextDate<=dateEnd);
 
-		//read all the stations' metadata
-		std::vector<StationData> vecStation;
-		for(size_t ii=0; ii<input_id.size(); ii++) {
-			StationData sd;
-			if(!parseStationData(input_id[ii], in_xpathCtx, sd)) {
-				closeIn_XML();
-				throw IOException("Unable to evaluate xpath expression for station \""+input_id[ii]+"\"", AT);
-			}
-			vecStation.push_back(sd);
+	//the files are independent from each other, so they are parsed in parallel
+	const long nr_readers = static_cast<long>( readers.size() );
+	std::vector<IOException*> errors(readers.size(), NULL);
+
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+	#endif
+	for(long ii=0; ii<nr_readers; ii++) {
+		const size_t idx = static_cast<size_t>(ii);
+		try {
+			parseFile(cache_meteo_files[ files[idx] ].second, *readers[idx]);
+		} catch(const std::exception& e) {
+			const IOException *io_error = dynamic_cast<const IOException*>(&e);
+			errors[idx] = (io_error!=NULL)? new IOException(*io_error) : new IOException(e.what(), AT);
 		}
+	}
 
-		//read all the stations' data
-		for(size_t ii=0; ii<input_id.size(); ii++) {
-			const string station_id = xml_stations_id[ input_id[ii] ];
-
-			//do we already have a vector with this station meteo?
-			size_t found_id = IOUtils::npos;
-			for(size_t jj=0; jj<vecMeteo.size(); jj++) {
-				if(vecMeteo[jj].front().meta.stationID==input_id[ii]) {
-					found_id = jj;
-					break;
-				}
-			}
-
-			if(found_id==IOUtils::npos) { //creating the station
-				vector<MeteoData> vecTmp;
-				if(!parseMeteoData(dateStart, nextDate, station_id, vecStation[ii], in_xpathCtx, vecTmp)) {
-					closeIn_XML();
-					throw IOException("Unable to evaluate xpath expression for station \""+input_id[ii]+"\"", AT);
-				}
-				vecMeteo.push_back(vecTmp);
-			} else { //appending to the station
-				if(!parseMeteoData(dateStart, nextDate, station_id, vecStation[ii], in_xpathCtx, vecMeteo[found_id])) {
-					closeIn_XML();
-					throw IOException("Unable to evaluate xpath expression for station \""+input_id[ii]+"\"", AT);
-				}
-			}
-		}
+	//the error of the first file is reported
+	for(size_t ii=0; ii<errors.size(); ii++) {
+		if(errors[ii]==NULL) continue;
+		const IOException tmp( *errors[ii] );
+		for(size_t jj=ii; jj<errors.size(); jj++) delete errors[jj];
+		for(size_t jj=0; jj<readers.size(); jj++) delete readers[jj];
+		throw tmp;
+	}
 
-		closeIn_XML();
+	plugin_nodata = readers.back()->plugin_nodata;
 
-		file_idx++;
-	} while (file_idx<nr_files && nextDate<=dateEnd);
+	//each station gets the data of all the files, in order
+	vecMeteo.resize(input_id.size());
+	for(size_t ii=0; ii<readers.size(); ii++) {
+		for(size_t jj=0; jj<input_id.size(); jj++) {
+			const std::vector<MeteoData>& vecTmp = readers[ii]->vecMeteo[jj];
+			vecMeteo[jj].insert(vecMeteo[jj].end(), vecTmp.begin(), vecTmp.end());
+		}
+		delete readers[ii];
+	}
 }
 
 void CosmoXMLIO::writeMeteoData(const std::vector< std::vector<MeteoData> >& /*vecMeteo*/,
@@ -25,9 +25,10 @@ along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
 #include <meteoio/IOExceptions.h>
 
 #include <string>
+#include <vector>
+#include <map>
 
 #include <libxml/parser.h>
-#include <libxml/xpath.h>
 
 namespace mio {
 
@@ -47,8 +48,6 @@ class CosmoXMLIO : public IOInterface {
 		CosmoXMLIO(const Config& cfg);
 		~CosmoXMLIO() throw();
 
-		CosmoXMLIO& operator=(const CosmoXMLIO&); ///<Assignement operator, required because of pointer member
-
 		virtual void read2DGrid(Grid2DObject& grid_out, const std::string& parameter="");
 		virtual void read2DGrid(Grid2DObject& grid_out, const MeteoGrids::Parameters& parameter, const Date& date);
 
@@ -67,35 +66,67 @@ class CosmoXMLIO : public IOInterface {
 
 	private:
 		typedef enum METEOREADSTATUS { read_ok, read_continue, read_stop } MeteoReadStatus;
+		typedef std::vector< std::pair<std::string, std::string> > xml_row; //(id, text) of the columns of a row
+
+		//state of the parsing of one file, all the stations being read in one single pass over the file
+		typedef struct XML_READER {
+			XML_READER(const CosmoXMLIO* i_plugin, const size_t& nr_stations, const Date& i_dateStart, const Date& i_dateEnd,
+			           const bool& i_metadata_only, const double& i_nodata)
+			           : plugin(i_plugin), ctxt(NULL), dateStart(i_dateStart), dateEnd(i_dateEnd), metadata_only(i_metadata_only), stopped(false),
+			             elements(), in_col(false), col_id(), col_text(), row(), abbreviations(), vecStation(nr_stations), xml_id(nr_stations),
+			             nr_metadata(nr_stations, 0), located(nr_stations, false), stations(), vecMeteo(nr_stations),
+			             data_found(nr_stations, false), data_stop(nr_stations, false), plugin_nodata(i_nodata), error() {}
+			const CosmoXMLIO* plugin;
+			xmlParserCtxtPtr ctxt;
+			Date dateStart, dateEnd;
+			bool metadata_only; ///< stop the parsing after the stations' metadata
+			bool stopped; ///< the parsing has been stopped on purpose
+			std::vector<int> elements; ///< the elements that are currently open
+			bool in_col;
+			std::string col_id, col_text;
+			xml_row row;
+			std::map< std::string, std::vector<size_t> > abbreviations; ///< the stations that use a given station abbreviation
+			std::vector<StationData> vecStation;
+			std::vector<std::string> xml_id; ///< the messy id used in the xml for each station
+			std::vector<size_t> nr_metadata;
+			std::vector<bool> located;
+			std::map< std::string, std::vector<size_t> > stations; ///< the stations that use a given xml id
+			std::vector< std::vector<MeteoData> > vecMeteo;
+			std::vector<bool> data_found, data_stop;
+			double plugin_nodata;
+			std::string error; ///< exceptions can not be thrown through libxml, so they are kept here
+			private:
+				XML_READER(const XML_READER&); //the reader is bound to one libxml parsing context, it can not be copied
+				XML_READER& operator=(const XML_READER&);
+		} xml_reader;
 
 		void init(const Config& cfg);
 		void scanMeteoPath(const std::string& meteopath_in, std::vector< std::pair<Date,std::string> > &meteo_files) const;
 		size_t getFileIdx(const Date& start_date) const;
-		void openIn_XML(const std::string& in_meteofile);
-		void closeIn_XML() throw();
-		bool parseStationData(const std::string& station_id, const xmlXPathContextPtr& xpathCtx, StationData &sd);
-		MeteoReadStatus parseMeteoDataPoint(const Date& dateStart, const Date& dateEnd, const xmlNodePtr &element, MeteoData &md) const;
+		void parseFile(const std::string& in_meteofile, xml_reader& reader) const;
+		void parseStationData(xml_reader& reader) const;
+		void parseMeteoData(xml_reader& reader) const;
+		MeteoReadStatus parseMeteoDataPoint(const Date& dateStart, const Date& dateEnd, const xml_row& row, const size_t& first_col,
+		                                    const double& nodata, MeteoData &md) const;
 
-		bool parseMeteoData(const Date& dateStart, const Date& dateEnd, const std::string& station_id,
-		                    const StationData& sd, const xmlXPathContextPtr& xpathCtx, std::vector<MeteoData> &vecMeteo) const;
+		static void xml_startElement(void* ctx, const xmlChar* localname, const xmlChar* prefix, const xmlChar* URI,
+		                             int nb_namespaces, const xmlChar** namespaces, int nb_attributes, int nb_defaulted, const xmlChar** attributes);
+		static void xml_endElement(void* ctx, const xmlChar* localname, const xmlChar* prefix, const xmlChar* URI);
+		static void xml_characters(void* ctx, const xmlChar* ch, int len);
 
 		std::vector< std::pair<Date,std::string> > cache_meteo_files; //cache of meteo files in METEOPATH
-		std::map<std::string, std::string> xml_stations_id; //mapping between true station ID and the messy id used in the xml
 		std::vector<std::string> input_id; //user specified stations to read
 		std::string meteo_prefix, meteo_ext; //for the file naming scheme
 		double plugin_nodata; //plugin specific no data value
 		bool imis_stations; //to make the station ID like an IMIS station ID
 		bool use_model_loc; //for each station, use the model location instead of the true station location (default=true)
 
-		xmlDocPtr in_doc;
-		xmlXPathContextPtr in_xpathCtx;
 		xmlCharEncoding in_encoding;
 
 		static const double in_tz; //plugin specific time zones
 		static const xmlChar* xml_attribute;
 		static const xmlChar* xml_namespace;
-		static const xmlChar* xml_namespace_abrev;
-		static const std::string StationData_xpath, MeteoData_xpath;
+		static const size_t chunk_size; //how much of the file is given at once to the parser
 
 		std::string coordin, coordinparam; //projection parameters
 };
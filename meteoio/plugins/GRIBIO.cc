@@ -25,7 +25,11 @@
 
 #include <cmath>
 #include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <map>
 #include <errno.h>
+#include <sys/stat.h>
 #include <grib_api.h>
 
 using namespace std;
@@ -88,31 +92,52 @@ namespace mio {
  * - STATION#: coordinates for virtual stations (if using GRIB as METEO plugin). Each station is given by its coordinates and the closest
  * grid point will be chosen. Coordinates are given one one line as "lat lon" or "xcoord ycoord epsg_code". If a point leads to duplicate grid points,
  * it will be removed from the list.
+ * - GRIB_INDEX: file where to keep the index of all the messages found in METEOPATH, or <i>none</i> to always re-index the files
+ * (default: METEOPATH/meteoio_grib.idx)
+ * - GRIB_PARALLEL: decode the files of METEOPATH in parallel (default=false). This requires MeteoIO to be compiled with
+ * OpenMP support and grib_api to be compiled as thread safe (ie: with pthreads support).
+ *
+ * @section gribio_meteo_index Virtual stations extraction
+ * When extracting time series at virtual stations, each file of METEOPATH is scanned only once and the parameter, level, date
+ * and position of each of its messages is kept in an index (GRIB_INDEX). This index is saved on disk and reused at the next
+ * run for all the files whose size and modification time did not change. Similarly, the grid points matching the
+ * virtual stations are only searched once and then directly extracted from every message.
  *
  */
 
 const double GRIBIO::plugin_nodata = -999.; //plugin specific nodata value. It can also be read by the plugin (depending on what is appropriate)
 const double GRIBIO::tz_in = 0.; //GRIB time zone, always UTC
 const std::string GRIBIO::default_ext=".grb"; //filename extension
+const std::string GRIBIO::default_index="meteoio_grib.idx"; //messages index file name
+const std::string GRIBIO::index_header="#MeteoIO GRIB messages index v1";
+
+static bool getFileStatus(const std::string& filename, long &size, long &mtime)
+{
+	struct stat buffer;
+	if(stat(filename.c_str(), &buffer)!=0) return false;
+	size = static_cast<long>(buffer.st_size);
+	mtime = static_cast<long>(buffer.st_mtime);
+	return true;
+}
 
 GRIBIO::GRIBIO(const std::string& configfile)
         : cfg(configfile), grid2dpath_in(), meteopath_in(), vecPts(), cache_meteo_files(),
-          meteo_ext(default_ext), grid2d_ext(default_ext), grid2d_prefix(), idx_filename(), coordin(), coordinparam(),
+          meteo_meta(), grid_indexes(), grid_size(0), meteo_index(), meteo_ext(default_ext), grid2d_ext(default_ext), grid2d_prefix(), idx_filename(), coordin(), coordinparam(),
           VW(), DW(), wind_date(), llcorner(), fp(NULL), idx(NULL),
           latitudeOfNorthernPole(IOUtils::nodata), longitudeOfNorthernPole(IOUtils::nodata), bearing_offset(IOUtils::nodata),
           cellsize_x(IOUtils::nodata), cellsize_y(IOUtils::nodata), factor_x(IOUtils::nodata), factor_y(IOUtils::nodata),
-          indexed(false), meteo_initialized(false), update_dem(false)
+          indexed(false), meteo_initialized(false), update_dem(false), parallel_decoding(false)
 {
 	setOptions();
 }
 
 GRIBIO::GRIBIO(const Config& cfgreader)
         : cfg(cfgreader), grid2dpath_in(), meteopath_in(), vecPts(), cache_meteo_files(),
-          meteo_ext(default_ext), grid2d_ext(default_ext), grid2d_prefix(), idx_filename(), coordin(), coordinparam(),
+          meteo_meta(), grid_indexes(), grid_size(0), meteo_index(), meteo_ext(default_ext), grid2d_ext(default_ext), grid2d_prefix(), idx_filename(), coordin(), coordinparam(),
           VW(), DW(), wind_date(), llcorner(), fp(NULL), idx(NULL),
           latitudeOfNorthernPole(IOUtils::nodata), longitudeOfNorthernPole(IOUtils::nodata), bearing_offset(IOUtils::nodata),
           cellsize_x(IOUtils::nodata), cellsize_y(IOUtils::nodata), factor_x(IOUtils::nodata), factor_y(IOUtils::nodata),
-          indexed(false), meteo_initialized(false), update_dem(false)
+          indexed(false), meteo_initialized(false), update_dem(false), parallel_decoding(false)
 {
 	setOptions();
 }
@@ -125,6 +150,10 @@ GRIBIO& GRIBIO::operator=(const GRIBIO& source) {
 		meteopath_in = source.meteopath_in;
 		vecPts = source.vecPts;
 		cache_meteo_files = source.cache_meteo_files;
+		meteo_meta = source.meteo_meta;
+		grid_indexes = source.grid_indexes;
+		grid_size = source.grid_size;
+		meteo_index = source.meteo_index;
 		meteo_ext = source.meteo_ext;
 		grid2d_ext = source.grid2d_ext;
 		grid2d_prefix = source.grid2d_prefix;
@@ -145,6 +174,7 @@ GRIBIO& GRIBIO::operator=(const GRIBIO& source) {
 		indexed = source.indexed;
 		meteo_initialized = source.meteo_initialized;
 		update_dem = source.update_dem;
+		parallel_decoding = source.parallel_decoding;
 	}
 	return *this;
 }
@@ -171,11 +201,16 @@ void GRIBIO::setOptions()
 
 	cfg.getValue("GRID2DEXT", "Input", grid2d_ext, IOUtils::nothrow);
 	if(grid2d_ext=="none") grid2d_ext.clear();
+
+	cfg.getValue("GRIB_PARALLEL", "Input", parallel_decoding, IOUtils::nothrow);
 }
 
 void GRIBIO::readStations(std::vector<Coords> &vecPoints)
 {
 	cfg.getValue("METEOPATH", "Input", meteopath_in);
+	cfg.getValue("GRIB_INDEX", "Input", meteo_index, IOUtils::nothrow);
+	if(meteo_index.empty()) meteo_index = meteopath_in + "/" + default_index;
+	else if(meteo_index=="none") meteo_index.clear();
 
 	std::vector<std::string> vecStation;
 	cfg.getValues("STATION", "INPUT", vecStation);
@@ -242,7 +277,7 @@ void  GRIBIO::listFields(const std::string& filename)
 	}
 }
 
-void GRIBIO::getDate(grib_handle* h, Date &base, double &d1, double &d2) {
+void GRIBIO::getDate(grib_handle* h, Date &base, double &d1, double &d2) const {
 	long dataDate, dataTime;
 	GRIB_CHECK(grib_get_long(h,"dataDate",&dataDate),0);
 	GRIB_CHECK(grib_get_long(h,"dataTime",&dataTime),0);
@@ -495,7 +530,10 @@ void GRIBIO::read2DGrid(Grid2DObject& grid_out, const MeteoGrids::Parameters& pa
 	Date UTC_date = date;
 	UTC_date.setTimeZone(tz_in);
 
-	const std::string filename = grid2dpath_in+"/"+grid2d_prefix+UTC_date.toString(Date::NUM).substr(0,10)+grid2d_ext;
+	char date_str[Date::max_str_len];
+	UTC_date.toString(Date::NUM, date_str, Date::max_str_len);
+	date_str[10] = '\0'; //only keep YYYYMMDDHH
+	const std::string filename = grid2dpath_in+"/"+grid2d_prefix+date_str+grid2d_ext;
 
 	read2DGrid(filename, grid_out, parameter, UTC_date);
 }
@@ -708,24 +746,181 @@ void GRIBIO::readStationData(const Date&, std::vector<StationData>& /*vecStation
 	throw IOException("Nothing implemented here", AT);
 }
 
+bool GRIBIO::grib_message::matchDate(const Date& i_date) const
+{
+	//see WMO code table5 for definitions of timeRangeIndicator. http://dss.ucar.edu/docs/formats/grib/gribdoc/timer.html
+	return (i_date.isUndef()) ||
+	       (timeRange==0 && i_date==base_date+P1) ||
+	       (timeRange==1 && i_date==base_date) ||
+	       ((timeRange==2 || timeRange==3) && i_date>=base_date+P1 && i_date<=base_date+P2) ||
+	       ((timeRange==4 || timeRange==5) && i_date==base_date+P2);
+}
+
 void GRIBIO::scanMeteoPath()
 {
 	std::list<std::string> dirlist;
 	IOUtils::readDirectory(meteopath_in, dirlist, meteo_ext);
 	dirlist.sort();
+	const std::string index_name = IOUtils::getFilename(meteo_index);
 
 	//Check date in every filename and cache it
 	std::list<std::string>::const_iterator it = dirlist.begin();
 	while ((it != dirlist.end())) {
 		const std::string& filename = *it;
+		it++;
+		if(!meteo_index.empty() && filename==index_name) continue;
+
 		const std::string::size_type spos = filename.find_first_of("0123456789");
-		Date date;
-		IOUtils::convertString(date, filename.substr(spos,10), tz_in);
-		const std::pair<Date,std::string> tmp(date, filename);
+		grib_file file_index;
+		IOUtils::convertString(file_index.date, filename.substr(spos,10), tz_in);
+		file_index.filename = filename;
+		cache_meteo_files.push_back(file_index);
+	}
 
-		cache_meteo_files.push_back(tmp);
-		it++;
+	//reuse the saved index for the files that did not change, re-index the others
+	std::vector<grib_file> vecIndex;
+	readMessagesIndex(vecIndex);
+	std::map<std::string, size_t> saved_files;
+	for(size_t ii=0; ii<vecIndex.size(); ii++)
+		saved_files[ vecIndex[ii].filename ] = ii;
+
+	std::vector<size_t> outdated;
+	for(size_t ii=0; ii<cache_meteo_files.size(); ii++) {
+		grib_file& file_index = cache_meteo_files[ii];
+		const std::map<std::string, size_t>::const_iterator saved = saved_files.find(file_index.filename);
+		long size, mtime;
+		if(saved!=saved_files.end() && getFileStatus(meteopath_in+"/"+file_index.filename, size, mtime)) {
+			const grib_file& saved_index = vecIndex[saved->second];
+			if(saved_index.size==size && saved_index.mtime==mtime) {
+				file_index.size = size;
+				file_index.mtime = mtime;
+				file_index.messages = saved_index.messages;
+				continue;
+			}
+		}
+		outdated.push_back(ii);
+	}
+
+	const long nr_outdated = static_cast<long>(outdated.size());
+	std::string error_msg;
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if(parallel_decoding)
+	#endif
+	for(long ii=0; ii<nr_outdated; ii++) {
+		grib_file& file_index = cache_meteo_files[ outdated[ii] ];
+		try {
+			indexMessages(meteopath_in+"/"+file_index.filename, file_index);
+		} catch(const std::exception& e) {
+			#ifdef _OPENMP
+			#pragma omp critical(gribio_errors)
+			#endif
+			{
+				if(error_msg.empty()) error_msg = e.what();
+			}
+		}
+	}
+	if(!error_msg.empty()) throw IOException(error_msg, AT);
+
+	if(!outdated.empty() || vecIndex.size()!=cache_meteo_files.size()) writeMessagesIndex();
+}
+
+void GRIBIO::indexMessages(const std::string& path, grib_file& file_index) const
+{
+	if(!getFileStatus(path, file_index.size, file_index.mtime)) {
+		ostringstream ss;
+		ss << "Error accessing file \"" << path << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
+	}
+	FILE *in = fopen(path.c_str(),"r");
+	if(in==NULL) {
+		ostringstream ss;
+		ss << "Error opening file \"" << path << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
+	}
+
+	file_index.messages.clear();
+	grib_handle* h=NULL;
+	int err=0;
+	long offset = ftell(in);
+	while((h = grib_handle_new_from_file(0,in,&err)) != NULL) {
+		grib_message msg;
+		msg.offset = offset;
+		GRIB_CHECK(grib_get_double(h,"marsParam",&msg.marsParam),0);
+		GRIB_CHECK(grib_get_long(h,"indicatorOfTypeOfLevel", &msg.levelType),0);
+		GRIB_CHECK(grib_get_long(h,"timeRangeIndicator", &msg.timeRange),0);
+		grib_get_long(h,"level", &msg.level); //not always defined, for example for surface fields
+		getDate(h, msg.base_date, msg.P1, msg.P2);
+		grib_handle_delete(h);
+
+		file_index.messages.push_back(msg);
+		offset = ftell(in);
+	}
+	fclose(in);
+
+	if(err!=0)
+		throw IOException("Error indexing GRIB file \""+path+"\": "+std::string(grib_get_error_message(err)), AT);
+}
+
+void GRIBIO::readMessagesIndex(std::vector<grib_file>& vecIndex) const
+{ //an invalid or outdated index is not an error: the files will simply be re-indexed
+	vecIndex.clear();
+	if(meteo_index.empty() || !IOUtils::fileExists(meteo_index)) return;
+
+	std::ifstream fin(meteo_index.c_str());
+	if(fin.fail()) return;
+
+	std::string line;
+	getline(fin, line);
+	if(line!=index_header) return;
+
+	while(getline(fin, line)) {
+		grib_file file_index;
+		size_t nr_messages = 0;
+		std::istringstream iss(line);
+		iss >> file_index.size >> file_index.mtime >> nr_messages;
+		getline(iss >> std::ws, file_index.filename);
+		if(iss.fail()) {
+			vecIndex.clear();
+			return;
+		}
+
+		file_index.messages.resize(nr_messages);
+		for(size_t ii=0; ii<nr_messages; ii++) {
+			grib_message& msg = file_index.messages[ii];
+			double julian;
+			fin >> msg.marsParam >> msg.levelType >> msg.level >> msg.timeRange >> julian >> msg.P1 >> msg.P2 >> msg.offset;
+			msg.base_date.setDate(julian, tz_in);
+		}
+		fin >> std::ws;
+		if(fin.fail()) {
+			vecIndex.clear();
+			return;
+		}
+		vecIndex.push_back(file_index);
+	}
+}
+
+void GRIBIO::writeMessagesIndex() const
+{
+	if(meteo_index.empty()) return;
+
+	std::ofstream fout(meteo_index.c_str());
+	if(fout.fail()) {
+		std::cerr << "[W] Could not write GRIB messages index \"" << meteo_index << "\", the files will be re-indexed at the next run\n";
+		return;
+	}
+
+	fout << index_header << "\n" << std::setprecision(15);
+	for(size_t ii=0; ii<cache_meteo_files.size(); ii++) {
+		const grib_file& file_index = cache_meteo_files[ii];
+		fout << file_index.size << " " << file_index.mtime << " " << file_index.messages.size() << " " << file_index.filename << "\n";
+		for(size_t jj=0; jj<file_index.messages.size(); jj++) {
+			const grib_message& msg = file_index.messages[jj];
+			fout << msg.marsParam << " " << msg.levelType << " " << msg.level << " " << msg.timeRange << " ";
+			fout << msg.base_date.getJulian(true) << " " << msg.P1 << " " << msg.P2 << " " << msg.offset << "\n";
+		}
 	}
+	fout.close();
 }
 
 void GRIBIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
@@ -739,63 +934,64 @@ void GRIBIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
 	}
 
 	vecMeteo.clear();
-
-	double *lats = (double*)malloc(vecPts.size()*sizeof(double));
-	double *lons = (double*)malloc(vecPts.size()*sizeof(double));
-	std::vector<StationData> meta; //metadata for meteo time series
-	bool meta_ok=false; //set to true once the metadata have been read
+	if(vecPts.empty()) return;
 
 	//find index of first time step
 	size_t idx_start;
 	bool start_found=false;
 	for (idx_start=0; idx_start<cache_meteo_files.size(); idx_start++) {
-		if(dateStart<cache_meteo_files[idx_start].first) {
+		if(dateStart<cache_meteo_files[idx_start].date) {
 			start_found=true;
 			break;
 		}
 	}
 
-	if (start_found==false) {
-		free(lats); free(lons);
-		return;
-	}
+	if (start_found==false) return;
 
 	if (idx_start>0) idx_start--; //start with first element before dateStart (useful for resampling)
+	size_t idx_end = idx_start;
+	while(idx_end<cache_meteo_files.size() && cache_meteo_files[idx_end].date<=dateEnd) idx_end++;
 
-	try {
-		for(size_t ii=idx_start; ii<cache_meteo_files.size(); ii++) {
-			const Date& date = cache_meteo_files[ii].first;
-			if(date>dateEnd) break;
-			const std::string filename = meteopath_in+"/"+cache_meteo_files[ii].second;
-
-			if(!indexed || idx_filename!=filename) {
-				cleanup();
-				indexFile(filename); //this will also read geolocalization
-			}
-			if(!meta_ok) {
-				if(readMeteoMeta(vecPts, meta, lats, lons)==false) {
-					//some points have been removed vecPts has been changed -> re-reading
-					free(lats); free(lons);
-					lats = (double*)malloc(vecPts.size()*sizeof(double));
-					lons = (double*)malloc(vecPts.size()*sizeof(double));
-					readMeteoMeta(vecPts, meta, lats, lons);
-				}
-				vecMeteo.insert(vecMeteo.begin(), vecPts.size(), std::vector<MeteoData>()); //allocation for the vectors now that we know how many true stations we have
-				meta_ok=true;
-			}
-
-			std::vector<MeteoData> Meteo;
-			readMeteoStep(meta, lats, lons, date, Meteo);
-			for(size_t jj=0; jj<vecPts.size(); jj++)
-				vecMeteo[jj].push_back(Meteo[jj]);
+	if(meteo_meta.empty()) { //the grid points matching the virtual stations are only searched once
+		try {
+			cleanup();
+			indexFile(meteopath_in+"/"+cache_meteo_files[idx_start].filename); //this will also read geolocalization
+			while(readMeteoMeta(vecPts, meteo_meta)==false) {} //some points have been removed, vecPts has been changed -> re-reading
+			cleanup();
+		} catch(...) {
+			cleanup();
+			throw;
 		}
-	} catch(...) {
-		free(lats); free(lons);
-		cleanup();
-		throw;
 	}
 
-	free(lats); free(lons);
+	//decode the time steps, possibly in parallel
+	const long nr_steps = static_cast<long>(idx_end - idx_start);
+	std::vector< std::vector<MeteoData> > vecSteps(nr_steps);
+	std::string error_msg;
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if(parallel_decoding)
+	#endif
+	for(long ii=0; ii<nr_steps; ii++) {
+		try {
+			readMeteoStep(cache_meteo_files[idx_start+ii], vecSteps[ii]);
+		} catch(const std::exception& e) {
+			#ifdef _OPENMP
+			#pragma omp critical(gribio_errors)
+			#endif
+			{
+				if(error_msg.empty()) error_msg = e.what();
+			}
+		}
+	}
+	if(!error_msg.empty()) throw IOException(error_msg, AT);
+
+	const size_t npoints = meteo_meta.size();
+	vecMeteo.resize(npoints);
+	for(size_t jj=0; jj<npoints; jj++) {
+		vecMeteo[jj].reserve(nr_steps);
+		for(long ii=0; ii<nr_steps; ii++)
+			vecMeteo[jj].push_back(vecSteps[ii][jj]);
+	}
 }
 
 bool GRIBIO::removeDuplicatePoints(std::vector<Coords>& vecPoints, double *lats, double *lons)
@@ -823,9 +1019,10 @@ bool GRIBIO::removeDuplicatePoints(std::vector<Coords>& vecPoints, double *lats,
 	return false;
 }
 
-bool GRIBIO::readMeteoMeta(std::vector<Coords>& vecPoints, std::vector<StationData> &stations, double *lats, double *lons)
+bool GRIBIO::readMeteoMeta(std::vector<Coords>& vecPoints, std::vector<StationData> &stations)
 {//return true if the metadata have been read, false if it needs to be re-read (ie: some points were leading to duplicates -> vecPoints has been changed)
 	stations.clear();
+	grid_indexes.clear();
 
 	GRIB_CHECK(grib_index_select_double(idx,"marsParam",8.2),0); //This is the DEM
 	GRIB_CHECK(grib_index_select_long(idx,"indicatorOfTypeOfLevel", 1),0);
@@ -846,27 +1043,25 @@ bool GRIBIO::readMeteoMeta(std::vector<Coords>& vecPoints, std::vector<StationDa
 
 	long Ni;
 	GRIB_CHECK(grib_get_long(h,"Ni",&Ni),0);
+	GRIB_CHECK(grib_get_size(h,"values",&grid_size),0);
 
 	//build GRIB local coordinates for the points
+	std::vector<double> lats(npoints), lons(npoints);
 	for(size_t ii=0; ii<npoints; ii++) {
 		Coords::trueLatLonToRotated(latitudeOfNorthernPole, longitudeOfNorthernPole, vecPoints[ii].getLat(), vecPoints[ii].getLon(), lats[ii], lons[ii]);
 	}
 
 	//retrieve nearest points
-	double *outlats = (double*)malloc(npoints*sizeof(double));
-	double *outlons = (double*)malloc(npoints*sizeof(double));
-	double *values = (double*)malloc(npoints*sizeof(double));
-	double *distances = (double*)malloc(npoints*sizeof(double));
-	int *indexes = (int *)malloc(npoints*sizeof(int));
-	if(grib_nearest_find_multiple(h, 0, lats, lons, npoints, outlats, outlons, values, distances, indexes)!=0) {
+	std::vector<double> outlats(npoints), outlons(npoints), values(npoints), distances(npoints);
+	std::vector<int> indexes(npoints);
+	if(grib_nearest_find_multiple(h, 0, &lats[0], &lons[0], npoints, &outlats[0], &outlons[0], &values[0], &distances[0], &indexes[0])!=0) {
 		grib_handle_delete(h);
 		cleanup();
 		throw IOException("Errro when searching for nearest points in DEM", AT);
 	}
 
 	//remove potential duplicates
-	if(removeDuplicatePoints(vecPoints, outlats, outlons)==true) {
-		free(outlats); free(outlons); free(values); free(distances); free(indexes);
+	if(removeDuplicatePoints(vecPoints, &outlats[0], &outlons[0])==true) {
 		grib_handle_delete(h);
 		return false;
 	}
@@ -887,147 +1082,147 @@ bool GRIBIO::readMeteoMeta(std::vector<Coords>& vecPoints, std::vector<StationDa
 		stations.push_back(sd);
 	}
 
-	free(outlats); free(outlons); free(values); free(distances); free(indexes);
+	grid_indexes = indexes; //this mapping will be reused for every message
 	grib_handle_delete(h);
 	return true;
 }
 
-bool GRIBIO::readMeteoValues(const double& marsParam, const long& levelType, const long& i_level, const Date& i_date, const size_t& npoints, double *lats, double *lons, double *values)
+bool GRIBIO::readMeteoValues(FILE *in, const grib_file& file_index, const double& marsParam, const long& levelType, const long& i_level, const Date& i_date, double *values) const
 {
-	GRIB_CHECK(grib_index_select_double(idx,"marsParam",marsParam),0);
-	GRIB_CHECK(grib_index_select_long(idx,"indicatorOfTypeOfLevel", levelType),0);
-
-	grib_handle* h=NULL;
-	int err=0;
-	while((h = grib_handle_new_from_index(idx,&err)) != NULL) {
-		if(!h) {
-			cleanup();
-			throw IOException("Unable to create grib handle from index", AT);
+	const std::vector<grib_message>& messages = file_index.messages;
+	for(size_t ii=0; ii<messages.size(); ii++) {
+		const grib_message& msg = messages[ii];
+		if(fabs(msg.marsParam-marsParam)>1e-6 || msg.levelType!=levelType) continue;
+		if(i_level!=0 && msg.level!=i_level) continue;
+		if(!msg.matchDate(i_date)) continue;
+
+		int err=0;
+		grib_handle* h=NULL;
+		if(fseek(in, msg.offset, SEEK_SET)==0) h = grib_handle_new_from_file(0,in,&err);
+		if(h==NULL)
+			throw IOException("Unable to read message from \""+file_index.filename+"\", please delete the GRIB messages index \""+meteo_index+"\"", AT);
+
+		size_t values_len=0;
+		GRIB_CHECK(grib_get_size(h,"values",&values_len),0);
+		if(values_len!=grid_size) {
+			grib_handle_delete(h);
+			throw InvalidArgumentException("The grids in \""+file_index.filename+"\" do not match the grid used to locate the virtual stations", AT);
 		}
 
-		Date base_date;
-		double P1, P2;
-		getDate(h, base_date, P1, P2);
-
-		//see WMO code table5 for definitions of timeRangeIndicator. http://dss.ucar.edu/docs/formats/grib/gribdoc/timer.html
-		long timeRange;
-		GRIB_CHECK(grib_get_long(h,"timeRangeIndicator", &timeRange),0);
-
-		long level=0;
-		if(i_level!=0) GRIB_CHECK(grib_get_long(h,"level", &level),0);
-		if(level==i_level) {
-			if( (i_date.isUndef()) ||
-			    (timeRange==0 && i_date==base_date+P1) ||
-			    (timeRange==1 && i_date==base_date) ||
-			    ((timeRange==2 || timeRange==3) && i_date>=base_date+P1 && i_date<=base_date+P2) ||
-			    ((timeRange==4 || timeRange==5) && i_date==base_date+P2) ) {
-				double *outlats = (double*)malloc(npoints*sizeof(double));
-				double *outlons = (double*)malloc(npoints*sizeof(double));
-				double *distances = (double*)malloc(npoints*sizeof(double));
-				int *indexes = (int *)malloc(npoints*sizeof(int));
-				if(grib_nearest_find_multiple(h, 0, lats, lons, npoints, outlats, outlons, values, distances, indexes)!=0) {
-					grib_handle_delete(h);
-					cleanup();
-					throw IOException("Errro when searching for nearest points in DEM", AT);
-				}
-
-				free(outlats); free(outlons); free(distances); free(indexes);
-				grib_handle_delete(h);
-				return true;
-			}
-		}
+		//the grid points matching the virtual stations have already been found, so we directly extract them
+		err = grib_get_double_elements(h, "values", const_cast<int*>(&grid_indexes[0]), static_cast<long>(grid_indexes.size()), values);
 		grib_handle_delete(h);
+		if(err!=0)
+			throw IOException("Error extracting data from \""+file_index.filename+"\": "+std::string(grib_get_error_message(err)), AT);
+		return true;
 	}
 	return false;
 }
 
-void GRIBIO::fillMeteo(double *values, const MeteoData::Parameters& param, const size_t& npoints, std::vector<MeteoData> &Meteo) {
+void GRIBIO::fillMeteo(double *values, const MeteoData::Parameters& param, const size_t& npoints, std::vector<MeteoData> &Meteo) const {
 	for(size_t ii=0; ii<npoints; ii++) {
 		Meteo[ii](param) = values[ii];
 	}
 }
 
-void GRIBIO::readMeteoStep(std::vector<StationData> &stations, double *lats, double *lons, const Date i_date, std::vector<MeteoData> &Meteo)
-{
-	const size_t npoints = stations.size();
+void GRIBIO::readMeteoStep(const grib_file& file_index, std::vector<MeteoData> &Meteo) const
+{ //this is called concurrently for different files, so it must not modify the object
+	const size_t npoints = meteo_meta.size();
+	const Date& i_date = file_index.date;
 
+	Meteo.clear();
+	Meteo.reserve(npoints);
 	for(size_t ii=0; ii<npoints; ii++) {
 		MeteoData md;
-		md.meta = stations[ii];
+		md.meta = meteo_meta[ii];
 		md.date = i_date;
 		Meteo.push_back(md);
 	}
 
-	double *values = (double*)malloc(npoints*sizeof(double));
-	double *values2 = (double*)malloc(npoints*sizeof(double)); //for extra parameters
-
-	//basic meteorological parameters
-	if(readMeteoValues(1.2, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::P, npoints, Meteo); //PS
-	if(readMeteoValues(11.2, 105, 2, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::TA, npoints, Meteo); //T_2M
-	if(readMeteoValues(197.201, 111, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::TSS, npoints, Meteo); //T_SO take 118, BRTMP instead?
-	if(readMeteoValues(11.2, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::TSG, npoints, Meteo); //T_G
-	if(readMeteoValues(52.2, 105, 2, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::RH, npoints, Meteo); //RELHUM_2M
-	else if(readMeteoValues(17.2, 105, 2, i_date, npoints, lats, lons, values)) { //TD_2M
-		for(size_t ii=0; ii<npoints; ii++) {
-			if(Meteo[ii](MeteoData::TA)!=IOUtils::nodata)
-				Meteo[ii](MeteoData::RH) = Atmosphere::DewPointtoRh(values[ii], Meteo[ii](MeteoData::TA), true);
-		}
+	const std::string filename = meteopath_in+"/"+file_index.filename;
+	FILE *in = fopen(filename.c_str(),"r");
+	if(in==NULL) {
+		ostringstream ss;
+		ss << "Error opening file \"" << filename << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
 	}
 
-	//hydrological parameters
-	if(readMeteoValues(61.2, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::HNW, npoints, Meteo); //tp
-	if(readMeteoValues(66.2, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::HS, npoints, Meteo);
-	else if(readMeteoValues(133.201, 1, 0, i_date, npoints, lats, lons, values)  //RHO_SNOW
-	   && readMeteoValues(65.2, 1, 0, i_date, npoints, lats, lons, values2)) { //W_SNOW
-		for(size_t ii=0; ii<npoints; ii++) {
-			Meteo[ii](MeteoData::HS) = values2[ii] / values[ii];
-		}
-	}
+	std::vector<double> vec_values(npoints), vec_values2(npoints);
+	double *values = &vec_values[0];
+	double *values2 = &vec_values2[0]; //for extra parameters
 
-	//radiation parameters
-	if(readMeteoValues(115.2, 1, 0, i_date, npoints, lats, lons, values)) { //long wave
-		for(size_t ii=0; ii<npoints; ii++) {
-			Meteo[ii](MeteoData::ISWR) = -values[ii];
-		}
-	} else if(readMeteoValues(25.201, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::ILWR, npoints, Meteo); //ALWD_S
-	if(readMeteoValues(116.2, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::ISWR, npoints, Meteo); //SWAVR
-	else if(readMeteoValues(111.250, 1, 0, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::ISWR, npoints, Meteo); //GLOB
-	else {
-		if(readMeteoValues(23.201, 1, 0, i_date, npoints, lats, lons, values) //ASWDIFD_S
-		   && readMeteoValues(22.201, 1, 0, i_date, npoints, lats, lons, values2)) { //ASWDIR_S
+	try {
+		//basic meteorological parameters
+		if(readMeteoValues(in, file_index, 1.2, 1, 0, i_date, values)) fillMeteo(values, MeteoData::P, npoints, Meteo); //PS
+		if(readMeteoValues(in, file_index, 11.2, 105, 2, i_date, values)) fillMeteo(values, MeteoData::TA, npoints, Meteo); //T_2M
+		if(readMeteoValues(in, file_index, 197.201, 111, 0, i_date, values)) fillMeteo(values, MeteoData::TSS, npoints, Meteo); //T_SO take 118, BRTMP instead?
+		if(readMeteoValues(in, file_index, 11.2, 1, 0, i_date, values)) fillMeteo(values, MeteoData::TSG, npoints, Meteo); //T_G
+		if(readMeteoValues(in, file_index, 52.2, 105, 2, i_date, values)) fillMeteo(values, MeteoData::RH, npoints, Meteo); //RELHUM_2M
+		else if(readMeteoValues(in, file_index, 17.2, 105, 2, i_date, values)) { //TD_2M
 			for(size_t ii=0; ii<npoints; ii++) {
-				Meteo[ii](MeteoData::ISWR) = values[ii] + values2[ii];
+				if(Meteo[ii](MeteoData::TA)!=IOUtils::nodata)
+					Meteo[ii](MeteoData::RH) = Atmosphere::DewPointtoRh(values[ii], Meteo[ii](MeteoData::TA), true);
 			}
 		}
-	}
-	if(readMeteoValues(84.2, 1, 0, i_date, npoints, lats, lons, values)) { //ALB_RAD
-		for(size_t ii=0; ii<npoints; ii++) {
-			if(Meteo[ii](MeteoData::ISWR)!=IOUtils::nodata) Meteo[ii](MeteoData::RSWR) = Meteo[ii](MeteoData::ISWR) * values[ii]/100.;
+
+		//hydrological parameters
+		if(readMeteoValues(in, file_index, 61.2, 1, 0, i_date, values)) fillMeteo(values, MeteoData::HNW, npoints, Meteo); //tp
+		if(readMeteoValues(in, file_index, 66.2, 1, 0, i_date, values)) fillMeteo(values, MeteoData::HS, npoints, Meteo);
+		else if(readMeteoValues(in, file_index, 133.201, 1, 0, i_date, values)  //RHO_SNOW
+		   && readMeteoValues(in, file_index, 65.2, 1, 0, i_date, values2)) { //W_SNOW
+			for(size_t ii=0; ii<npoints; ii++) {
+				Meteo[ii](MeteoData::HS) = values2[ii] / values[ii];
+			}
 		}
-	}
 
-	//Wind parameters
-	if(readMeteoValues(187.201, 105, 10, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::VW_MAX, npoints, Meteo); //VMAX_10M
-	if(readMeteoValues(31.2, 105, 10, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::DW, npoints, Meteo); //DD_10M
-	else {
-		if(readMeteoValues(34.2, 105, 10, i_date, npoints, lats, lons, values) //V_10M
-		   && readMeteoValues(33.2, 105, 10, i_date, npoints, lats, lons, values2)) { //U_10M
+		//radiation parameters
+		if(readMeteoValues(in, file_index, 115.2, 1, 0, i_date, values)) { //long wave
 			for(size_t ii=0; ii<npoints; ii++) {
-				Meteo[ii](MeteoData::DW) = fmod( atan2( values2[ii], values[ii] ) * Cst::to_deg + 360. + bearing_offset, 360.); // turn into degrees [0;360)
+				Meteo[ii](MeteoData::ISWR) = -values[ii];
+			}
+		} else if(readMeteoValues(in, file_index, 25.201, 1, 0, i_date, values)) fillMeteo(values, MeteoData::ILWR, npoints, Meteo); //ALWD_S
+		if(readMeteoValues(in, file_index, 116.2, 1, 0, i_date, values)) fillMeteo(values, MeteoData::ISWR, npoints, Meteo); //SWAVR
+		else if(readMeteoValues(in, file_index, 111.250, 1, 0, i_date, values)) fillMeteo(values, MeteoData::ISWR, npoints, Meteo); //GLOB
+		else {
+			if(readMeteoValues(in, file_index, 23.201, 1, 0, i_date, values) //ASWDIFD_S
+			   && readMeteoValues(in, file_index, 22.201, 1, 0, i_date, values2)) { //ASWDIR_S
+				for(size_t ii=0; ii<npoints; ii++) {
+					Meteo[ii](MeteoData::ISWR) = values[ii] + values2[ii];
+				}
 			}
 		}
-	}
-	if(readMeteoValues(32.2, 105, 10, i_date, npoints, lats, lons, values)) fillMeteo(values, MeteoData::VW, npoints, Meteo); //FF_10M
-	else {
-		if(readMeteoValues(34.2, 105, 10, i_date, npoints, lats, lons, values) //V_10M
-		   && readMeteoValues(33.2, 105, 10, i_date, npoints, lats, lons, values2)) { //U_10M
+		if(readMeteoValues(in, file_index, 84.2, 1, 0, i_date, values)) { //ALB_RAD
 			for(size_t ii=0; ii<npoints; ii++) {
-				Meteo[ii](MeteoData::VW) =  sqrt( Optim::pow2(values[ii]) + Optim::pow2(values2[ii]) );
+				if(Meteo[ii](MeteoData::ISWR)!=IOUtils::nodata) Meteo[ii](MeteoData::RSWR) = Meteo[ii](MeteoData::ISWR) * values[ii]/100.;
 			}
 		}
+
+		//Wind parameters
+		if(readMeteoValues(in, file_index, 187.201, 105, 10, i_date, values)) fillMeteo(values, MeteoData::VW_MAX, npoints, Meteo); //VMAX_10M
+		if(readMeteoValues(in, file_index, 31.2, 105, 10, i_date, values)) fillMeteo(values, MeteoData::DW, npoints, Meteo); //DD_10M
+		else {
+			if(readMeteoValues(in, file_index, 34.2, 105, 10, i_date, values) //V_10M
+			   && readMeteoValues(in, file_index, 33.2, 105, 10, i_date, values2)) { //U_10M
+				for(size_t ii=0; ii<npoints; ii++) {
+					Meteo[ii](MeteoData::DW) = fmod( atan2( values2[ii], values[ii] ) * Cst::to_deg + 360. + bearing_offset, 360.); // turn into degrees [0;360)
+				}
+			}
+		}
+		if(readMeteoValues(in, file_index, 32.2, 105, 10, i_date, values)) fillMeteo(values, MeteoData::VW, npoints, Meteo); //FF_10M
+		else {
+			if(readMeteoValues(in, file_index, 34.2, 105, 10, i_date, values) //V_10M
+			   && readMeteoValues(in, file_index, 33.2, 105, 10, i_date, values2)) { //U_10M
+				for(size_t ii=0; ii<npoints; ii++) {
+					Meteo[ii](MeteoData::VW) =  sqrt( Optim::pow2(values[ii]) + Optim::pow2(values2[ii]) );
+				}
+			}
+		}
+	} catch(...) {
+		fclose(in);
+		throw;
 	}
 
-	free(values); free(values2);
+	fclose(in);
 }
 
 void GRIBIO::writeMeteoData(const std::vector< std::vector<MeteoData> >& /*vecMeteo*/,
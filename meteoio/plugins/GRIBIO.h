@@ -62,9 +62,35 @@ class GRIBIO : public IOInterface {
 		virtual void write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date);
 
 	private:
+		/**
+		* @brief Location and identification of one message within a GRIB file, as stored in the messages index
+		*/
+		struct grib_message {
+			grib_message() : marsParam(IOUtils::nodata), levelType(0), level(0), timeRange(0), base_date(), P1(0.), P2(0.), offset(0) {}
+			bool matchDate(const Date& i_date) const;
+
+			double marsParam;
+			long levelType, level, timeRange;
+			Date base_date; //reference date of the message, the offsets P1/P2 are relative to it
+			double P1, P2;
+			long offset; //byte offset of the message within its file
+		};
+
+		/**
+		* @brief Index of all the messages contained in one GRIB file of METEOPATH
+		*/
+		struct grib_file {
+			grib_file() : date(), filename(), size(0), mtime(0), messages() {}
+
+			Date date;
+			std::string filename;
+			long size, mtime; //used to detect if the index is outdated
+			std::vector<grib_message> messages;
+		};
+
 		void setOptions();
 		void listFields(const std::string& filename);
-		void getDate(grib_handle* h, Date &base, double &d1, double &d2);
+		void getDate(grib_handle* h, Date &base, double &d1, double &d2) const;
 		Coords getGeolocalization(grib_handle* h, double &cellsize_x, double &cellsize_y);
 		void read2Dlevel(grib_handle* h, Grid2DObject& grid_out, const bool& read_geolocalization);
 		bool read2DGrid_indexed(const double& in_marsParam, const long& i_levelType, const long& i_level, const Date i_date, Grid2DObject& grid_out);
@@ -74,21 +100,28 @@ class GRIBIO : public IOInterface {
 		void readStations(std::vector<Coords> &vecPoints);
 		void listKeys(grib_handle** h, const std::string& filename);
 		void scanMeteoPath();
+		void indexMessages(const std::string& path, grib_file& file_index) const;
+		void readMessagesIndex(std::vector<grib_file>& vecIndex) const;
+		void writeMessagesIndex() const;
 		/*void rotatedToTrueLatLon(const double& lat_rot, const double& lon_rot, double &lat_true, double &lon_true) const;
 		void trueLatLonToRotated(const double& lat_true, const double& lon_true, double &lat_rot, double &lon_rot) const;*/
 		void cleanup() throw();
 
 		bool removeDuplicatePoints(std::vector<Coords>& vecPoints, double *lats, double *lons);
-		bool readMeteoMeta(std::vector<Coords>& vecPoints, std::vector<StationData> &stations, double *lats, double *lons);
-		bool readMeteoValues(const double& marsParam, const long& levelType, const long& i_level, const Date& i_date, const size_t& npoints, double *lats, double *lons, double *values);
-		void fillMeteo(double *values, const MeteoData::Parameters& param, const size_t& npoints, std::vector<MeteoData> &Meteo);
-		void readMeteoStep(std::vector<StationData> &stations, double *lats, double *lons, const Date i_date, std::vector<MeteoData> &Meteo);
+		bool readMeteoMeta(std::vector<Coords>& vecPoints, std::vector<StationData> &stations);
+		bool readMeteoValues(FILE *in, const grib_file& file_index, const double& marsParam, const long& levelType, const long& i_level, const Date& i_date, double *values) const;
+		void fillMeteo(double *values, const MeteoData::Parameters& param, const size_t& npoints, std::vector<MeteoData> &Meteo) const;
+		void readMeteoStep(const grib_file& file_index, std::vector<MeteoData> &Meteo) const;
 
 		const Config cfg;
 		std::string grid2dpath_in;
 		std::string meteopath_in;
 		std::vector<Coords> vecPts; //points to use for virtual stations if METEO=GRIB
-		std::vector< std::pair<Date,std::string> > cache_meteo_files; //cache of meteo files in METEOPATH
+		std::vector<grib_file> cache_meteo_files; //messages index of the meteo files in METEOPATH
+		std::vector<StationData> meteo_meta; //metadata of the virtual stations
+		std::vector<int> grid_indexes; //index of the grid point matching each virtual station
+		size_t grid_size; //number of points of the grids the grid_indexes refer to
+		std::string meteo_index; //file where the messages index is kept between runs
 		std::string meteo_ext; //file extension
 		std::string grid2d_ext; //file extension
 		std::string grid2d_prefix; //filename prefix, like "laf"
@@ -105,11 +138,14 @@ class GRIBIO : public IOInterface {
 		double cellsize_x, cellsize_y, factor_x, factor_y;
 
 		static const std::string default_ext;
+		static const std::string default_index; //default messages index file name
+		static const std::string index_header; //first line of the messages index file, identifies its version
 		static const double plugin_nodata; //plugin specific nodata value, e.g. -999
 		static const double tz_in; //GRIB time zone
 		bool indexed; //flag to know if the file has already been indexed
 		bool meteo_initialized; //set to true after we scanned METEOPATH, filed the cache, read the virtual stations from io.ini
 		bool update_dem;
+		bool parallel_decoding; //decode the meteo files in parallel (grib_api must be thread safe)
 
 };
 
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <sstream>
 #include <iostream>
+#include <cstring>
 
 #include <curl/curl.h>
 
@@ -77,6 +78,9 @@ namespace mio {
  * - GSN_USER: The username to access the service
  * - GSN_PASS: The password to authenticate the USER
  * - STATION#: station code for the given number #, e. g. la_fouly_1034 (case sensitive!)
+ * - GSN_CONNECTIONS: how many stations can be requested at the same time (optional, default: 1). The data of each station is
+ * parsed while it is being received and the connections to the server are reused from one station to the next, so this mostly
+ * helps when many stations are read from a distant server.
  *
  * If no STATION keys are given, the full list of ALL stations available to the user in GSN will be used!
  * This may result in a long download.
@@ -95,17 +99,32 @@ const int GSNIO::http_timeout = 60; // seconds until connect time out for libcur
 const std::string GSNIO::sensors_endpoint = "sensors";
 const std::string GSNIO::null_string = "null";
 
+//set the options of a transfer
+static CURLcode set_transfer(CURL* curl, const std::string& url, const long& timeout,
+                             size_t (*write_function)(void*, size_t, size_t, void*), void* userp)
+{
+	CURLcode code;
+	if (CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_function))
+	    && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L))
+	    && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L))
+	    && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_FILE, userp))
+	    && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout))
+	    && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_URL, url.c_str())))
+		return CURLE_OK;
+	return code;
+}
+
 GSNIO::GSNIO(const std::string& configfile)
-      : cfg(configfile), vecStationName(), multiplier(), offset(), vecMeta(), vecAllMeta(), coordin(),
-        coordinparam(), coordout(), coordoutparam(), endpoint(), userid(), passwd(), default_timezone(1.)
+      : cfg(configfile), vecStationName(), vecMeta(), vecAllMeta(), coordin(),
+        coordinparam(), coordout(), coordoutparam(), endpoint(), userid(), passwd(), default_timezone(1.), nr_connections(1)
 {
 	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
 	initGSNConnection();
 }
 
 GSNIO::GSNIO(const Config& cfgreader)
-      : cfg(cfgreader), vecStationName(), multiplier(), offset(), vecMeta(), vecAllMeta(), coordin(),
-        coordinparam(), coordout(), coordoutparam(), endpoint(), userid(), passwd(), default_timezone(1.)
+      : cfg(cfgreader), vecStationName(), vecMeta(), vecAllMeta(), coordin(),
+        coordinparam(), coordout(), coordoutparam(), endpoint(), userid(), passwd(), default_timezone(1.), nr_connections(1)
 {
 	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
 	initGSNConnection();
@@ -127,6 +146,9 @@ void GSNIO::initGSNConnection() {
 
 	cfg.getValue("GSN_USER", "Input", userid);
 	cfg.getValue("GSN_PASS", "Input", passwd);
+
+	cfg.getValue("GSN_CONNECTIONS", "Input", nr_connections, IOUtils::nothrow);
+	if (nr_connections == 0) nr_connections = 1;
 }
 
 void GSNIO::read2DGrid(Grid2DObject&, const std::string&)
@@ -293,80 +315,140 @@ void GSNIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
 	if (vecMeta.empty()) //if there are no stations -> return
 		return;
 
-	size_t indexStart=0, indexEnd=vecMeta.size();
+	vector<size_t> stations;
 
 	//The following part decides whether all the stations are rebuffered or just one station
 	if (stationindex == IOUtils::npos){
 		vecMeteo.clear();
 		vecMeteo.insert(vecMeteo.begin(), vecMeta.size(), vector<MeteoData>());
+		for (size_t ii=0; ii<vecMeta.size(); ii++) stations.push_back(ii);
 	} else {
 		if (stationindex < vecMeteo.size()){
-			indexStart = stationindex;
-			indexEnd   = stationindex+1;
+			vecMeteo[stationindex].clear();
+			stations.push_back(stationindex);
 		} else {
 			throw IndexOutOfBoundsException("You tried to access a stationindex in readMeteoData that is out of bounds", AT);
 		}
 	}
 
-	for (size_t ii=indexStart; ii<indexEnd; ii++){ //loop through stations
-		readData(dateStart, dateEnd, vecMeteo[ii], ii);
-	}
-
+	readData(dateStart, dateEnd, stations, vecMeteo);
 }
 
-void GSNIO::readData(const Date& dateStart, const Date& dateEnd, std::vector<MeteoData>& vecMeteo, const size_t& stationindex)
+/**
+* @brief Retrieve the data of the given stations
+* Up to nr_connections requests are running at the same time (the connections being kept alive between the
+* requests) and the data is parsed as it is received.
+*/
+void GSNIO::readData(const Date& dateStart, const Date& dateEnd, const std::vector<size_t>& stations,
+                     std::vector< std::vector<MeteoData> >& vecMeteo)
 {
-	const string fields_str("# fields:");
-	const string units_str("# units:");
-
-	const string request = sensors_endpoint + "/" + vecMeta[stationindex].stationID + "?from=" + dateStart.toString(Date::ISO) + ":00"
-	                 + "&to=" + dateEnd.toString(Date::ISO) + ":00" + "&username=" + userid + "&password=" + passwd;
-
-	stringstream ss;
-
-	if (curl_read(request, ss)) {
-		vector<size_t> index;
-		bool olwr_present = false;
-
-		MeteoData tmpmeteo;
-		tmpmeteo.meta = vecMeta.at(stationindex);
-
-		string line(""), fields(""), units("");
-		while (getline(ss, line)) { //parse header section
-
-			if (line.size() && (line[0] != '#')) break;
+	const string time_query = "?from=" + dateStart.toString(Date::ISO) + ":00" + "&to=" + dateEnd.toString(Date::ISO) + ":00"
+	                          + "&username=" + userid + "&password=" + passwd;
+
+	CURLM* multi = curl_multi_init();
+	if (!multi) throw IOException("Could not initialize libcurl", AT);
+
+	vector<station_stream*> streams; //the transfers keep pointers to the streams
+	streams.reserve(stations.size());
+	for (size_t ii=0; ii<stations.size(); ii++)
+		streams.push_back( new station_stream(this, vecMeta[ stations[ii] ], &vecMeteo[ stations[ii] ]) );
+	curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, static_cast<long>(nr_connections));
+
+	map<CURL*, size_t> transfers; //running transfers and their stream
+	size_t next = 0; //next stream to start
+	string error;
+
+	//start the first transfers, the easy handles are then reused for the next stations
+	for (size_t ii=0; ii<nr_connections && next<streams.size(); ii++) {
+		CURL* curl = curl_easy_init();
+		if (!curl) break;
+		const size_t jj = next++;
+		const string url = endpoint + sensors_endpoint + "/" + vecMeta[ stations[jj] ].stationID + time_query;
+		if (set_transfer(curl, url, GSNIO::http_timeout, &stream_write, streams[jj]) != CURLE_OK || curl_multi_add_handle(multi, curl) != CURLM_OK) {
+			curl_easy_cleanup(curl);
+			error = "Could not retrieve data for station " + vecMeta[ stations[jj] ].stationID;
+			break;
+		}
+		transfers[curl] = jj;
+	}
 
-			if (!line.compare(0, fields_str.size(), fields_str)) {
-				fields = line.substr(fields_str.size());
-			} else if (!line.compare(0, units_str.size(), units_str)) {
-				units = line.substr(units_str.size()) + " "; // the extra space is important if no units are specified
-			}
+	while (!transfers.empty()) {
+		int still_running = 0;
+		if (curl_multi_perform(multi, &still_running) != CURLM_OK) {
+			if (error.empty()) error = "Transfer error while retrieving GSN data";
+			break;
 		}
 
-		if (units.empty() || fields.empty()) {
-			throw InvalidFormatException("Invalid header for station " + tmpmeteo.meta.stationID, AT);
+		CURLMsg* msg;
+		int msgs_left;
+		while ((msg = curl_multi_info_read(multi, &msgs_left)) != NULL) {
+			if (msg->msg != CURLMSG_DONE) continue;
+
+			CURL* curl = msg->easy_handle;
+			const CURLcode code = msg->data.result;
+			station_stream& stream = *streams[ transfers[curl] ];
+			curl_multi_remove_handle(multi, curl);
+			transfers.erase(curl);
+
+			if (stream.error.empty()) {
+				if (code != CURLE_OK) {
+					std::cout << "[E] " << curl_easy_strerror(code) << "\n";
+					stream.error = "Could not retrieve data for station " + stream.tmpmeteo.meta.stationID;
+				} else {
+					try {
+						parse_line(stream); //the last line might not be terminated by an end of line
+						if (!stream.header_done) { //no data, but the header must be valid
+							map_parameters(stream);
+						}
+					} catch (const std::exception& e) {
+						stream.error = e.what();
+					}
+				}
+			}
+			if (error.empty() && !stream.error.empty()) error = stream.error;
+
+			if (error.empty() && next<streams.size()) { //reuse the handle (and its connection) for the next station
+				const size_t jj = next++;
+				const string url = endpoint + sensors_endpoint + "/" + vecMeta[ stations[jj] ].stationID + time_query;
+				if (set_transfer(curl, url, GSNIO::http_timeout, &stream_write, streams[jj]) == CURLE_OK && curl_multi_add_handle(multi, curl) == CURLM_OK) {
+					transfers[curl] = jj;
+					continue;
+				}
+				error = "Could not retrieve data for station " + vecMeta[ stations[jj] ].stationID;
+			}
+			curl_easy_cleanup(curl);
 		}
 
-		map_parameters(fields, units, tmpmeteo, index);
-		olwr_present = tmpmeteo.param_exists("OLWR");
+		if (!error.empty()) break; //no need to wait for the other stations
+		if (!transfers.empty())
+			curl_multi_wait(multi, NULL, 0, 1000, NULL);
+	}
 
-		do { //parse data section, the first line should already be buffered
-			parse_streamElement(line, index, olwr_present, vecMeteo, tmpmeteo);
-		} while (getline(ss, line));
-	} else {
-		throw IOException("Could not retrieve data for station " + vecMeta[stationindex].stationID, AT);
+	for (map<CURL*, size_t>::const_iterator it = transfers.begin(); it != transfers.end(); ++it) { //aborted transfers
+		curl_multi_remove_handle(multi, it->first);
+		curl_easy_cleanup(it->first);
 	}
+	curl_multi_cleanup(multi);
+	for (size_t ii=0; ii<streams.size(); ii++)
+		delete streams[ii];
+
+	if (!error.empty())
+		throw IOException(error, AT);
 }
 
-void GSNIO::map_parameters(const std::string& fields, const std::string& units, MeteoData& md, std::vector<size_t>& index)
+void GSNIO::map_parameters(station_stream& stream)
 {
+	if (stream.units.empty() || stream.fields.empty()) {
+		throw InvalidFormatException("Invalid header for station " + stream.tmpmeteo.meta.stationID, AT);
+	}
+
+	MeteoData& md = stream.tmpmeteo;
+	vector<size_t>& index = stream.index;
 	vector<string> field, unit;
 	size_t timestamp_field = IOUtils::npos;
-	multiplier.clear();
-	offset.clear();
 
-	IOUtils::readLineToVec(fields, field, ',');
-	IOUtils::readLineToVec(units, unit, ',');
+	IOUtils::readLineToVec(stream.fields, field, ',');
+	IOUtils::readLineToVec(stream.units, unit, ',');
 
 	if ((field.size() != unit.size()) || (field.size() < 2)) {
 		throw InvalidFormatException("Fields and units are inconsistent for station " + md.meta.stationID, AT);
@@ -418,9 +500,9 @@ void GSNIO::map_parameters(const std::string& fields, const std::string& units,
 			IOUtils::trim(name);
 
 			if (name == "%") {
-				multiplier[parindex] = 0.01;
+				stream.multiplier[parindex] = 0.01;
 			} else if (name.size() == 2 && (int)((unsigned char)name[0]) == 176 && name[1] == 'C') { //in °C, UTF8
-				offset[parindex] = 273.15;
+				stream.offset[parindex] = 273.15;
 			}
 		}
 	}
@@ -430,19 +512,48 @@ void GSNIO::map_parameters(const std::string& fields, const std::string& units,
 	} else {
 		throw InvalidFormatException("No timestamp field for station " + md.meta.stationID, AT);
 	}
+
+	stream.olwr_present = md.param_exists("OLWR");
+	stream.header_done = true;
 }
 
-void GSNIO::parse_streamElement(const std::string& line, const std::vector<size_t>& index, const bool& olwr_present, std::vector<MeteoData>& vecMeteo, MeteoData& tmpmeteo) const
+//parse the line that has just been received: either a header line or a data line
+void GSNIO::parse_line(station_stream& stream) const
 {
-	static vector<string> data;
-	static double timestamp;
-	static const size_t timestamp_index = index[0];
+	static const string fields_str("# fields:");
+	static const string units_str("# units:");
+	const string& line = stream.line;
+
+	if (!stream.header_done) {
+		if (line.empty()) return;
 
-	const size_t size = IOUtils::readLineToVec(line, data, ',');
+		if (line[0] == '#') { //header section
+			if (!line.compare(0, fields_str.size(), fields_str)) {
+				stream.fields = line.substr(fields_str.size());
+			} else if (!line.compare(0, units_str.size(), units_str)) {
+				stream.units = line.substr(units_str.size()) + " "; // the extra space is important if no units are specified
+			}
+			return;
+		}
+
+		map_parameters(stream); //this is the first data line, so the header is complete
+	}
+
+	parse_streamElement(stream);
+}
+
+void GSNIO::parse_streamElement(station_stream& stream) const
+{
+	vector<string>& data = stream.data;
+	MeteoData& tmpmeteo = stream.tmpmeteo;
+	const vector<size_t>& index = stream.index;
+
+	const size_t size = IOUtils::readLineToVec(stream.line, data, ',');
 	if (size < 2) return; // Malformed for sure, retire gracefully, no exception thrown
 
 	//The timestamp index is stored in index[0]
-	IOUtils::convertString(timestamp, data[timestamp_index]);
+	double timestamp;
+	IOUtils::convertString(timestamp, data[ index[0] ]);
 	tmpmeteo.date.setUnixDate((time_t)(floor(timestamp/1000.0)));
 	tmpmeteo.date.setTimeZone(default_timezone);
 
@@ -455,11 +566,11 @@ void GSNIO::parse_streamElement(const std::string& line, const std::vector<size_
 		}
 	}
 
-	convertUnits(tmpmeteo);
-	if ((olwr_present) && (tmpmeteo(MeteoData::TSS) == IOUtils::nodata))
+	convertUnits(tmpmeteo, stream);
+	if ((stream.olwr_present) && (tmpmeteo(MeteoData::TSS) == IOUtils::nodata))
 		tmpmeteo(MeteoData::TSS) = olwr_to_tss(tmpmeteo("OLWR"));
 
-	vecMeteo.push_back(tmpmeteo);
+	stream.vecMeteo->push_back(tmpmeteo);
 	tmpmeteo(MeteoData::TSS) = IOUtils::nodata; //if tss has been set, then it needs to be reset manually
 }
 
@@ -495,7 +606,7 @@ void GSNIO::write2DGrid(const Grid2DObject&, const MeteoGrids::Parameters&, cons
 	throw IOException("Nothing implemented here", AT);
 }
 
-void GSNIO::convertUnits(MeteoData& meteo) const
+void GSNIO::convertUnits(MeteoData& meteo, const station_stream& stream)
 {
 	//converts C to Kelvin, converts RH to [0,1]
 	double& ta = meteo(MeteoData::TA);
@@ -520,12 +631,12 @@ void GSNIO::convertUnits(MeteoData& meteo) const
 
 	// For all parameters that have either an offset or an multiplier to bring to MKSA
 	map<size_t, double>::const_iterator it;
-	for (it = multiplier.begin(); it != multiplier.end(); it++) {
+	for (it = stream.multiplier.begin(); it != stream.multiplier.end(); it++) {
 		double& tmp = meteo(it->first);
 		if (tmp != IOUtils::nodata) tmp *= it->second;
 	}
 
-	for (it = offset.begin(); it != offset.end(); it++) {
+	for (it = stream.offset.begin(); it != stream.offset.end(); it++) {
 		double& tmp = meteo(it->first);
 		if (tmp != IOUtils::nodata) tmp += it->second;
 	}
@@ -543,6 +654,34 @@ size_t GSNIO::data_write(void* buf, size_t size, size_t nmemb, void* userp)
 	return 0;
 }
 
+//parse the received data line by line, only keeping the last incomplete line
+size_t GSNIO::stream_write(void* buf, size_t size, size_t nmemb, void* userp)
+{
+	station_stream& stream = *static_cast<station_stream*>(userp);
+	const size_t len = size * nmemb;
+	const char* data = static_cast<const char*>(buf);
+	const char* const data_end = data + len;
+
+	try {
+		while (data < data_end) {
+			const char* eol = static_cast<const char*>( memchr(data, '\n', static_cast<size_t>(data_end - data)) );
+			if (eol == NULL) { //the end of the line will come with the next chunk
+				stream.line.append(data, data_end);
+				break;
+			}
+			stream.line.append(data, eol);
+			stream.gsn->parse_line(stream);
+			stream.line.clear();
+			data = eol + 1;
+		}
+	} catch (const std::exception& e) {
+		stream.error = e.what();
+		return 0; //this aborts the transfer
+	}
+
+	return len;
+}
+
 bool GSNIO::curl_read(const std::string& url_query, std::ostream& os)
 {
 	CURLcode code(CURLE_FAILED_INIT);
@@ -551,12 +690,7 @@ bool GSNIO::curl_read(const std::string& url_query, std::ostream& os)
 	const string url = endpoint + url_query;
 
 	if (curl) {
-		if(CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &data_write))
-		   && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L))
-		   && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L))
-		   && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_FILE, &os))
-		   && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_TIMEOUT, GSNIO::http_timeout))
-		   && CURLE_OK == (code = curl_easy_setopt(curl, CURLOPT_URL, url.c_str())))
+		if(CURLE_OK == (code = set_transfer(curl, url, GSNIO::http_timeout, &data_write, &os)))
 		{
 			code = curl_easy_perform(curl);
 		}
@@ -27,6 +27,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 namespace mio {
 
@@ -66,27 +67,49 @@ class GSNIO : public IOInterface {
 		virtual void write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date);
 
 	private:
-		void convertUnits(MeteoData& meteo) const;
+		//parsing state of the data of one station, the data being parsed while it is being received
+		typedef struct STATION_STREAM {
+			STATION_STREAM(const GSNIO* i_gsn, const StationData& meta, std::vector<MeteoData>* i_vecMeteo)
+			               : gsn(i_gsn), vecMeteo(i_vecMeteo), line(), fields(), units(), data(), index(),
+			                 multiplier(), offset(), tmpmeteo(), header_done(false), olwr_present(false), error() {tmpmeteo.meta = meta;}
+			const GSNIO* gsn;
+			std::vector<MeteoData>* vecMeteo; ///< where to store the parsed data
+			std::string line; ///< the current line, until it has been fully received
+			std::string fields, units;
+			std::vector<std::string> data;
+			std::vector<size_t> index;
+			std::map<size_t, double> multiplier, offset; ///< conversions to MKSA of the extra parameters
+			MeteoData tmpmeteo;
+			bool header_done, olwr_present;
+			std::string error; ///< what went wrong, since exceptions can not be thrown through libcurl
+			private:
+				STATION_STREAM(const STATION_STREAM&); //the stream only points to its owner and output, it is not meant to be copied
+				STATION_STREAM& operator=(const STATION_STREAM&);
+		} station_stream;
+
+		static void convertUnits(MeteoData& meteo, const station_stream& stream);
 		void initGSNConnection();
 		void readMetaData();
 		void getAllStations();
 		void save_station(const std::string& id, const std::string& name, const double& lat, const double& lon,
 		                  const double& alt, const double& slope_angle, const double& slope_azi);
-		void readData(const Date& dateStart, const Date& dateEnd, std::vector<MeteoData>& vecMeteo, const size_t& stationindex);
-		void map_parameters(const std::string& fields, const std::string& units, MeteoData& md, std::vector<size_t>& index);
+		void readData(const Date& dateStart, const Date& dateEnd, const std::vector<size_t>& stations,
+		              std::vector< std::vector<MeteoData> >& vecMeteo);
+		static void map_parameters(station_stream& stream);
 		static double olwr_to_tss(const double& olwr);
-		void parse_streamElement(const std::string& line, const std::vector<size_t>& index,
-		                         const bool& olwr_present, std::vector<MeteoData>& vecMeteo, MeteoData& tmpmeteo) const;
+		void parse_line(station_stream& stream) const;
+		void parse_streamElement(station_stream& stream) const;
 		static size_t data_write(void* buf, size_t size, size_t nmemb, void* userp);
+		static size_t stream_write(void* buf, size_t size, size_t nmemb, void* userp);
 		bool curl_read(const std::string& url, std::ostream& os);
 
 		const Config cfg;
 		std::vector<std::string> vecStationName;
-		std::map<size_t, double> multiplier, offset;
 		std::vector<StationData> vecMeta, vecAllMeta;
 		std::string coordin, coordinparam, coordout, coordoutparam; //projection parameters
 		std::string endpoint, userid, passwd; ///< Variables for endpoint configuration
 		double default_timezone;
+		size_t nr_connections; ///< how many requests can be sent in parallel
 
 		static const int http_timeout; //time out for http connections
 		static const std::string sensors_endpoint, null_string;
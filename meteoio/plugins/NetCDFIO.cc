@@ -62,6 +62,9 @@ namespace mio {
  * - GRID2DFILE: the NetCDF file which shall be used for gridded input/output; [Input] and [Output] section
  * - STRICTFORMAT: Whether the NetCDF file should be strictly compliant with the CNRM standard; Parameters not present
  *                 in the specification will be omitted; [Input] and [Output] section
+ * - METEOPARAMS: only read the given meteorological parameters (MeteoIO names, for example TA RH HNW) from METEOFILE. All the
+ *                parameters needed by the application, the generators and the spatial interpolations (such as TA and RH for
+ *                the ILWR generators) must be listed. By default, all parameters are read; [Input] section
  *
  * @section example Example use
  * @code
@@ -160,20 +163,27 @@ bool NetCDFIO::initStaticData()
 }
 
 NetCDFIO::NetCDFIO(const std::string& configfile) : cfg(configfile), coordin(), coordinparam(), coordout(), coordoutparam(),
-                                                    in_dflt_TZ(0.), out_dflt_TZ(0.), in_strict(false), out_strict(false), vecMetaData()
+                                                    in_dflt_TZ(0.), out_dflt_TZ(0.), in_strict(false), out_strict(false), vecMetaData(),
+                                                    meteo_filename(), meteo_ncid(-1), vecMeteoDates(), meteo_parameters(), meteo_template(),
+                                                    meteo_timestep(IOUtils::nodata), meteo_chunk(0), requested_params()
 {
 	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
 	parseInputOutputSection();
 }
 
 NetCDFIO::NetCDFIO(const Config& cfgreader) : cfg(cfgreader), coordin(), coordinparam(), coordout(), coordoutparam(),
-                                              in_dflt_TZ(0.), out_dflt_TZ(0.), in_strict(false), out_strict(false), vecMetaData()
+                                              in_dflt_TZ(0.), out_dflt_TZ(0.), in_strict(false), out_strict(false), vecMetaData(),
+                                              meteo_filename(), meteo_ncid(-1), vecMeteoDates(), meteo_parameters(), meteo_template(),
+                                              meteo_timestep(IOUtils::nodata), meteo_chunk(0), requested_params()
 {
 	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
 	parseInputOutputSection();
 }
 
-NetCDFIO::~NetCDFIO() throw() {}
+NetCDFIO::~NetCDFIO() throw()
+{
+	if (meteo_ncid != -1) nc_close(meteo_ncid); //no exceptions in the destructor
+}
 
 void NetCDFIO::parseInputOutputSection()
 {
@@ -184,6 +194,40 @@ void NetCDFIO::parseInputOutputSection()
 
 	cfg.getValue("STRICTFORMAT", "Input", in_strict, IOUtils::nothrow);
 	cfg.getValue("STRICTFORMAT", "Output", out_strict, IOUtils::nothrow);
+
+	get_requested_parameters();
+}
+
+//build the list of MeteoIO parameters that should be read, as given by METEOPARAMS
+void NetCDFIO::get_requested_parameters()
+{
+	requested_params.clear();
+
+	vector<string> vecParams;
+	cfg.getValue("METEOPARAMS", "Input", vecParams, IOUtils::nothrow);
+	for (size_t ii=0; ii<vecParams.size(); ii++)
+		requested_params.insert( IOUtils::strToUpper(vecParams[ii]) ); //empty: all parameters will be read
+}
+
+//check if a NetCDF variable contributes to one of the requested MeteoIO parameters
+bool NetCDFIO::is_requested(const std::string& varname) const
+{
+	if (requested_params.empty()) return true;
+
+	string name;
+	if ((varname == cnrm_hnw) || (varname == cnrm_snowf)) {
+		name = "HNW";
+	} else if ((varname == cnrm_swr_direct) || (varname == cnrm_swr_diffuse)) {
+		name = "ISWR";
+	} else {
+		const map<string, size_t>::const_iterator it = paramname.find(varname);
+		if (it != paramname.end() && it->second != IOUtils::npos)
+			name = MeteoData::getParameterName(it->second);
+		else
+			name = IOUtils::strToUpper(varname);
+	}
+
+	return (requested_params.find(name) != requested_params.end());
 }
 
 void NetCDFIO::read2DGrid(Grid2DObject& grid_out, const std::string& arguments)
@@ -383,20 +427,60 @@ void NetCDFIO::readAssimilationData(const Date& /*date_in*/, Grid2DObject& /*da_
 
 void NetCDFIO::readStationData(const Date&, std::vector<StationData>& vecStation)
 {
-	if (!vecMetaData.empty()) { // We already have meta data
-		vecStation = vecMetaData;
-		return;
-	}
+	open_meteo_file();
+	vecStation = vecMetaData;
+}
 
-	string filename;
-	cfg.getValue("METEOFILE", "Input", filename);
+//open METEOFILE (if not already done) and read everything that does not depend on the requested dates
+void NetCDFIO::open_meteo_file()
+{
+	if (meteo_ncid != -1) return;
 
+	cfg.getValue("METEOFILE", "Input", meteo_filename);
 	int ncid;
-	open_file(filename, NC_NOWRITE, ncid);
-	readMetaData(ncid, vecMetaData);
-	close_file(filename, ncid);
+	open_file(meteo_filename, NC_NOWRITE, ncid);
 
-	vecStation = vecMetaData;
+	try {
+		readMetaData(ncid, vecMetaData);
+		vecMeteoDates.clear();
+		meteo_parameters.clear();
+		meteo_template = MeteoData();
+		meteo_timestep = IOUtils::nodata;
+		meteo_chunk = 0;
+
+		if (!vecMetaData.empty()) {
+			read_time_axis(ncid, vecMeteoDates);
+
+			map<string, size_t> map_parameters;
+			get_parameters(ncid, map_parameters, meteo_template); //get a list of parameters present an render the template
+			for (map<string, size_t>::const_iterator it = map_parameters.begin(); it != map_parameters.end(); ++it) {
+				if (is_requested(it->first)) meteo_parameters.insert(*it);
+			}
+
+			if (check_variable(ncid, cnrm_timestep)) {
+				int varid;
+				get_variable(ncid, cnrm_timestep, varid);
+				read_value(ncid, cnrm_timestep, varid, meteo_timestep);
+			}
+
+			//read as many records as fit in about 8MB, aligned on the chunks of the time dimension
+			const size_t nr_stations = vecMetaData.size();
+			const size_t target = std::max((size_t)1, (size_t)(1024*1024) / nr_stations);
+			size_t file_chunk = 0;
+			if (!meteo_parameters.empty()) {
+				int varid;
+				const string& varname = meteo_parameters.begin()->first;
+				get_variable(ncid, varname, varid);
+				file_chunk = get_chunk_length(ncid, varname, varid, 0);
+			}
+			meteo_chunk = (file_chunk==0)? target : ((target + file_chunk - 1) / file_chunk) * file_chunk;
+		}
+	} catch(...) {
+		nc_close(ncid);
+		throw;
+	}
+
+	meteo_ncid = ncid;
 }
 
 void NetCDFIO::readMetaData(const int& ncid, std::vector<StationData>& vecStation)
@@ -470,138 +554,110 @@ void NetCDFIO::get_meta_data_ids(const int& ncid, std::map<std::string, int>& ma
 void NetCDFIO::readMeteoData(const Date& dateStart, const Date& dateEnd, std::vector< std::vector<MeteoData> >& vecMeteo, const size_t&)
 {
 	vecMeteo.clear();
+	open_meteo_file();
+	if (vecMetaData.empty()) return; //no stations
 
-	string filename;
-	cfg.getValue("METEOFILE", "Input", filename);
+	//the time axis is sorted, so a binary search gives the records within [dateStart, dateEnd]
+	const size_t index_start = std::lower_bound(vecMeteoDates.begin(), vecMeteoDates.end(), dateStart) - vecMeteoDates.begin();
+	const size_t index_end = std::upper_bound(vecMeteoDates.begin(), vecMeteoDates.end(), dateEnd) - vecMeteoDates.begin();
+	if (index_start >= index_end) return;
 
-	int ncid;
-	open_file(filename, NC_NOWRITE, ncid);
-
-	if (vecMetaData.empty()) readMetaData(ncid, vecMetaData);
-
-	if (!vecMetaData.empty()) { //at least one station exists
-		size_t index_start, index_end;
-		vector<Date> vec_date;
-		get_indices(ncid, dateStart, dateEnd, index_start, index_end, vec_date); //get indices for dateStart and dateEnd
-
-		MeteoData meteo_data; //the template MeteoData object
-		if ((index_start != IOUtils::npos) && (index_end != IOUtils::npos)) {
-			map<string, size_t> map_parameters;
-			get_parameters(ncid, map_parameters, meteo_data); //get a list of parameters present an render the template
-
-			readData(ncid, index_start, vec_date, map_parameters, meteo_data, vecMeteo);
-		}
-	}
-
-	close_file(filename, ncid);
+	readData(index_start, index_end, vecMeteo);
 }
 
-void NetCDFIO::readData(const int& ncid, const size_t& index_start, const std::vector<Date>& vec_date,
-                        const std::map<std::string, size_t>& map_parameters, const MeteoData& meteo_data, std::vector< std::vector<MeteoData> >& vecMeteo)
+// The data is read for all stations, one parameter at a time and by blocks of records aligned on the
+// chunks of the file. Each block is then directly copied into the MeteoData objects so the memory
+// footprint stays limited to one block, whatever the size of the file or of the requested period
+void NetCDFIO::readData(const size_t& index_start, const size_t& index_end, std::vector< std::vector<MeteoData> >& vecMeteo)
 {
 	const size_t number_of_stations = vecMetaData.size();
-	const size_t number_of_records = vec_date.size();
-
-	// Allocate all the MeteoData objects based on the template meteo_data
-	vector<MeteoData> tmp_vec(number_of_records, meteo_data);
-	for (size_t jj=0; jj<number_of_records; jj++) tmp_vec[jj].date = vec_date[jj]; //set correct date for every record
+	const size_t number_of_records = index_end - index_start;
 
+	vecMeteo.resize(number_of_stations);
 	for (size_t ii=0; ii<number_of_stations; ii++) {
-		for (size_t jj=0; jj<number_of_records; jj++) tmp_vec[jj].meta = vecMetaData[ii]; //adapt meta data
-		vecMeteo.push_back(tmp_vec);
+		MeteoData md(meteo_template);
+		md.meta = vecMetaData[ii];
+		vecMeteo[ii].assign(number_of_records, md);
+		for (size_t jj=0; jj<number_of_records; jj++) vecMeteo[ii][jj].date = vecMeteoDates[index_start+jj];
 	}
 
-	// Allocate enough linear space for each parameter and read the data from NetCDF
-	map<string, double*> map_data;
-	for (map<string, size_t>::const_iterator it = map_parameters.begin(); it != map_parameters.end(); ++it) {
-		double* data = new double[number_of_stations*number_of_records];
-		const string& varname = it->first;
-
-		map_data[varname] = data;
+	const size_t block_records = std::min(meteo_chunk, number_of_records); //a block never spans more than one chunk
+	vector<double> buffer(block_records * number_of_stations);
+	double *data = &buffer[0];
 
+	for (map<string, size_t>::const_iterator it = meteo_parameters.begin(); it != meteo_parameters.end(); ++it) {
+		const string& varname = it->first;
 		int varid;
-		get_variable(ncid, varname, varid);
-		read_data_2D(ncid, varname, varid, index_start, number_of_records, number_of_stations, data);
-	}
-
-	copy_data(ncid, map_parameters, map_data, number_of_stations, number_of_records, vecMeteo);
-
-	for (map<string, double*>::const_iterator it = map_data.begin(); it != map_data.end(); ++it) {
-		delete[] it->second;
+		get_variable(meteo_ncid, varname, varid);
+
+		size_t record = index_start;
+		while (record < index_end) {
+			const size_t block_end = std::min(index_end, (record/meteo_chunk + 1) * meteo_chunk);
+			const size_t count = block_end - record;
+			read_data_2D(meteo_ncid, varname, varid, record, count, number_of_stations, data);
+			copy_data(varname, it->second, data, number_of_stations, record-index_start, count, vecMeteo);
+			record = block_end;
+		}
 	}
 }
 
 // The copying of data into vecMeteo is a process consisting of:
-// 1. A check what the relation between MeteoIO parameters and CNRM parameters present is, check map_parameters
+// 1. A check what the relation between MeteoIO parameters and CNRM parameters present is (param)
 // 2. If there is no direct association between the parameters present and the meteo_data parameters we might
 //    have to deal with the parameter in a more complex way: e.g., HNW or SWR measurements
-// 3. Once we know how to deal with the parameter we loop through all stations and all parameters and copy them
-//    into the appropriate places. All unit conversion have been accomplished at that point.
-void NetCDFIO::copy_data(const int& ncid, const std::map<std::string, size_t>& map_parameters, const std::map<std::string, double*> map_data,
-                         const size_t& number_of_stations, const size_t& number_of_records, std::vector< std::vector<MeteoData> >& vecMeteo)
+// 3. Once we know how to deal with the parameter we loop through all stations and all records of the block and
+//    copy them into the appropriate places. All unit conversion have been accomplished at that point.
+void NetCDFIO::copy_data(const std::string& varname, const size_t& param, const double * const data, const size_t& number_of_stations,
+                         const size_t& record_offset, const size_t& number_of_records, std::vector< std::vector<MeteoData> >& vecMeteo)
 {
-	for (map<string, double*>::const_iterator it = map_data.begin(); it != map_data.end(); ++it) {
-		const string& varname = it->first;
-
-		//find correct handling for each parameter
-		bool simple_copy = false, mutiply_copy = false, hnw_measurement = false, sw_measurement = false;
-		double multiplier = IOUtils::nodata;
-		const size_t param = map_parameters.find(varname)->second; //must exist, at this point we know it does
-
-		if (param == IOUtils::npos) {
-			if ((varname == cnrm_snowf) || (varname == cnrm_hnw)) {
-				int varid;
-				get_variable(ncid, cnrm_timestep, varid);
-				read_value(ncid, cnrm_timestep, varid, multiplier);
-
-				if (multiplier <= 0) throw InvalidArgumentException("The variable '" + cnrm_timestep + "' is invalid", AT);
-
-				hnw_measurement = true;
-			} else if ((varname == cnrm_swr_diffuse) || (varname == cnrm_swr_direct)) {
-				sw_measurement = true;
-			} else {
-				throw IOException("Don't know how to deal with parameter " + varname, AT);
-			}
+	//find correct handling for the parameter
+	bool simple_copy = false, mutiply_copy = false, hnw_measurement = false, sw_measurement = false;
+	double multiplier = IOUtils::nodata;
+
+	if (param == IOUtils::npos) {
+		if ((varname == cnrm_snowf) || (varname == cnrm_hnw)) {
+			multiplier = meteo_timestep;
+			if (multiplier == IOUtils::nodata || multiplier <= 0) throw InvalidArgumentException("The variable '" + cnrm_timestep + "' is invalid", AT);
+
+			hnw_measurement = true;
+		} else if ((varname == cnrm_swr_diffuse) || (varname == cnrm_swr_direct)) {
+			sw_measurement = true;
 		} else {
-			if (varname == cnrm_rh) {
-				mutiply_copy = true;
-				multiplier = 0.01;
-			} else {
-				simple_copy = true;
-			}
+			throw IOException("Don't know how to deal with parameter " + varname, AT);
 		}
+	} else {
+		if (varname == cnrm_rh) {
+			mutiply_copy = true;
+			multiplier = 0.01;
+		} else {
+			simple_copy = true;
+		}
+	}
 
-		// Loop through all times and all stations
-		for (size_t jj=0; jj<number_of_records; jj++) {
-			for (size_t ii=0; ii<number_of_stations; ii++) {
-				double& value = (it->second)[jj*number_of_stations + ii];
-				bool nodata = false;
-
-				if (value == plugin_nodata) {
-					nodata = true;
-					value = IOUtils::nodata;
+	// Loop through all times and all stations
+	for (size_t jj=0; jj<number_of_records; jj++) {
+		const double * const record = data + jj*number_of_stations;
+		const size_t index = record_offset + jj;
+
+		for (size_t ii=0; ii<number_of_stations; ii++) {
+			const bool nodata = (record[ii] == plugin_nodata);
+			const double value = (nodata)? IOUtils::nodata : record[ii];
+
+			if (simple_copy) {
+				vecMeteo[ii][index](param) = value;
+			} else if (mutiply_copy) {
+				vecMeteo[ii][index](param) = (nodata)? value : value * multiplier;
+			} else if (hnw_measurement) {
+				if (!nodata) {
+					double& hnw = vecMeteo[ii][index](MeteoData::HNW);
+					if (hnw == IOUtils::nodata) hnw = 0.0;
+					hnw += value * multiplier;
 				}
-
-				if (simple_copy) {
-					vecMeteo[ii][jj](param) = value;
-				} else if (mutiply_copy) {
-					if (nodata) {
-						vecMeteo[ii][jj](param) = value;
-					} else {
-						vecMeteo[ii][jj](param) = value * multiplier;
-					}
-				} else if (hnw_measurement) {
-					if (!nodata) {
-						double& hnw = vecMeteo[ii][jj](MeteoData::HNW);
-						if (hnw == IOUtils::nodata) hnw = 0.0;
-						hnw += value * multiplier;
-					}
-				} else if (sw_measurement) {
-					if (!nodata) {
-						double& iswr = vecMeteo[ii][jj](MeteoData::ISWR);
-						if (iswr == IOUtils::nodata) iswr = 0.0;
-						iswr += value;
-					}
+			} else if (sw_measurement) {
+				if (!nodata) {
+					double& iswr = vecMeteo[ii][index](MeteoData::ISWR);
+					if (iswr == IOUtils::nodata) iswr = 0.0;
+					iswr += value;
 				}
 			}
 		}
@@ -651,17 +707,16 @@ void NetCDFIO::get_parameters(const int& ncid, std::map<std::string, size_t>& ma
 }
 
 // The CNRM format stores timestamps as doubles (either seconds or days counted from a start date)
-// This method takes the dateStart and dateEnd requested and looks for the corresponding indices
-// of the time variable indexStart and indexEnd.
-// Furthermore the timestamps are converted to mio::Date objects and stored in vecDate
-void NetCDFIO::get_indices(const int& ncid, const Date& dateStart, const Date& dateEnd, size_t& indexStart, size_t& indexEnd, std::vector<Date>& vecDate)
+// This method reads the whole time axis once and converts the timestamps to mio::Date objects
+void NetCDFIO::read_time_axis(const int& ncid, std::vector<Date>& vecDate)
 {
-	indexStart = indexEnd = IOUtils::npos;
+	vecDate.clear();
 
 	int varid, dimid;
 	size_t dimlen;
 	get_dimension(ncid, NetCDFIO::cf_time, dimid, dimlen);
 	get_variable(ncid, NetCDFIO::cf_time, varid);
+	if (dimlen == 0) return;
 
 	// Get the units attribute and calculate the offset date
 	string units_str;
@@ -670,62 +725,15 @@ void NetCDFIO::get_indices(const int& ncid, const Date& dateStart, const Date& d
 	get_attribute(ncid, NetCDFIO::cf_time, varid, cf_units, units_str);
 	calculate_offset(units_str, unit_type, offset);
 
-	double *time = new double[dimlen];
-	read_data(ncid, NetCDFIO::cf_time, varid, time);
-
-	// Firstly, check whether search makes any sense, that is dateStart and dateEnd overlap with the times present
-	bool search = true;
-	if (dimlen > 0) {
-		Date time_start(offset), time_end(offset);
-
-		double start = time[0];
-		double end = time[dimlen-1];
-
-		if (unit_type == seconds) {
-			start /= 86400;
-			end   /= 86400;
-		}
-		if (unit_type == hours) {
-			start /= 24;
-			end   /= 24;
-		}
-		time_start += Date(start, 0.0);
-		time_end += Date(end, 0.0);
-
-		if (time_start > dateEnd) search = false;
-		if (time_end < dateStart) search = false;
-	}
-
-	// If search is feasible then loop through the existent timestamps and find the relevant indices
-	bool start_found = false;
-	if (search) {
-		for (size_t ii=0; ii<dimlen; ii++) {
-			if (unit_type == seconds) {
-				time[ii] /= 86400;
-			}
-			if (unit_type == hours) {
-				time[ii] /= 24;
-			}
-
-			const Date tmp_date = offset + Date(time[ii], 0.0);
-
-			if (!start_found && (dateStart <= tmp_date && tmp_date <= dateEnd)) {
-				start_found = true;
-				indexStart = ii;
-			} else if (start_found && (tmp_date > dateEnd)) {
-				indexEnd = ii-1;
-				break;
-			}
-
-			if (start_found) vecDate.push_back(tmp_date);
-		}
+	vector<double> time(dimlen);
+	double *time_ptr = &time[0];
+	read_data(ncid, NetCDFIO::cf_time, varid, time_ptr);
 
-		if (start_found && (indexEnd == IOUtils::npos)) {
-			indexEnd = dimlen-1;
-		}
+	const double divisor = (unit_type == seconds)? 86400. : (unit_type == hours)? 24. : 1.;
+	vecDate.reserve(dimlen);
+	for (size_t ii=0; ii<dimlen; ii++) {
+		vecDate.push_back( offset + Date(time[ii] / divisor, 0.0) );
 	}
-
-	delete[] time;
 }
 
 // The CNRM timestamps have an offset that is saved in the units attribute of
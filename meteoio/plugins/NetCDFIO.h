@@ -22,6 +22,7 @@
 #include <meteoio/Config.h>
 
 #include <string>
+#include <set>
 
 namespace mio {
 
@@ -73,14 +74,16 @@ class NetCDFIO : public IOInterface {
 		size_t get_dates(const std::vector< std::vector<MeteoData> >& vecMeteo, double*& dates);
 		void copy_data(const size_t& number_of_stations, const size_t& number_of_records, const std::vector< std::vector<MeteoData> >& vecMeteo,
                          const std::map<size_t, std::string>& map_param_name, std::map<std::string, double*>& map_data_2D);
-		void copy_data(const int& ncid, const std::map<std::string, size_t>& map_parameters, const std::map<std::string, double*> map_data,
-		               const size_t& number_of_stations, const size_t& number_of_records, std::vector< std::vector<MeteoData> >& vecMeteo);
-		void readData(const int& ncid, const size_t& index_start, const std::vector<Date>& vec_date, const std::map<std::string, size_t>& map_parameters,
-		              const MeteoData& meteo_data, std::vector< std::vector<MeteoData> >& vecMeteo);
+		void copy_data(const std::string& varname, const size_t& param, const double * const data, const size_t& number_of_stations,
+		               const size_t& record_offset, const size_t& number_of_records, std::vector< std::vector<MeteoData> >& vecMeteo);
+		void readData(const size_t& index_start, const size_t& index_end, std::vector< std::vector<MeteoData> >& vecMeteo);
+		void open_meteo_file();
+		void get_requested_parameters();
+		bool is_requested(const std::string& varname) const;
 		void readMetaData(const int& ncid, std::vector<StationData>& vecStation);
 		void get_meta_data_ids(const int& ncid, std::map<std::string, int>& map_vid);
 		std::string get_varname(const MeteoGrids::Parameters& parameter);
-		void get_indices(const int& ncid, const Date& dateStart, const Date& dateEnd, size_t& indexStart, size_t& indexEnd, std::vector<Date>& vecDate);
+		void read_time_axis(const int& ncid, std::vector<Date>& vecDate);
 		void calculate_offset(const std::string& units, NetCDFIO::TimeUnit& time_unit, Date& offset);
 		void check_consistency(const int& ncid, const Grid2DObject& grid, double*& lat_array, double*& lon_array,
 		                       int& did_lat, int& did_lon, int& vid_lat, int& vid_lon);
@@ -113,6 +116,16 @@ class NetCDFIO : public IOInterface {
 		double in_dflt_TZ, out_dflt_TZ;     //default time zones
 		bool in_strict, out_strict;
 		std::vector<StationData> vecMetaData;
+
+		//the METEOFILE is kept open between calls to readMeteoData
+		std::string meteo_filename;
+		int meteo_ncid; ///< -1 when METEOFILE is not opened
+		std::vector<Date> vecMeteoDates; ///< time axis of METEOFILE
+		std::map<std::string, size_t> meteo_parameters; ///< variables to read and their index in meteo_template
+		MeteoData meteo_template; ///< MeteoData object with all the extra parameters found in METEOFILE
+		double meteo_timestep; ///< value of FRC_TIME_STP, nodata if not present
+		size_t meteo_chunk; ///< number of records read at once, aligned on the file's chunks
+		std::set<std::string> requested_params; ///< MeteoIO parameters to read, empty means all
 };
 
 } //namespace
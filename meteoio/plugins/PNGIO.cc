@@ -57,6 +57,8 @@ namespace mio {
  * - PNG_INDEXED: create an indexed PNG? (default=true)
  * - PNG_NR_LEVELS: number of colors to use (less=smaller files, but it must be at least 5 and less than 255. default=30)
  * - PNG_SPEED_OPTIMIZE: optimize file creation for speed? (default=true, otherwise optimize for file size)
+ * - PNG_PARALLEL: convert, filter and compress the image by blocks of rows on several threads (default=false). This requires
+ * MeteoIO to be compiled with OpenMP support to bring any speedup and produces slightly larger files.
  *
  * The size are specified as width followed by height, with the separator being either a space, 'x' or '*'. If a minimum and a maximum size are given, the average of the smallest and largest permissible sizes will be used.
  * The world file is used for geolocalization and goes alongside the graphics output. By convention,
@@ -98,11 +100,70 @@ const double PNGIO::plugin_nodata = -999.; //plugin specific nodata value. It ca
 const unsigned char PNGIO::channel_depth = 8;
 const unsigned char PNGIO::channel_max_color = 255;
 const unsigned char PNGIO::transparent_grey = channel_max_color;
+const size_t PNGIO::block_bytes = 256*1024;
+
+//PNG filtering of one row (see the PNG specification, chapter 9): we use either SUB or UP, whichever gives the
+//smallest sum of absolute differences (as libpng does when both filters are allowed)
+static void filterRow(const png_byte *row, const png_byte *prev, const size_t& row_bytes, const size_t& bpp, png_byte *out)
+{
+	unsigned long sum_sub=0, sum_up=0;
+	for(size_t ii=0; ii<row_bytes; ii++) {
+		const png_byte sub = static_cast<png_byte>(row[ii] - ((ii>=bpp)? row[ii-bpp] : 0));
+		const png_byte up = static_cast<png_byte>(row[ii] - ((prev!=NULL)? prev[ii] : 0));
+		sum_sub += (sub<128)? sub : 256-sub;
+		sum_up += (up<128)? up : 256-up;
+	}
+
+	if(sum_up<sum_sub) {
+		out[0] = 2;
+		for(size_t ii=0; ii<row_bytes; ii++)
+			out[ii+1] = static_cast<png_byte>(row[ii] - ((prev!=NULL)? prev[ii] : 0));
+	} else {
+		out[0] = 1;
+		for(size_t ii=0; ii<row_bytes; ii++)
+			out[ii+1] = static_cast<png_byte>(row[ii] - ((ii>=bpp)? row[ii-bpp] : 0));
+	}
+}
+
+//compress data[start, start+len[ as raw deflate blocks that can be concatenated with the previous and next ones
+static bool deflateBlock(const png_byte *data, const size_t& start, const size_t& len, const bool& last, const int& level, const int& strategy, std::vector<png_byte>& out)
+{
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	if(deflateInit2(&strm, level, Z_DEFLATED, -15, 8, strategy)!=Z_OK) return false; //negative window bits -> no zlib header
+
+	//the end of the previous block is given as dictionary, so splitting the data costs very little compression
+	if(start>0) {
+		const size_t dict_len = std::min(start, static_cast<size_t>(32768));
+		deflateSetDictionary(&strm, data+start-dict_len, static_cast<uInt>(dict_len));
+	}
+
+	const int flush = (last)? Z_FINISH : Z_SYNC_FLUSH; //the sync flush aligns the end of the block on a byte boundary
+	strm.next_in = const_cast<Bytef*>(data+start);
+	strm.avail_in = static_cast<uInt>(len);
+	out.resize(deflateBound(&strm, static_cast<uLong>(len)) + 64);
+	size_t produced = 0;
+	int status;
+	while(true) {
+		strm.next_out = &out[produced];
+		strm.avail_out = static_cast<uInt>(out.size()-produced);
+		status = deflate(&strm, flush);
+		produced = out.size() - strm.avail_out;
+		if(status==Z_STREAM_ERROR || status==Z_STREAM_END || strm.avail_out!=0) break;
+		out.resize(2*out.size());
+	}
+	deflateEnd(&strm);
+	out.resize(produced);
+
+	return (last)? (status==Z_STREAM_END) : (status==Z_OK || status==Z_BUF_ERROR);
+}
 
 PNGIO::PNGIO(const std::string& configfile)
        : cfg(configfile),
          fp(NULL), autoscale(true), has_legend(true), has_world_file(false), optimize_for_speed(true),
-         indexed_png(true), nr_levels(30),
+         indexed_png(true), parallel_encoding(false), nr_levels(30),
          coordout(), coordoutparam(), grid2dpath(),
          scaling("bilinear"), min_w(IOUtils::unodata), min_h(IOUtils::unodata), max_w(IOUtils::unodata), max_h(IOUtils::unodata),
          metadata_key(), metadata_text()
@@ -113,7 +174,7 @@ PNGIO::PNGIO(const std::string& configfile)
 PNGIO::PNGIO(const Config& cfgreader)
        : cfg(cfgreader),
          fp(NULL), autoscale(true), has_legend(true), has_world_file(false), optimize_for_speed(true),
-         indexed_png(true), nr_levels(30),
+         indexed_png(true), parallel_encoding(false), nr_levels(30),
          coordout(), coordoutparam(), grid2dpath(),
          scaling("bilinear"), min_w(IOUtils::unodata), min_h(IOUtils::unodata), max_w(IOUtils::unodata), max_h(IOUtils::unodata),
          metadata_key(), metadata_text()
@@ -129,6 +190,7 @@ PNGIO& PNGIO::operator=(const PNGIO& source) {
 		has_world_file = source.has_world_file;
 		optimize_for_speed = source.optimize_for_speed;
 		indexed_png = source.indexed_png;
+		parallel_encoding = source.parallel_encoding;
 		nr_levels = source.nr_levels;
 		coordout = source.coordout;
 		coordoutparam = source.coordoutparam;
@@ -171,6 +233,7 @@ void PNGIO::setOptions()
 
 	cfg.getValue("PNG_INDEXED", "Output", indexed_png, IOUtils::nothrow);
 	cfg.getValue("PNG_SPEED_OPTIMIZE", "Output", optimize_for_speed, IOUtils::nothrow);
+	cfg.getValue("PNG_PARALLEL", "Output", parallel_encoding, IOUtils::nothrow);
 	unsigned int tmp=IOUtils::unodata;
 	cfg.getValue("PNG_NR_LEVELS", "Output", tmp, IOUtils::nothrow);
 	if(tmp!=IOUtils::unodata && (tmp>255 || tmp<5)) {
@@ -391,70 +454,106 @@ size_t PNGIO::setLegend(const size_t &ncols, const size_t &nrows, const double &
 	}
 }
 
-void PNGIO::writeDataSection(const Grid2DObject& grid, const Array2D<double>& legend_array, const Gradient& gradient, const size_t& full_width, const png_structp& png_ptr, png_infop& info_ptr)
+void PNGIO::writeDataSection(const Grid2DObject& grid, const Array2D<double>& legend_array, const Gradient& gradient, const size_t& full_width, const png_structp& png_ptr, png_infop& /*info_ptr*/)
 {
 	const size_t ncols = grid.ncols;
 	const size_t nrows = grid.nrows;
-
-	// Allocate memory for one row (3 bytes per pixel - RGB)
 	const unsigned char channels = (indexed_png)? 1 : 3; //4 for rgba
-	png_bytep row = (png_bytep)calloc(channels*sizeof(png_byte), full_width);
-	if(row==NULL) {
-		fclose(fp); fp=NULL;
-		png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
-		free(png_ptr);
-		throw IOException("Can not allocate row memory for PNG!", AT);
+	const size_t row_bytes = channels*full_width;
+
+	//convert the whole image to colors, the top row coming first
+	std::vector<png_byte> image(row_bytes*nrows);
+	const long nr_rows = static_cast<long>(nrows);
+	std::string error_msg;
+	#ifdef _OPENMP
+	#pragma omp parallel for if(parallel_encoding)
+	#endif
+	for(long jj=0; jj<nr_rows; jj++) {
+		const size_t y = nrows-1-static_cast<size_t>(jj);
+		std::vector<double> values(full_width);
+		for(size_t x=0; x<ncols; x++) values[x] = grid(x,y);
+		for(size_t x=ncols; x<full_width; x++) values[x] = legend_array(x-ncols,y);
+
+		try {
+			png_bytep row = &image[static_cast<size_t>(jj)*row_bytes];
+			if(indexed_png) gradient.getColors(&values[0], full_width, row);
+			else gradient.getColors(&values[0], full_width, row, transparent_grey);
+		} catch(const std::exception& e) {
+			#ifdef _OPENMP
+			#pragma omp critical(pngio_errors)
+			#endif
+			{
+				if(error_msg.empty()) error_msg = e.what();
+			}
+		}
 	}
+	if(!error_msg.empty()) throw IOException(error_msg, AT);
 
 	// Write image data
-	if(indexed_png) {
-		for(size_t y=(nrows-1) ; y-- > 0; ) {
-			size_t x=0;
-			for(; x<ncols ; x++) {
-				const size_t i=x*channels;
-				unsigned char index;
-				gradient.getColor(grid(x,y), index);
-				row[i]=static_cast<png_byte>(index);
-			}
-			for(; x<full_width; x++) {
-				const size_t i=x*channels;
-				unsigned char index;
-				gradient.getColor(legend_array(x-ncols,y), index);
-				row[i]=static_cast<png_byte>(index);
-			}
-			png_write_row(png_ptr, row);
-		}
+	if(parallel_encoding) {
+		writeParallelData(image, row_bytes, nrows, png_ptr);
 	} else {
-		for(size_t y=(nrows-1) ; y -- > 0; ) {
-			size_t x=0;
-			for(; x<ncols ; x++) {
-				const size_t i=x*channels;
-				unsigned char r,g,b;
-				bool a;
-				gradient.getColor(grid(x,y), r,g,b,a);
-				if(a==true) {
-					row[i]=static_cast<png_byte>(transparent_grey); row[i+1]=static_cast<png_byte>(transparent_grey); row[i+2]=static_cast<png_byte>(transparent_grey);
-				} else {
-					row[i]=static_cast<png_byte>(r); row[i+1]=static_cast<png_byte>(g); row[i+2]=static_cast<png_byte>(b);
-				}
-			}
-			for(; x<full_width; x++) {
-				const size_t i=x*channels;
-				unsigned char r,g,b;
-				bool a;
-				gradient.getColor(legend_array(x-ncols,y), r,g,b,a);
-				if(a==true) {
-					row[i]=static_cast<png_byte>(transparent_grey); row[i+1]=static_cast<png_byte>(transparent_grey); row[i+2]=static_cast<png_byte>(transparent_grey);
-				} else {
-					row[i]=static_cast<png_byte>(r); row[i+1]=static_cast<png_byte>(g); row[i+2]=static_cast<png_byte>(b);
-				}
-			}
-			png_write_row(png_ptr, row);
-		}
+		for(size_t jj=0; jj<nrows; jj++)
+			png_write_row(png_ptr, &image[jj*row_bytes]);
+		png_write_end(png_ptr, NULL);
+	}
+}
+
+//The rows are filtered and compressed by independent blocks, then written as one zlib stream (as pigz does). Since libpng
+//can only compress sequentially, we write the IDAT and IEND chunks ourselves.
+void PNGIO::writeParallelData(const std::vector<png_byte>& image, const size_t& row_bytes, const size_t& nrows, const png_structp& png_ptr)
+{
+	const size_t bpp = (indexed_png)? 1 : 3; //bytes per pixel, for the SUB filter
+	const size_t line_bytes = row_bytes+1; //each filtered row starts with its filter type
+	const long nr_rows = static_cast<long>(nrows);
+
+	std::vector<png_byte> filtered(line_bytes*nrows);
+	#ifdef _OPENMP
+	#pragma omp parallel for if(parallel_encoding)
+	#endif
+	for(long jj=0; jj<nr_rows; jj++) {
+		const png_byte *prev = (jj>0)? &image[static_cast<size_t>(jj-1)*row_bytes] : NULL;
+		filterRow(&image[static_cast<size_t>(jj)*row_bytes], prev, row_bytes, bpp, &filtered[static_cast<size_t>(jj)*line_bytes]);
+	}
+
+	const size_t block_rows = std::max(static_cast<size_t>(1), block_bytes/line_bytes);
+	const size_t nr_blocks = (nrows+block_rows-1) / block_rows;
+	const int level = (optimize_for_speed)? Z_BEST_SPEED : Z_BEST_COMPRESSION;
+	const int strategy = (indexed_png)? Z_RLE : Z_DEFAULT_STRATEGY;
+	std::vector< std::vector<png_byte> > blocks(nr_blocks);
+	std::vector<uLong> checksums(nr_blocks);
+	std::vector<size_t> lengths(nr_blocks);
+	std::vector<char> status(nr_blocks, 0);
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if(parallel_encoding)
+	#endif
+	for(long ii=0; ii<static_cast<long>(nr_blocks); ii++) {
+		const size_t start = static_cast<size_t>(ii)*block_rows*line_bytes;
+		lengths[ii] = std::min(block_rows*line_bytes, filtered.size()-start);
+		const bool last = (static_cast<size_t>(ii)==nr_blocks-1);
+		status[ii] = deflateBlock(&filtered[0], start, lengths[ii], last, level, strategy, blocks[ii]);
+		checksums[ii] = adler32(adler32(0L, Z_NULL, 0), &filtered[start], static_cast<uInt>(lengths[ii]));
 	}
 
+	//zlib stream: header, concatenated deflate blocks and adler32 checksum of the uncompressed data
+	std::vector<png_byte> stream;
+	stream.push_back(0x78); //deflate with a 32k window
+	stream.push_back((optimize_for_speed)? 0x01 : 0xDA); //compression level hint, so that the header is a multiple of 31
+	uLong adler = adler32(0L, Z_NULL, 0);
+	for(size_t ii=0; ii<nr_blocks; ii++) {
+		if(!status[ii]) throw IOException("Error while compressing PNG data", AT);
+		stream.insert(stream.end(), blocks[ii].begin(), blocks[ii].end());
+		adler = adler32_combine(adler, checksums[ii], static_cast<z_off_t>(lengths[ii]));
+	}
+	stream.push_back(static_cast<png_byte>((adler>>24) & 0xff));
+	stream.push_back(static_cast<png_byte>((adler>>16) & 0xff));
+	stream.push_back(static_cast<png_byte>((adler>>8) & 0xff));
+	stream.push_back(static_cast<png_byte>(adler & 0xff));
+
+	for(size_t pos=0; pos<stream.size(); pos+=block_bytes)
+		png_write_chunk(png_ptr, (png_bytep)"IDAT", &stream[pos], std::min(block_bytes, stream.size()-pos));
+	png_write_chunk(png_ptr, (png_bytep)"IEND", NULL, 0);
 	png_write_flush(png_ptr);
-	png_free(png_ptr, row);
 }
 
 void PNGIO::setPalette(const Gradient &gradient, png_structp& png_ptr, png_infop& info_ptr, png_color *palette)
@@ -514,7 +613,6 @@ void PNGIO::write2DGrid(const Grid2DObject& grid_in, const std::string& filename
 	writeMetadata(png_ptr, info_ptr);
 
 	writeDataSection(grid, legend_array, gradient, full_width, png_ptr, info_ptr);
-	png_write_end(png_ptr, NULL);
 
 	closePNG(png_ptr, info_ptr, palette);
 }
@@ -651,7 +749,6 @@ void PNGIO::write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameter
 	writeMetadata(png_ptr, info_ptr);
 
 	writeDataSection(grid, legend_array, gradient, full_width, png_ptr, info_ptr);
-	png_write_end(png_ptr, NULL);
 
 	closePNG(png_ptr, info_ptr, palette);
 }
@@ -73,6 +73,7 @@ class PNGIO : public IOInterface {
 		void writeWorldFile(const Grid2DObject& grid_in, const std::string& filename);
 		size_t setLegend(const size_t &ncols, const size_t &nrows, const double &min, const double &max, Array2D<double> &legend_array);
 		void writeDataSection(const Grid2DObject &grid, const Array2D<double> &legend_array, const Gradient &gradient, const size_t &full_width, const png_structp &png_ptr, png_infop& info_ptr);
+		void writeParallelData(const std::vector<png_byte>& image, const size_t& row_bytes, const size_t& nrows, const png_structp& png_ptr);
 		void setPalette(const Gradient &gradient, png_structp& png_ptr, png_infop& info_ptr, png_color *palette);
 		void closePNG(png_structp& png_ptr, png_infop& info_ptr, png_color *palette);
 		std::string decimal_to_dms(const double& decimal);
@@ -84,6 +85,7 @@ class PNGIO : public IOInterface {
 		bool has_world_file; ///< create world file with each file?
 		bool optimize_for_speed; ///< optimize for speed instead of compression?
 		bool indexed_png; ///< write an indexed png?
+		bool parallel_encoding; ///< filter and compress blocks of rows on several threads?
 		unsigned char nr_levels; ///< number of levels to represent? (less-> smaller file size and faster)
 		std::string coordout, coordoutparam; //projection parameters
 		std::string grid2dpath;
@@ -97,6 +99,7 @@ class PNGIO : public IOInterface {
 		static const unsigned char channel_depth;
 		static const unsigned char channel_max_color;
 		static const unsigned char transparent_grey;
+		static const size_t block_bytes; ///< size of the blocks of rows compressed independently when encoding in parallel
 };
 
 } //namespace
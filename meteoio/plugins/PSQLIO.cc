@@ -17,6 +17,9 @@
 */
 #include <set>
 #include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cmath>
 #include "PSQLIO.h"
 
 using namespace std;
@@ -50,6 +53,11 @@ namespace mio {
  *
  *      SELECT * FROM all_measurements WHERE id = ''STATIONID'' AND date>=''DATE_START'' AND date<=''DATE_END'' ORDER BY date
  *
+ * The queries of all the requested stations are combined into one single query (with UNION ALL), so all the stations are retrieved in one round trip
+ * to the server. The data is transferred in PostgreSQL's binary format, so the numerical columns must be of one of the following
+ * types: smallint, integer, bigint, real, double precision, numeric or text (the date column being a timestamp, a date or a text).
+ * The connection to the server is opened on the first request and kept open as long as the plugin is used.
+ *
  * @subsection psql_exclude_file Exclude file
  * It is possible to exclude specific parameters from specific stations. This is done by listing in a CSV file for each station id, which parameters should be excluded.
  * An example of an exclude file is given below:
@@ -85,13 +93,83 @@ namespace mio {
  *      - SQL_DATA: SQL query to use to get the stations' data.
  * - STATIONS: comma separated list of station ids that the user is interested in; [Input] section
  * - EXCLUDE: File containing a list of parameters to exclude listed per station id (optional; [Input] section)
+ * - PSQL_PREFETCH: once some data has been read, already request the next buffer window from the server so it can be processed while the current
+ * data is being used (optional, default: false; [Input] section). This doubles the amount of data that is transferred and only helps if the data is read
+ * sequentially in time.
  *
  */
 
 const double PSQLIO::plugin_nodata = -999.; //plugin specific nodata value. It can also be read by the plugin (depending on what is appropriate)
 
+//PostgreSQL's types (see the server's catalog/pg_type.h), needed to decode the binary results
+static const Oid pg_int8 = 20, pg_int2 = 21, pg_int4 = 23, pg_text = 25, pg_float4 = 700, pg_float8 = 701;
+static const Oid pg_bpchar = 1042, pg_varchar = 1043, pg_date = 1082, pg_timestamp = 1114, pg_timestamptz = 1184, pg_numeric = 1700;
+static const double pg_epoch = 2451544.5; //the binary dates are relative to 2000-01-01T00:00
+
+//the binary values are in network byte order (big endian)
+static unsigned int read_uint16(const char* ptr)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(ptr);
+	return (static_cast<unsigned int>(bytes[0]) << 8) | bytes[1];
+}
+
+static unsigned int read_uint32(const char* ptr)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(ptr);
+	return (static_cast<unsigned int>(bytes[0]) << 24) | (static_cast<unsigned int>(bytes[1]) << 16) | (static_cast<unsigned int>(bytes[2]) << 8) | bytes[3];
+}
+
+static int read_int16(const char* ptr)
+{
+	const unsigned int value = read_uint16(ptr);
+	return (value>=32768)? static_cast<int>(value) - 65536 : static_cast<int>(value);
+}
+
+static double read_int32(const char* ptr)
+{
+	const unsigned int value = read_uint32(ptr);
+	return (value>=2147483648U)? static_cast<double>(value) - 4294967296. : static_cast<double>(value);
+}
+
+//a 64 bits integer, exact up to 2^53
+static double read_int64(const char* ptr)
+{
+	return read_int32(ptr)*4294967296. + static_cast<double>(read_uint32(ptr+4));
+}
+
+//IEEE floating point number of the given size (4 or 8 bytes)
+template <class T> static T read_float(const char* ptr)
+{
+	static const unsigned int one = 1;
+	const bool little_endian = (*reinterpret_cast<const unsigned char*>(&one) == 1);
+	char bytes[sizeof(T)];
+	for (size_t ii=0; ii<sizeof(T); ii++)
+		bytes[ii] = (little_endian)? ptr[sizeof(T)-1-ii] : ptr[ii];
+	T value;
+	memcpy(&value, bytes, sizeof(T));
+	return value;
+}
+
+//numeric: number of base 10000 digits, weight of the first digit, sign, display scale and the digits
+static double read_numeric(const char* ptr)
+{
+	const int ndigits = read_int16(ptr);
+	const int weight = read_int16(ptr+2);
+	const unsigned int sign = read_uint16(ptr+4);
+	if (sign==0xC000) return IOUtils::nodata; //NaN
+
+	//the digits are accumulated as an integer, so the final scaling is done by a single (correctly rounded) operation
+	double mantissa = 0.;
+	for (int ii=0; ii<ndigits; ii++)
+		mantissa = mantissa*10000. + read_int16(ptr+8+2*ii);
+	const int exponent = 4*(weight-ndigits+1);
+	const double value = (exponent>=0)? mantissa*pow(10., exponent) : mantissa/pow(10., -exponent);
+	return (sign==0x4000)? -value : value;
+}
+
 PSQLIO::PSQLIO(const std::string& configfile) : coordin(), coordinparam(), coordout(), coordoutparam(), endpoint(), port(),
-                                                dbname(), userid(), passwd(), psql(NULL), default_timezone(1.), vecMeta(),
+                                                dbname(), userid(), passwd(), psql(NULL), integer_datetimes(true), prefetch(false),
+                                                prefetch_pending(false), prefetch_start(), prefetch_end(), prefetch_stations(), default_timezone(1.), vecMeta(),
                                                 vecFixedStationID(), vecMobileStationID(), sql_meta(), sql_data(), shadowed_parameters()
 {
 	Config cfg(configfile);
@@ -100,7 +178,8 @@ PSQLIO::PSQLIO(const std::string& configfile) : coordin(), coordinparam(), coord
 }
 
 PSQLIO::PSQLIO(const Config& cfg) : coordin(), coordinparam(), coordout(), coordoutparam(), endpoint(), port(),
-                                          dbname(), userid(), passwd(), psql(NULL), default_timezone(1.), vecMeta(),
+                                          dbname(), userid(), passwd(), psql(NULL), integer_datetimes(true), prefetch(false),
+                                          prefetch_pending(false), prefetch_start(), prefetch_end(), prefetch_stations(), default_timezone(1.), vecMeta(),
                                           vecFixedStationID(), vecMobileStationID(), sql_meta(), sql_data(), shadowed_parameters()
 {
 	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
@@ -109,7 +188,8 @@ PSQLIO::PSQLIO(const Config& cfg) : coordin(), coordinparam(), coordout(), coord
 
 PSQLIO::PSQLIO(const PSQLIO& in) : coordin(in.coordin), coordinparam(in.coordinparam), coordout(in.coordout),
                                    coordoutparam(in.coordoutparam), endpoint(in.endpoint), port(in.port), dbname(in.dbname), userid(in.userid),
-                                   passwd(in.passwd), psql(NULL), default_timezone(1.), vecMeta(in.vecMeta),
+                                   passwd(in.passwd), psql(NULL), integer_datetimes(true), prefetch(in.prefetch),
+                                   prefetch_pending(false), prefetch_start(), prefetch_end(), prefetch_stations(), default_timezone(1.), vecMeta(in.vecMeta),
                                    vecFixedStationID(in.vecFixedStationID), vecMobileStationID(in.vecMobileStationID),
                                    sql_meta(in.sql_meta), sql_data(in.sql_data), shadowed_parameters(in.shadowed_parameters) {}
 
@@ -127,6 +207,12 @@ PSQLIO& PSQLIO::operator=(const PSQLIO& in)
 	 swap(userid, tmp.userid);
 	 swap(passwd, tmp.passwd);
 	 swap(psql, tmp.psql);
+	 swap(integer_datetimes, tmp.integer_datetimes);
+	 swap(prefetch, tmp.prefetch);
+	 swap(prefetch_pending, tmp.prefetch_pending);
+	 swap(prefetch_start, tmp.prefetch_start);
+	 swap(prefetch_end, tmp.prefetch_end);
+	 swap(prefetch_stations, tmp.prefetch_stations);
 	 swap(default_timezone, tmp.default_timezone);
 	 swap(vecMeta, tmp.vecMeta);
 	 swap(vecFixedStationID, tmp.vecFixedStationID);
@@ -138,7 +224,10 @@ PSQLIO& PSQLIO::operator=(const PSQLIO& in)
       return *this;
 }
 
-PSQLIO::~PSQLIO() throw() {}
+PSQLIO::~PSQLIO() throw()
+{
+	close_connection();
+}
 
 void PSQLIO::getParameters(const Config& cfg)
 {
@@ -164,6 +253,7 @@ void PSQLIO::getParameters(const Config& cfg)
 	cfg.getValue("SQL_DATA", "Input", sql_data);
 
 	cfg.getValue("TIME_ZONE", "Input", default_timezone, IOUtils::nothrow);
+	cfg.getValue("PSQL_PREFETCH", "Input", prefetch, IOUtils::nothrow);
 }
 
 void PSQLIO::create_shadow_map(const std::string& exclude_file)
@@ -263,6 +353,7 @@ void PSQLIO::readStationData(const Date&, std::vector<StationData>& vecStation)
 		int col_epsg = PQfnumber(result, "epsg");
 
 		if ((col_id * col_name * col_x * col_y * col_alt * col_epsg) < 0) { //missing column
+			PQclear(result);
 			throw IOException("Result set does not have all necessary columns", AT);
 		}
 
@@ -305,24 +396,41 @@ void PSQLIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
 	if (vecMeta.empty()) readStationData(dateStart, vecMeta);
 	if (vecMeta.empty()) return; //if there are no stations -> return
 
-	size_t indexStart=0, indexEnd=vecMeta.size();
-
 	//The following part decides whether all the stations are rebuffered or just one station
+	vector<size_t> stations;
 	if (stationindex == IOUtils::npos){
 		vecMeteo.clear();
 		vecMeteo.insert(vecMeteo.begin(), vecMeta.size(), vector<MeteoData>());
+		for (size_t ii=0; ii<vecMeta.size(); ii++) stations.push_back(ii);
 	} else {
 		if (stationindex < vecMeteo.size()){
-			indexStart = stationindex;
-			indexEnd   = stationindex+1;
+			vecMeteo[stationindex].clear();
+			stations.push_back(stationindex);
 		} else {
 			throw IndexOutOfBoundsException("You tried to access a stationindex in readMeteoData that is out of bounds", AT);
 		}
 	}
 
-	for (size_t ii=indexStart; ii<indexEnd; ii++){ //loop through stations
-		readData(dateStart, dateEnd, vecMeteo[ii], ii);
+	//all the stations are retrieved with one query, that might already have been sent as prefetch
+	PGresult *result = NULL;
+	if (prefetch_pending && prefetch_stations==stations && prefetch_start<=dateStart && dateEnd<=prefetch_end)
+		result = get_prefetched();
+	if (!result)
+		result = get_data(batch_query(dateStart, dateEnd, stations), true);
+
+	if (result) {
+		try {
+			parse_result(result, dateStart, dateEnd, vecMeteo);
+		} catch (...) {
+			PQclear(result);
+			throw;
+		}
+		PQclear(result);
 	}
+
+	//the next buffer usually overlaps the current one (buffer centering), so the prefetched window starts with the current one
+	if (prefetch && stationindex == IOUtils::npos)
+		send_prefetch(dateStart, dateEnd + (dateEnd - dateStart), stations);
 }
 
 bool PSQLIO::replace(std::string& str, const std::string& from, const std::string& to)
@@ -334,67 +442,136 @@ bool PSQLIO::replace(std::string& str, const std::string& from, const std::strin
     return true;
 }
 
-void PSQLIO::readData(const Date& dateStart, const Date& dateEnd, std::vector<MeteoData>& vecMeteo, const size_t& stationindex)
+//combine the data queries of the given stations into one query, the station index being returned as first column
+std::string PSQLIO::batch_query(const Date& dateStart, const Date& dateEnd, const std::vector<size_t>& stations) const
 {
-	string sql_query(sql_data);
-
-	string id = vecFixedStationID.at(stationindex);
 	string date_start = dateStart.toString(Date::ISO);
 	string date_end = dateEnd.toString(Date::ISO);
 	std::replace(date_start.begin(), date_start.end(), 'T', ' ');
 	std::replace(date_end.begin(), date_end.end(), 'T', ' ');
 
-	replace(sql_query, "STATIONID", vecMeta.at(stationindex).stationID);
-	replace(sql_query, "DATE_START", date_start);
-	replace(sql_query, "DATE_END", date_end);
+	string data_query(sql_data);
+	const size_t last = data_query.find_last_not_of(" \t\r\n;");
+	data_query.erase((last==string::npos)? 0 : last+1); //it will be used as a sub-query
 
-	PGresult *result = get_data(sql_query);
-	if (result) {
-		int rows = PQntuples(result);
-		int columns = PQnfields(result);
-
-		vector<size_t> index;
-		MeteoData tmpmeteo;
-		tmpmeteo.meta = vecMeta.at(stationindex);
+	ostringstream ss;
+	ss << "SELECT * FROM (";
+	for (size_t ii=0; ii<stations.size(); ii++) {
+		string sql_query(data_query);
+		replace(sql_query, "STATIONID", vecMeta.at(stations[ii]).stationID);
+		replace(sql_query, "DATE_START", date_start);
+		replace(sql_query, "DATE_END", date_end);
 
-		map_parameters(result, tmpmeteo, index);
+		if (ii>0) ss << " UNION ALL ";
+		ss << "SELECT " << stations[ii] << " AS mio_station, q.* FROM (" << sql_query << ") AS q";
+	}
+	ss << ") AS mio_batch ORDER BY mio_station, date";
+	return ss.str();
+}
 
-		for (int ii=0; ii<rows; ii++) {
-			parse_row(result, ii, columns, tmpmeteo, index, vecMeteo);
+void PSQLIO::parse_result(PGresult* result, const Date& dateStart, const Date& dateEnd, std::vector< std::vector<MeteoData> >& vecMeteo) const
+{
+	const int rows = PQntuples(result);
+	const int columns = PQnfields(result);
+	const int col_date = PQfnumber(result, "date");
+	if (col_date < 0) throw IOException("Result set does not have a date column", AT);
+
+	vector<Oid> types(columns);
+	for (int ii=0; ii<columns; ii++) types[ii] = PQftype(result, ii);
+
+	//the dates are compared as they have been written in the query (the prefetched data covers a larger period)
+	const Date start(dateStart.getJulian(false), 0.), end(dateEnd.getJulian(false), 0.);
+
+	size_t station = IOUtils::npos;
+	vector<size_t> index;
+	MeteoData tmpmeteo;
+	for (int ii=0; ii<rows; ii++) {
+		const double row_station = get_double(result, ii, 0, types[0]);
+		if (row_station<0. || row_station>=static_cast<double>(vecMeteo.size()))
+			throw IndexOutOfBoundsException("Invalid station index in the result set", AT);
+		if (static_cast<size_t>(row_station) != station) { //the rows are sorted by station
+			station = static_cast<size_t>(row_station);
+			tmpmeteo = MeteoData();
+			tmpmeteo.meta = vecMeta.at(station);
+			index.clear();
+			map_parameters(result, col_date, tmpmeteo, index);
 		}
 
-		PQclear(result);
+		Date date;
+		get_date(result, ii, col_date, types[col_date], date);
+		if (date<start || date>end) continue;
+
+		MeteoData md(tmpmeteo);
+		md.date = date;
+		parse_row(result, ii, types, index, md);
+		vecMeteo[station].push_back(md);
 	}
 }
 
-void PSQLIO::parse_row(PGresult* result, const int& row, const int& cols, MeteoData& md, std::vector<size_t>& index, std::vector<mio::MeteoData>& vecMeteo)
+void PSQLIO::parse_row(PGresult* result, const int& row, const std::vector<Oid>& types, const std::vector<size_t>& index, MeteoData& md) const
 {
-	MeteoData tmp(md);
-	IOUtils::convertString(md.date, PQgetvalue(result, row, 0), 0.0);
+	const int cols = static_cast<int>( index.size() );
+	for (int ii=0; ii<cols; ii++) {
+		if (index[ii] != IOUtils::npos && !PQgetisnull(result, row, ii))
+			md(index[ii]) = get_double(result, row, ii, types[ii]);
+	}
 
-	for (int ii=1; ii<cols; ii++) {
-		if (index[ii] != IOUtils::npos) {
-			string val( PQgetvalue(result, row, ii) );
-			if (!val.empty()) IOUtils::convertString(tmp(index[ii]), val);
-		}
+	convertUnits(md);
+}
+
+double PSQLIO::get_double(PGresult* result, const int& row, const int& col, const Oid& type) const
+{
+	const char* value = PQgetvalue(result, row, col);
+
+	if (type == pg_float8) return read_float<double>(value);
+	if (type == pg_float4) return read_float<float>(value);
+	if (type == pg_int4) return read_int32(value);
+	if (type == pg_int2) return read_int16(value);
+	if (type == pg_int8) return read_int64(value);
+	if (type == pg_numeric) return read_numeric(value);
+	if (type == pg_text || type == pg_varchar || type == pg_bpchar) { //the binary format of a text is the text itself
+		const string str(value, PQgetlength(result, row, col));
+		double tmp = IOUtils::nodata;
+		if (!str.empty()) IOUtils::convertString(tmp, str);
+		return tmp;
 	}
 
-	convertUnits(tmp);
-	vecMeteo.push_back(tmp);
+	ostringstream ss;
+	ss << "Unsupported type (oid " << type << ") for column \"" << PQfname(result, col) << "\"";
+	throw IOException(ss.str(), AT);
 }
 
-void PSQLIO::map_parameters(PGresult* result, MeteoData& md, std::vector<size_t>& index)
+void PSQLIO::get_date(PGresult* result, const int& row, const int& col, const Oid& type, Date& date) const
+{
+	const char* value = PQgetvalue(result, row, col);
+
+	if (type == pg_timestamp || type == pg_timestamptz) { //microseconds (or seconds) since 2000-01-01
+		const double seconds = (integer_datetimes)? read_int64(value) * 1e-6 : read_float<double>(value);
+		date.setDate(pg_epoch + seconds/(24.*3600.), 0.);
+	} else if (type == pg_date) { //days since 2000-01-01
+		date.setDate(pg_epoch + read_int32(value), 0.);
+	} else if (type == pg_text || type == pg_varchar || type == pg_bpchar) {
+		IOUtils::convertString(date, string(value, PQgetlength(result, row, col)), 0.0);
+	} else {
+		ostringstream ss;
+		ss << "Unsupported type (oid " << type << ") for the date column \"" << PQfname(result, col) << "\"";
+		throw IOException(ss.str(), AT);
+	}
+}
+
+void PSQLIO::map_parameters(PGresult* result, const int& col_date, MeteoData& md, std::vector<size_t>& index) const
 {
 	const int columns = PQnfields(result);
 
 	set<string> shadowed;
-	map< string, set<string> >::iterator it = shadowed_parameters.find(md.meta.stationID);
+	map< string, set<string> >::const_iterator it = shadowed_parameters.find(md.meta.stationID);
 	if (it != shadowed_parameters.end()) shadowed = it->second;
 
-	for (int ii=0; ii<columns; ii++) {
+	index.push_back(IOUtils::npos); //the station index, added by batch_query()
+	for (int ii=1; ii<columns; ii++) {
 		const string field_name( IOUtils::strToUpper(PQfname(result, ii)) );
 		const bool is_in = shadowed.find(field_name) != shadowed.end();
-		if (is_in) { // Certain parameters may be shadowed
+		if (is_in || ii == col_date) { // Certain parameters may be shadowed
 			index.push_back(IOUtils::npos);
 			continue;
 		}
@@ -519,6 +696,14 @@ void PSQLIO::convertUnits(MeteoData& meteo)
 
 void PSQLIO::open_connection()
 {
+	if (psql) {
+		if (PQstatus(psql) == CONNECTION_OK) return; //the connection is kept open between the requests
+
+		PQreset(psql); //the connection has been lost, try to reestablish it
+		if (PQstatus(psql) == CONNECTION_OK) return;
+		close_connection();
+	}
+
 	const string connect = "hostaddr = '" + endpoint +
 		"' port = '" + port +
 		"' dbname = '" + dbname +
@@ -532,39 +717,68 @@ void PSQLIO::open_connection()
 		throw IOException("PSQLIO connection error: PQconnectdb returned NULL", AT);
 	}
 	if (PQstatus(psql) != CONNECTION_OK) {
-		cerr << "ERROR" << PQstatus(psql) << endl;
-		throw IOException("PSQLIO connection error: PQstatus(psql) != CONNECTION_OK", AT);
+		const string msg( PQerrorMessage(psql) );
+		close_connection();
+		throw IOException("PSQLIO connection error: " + msg, AT);
 	}
+
+	const char* datetimes = PQparameterStatus(psql, "integer_datetimes");
+	integer_datetimes = (datetimes==NULL || string(datetimes)=="on");
 }
 
-PGresult *PSQLIO::get_data(const string& sql_command)
+PGresult *PSQLIO::get_data(const string& sql_command, const bool& binary)
 {
 	open_connection();
+	discard_prefetch(); //only one query can run at a time on a connection
 
-	PGresult *result = PQexec(psql, sql_command.c_str());
-	ExecStatusType status = PQresultStatus(result);
-	if (status == PGRES_TUPLES_OK) { //Successful completion of a SELECT data request
-		// cout << "Select executed normally... " << endl;
-
-		// PQprintOpt        options = {0};
-		// options.header    = 1;    /* Ask for column headers            */
-		// options.align     = 1;    /* Pad short columns for alignment   */
-		// options.fieldSep  = "|";  /* Use a pipe as the field separator */
-		// PQprint(stdout, result, &options);
-
-	} else {
-		//cout << "BAD SELECT: " << PQresStatus(status) << endl;
+	PGresult *result = (binary)? PQexecParams(psql, sql_command.c_str(), 0, NULL, NULL, NULL, NULL, 1) : PQexec(psql, sql_command.c_str());
+	if (PQresultStatus(result) != PGRES_TUPLES_OK) { //Successful completion of a SELECT data request
 		PQclear(result);
+		if (PQstatus(psql) != CONNECTION_OK) close_connection();
 		return NULL;
 	}
 
-	close_connection(psql);
 	return result;
 }
 
-void PSQLIO::close_connection(PGconn *conn)
+//send the query for the given window without waiting for its result
+void PSQLIO::send_prefetch(const Date& dateStart, const Date& dateEnd, const std::vector<size_t>& stations)
+{
+	open_connection();
+	discard_prefetch();
+
+	if (PQsendQueryParams(psql, batch_query(dateStart, dateEnd, stations).c_str(), 0, NULL, NULL, NULL, NULL, 1) == 1) {
+		prefetch_pending = true;
+		prefetch_start = dateStart;
+		prefetch_end = dateEnd;
+		prefetch_stations = stations;
+	}
+}
+
+//wait for the result of the prefetch query, NULL if it failed
+PGresult* PSQLIO::get_prefetched()
+{
+	PGresult *result = NULL;
+	PGresult *tmp;
+	while ((tmp = PQgetResult(psql)) != NULL) { //NULL is returned once the query is over
+		if (result==NULL && PQresultStatus(tmp) == PGRES_TUPLES_OK) result = tmp;
+		else PQclear(tmp);
+	}
+	prefetch_pending = false;
+	return result;
+}
+
+void PSQLIO::discard_prefetch()
+{
+	if (!prefetch_pending) return;
+	PQclear( get_prefetched() );
+}
+
+void PSQLIO::close_connection()
 {
-    PQfinish(conn);
+	if (psql) PQfinish(psql);
+	psql = NULL;
+	prefetch_pending = false;
 }
 
 } //namespace
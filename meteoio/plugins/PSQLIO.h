@@ -20,9 +20,11 @@
 
 #include <meteoio/IOInterface.h>
 #include <meteoio/Config.h>
+#include <meteoio/Date.h>
 
 #include <libpq-fe.h>
 #include <string>
+#include <vector>
 #include <map>
 
 namespace mio {
@@ -66,19 +68,28 @@ class PSQLIO : public IOInterface {
 		void getParameters(const Config& cfg);
 		void create_shadow_map(const std::string& exclude_file);
 		void open_connection();
-		PGresult* get_data(const std::string& sqlcommand);
+		PGresult* get_data(const std::string& sqlcommand, const bool& binary=false);
 		static bool replace(std::string& str, const std::string& from, const std::string& to);
-		void readData(const Date& dateStart, const Date& dateEnd, std::vector<MeteoData>& vecMeteo, const size_t& stationindex);
-		void map_parameters(PGresult* result, MeteoData& md, std::vector<size_t>& index);
-		static void parse_row(PGresult* result, const int& row, const int& cols,
-		                      MeteoData& md, std::vector<size_t>& index, std::vector<mio::MeteoData>& vecMeteo);
-		void close_connection(PGconn *conn);
+		std::string batch_query(const Date& dateStart, const Date& dateEnd, const std::vector<size_t>& stations) const;
+		void send_prefetch(const Date& dateStart, const Date& dateEnd, const std::vector<size_t>& stations);
+		PGresult* get_prefetched();
+		void discard_prefetch();
+		void parse_result(PGresult* result, const Date& dateStart, const Date& dateEnd, std::vector< std::vector<MeteoData> >& vecMeteo) const;
+		void map_parameters(PGresult* result, const int& col_date, MeteoData& md, std::vector<size_t>& index) const;
+		void parse_row(PGresult* result, const int& row, const std::vector<Oid>& types, const std::vector<size_t>& index, MeteoData& md) const;
+		double get_double(PGresult* result, const int& row, const int& col, const Oid& type) const;
+		void get_date(PGresult* result, const int& row, const int& col, const Oid& type, Date& date) const;
+		void close_connection();
 		static bool checkConsistency(const std::vector<MeteoData>& vecMeteo, StationData& sd);
 		static void convertUnits(MeteoData& meteo);
 
 		std::string coordin, coordinparam, coordout, coordoutparam; //projection parameters
 		std::string endpoint, port, dbname, userid, passwd; ///< Variables for endpoint configuration
-		PGconn *psql; ///<holds the current connection
+		PGconn *psql; ///<holds the current connection, kept open as long as the plugin lives
+		bool integer_datetimes; ///< are the server's timestamps stored as integers (binary format)?
+		bool prefetch, prefetch_pending; ///< prefetch the next buffer window? is such a query running?
+		Date prefetch_start, prefetch_end; ///< window of the running prefetch query
+		std::vector<size_t> prefetch_stations; ///< stations of the running prefetch query
 		double default_timezone;
 		std::vector<StationData> vecMeta;
 		std::vector<std::string> vecFixedStationID, vecMobileStationID;
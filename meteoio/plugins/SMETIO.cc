@@ -18,6 +18,8 @@
 #include "SMETIO.h"
 #include <meteoio/IOUtils.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace mio {
@@ -39,6 +41,12 @@ namespace mio {
  * - METEOPARAM: output file format options (ASCII or BINARY that might be followed by GZIP)
  * - POIFILE: a path+file name to the a file containing grid coordinates of Points Of Interest (for special outputs)
  *
+ * The files are overwritten when writing, but the plugin can also append data to the files it has already written,
+ * which is what makes it possible to write long time series block by block (see IOManager::streamMeteoData). The
+ * appended data must follow the data that has already been written and keep the station position (if it is written in
+ * the header). When a parameter only gets some data in a later block, the file is rewritten once with the new column
+ * (filled with nodata for the previous blocks).
+ *
  * Example:
  * @code
  * [Input]
@@ -72,7 +80,7 @@ const std::string SMETIO::dflt_extension = ".smet";
 SMETIO::SMETIO(const std::string& configfile)
         : cfg(configfile),
           coordin(), coordinparam(), coordout(), coordoutparam(),
-          vec_smet_reader(), vecFiles(), outpath(), in_dflt_TZ(0.), out_dflt_TZ(0.),
+          vec_smet_reader(), vecFiles(), written_files(), outpath(), in_dflt_TZ(0.), out_dflt_TZ(0.),
           plugin_nodata(IOUtils::nodata), nr_stations(0), outputIsAscii(true), outputIsGzipped(false)
 {
 	parseInputOutputSection();
@@ -81,7 +89,7 @@ SMETIO::SMETIO(const std::string& configfile)
 SMETIO::SMETIO(const Config& cfgreader)
         : cfg(cfgreader),
           coordin(), coordinparam(), coordout(), coordoutparam(),
-          vec_smet_reader(), vecFiles(), outpath(), in_dflt_TZ(0.), out_dflt_TZ(0.),
+          vec_smet_reader(), vecFiles(), written_files(), outpath(), in_dflt_TZ(0.), out_dflt_TZ(0.),
           plugin_nodata(IOUtils::nodata), nr_stations(0), outputIsAscii(true), outputIsGzipped(false)
 {
 	parseInputOutputSection();
@@ -436,84 +444,221 @@ void SMETIO::readMeteoData(const Date& dateStart, const Date& dateEnd,
 void SMETIO::writeMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo, const std::string&)
 {
 	//Loop through all stations
-	for (size_t ii=0; ii<vecMeteo.size(); ii++){
-		//1. check consistency of station data position -> write location in header or data section
-		StationData sd;
-		sd.position.setProj(coordout, coordoutparam);
-		const bool isConsistent = checkConsistency(vecMeteo.at(ii), sd);
+	for (size_t ii=0; ii<vecMeteo.size(); ii++)
+		writeStation(vecMeteo[ii], ii, false);
+}
+
+void SMETIO::appendMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo, const std::string&)
+{
+	//Loop through all stations
+	for (size_t ii=0; ii<vecMeteo.size(); ii++)
+		writeStation(vecMeteo[ii], ii, true);
+}
 
-		if (sd.stationID.empty()){
-			ostringstream ss;
-			ss << "Station" << ii+1;
-			sd.stationID = ss.str();
+void SMETIO::writeStation(const std::vector<MeteoData>& vecMeteo, const size_t& station_nr, const bool& append_data)
+{
+	//1. check consistency of station data position -> write location in header or data section
+	StationData sd;
+	sd.position.setProj(coordout, coordoutparam);
+	const bool isConsistent = checkConsistency(vecMeteo, sd);
+
+	if (sd.stationID.empty()){
+		ostringstream ss;
+		ss << "Station" << station_nr+1;
+		sd.stationID = ss.str();
+	}
+
+	const string filename = outpath + "/" + sd.stationID + ".smet";
+	if (!IOUtils::validFileName(filename)) //Check whether filename is valid
+		throw InvalidFileNameException(filename, AT);
+
+	//2. check which meteo parameter fields are actually in use
+	const size_t nr_of_parameters = getNrOfParameters(sd.stationID, vecMeteo);
+	vector<bool> vecParamInUse = vector<bool>(nr_of_parameters, false);
+	vector<string> vecColumnName = vector<string>(nr_of_parameters, "NULL");
+	double timezone = IOUtils::nodata; //time zone of the data
+	checkForUsedParameters(vecMeteo, nr_of_parameters, timezone, vecParamInUse, vecColumnName);
+	if(out_dflt_TZ != IOUtils::nodata) timezone=out_dflt_TZ; //if the user set an output time zone, all will be converted to it
+
+	//3. when appending, the file keeps the header that has been written with the previous data
+	const std::map<std::string, smet_output>::const_iterator previous = written_files.find(filename);
+	const bool append = append_data && (previous!=written_files.end());
+	if (append && vecMeteo.empty()) return; //nothing to add
+
+	smet_output output;
+	if (append) {
+		checkAppend(vecMeteo, previous->second, sd, isConsistent);
+		output = previous->second;
+		if (mergeColumns(vecParamInUse, vecColumnName, output.columns)) //some parameters only have data from now on
+			rewriteColumns(filename, sd, previous->second, output.columns);
+	} else {
+		output.position = sd.position;
+		output.timezone = timezone;
+		output.isConsistent = isConsistent;
+		for (size_t kk=0; kk<nr_of_parameters; kk++) {
+			if (vecParamInUse[kk]) output.columns.push_back(vecColumnName[kk]);
+		}
+	}
+	if (!vecMeteo.empty()) output.end_date = vecMeteo.back().date;
+
+	//the extra parameters are not always in the same order, so the columns are matched by name
+	vector<size_t> vecIndex(output.columns.size(), IOUtils::npos);
+	if (!vecMeteo.empty()) {
+		for (size_t ll=0; ll<output.columns.size(); ll++) {
+			const size_t index = vecMeteo.front().getParameterIndex(output.columns[ll]);
+			if (index < nr_of_parameters) vecIndex[ll] = index;
 		}
+	}
 
-		const string filename = outpath + "/" + sd.stationID + ".smet";
-		if (!IOUtils::validFileName(filename)) //Check whether filename is valid
-			throw InvalidFileNameException(filename, AT);
-
-		//2. check which meteo parameter fields are actually in use
-		const size_t nr_of_parameters = getNrOfParameters(sd.stationID, vecMeteo[ii]);
-		vector<bool> vecParamInUse = vector<bool>(nr_of_parameters, false);
-		vector<string> vecColumnName = vector<string>(nr_of_parameters, "NULL");
-		double timezone = IOUtils::nodata; //time zone of the data
-		checkForUsedParameters(vecMeteo[ii], nr_of_parameters, timezone, vecParamInUse, vecColumnName);
-		if(out_dflt_TZ != IOUtils::nodata) timezone=out_dflt_TZ; //if the user set an output time zone, all will be converted to it
-
-		try {
-			const smet::SMETType type = (outputIsAscii)? smet::ASCII : smet::BINARY;
-
-			smet::SMETWriter mywriter(filename, type, outputIsGzipped);
-			generateHeaderInfo(sd, outputIsAscii, isConsistent, timezone,
-                               nr_of_parameters, vecParamInUse, vecColumnName, mywriter);
-
-			vector<string> vec_timestamp;
-			vector<double> vec_data;
-			for (size_t jj=0; jj<vecMeteo[ii].size(); jj++) {
-				if (outputIsAscii){
-					if (out_dflt_TZ != IOUtils::nodata) { //user-specified time zone
-						Date tmp_date(vecMeteo[ii][jj].date);
-						tmp_date.setTimeZone(out_dflt_TZ);
-						vec_timestamp.push_back(tmp_date.toString(Date::ISO));
-					} else {
-						vec_timestamp.push_back(vecMeteo[ii][jj].date.toString(Date::ISO));
-					}
+	try {
+		const smet::SMETType type = (outputIsAscii)? smet::ASCII : smet::BINARY;
+
+		smet::SMETWriter mywriter(filename, type, outputIsGzipped, append);
+		generateHeaderInfo(sd, outputIsAscii, output.isConsistent, output.timezone, output.columns, mywriter);
+
+		vector<string> vec_timestamp;
+		vector<double> vec_data;
+		char date_str[Date::max_str_len];
+		if (outputIsAscii) vec_timestamp.reserve(vecMeteo.size());
+		for (size_t jj=0; jj<vecMeteo.size(); jj++) {
+			if (outputIsAscii){
+				if (out_dflt_TZ != IOUtils::nodata) { //user-specified time zone
+					Date tmp_date(vecMeteo[jj].date);
+					tmp_date.setTimeZone(out_dflt_TZ);
+					tmp_date.toString(Date::ISO, date_str, Date::max_str_len);
 				} else {
-					double julian;
-					if(out_dflt_TZ!=IOUtils::nodata) {
-						Date tmp_date(vecMeteo[ii][jj].date);
-						tmp_date.setTimeZone(out_dflt_TZ);
-						julian = tmp_date.getJulian();
-					} else {
-						julian = vecMeteo[ii][jj].date.getJulian();
-					}
-					vec_data.push_back(julian);
+					vecMeteo[jj].date.toString(Date::ISO, date_str, Date::max_str_len);
 				}
-
-				if (!isConsistent) { //Meta data changes
-					vec_data.push_back(vecMeteo[ii][jj].meta.position.getLat());
-					vec_data.push_back(vecMeteo[ii][jj].meta.position.getLon());
-					vec_data.push_back(vecMeteo[ii][jj].meta.position.getAltitude());
+				vec_timestamp.push_back(date_str);
+			} else {
+				double julian;
+				if(out_dflt_TZ!=IOUtils::nodata) {
+					Date tmp_date(vecMeteo[jj].date);
+					tmp_date.setTimeZone(out_dflt_TZ);
+					julian = tmp_date.getJulian();
+				} else {
+					julian = vecMeteo[jj].date.getJulian();
 				}
+				vec_data.push_back(julian);
+			}
 
-				for (size_t kk=0; kk<nr_of_parameters; kk++) {
-					if (vecParamInUse[kk])
-						vec_data.push_back(vecMeteo[ii][jj](kk)); //add data value
-				}
+			if (!output.isConsistent) { //Meta data changes
+				vec_data.push_back(vecMeteo[jj].meta.position.getLat());
+				vec_data.push_back(vecMeteo[jj].meta.position.getLon());
+				vec_data.push_back(vecMeteo[jj].meta.position.getAltitude());
 			}
 
-			if (outputIsAscii) mywriter.write(vec_timestamp, vec_data);
-			else mywriter.write(vec_data);
+			for (size_t ll=0; ll<vecIndex.size(); ll++) {
+				const size_t kk = vecIndex[ll];
+				vec_data.push_back( (kk!=IOUtils::npos)? vecMeteo[jj](kk) : IOUtils::nodata ); //add data value
+			}
+		}
+
+		if (outputIsAscii) mywriter.write(vec_timestamp, vec_data);
+		else mywriter.write(vec_data);
+
+	} catch(exception&) {
+		throw;
+	}
 
-		} catch(exception&) {
-			throw;
+	written_files[filename] = output;
+}
+
+void SMETIO::checkAppend(const std::vector<MeteoData>& vecMeteo, const smet_output& previous,
+                         const StationData& sd, const bool& isConsistent)
+{
+	/**
+	 * The data is appended after the data that is already in the file and the header is kept.
+	 * The new data must therefore come after the previous data and the station position
+	 * must not change (if it is written in the header).
+	 */
+	const std::string& stationID = sd.stationID;
+	if (!vecMeteo.empty() && vecMeteo.front().date <= previous.end_date)
+		throw IOException("The data appended to the output of station "+stationID+" must start after "+previous.end_date.toString(Date::ISO), AT);
+	if (previous.isConsistent && (!isConsistent || (!sd.position.isNodata() && sd.position!=previous.position)))
+		throw IOException("The position of station "+stationID+" changed when appending data to its output", AT);
+}
+
+bool SMETIO::mergeColumns(const std::vector<bool>& vecParamInUse, const std::vector<std::string>& vecColumnName,
+                          std::vector<std::string>& columns)
+{
+	/**
+	 * The parameters in use are added to the columns that are already written in the file. As when the
+	 * columns are first chosen, the standard parameters come in their usual order, followed by the extra
+	 * parameters. Returns true if some columns have been added.
+	 */
+	std::vector<std::string> merged;
+	bool added = false;
+	for (size_t kk=0; kk<MeteoData::nrOfParameters; kk++) {
+		const std::string& param = MeteoData::getParameterName(kk);
+		const bool in_file = (std::find(columns.begin(), columns.end(), param) != columns.end());
+		const bool in_use = (kk<vecParamInUse.size() && vecParamInUse[kk]);
+		if (in_file || in_use) merged.push_back(param);
+		if (in_use && !in_file) added = true;
+	}
+
+	for (size_t ll=0; ll<columns.size(); ll++) { //extra parameters that are already in the file
+		if (std::find(merged.begin(), merged.end(), columns[ll]) == merged.end())
+			merged.push_back(columns[ll]);
+	}
+	for (size_t kk=MeteoData::nrOfParameters; kk<vecParamInUse.size(); kk++) {
+		if (vecParamInUse[kk] && std::find(merged.begin(), merged.end(), vecColumnName[kk]) == merged.end()) {
+			merged.push_back(vecColumnName[kk]);
+			added = true;
 		}
 	}
+
+	if (added) columns.swap(merged);
+	return added;
+}
+
+void SMETIO::rewriteColumns(const std::string& filename, const StationData& sd, const smet_output& previous,
+                            const std::vector<std::string>& columns)
+{
+	/**
+	 * The file is read back and written again with the new columns, that are filled with nodata.
+	 * This is only done when a parameter gets its first data after some blocks have already been written.
+	 */
+	vector<string> vec_timestamp;
+	vector<double> vec_data;
+	smet::SMETReader myreader(filename);
+	if (outputIsAscii) myreader.read(vec_timestamp, vec_data);
+	else myreader.read(vec_data);
+
+	//the julian date (in binary files) and the position columns come before the parameters
+	const size_t nr_leading = ((outputIsAscii)? 0 : 1) + ((previous.isConsistent)? 0 : 3);
+	const size_t old_width = nr_leading + previous.columns.size();
+	const size_t new_width = nr_leading + columns.size();
+	const size_t nr_lines = (outputIsAscii)? vec_timestamp.size() : vec_data.size()/old_width;
+
+	vector<size_t> old_pos(columns.size(), IOUtils::npos);
+	for (size_t ll=0; ll<columns.size(); ll++) {
+		const vector<string>::const_iterator it = std::find(previous.columns.begin(), previous.columns.end(), columns[ll]);
+		if (it != previous.columns.end()) old_pos[ll] = nr_leading + static_cast<size_t>(it - previous.columns.begin());
+	}
+
+	vector<double> new_data;
+	new_data.reserve(nr_lines*new_width);
+	for (size_t jj=0; jj<nr_lines; jj++) {
+		const size_t line = jj*old_width;
+		for (size_t ll=0; ll<nr_leading; ll++)
+			new_data.push_back( vec_data[line+ll] );
+		for (size_t ll=0; ll<columns.size(); ll++)
+			new_data.push_back( (old_pos[ll]!=IOUtils::npos)? vec_data[ line+old_pos[ll] ] : IOUtils::nodata );
+	}
+	vector<double>().swap(vec_data);
+
+	StationData header_sd(sd);
+	header_sd.position = previous.position;
+	const smet::SMETType type = (outputIsAscii)? smet::ASCII : smet::BINARY;
+	smet::SMETWriter mywriter(filename, type, outputIsGzipped);
+	generateHeaderInfo(header_sd, outputIsAscii, previous.isConsistent, previous.timezone, columns, mywriter);
+	if (outputIsAscii) mywriter.write(vec_timestamp, new_data);
+	else mywriter.write(new_data);
 }
 
 void SMETIO::generateHeaderInfo(const StationData& sd, const bool& i_outputIsAscii, const bool& isConsistent,
-                                const double& timezone, const size_t& nr_of_parameters,
-                                const std::vector<bool>& vecParamInUse, const std::vector<std::string>& vecColumnName,
+                                const double& timezone, const std::vector<std::string>& columns,
                                 smet::SMETWriter& mywriter)
 {
 	/**
@@ -564,17 +709,23 @@ void SMETIO::generateHeaderInfo(const StationData& sd, const bool& i_outputIsAsc
 
 	//Add all other used parameters
 	int tmpwidth, tmpprecision;
-	for (size_t ll=0; ll<nr_of_parameters; ll++) {
-		if (vecParamInUse[ll]) {
-			string column = vecColumnName.at(ll);
-			if (column == "RSWR") column = "OSWR";
-			if (column == "HNW")  column = "PSUM";
-			ss << " " << column;
-
-			getFormatting(ll, tmpprecision, tmpwidth);
-			myprecision.push_back(tmpprecision);
-			mywidth.push_back(tmpwidth);
+	for (size_t ll=0; ll<columns.size(); ll++) {
+		size_t param = IOUtils::npos; //the extra parameters get the default formatting
+		for (size_t kk=0; kk<MeteoData::nrOfParameters; kk++) {
+			if (MeteoData::getParameterName(kk) == columns[ll]) {
+				param = kk;
+				break;
+			}
 		}
+
+		string column = columns[ll];
+		if (column == "RSWR") column = "OSWR";
+		if (column == "HNW")  column = "PSUM";
+		ss << " " << column;
+
+		getFormatting(param, tmpprecision, tmpwidth);
+		myprecision.push_back(tmpprecision);
+		mywidth.push_back(tmpwidth);
 	}
 
 	mywriter.set_header_value("fields", ss.str());
@@ -23,6 +23,7 @@
 #include <meteoio/plugins/libsmet.h>
 
 #include <string>
+#include <map>
 
 namespace mio {
 
@@ -54,6 +55,8 @@ class SMETIO : public IOInterface {
 
 		virtual void writeMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo,
 		                            const std::string& name="");
+		virtual void appendMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo,
+		                             const std::string& name="");
 
 		virtual void readAssimilationData(const Date&, Grid2DObject& da_out);
 		virtual void readPOI(std::vector<Coords>& pts);
@@ -61,6 +64,23 @@ class SMETIO : public IOInterface {
 		virtual void write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date);
 
 	private:
+		///what has already been written to an output file, so more data can be appended to it
+		typedef struct SMET_OUTPUT {
+			SMET_OUTPUT() : end_date(), position(), columns(), timezone(IOUtils::nodata), isConsistent(true) {}
+			Date end_date;
+			Coords position;
+			std::vector<std::string> columns; ///< the parameters that are written in the file, in order
+			double timezone;
+			bool isConsistent;
+		} smet_output;
+
+		void writeStation(const std::vector<MeteoData>& vecMeteo, const size_t& station_nr, const bool& append_data);
+		void checkAppend(const std::vector<MeteoData>& vecMeteo, const smet_output& previous,
+		                 const StationData& sd, const bool& isConsistent);
+		static bool mergeColumns(const std::vector<bool>& vecParamInUse, const std::vector<std::string>& vecColumnName,
+		                         std::vector<std::string>& columns);
+		void rewriteColumns(const std::string& filename, const StationData& sd, const smet_output& previous,
+		                    const std::vector<std::string>& columns);
 		void read_meta_data(const smet::SMETReader& myreader, StationData& meta);
 		void identify_fields(const std::vector<std::string>& fields, std::vector<size_t>& indexes,
 		                     bool& julian_present, MeteoData& md);
@@ -75,9 +95,7 @@ class SMETIO : public IOInterface {
 		void getFormatting(const size_t& param, int& prec, int& width);
 		double olwr_to_tss(const double& olwr);
 		void generateHeaderInfo(const StationData& sd, const bool& i_outputIsAscii, const bool& isConsistent,
-		                        const double& timezone, const size_t& nr_of_parameters,
-		                        const std::vector<bool>& vecParamInUse,
-		                        const std::vector<std::string>& vecColumnName,
+		                        const double& timezone, const std::vector<std::string>& columns,
 		                        smet::SMETWriter& mywriter);
 
 		static const std::string dflt_extension;
@@ -85,6 +103,7 @@ class SMETIO : public IOInterface {
 		std::string coordin, coordinparam, coordout, coordoutparam; //default projection parameters
 		std::vector<smet::SMETReader> vec_smet_reader;
 		std::vector<std::string> vecFiles;  //read from the Config [Input] section
+		std::map<std::string, smet_output> written_files; //output files written by this instance
 		std::string outpath;                //read from the Config [Output] section
 		double in_dflt_TZ, out_dflt_TZ;     //default time zones
 		double plugin_nodata;
@@ -0,0 +1,629 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TiledIO.h"
+
+#if defined _WIN32 || defined __MINGW32__
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <zlib.h>
+#include <errno.h>
+#include <string.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+namespace mio {
+/**
+ * @page tiled TILED
+ * @section tiled_format Format
+ * This is MeteoIO's own binary grid format. The grid is split into square tiles that are stored (and optionally compressed)
+ * independently from each other, so a part of a grid can be read by only decoding the tiles that contain it. The files are
+ * mapped in memory, so only the parts of the file that are needed are actually read from the disk. This makes it efficient to
+ * read small areas out of very large grids (for example a sub-DEM around some points of interest, see TiledIO::readSubGrid).
+ *
+ * All the numbers are stored in little endian byte order. A file contains:
+ * - a 64 bytes header: the "MIOTILES" signature, the format version (uint32, currently 1), ncols, nrows, the tile size (in cells)
+ *   and the size of the values (4 for float32, 8 for float64) as uint32, then xllcorner, yllcorner, cellsize and the nodata value as float64;
+ * - the index of the tiles: for each tile, its position in the file (uint64) and its stored size in bytes (uint32). The tiles are ordered
+ *   from the lower left corner of the grid, row after row of tiles;
+ * - the tiles themselves. The cells of a tile are ordered from its lower left corner, row after row. The tiles on the right and top
+ *   edges of the grid only contain the cells that are within the grid. When a tile is compressed (its stored size is then smaller than
+ *   its number of cells times the size of the values), the bytes of its values are first grouped by significance (all the first bytes,
+ *   then all the second bytes, etc) and then compressed with zlib.
+ *
+ * The naming scheme for meteo grids is the same as for the \ref arc "ARC" plugin: YYYY-MM-DDTHH.mm_{MeteoGrids::Parameters}.mtg
+ *
+ * @section tiled_units Units
+ * The distances are assumed to be in meters.
+ *
+ * @section tiled_keywords Keywords
+ * This plugin uses the following keywords:
+ * - COORDSYS: input coordinate system (see Coords) specified in the [Input] section
+ * - COORDPARAM: extra input coordinates parameters (see Coords) specified in the [Input] section
+ * - COORDSYS: output coordinate system (see Coords) specified in the [Output] section
+ * - COORDPARAM: extra output coordinates parameters (see Coords) specified in the [Output] section
+ * - GRID2DPATH: meteo grids directory where to read/write the grids; [Input] and [Output] sections
+ * - GRID2DEXT: grid file extension, or <i>none</i> for no file extension (default: .mtg)
+ * - DEMFILE: for reading the data as a DEMObject
+ * - LANDUSEFILE: for interpreting the data as landuse codes
+ * - TILED_BBOX: only read the cells within the given bounding box, given as <i>xll yll xur yur</i> in the input coordinate system (optional,
+ *               [Input] section). This applies to all the grids that are read (dem, landuse and grid2d);
+ * - TILED_TILESIZE: size (in cells) of the tiles when writing grids (default: 256; [Output] section). Smaller tiles make reading small areas
+ *                   cheaper but compress less well;
+ * - TILED_DOUBLE: write the values as float64 instead of float32 (default: false; [Output] section);
+ * - TILED_COMPRESS: compress the tiles when writing grids (default: true; [Output] section). The tiles that would not become smaller
+ *                   are stored uncompressed.
+ *
+ * @code
+ * [Input]
+ * COORDSYS   = CH1903
+ * DEM        = TILED
+ * DEMFILE    = ./input/surface-grids/davos.mtg
+ * TILED_BBOX = 779000 185000 786000 191000
+ * @endcode
+ *
+ * In order to compile this plugin, you need zlib and its development files.
+ */
+
+const size_t TiledIO::header_size = 64;
+const size_t TiledIO::index_entry_size = 12;
+const double TiledIO::plugin_nodata = -9999.; //plugin specific nodata value. It can also be read by the plugin (depending on what is appropriate)
+static const char signature[8] = {'M','I','O','T','I','L','E','S'};
+static const unsigned int format_version = 1;
+
+static bool isLittleEndian()
+{
+	static const unsigned int one = 1;
+	return (*reinterpret_cast<const unsigned char*>(&one) == 1);
+}
+
+static unsigned int readUInt32(const char* ptr)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(ptr);
+	return (static_cast<unsigned int>(bytes[3]) << 24) | (static_cast<unsigned int>(bytes[2]) << 16) | (static_cast<unsigned int>(bytes[1]) << 8) | bytes[0];
+}
+
+static void writeUInt32(const unsigned int& value, char* ptr)
+{
+	for (size_t ii=0; ii<4; ii++)
+		ptr[ii] = static_cast<char>( (value >> (8*ii)) & 0xFF );
+}
+
+//IEEE floating point number stored in little endian byte order
+template <class T> static T readFloat(const char* ptr)
+{
+	T value;
+	if (isLittleEndian()) {
+		memcpy(&value, ptr, sizeof(T));
+	} else {
+		char bytes[sizeof(T)];
+		for (size_t ii=0; ii<sizeof(T); ii++) bytes[ii] = ptr[sizeof(T)-1-ii];
+		memcpy(&value, bytes, sizeof(T));
+	}
+	return value;
+}
+
+template <class T> static void writeFloat(const T& value, char* ptr)
+{
+	if (isLittleEndian()) {
+		memcpy(ptr, &value, sizeof(T));
+	} else {
+		char bytes[sizeof(T)];
+		memcpy(bytes, &value, sizeof(T));
+		for (size_t ii=0; ii<sizeof(T); ii++) ptr[ii] = bytes[sizeof(T)-1-ii];
+	}
+}
+
+//the conversion through lat/lon is only done when needed, since it is not exactly reversible
+static void setProj(Coords& coords, const std::string& coordsys, const std::string& coordparam)
+{
+	std::string proj_type, proj_args;
+	coords.getProj(proj_type, proj_args);
+	if (proj_type!=coordsys || proj_args!=coordparam)
+		coords.setProj(coordsys, coordparam);
+}
+
+TiledIO::TiledIO(const std::string& configfile)
+        : cfg(configfile), coordin(), coordinparam(), coordout(), coordoutparam(),
+          grid2dpath_in(), grid2dpath_out(), grid2d_ext_in(), grid2d_ext_out(),
+          bbox(), tile_size(256), write_double(false), compress(true)
+{
+	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
+	getGridPaths();
+}
+
+TiledIO::TiledIO(const Config& cfgreader)
+        : cfg(cfgreader), coordin(), coordinparam(), coordout(), coordoutparam(),
+          grid2dpath_in(), grid2dpath_out(), grid2d_ext_in(), grid2d_ext_out(),
+          bbox(), tile_size(256), write_double(false), compress(true)
+{
+	IOUtils::getProjectionParameters(cfg, coordin, coordinparam, coordout, coordoutparam);
+	getGridPaths();
+}
+
+TiledIO::~TiledIO() throw()
+{
+
+}
+
+void TiledIO::getGridPaths() {
+	grid2dpath_in.clear(), grid2dpath_out.clear();
+	string tmp;
+	cfg.getValue("GRID2D", "Input", tmp, IOUtils::nothrow);
+	if (tmp == "TILED") //keep it synchronized with IOHandler.cc for plugin mapping!!
+		cfg.getValue("GRID2DPATH", "Input", grid2dpath_in);
+	tmp.clear();
+	cfg.getValue("GRID2D", "Output", tmp, IOUtils::nothrow);
+	if (tmp == "TILED") //keep it synchronized with IOHandler.cc for plugin mapping!!
+		cfg.getValue("GRID2DPATH", "Output", grid2dpath_out);
+
+	grid2d_ext_in = ".mtg";
+	cfg.getValue("GRID2DEXT", "Input", grid2d_ext_in, IOUtils::nothrow);
+	if(grid2d_ext_in=="none") grid2d_ext_in.clear();
+	grid2d_ext_out = ".mtg";
+	cfg.getValue("GRID2DEXT", "Output", grid2d_ext_out, IOUtils::nothrow);
+	if(grid2d_ext_out=="none") grid2d_ext_out.clear();
+
+	cfg.getValue("TILED_BBOX", "Input", bbox, IOUtils::nothrow);
+	if (!bbox.empty() && (bbox.size()!=4 || bbox[0]>bbox[2] || bbox[1]>bbox[3]))
+		throw InvalidArgumentException("TILED_BBOX must be given as \"xll yll xur yur\"", AT);
+	cfg.getValue("TILED_TILESIZE", "Output", tile_size, IOUtils::nothrow);
+	if (tile_size==0)
+		throw InvalidArgumentException("TILED_TILESIZE must be greater than zero", AT);
+	cfg.getValue("TILED_DOUBLE", "Output", write_double, IOUtils::nothrow);
+	cfg.getValue("TILED_COMPRESS", "Output", compress, IOUtils::nothrow);
+}
+
+void TiledIO::mapFile(const std::string& full_name, mapped_file& file)
+{
+	if (!IOUtils::validFileName(full_name)) {
+		throw InvalidFileNameException(full_name, AT);
+	}
+	if (!IOUtils::fileExists(full_name)) {
+		throw FileNotFoundException(full_name, AT);
+	}
+
+#if defined _WIN32 || defined __MINGW32__
+	const HANDLE fd = CreateFileA(full_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fd == INVALID_HANDLE_VALUE)
+		throw FileAccessException("Error opening file \"" + full_name + "\"", AT);
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(fd, &file_size) || file_size.QuadPart==0 || static_cast<double>(file_size.QuadPart)>static_cast<double>(static_cast<size_t>(-1))) {
+		CloseHandle(fd);
+		throw InvalidFormatException("Invalid size for file \"" + full_name + "\"", AT);
+	}
+	const HANDLE mapping = CreateFileMapping(fd, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fd); //the mapping keeps the file open
+	if (mapping == NULL)
+		throw FileAccessException("Error mapping file \"" + full_name + "\"", AT);
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == NULL) {
+		CloseHandle(mapping);
+		throw FileAccessException("Error mapping file \"" + full_name + "\"", AT);
+	}
+	file.data = static_cast<const char*>(data);
+	file.size = static_cast<size_t>(file_size.QuadPart);
+	file.handle = mapping;
+#else
+	const int fd = open(full_name.c_str(), O_RDONLY);
+	if (fd == -1) {
+		ostringstream ss;
+		ss << "Error opening file \"" << full_name << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
+	}
+	struct stat file_stat;
+	if (fstat(fd, &file_stat)!=0 || file_stat.st_size<=0) {
+		close(fd);
+		throw InvalidFormatException("Invalid size for file \"" + full_name + "\"", AT);
+	}
+	const size_t size = static_cast<size_t>(file_stat.st_size);
+	void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); //the mapping keeps the file open
+	if (data == MAP_FAILED) {
+		ostringstream ss;
+		ss << "Error mapping file \"" << full_name << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
+	}
+	file.data = static_cast<const char*>(data);
+	file.size = size;
+#endif
+}
+
+void TiledIO::unmapFile(mapped_file& file)
+{
+	if (file.data==NULL) return;
+#if defined _WIN32 || defined __MINGW32__
+	UnmapViewOfFile(file.data);
+	CloseHandle(static_cast<HANDLE>(file.handle));
+#else
+	munmap(const_cast<char*>(file.data), file.size);
+#endif
+	file.data = NULL;
+	file.size = 0;
+	file.handle = NULL;
+}
+
+void TiledIO::readHeader(const mapped_file& file, const std::string& full_name, tiled_header& header)
+{
+	if (file.size<header_size || memcmp(file.data, signature, sizeof(signature))!=0)
+		throw InvalidFormatException("File \"" + full_name + "\" is not a tiled grid", AT);
+	if (readUInt32(file.data+8) != format_version)
+		throw InvalidFormatException("Unsupported format version in file \"" + full_name + "\"", AT);
+
+	header.ncols = readUInt32(file.data+12);
+	header.nrows = readUInt32(file.data+16);
+	header.tile_size = readUInt32(file.data+20);
+	header.value_size = readUInt32(file.data+24);
+	header.xllcorner = readFloat<double>(file.data+32);
+	header.yllcorner = readFloat<double>(file.data+40);
+	header.cellsize = readFloat<double>(file.data+48);
+	header.nodata = readFloat<double>(file.data+56);
+	if (header.ncols==0 || header.nrows==0 || header.tile_size==0 || (header.value_size!=4 && header.value_size!=8))
+		throw InvalidFormatException("Invalid header in file \"" + full_name + "\"", AT);
+
+	if (header.ncols > static_cast<size_t>(-1)/header.nrows/header.value_size)
+		throw InvalidFormatException("Grid too large in file \"" + full_name + "\"", AT);
+	//a tile larger than the grid is the same as a single tile covering the grid, this keeps the tiles computations from overflowing
+	header.tile_size = std::min(header.tile_size, std::max(header.ncols, header.nrows));
+
+	//the number of tiles is checked against the size of the index before being multiplied, so it can not overflow
+	const size_t nx_tiles = header.ncols/header.tile_size + ((header.ncols%header.tile_size!=0)? 1 : 0);
+	const size_t ny_tiles = header.nrows/header.tile_size + ((header.nrows%header.tile_size!=0)? 1 : 0);
+	const size_t max_tiles = (file.size-header_size) / index_entry_size;
+	if (nx_tiles>max_tiles || ny_tiles>max_tiles/nx_tiles)
+		throw InvalidFormatException("Truncated tiles index in file \"" + full_name + "\"", AT);
+	const size_t nr_tiles = nx_tiles * ny_tiles;
+
+	//zlib can not compress more than 1032:1, so the tiles must be large enough to hold the grid
+	//(this keeps a hostile header from making us allocate a huge grid)
+	const size_t min_stored = header.ncols*header.nrows*header.value_size / 1032;
+	size_t stored = 0;
+
+	header.offsets.resize(nr_tiles);
+	header.sizes.resize(nr_tiles);
+	for (size_t ii=0; ii<nr_tiles; ii++) {
+		const char *entry = file.data + header_size + ii*index_entry_size;
+		const unsigned int offset_high = readUInt32(entry+4);
+		if (sizeof(size_t)<8 && offset_high!=0)
+			throw InvalidFormatException("File \"" + full_name + "\" is too large for this system", AT);
+		header.offsets[ii] = ((static_cast<size_t>(offset_high) << 16) << 16) | readUInt32(entry);
+		header.sizes[ii] = readUInt32(entry+8);
+		if (header.offsets[ii]>file.size || header.sizes[ii]>file.size-header.offsets[ii])
+			throw InvalidFormatException("Truncated tiles in file \"" + full_name + "\"", AT);
+		stored = (header.sizes[ii] >= min_stored-stored)? min_stored : stored+header.sizes[ii];
+	}
+	if (stored<min_stored)
+		throw InvalidFormatException("Inconsistent tiles sizes in file \"" + full_name + "\"", AT);
+}
+
+/**
+* @brief Decode one tile
+* @param file mapped file
+* @param header header of this file
+* @param tile index of the tile
+* @param buffer work space for decompressing the tile
+* @param values values of the tile's cells, from its lower left corner, row after row
+*/
+void TiledIO::readTile(const mapped_file& file, const tiled_header& header, const size_t& tile, std::vector<char>& buffer, std::vector<double>& values)
+{
+	const size_t nx_tiles = (header.ncols+header.tile_size-1)/header.tile_size;
+	const size_t tile_i = (tile % nx_tiles) * header.tile_size;
+	const size_t tile_j = (tile / nx_tiles) * header.tile_size;
+	const size_t nr_cells = std::min(header.tile_size, header.ncols-tile_i) * std::min(header.tile_size, header.nrows-tile_j);
+	const size_t vs = header.value_size;
+	const size_t raw_size = nr_cells * vs;
+	const char *data = file.data + header.offsets[tile];
+	values.resize(nr_cells);
+
+	if (header.sizes[tile] == raw_size) { //stored as it is
+		for (size_t ii=0; ii<nr_cells; ii++)
+			values[ii] = (vs==4)? readFloat<float>(data+ii*vs) : readFloat<double>(data+ii*vs);
+		return;
+	}
+
+	buffer.resize(raw_size);
+	uLongf dest_len = static_cast<uLongf>(raw_size);
+	if (uncompress(reinterpret_cast<Bytef*>(&buffer[0]), &dest_len, reinterpret_cast<const Bytef*>(data), static_cast<uLong>(header.sizes[tile]))!=Z_OK
+	    || dest_len!=raw_size) {
+		ostringstream ss;
+		ss << "Can not decompress tile " << tile;
+		throw InvalidFormatException(ss.str(), AT);
+	}
+
+	//the bytes have been grouped by significance before compressing
+	char bytes[8];
+	for (size_t ii=0; ii<nr_cells; ii++) {
+		for (size_t kk=0; kk<vs; kk++) bytes[kk] = buffer[kk*nr_cells + ii];
+		values[ii] = (vs==4)? readFloat<float>(bytes) : readFloat<double>(bytes);
+	}
+}
+
+/**
+* @brief Read the cells of a grid that intersect a given window
+* @param grid_out grid to fill
+* @param full_name file name, including its path
+* @param window xll, yll, xur, yur in the file's coordinates, or empty to read the whole grid
+*/
+void TiledIO::readWindow(Grid2DObject& grid_out, const std::string& full_name, const std::vector<double>& window)
+{
+	mapped_file file;
+	mapFile(full_name, file);
+
+	try {
+		tiled_header header;
+		readHeader(file, full_name, header);
+
+		//range of cells to read, the end being excluded
+		size_t i_start = 0, i_end = header.ncols, j_start = 0, j_end = header.nrows;
+		if (!window.empty()) {
+			static const double epsilon = 1e-6; //so the coordinates round trips through lat/lon do not add a row or column
+			const double i_min = floor( (window[0]-header.xllcorner) / header.cellsize + epsilon );
+			const double i_max = ceil( (window[2]-header.xllcorner) / header.cellsize - epsilon );
+			const double j_min = floor( (window[1]-header.yllcorner) / header.cellsize + epsilon );
+			const double j_max = ceil( (window[3]-header.yllcorner) / header.cellsize - epsilon );
+			i_start = static_cast<size_t>( std::max(0., i_min) );
+			i_end = static_cast<size_t>( std::min(static_cast<double>(header.ncols), std::max(0., i_max)) );
+			j_start = static_cast<size_t>( std::max(0., j_min) );
+			j_end = static_cast<size_t>( std::min(static_cast<double>(header.nrows), std::max(0., j_max)) );
+			if (i_start>=i_end || j_start>=j_end)
+				throw NoAvailableDataException("The requested bounding box does not intersect the grid \"" + full_name + "\"", AT);
+		}
+
+		Coords location(coordin, coordinparam);
+		location.setXY(header.xllcorner + static_cast<double>(i_start)*header.cellsize,
+		               header.yllcorner + static_cast<double>(j_start)*header.cellsize, IOUtils::nodata);
+		grid_out.set(i_end-i_start, j_end-j_start, header.cellsize, location);
+
+		//list the tiles that intersect the window
+		const size_t ts = header.tile_size;
+		const size_t nx_tiles = (header.ncols+ts-1)/ts;
+		std::vector<size_t> tiles;
+		for (size_t tj=j_start/ts; tj<=(j_end-1)/ts; tj++)
+			for (size_t ti=i_start/ts; ti<=(i_end-1)/ts; ti++)
+				tiles.push_back(tj*nx_tiles + ti);
+
+		//the tiles are independent from each other, so they are decoded in parallel
+		const long nr_tiles = static_cast<long>( tiles.size() );
+		std::vector<IOException*> errors(tiles.size(), NULL);
+		#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic)
+		#endif
+		for (long ii=0; ii<nr_tiles; ii++) {
+			const size_t tile = tiles[static_cast<size_t>(ii)];
+			try {
+				std::vector<char> buffer;
+				std::vector<double> values;
+				readTile(file, header, tile, buffer, values);
+
+				const size_t tile_i = (tile % nx_tiles) * ts;
+				const size_t tile_j = (tile / nx_tiles) * ts;
+				const size_t tile_nx = std::min(ts, header.ncols-tile_i);
+				const size_t tile_ny = std::min(ts, header.nrows-tile_j);
+				for (size_t jj=std::max(tile_j, j_start); jj<std::min(tile_j+tile_ny, j_end); jj++) {
+					for (size_t kk=std::max(tile_i, i_start); kk<std::min(tile_i+tile_nx, i_end); kk++) {
+						const double value = values[(jj-tile_j)*tile_nx + (kk-tile_i)];
+						grid_out.grid2D(kk-i_start, jj-j_start) = IOUtils::standardizeNodata(value, header.nodata);
+					}
+				}
+			} catch(const std::exception& e) {
+				const IOException *io_error = dynamic_cast<const IOException*>(&e);
+				errors[static_cast<size_t>(ii)] = (io_error!=NULL)? new IOException(*io_error) : new IOException(e.what(), AT);
+			}
+		}
+
+		for (size_t ii=0; ii<errors.size(); ii++) {
+			if (errors[ii]==NULL) continue;
+			const IOException tmp( *errors[ii] );
+			for (size_t jj=ii; jj<errors.size(); jj++) delete errors[jj];
+			throw tmp;
+		}
+	} catch(...) {
+		unmapFile(file);
+		throw;
+	}
+	unmapFile(file);
+}
+
+void TiledIO::read2DGrid_internal(Grid2DObject& grid_out, const std::string& full_name)
+{
+	readWindow(grid_out, full_name, bbox);
+}
+
+void TiledIO::readSubGrid(Grid2DObject& grid_out, const std::string& full_name, const Coords& llcorner, const Coords& urcorner)
+{
+	Coords ll(llcorner), ur(urcorner);
+	setProj(ll, coordin, coordinparam);
+	setProj(ur, coordin, coordinparam);
+
+	std::vector<double> window(4);
+	window[0] = ll.getEasting();
+	window[1] = ll.getNorthing();
+	window[2] = ur.getEasting();
+	window[3] = ur.getNorthing();
+	readWindow(grid_out, full_name, window);
+}
+
+void TiledIO::read2DGrid(Grid2DObject& grid_out, const std::string& filename)
+{
+	read2DGrid_internal(grid_out, grid2dpath_in+"/"+filename);
+}
+
+void TiledIO::read2DGrid(Grid2DObject& grid_out, const MeteoGrids::Parameters& parameter, const Date& date)
+{
+	std::string date_str = date.toString(Date::ISO);
+	std::replace( date_str.begin(), date_str.end(), ':', '.');
+	read2DGrid_internal(grid_out, grid2dpath_in + "/" + date_str + "_" + MeteoGrids::getParameterName(parameter) + grid2d_ext_in);
+}
+
+void TiledIO::readDEM(DEMObject& dem_out)
+{
+	string filename;
+	cfg.getValue("DEMFILE", "Input", filename);
+	read2DGrid_internal(dem_out, filename);
+}
+
+void TiledIO::readLanduse(Grid2DObject& landuse_out)
+{
+	string filename;
+	cfg.getValue("LANDUSEFILE", "Input", filename);
+	read2DGrid_internal(landuse_out, filename);
+}
+
+void TiledIO::readAssimilationData(const Date&, Grid2DObject&)
+{
+	//Nothing so far
+	throw IOException("Nothing implemented here", AT);
+}
+
+void TiledIO::readStationData(const Date&, std::vector<StationData>&)
+{
+	//Nothing so far
+	throw IOException("Nothing implemented here", AT);
+}
+
+void TiledIO::readMeteoData(const Date&, const Date&, std::vector< std::vector<MeteoData> >&,
+                            const size_t&)
+{
+	//Nothing so far
+	throw IOException("Nothing implemented here", AT);
+}
+
+void TiledIO::writeMeteoData(const std::vector< std::vector<MeteoData> >&, const std::string&)
+{
+	//Nothing so far
+	throw IOException("Nothing implemented here", AT);
+}
+
+void TiledIO::readPOI(std::vector<Coords>&)
+{
+	//Nothing so far
+	throw IOException("Nothing implemented here", AT);
+}
+
+void TiledIO::write2DGrid(const Grid2DObject& grid_in, const std::string& name)
+{
+	const std::string full_name = grid2dpath_out+"/"+name;
+	if (grid_in.ncols==0 || grid_in.nrows==0)
+		throw InvalidArgumentException("Can not write an empty grid to \"" + full_name + "\"", AT);
+
+	std::ofstream fout(full_name.c_str(), ios::out | ios::binary);
+	if (fout.fail()) {
+		ostringstream ss;
+		ss << "Error opening file \"" << full_name << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
+	}
+
+	Coords llcorner=grid_in.llcorner;
+	//we want to make sure that we are using the provided projection parameters
+	//so that we output is done in the same system as the inputs
+	setProj(llcorner, coordout, coordoutparam);
+
+	const size_t ts = tile_size;
+	const size_t nx_tiles = (grid_in.ncols+ts-1)/ts;
+	const size_t nr_tiles = nx_tiles * ((grid_in.nrows+ts-1)/ts);
+	const size_t vs = (write_double)? 8 : 4;
+
+	std::vector<char> header(header_size, 0);
+	memcpy(&header[0], signature, sizeof(signature));
+	writeUInt32(format_version, &header[8]);
+	writeUInt32(static_cast<unsigned int>(grid_in.ncols), &header[12]);
+	writeUInt32(static_cast<unsigned int>(grid_in.nrows), &header[16]);
+	writeUInt32(static_cast<unsigned int>(ts), &header[20]);
+	writeUInt32(static_cast<unsigned int>(vs), &header[24]);
+	writeFloat(llcorner.getEasting(), &header[32]);
+	writeFloat(llcorner.getNorthing(), &header[40]);
+	writeFloat(grid_in.cellsize, &header[48]);
+	writeFloat(plugin_nodata, &header[56]);
+	std::vector<char> index(nr_tiles*index_entry_size, 0); //written once the tiles are known
+	fout.write(&header[0], header.size());
+	fout.write(&index[0], index.size());
+
+	size_t offset = header_size + index.size();
+	std::vector<char> raw, shuffled, compressed;
+	for (size_t tile=0; tile<nr_tiles; tile++) {
+		const size_t tile_i = (tile % nx_tiles) * ts;
+		const size_t tile_j = (tile / nx_tiles) * ts;
+		const size_t tile_nx = std::min(ts, grid_in.ncols-tile_i);
+		const size_t tile_ny = std::min(ts, grid_in.nrows-tile_j);
+		const size_t nr_cells = tile_nx*tile_ny;
+		raw.resize(nr_cells*vs);
+		for (size_t jj=0; jj<tile_ny; jj++) {
+			for (size_t ii=0; ii<tile_nx; ii++) {
+				const double value = grid_in.grid2D(tile_i+ii, tile_j+jj);
+				const double out = (value==IOUtils::nodata)? plugin_nodata : value;
+				char *ptr = &raw[(jj*tile_nx+ii)*vs];
+				if (write_double) writeFloat(out, ptr);
+				else writeFloat(static_cast<float>(out), ptr);
+			}
+		}
+
+		const char *stored = &raw[0];
+		size_t stored_size = raw.size();
+		if (compress) {
+			shuffled.resize(raw.size());
+			for (size_t ii=0; ii<nr_cells; ii++)
+				for (size_t kk=0; kk<vs; kk++) shuffled[kk*nr_cells + ii] = raw[ii*vs + kk];
+			uLongf compressed_size = compressBound(static_cast<uLong>(raw.size()));
+			compressed.resize(compressed_size);
+			if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_size, reinterpret_cast<const Bytef*>(&shuffled[0]), static_cast<uLong>(raw.size()), Z_DEFAULT_COMPRESSION)==Z_OK
+			    && compressed_size<raw.size()) {
+				stored = &compressed[0];
+				stored_size = compressed_size;
+			}
+		}
+		fout.write(stored, stored_size);
+
+		char *entry = &index[tile*index_entry_size];
+		writeUInt32(static_cast<unsigned int>(offset & 0xFFFFFFFFUL), entry);
+		writeUInt32(static_cast<unsigned int>((offset >> 16) >> 16), entry+4);
+		writeUInt32(static_cast<unsigned int>(stored_size), entry+8);
+		offset += stored_size;
+	}
+
+	fout.seekp(header_size);
+	fout.write(&index[0], index.size());
+	fout.close();
+	if (fout.fail()) {
+		ostringstream ss;
+		ss << "Error writing file \"" << full_name << "\", possible reason: " << strerror(errno);
+		throw FileAccessException(ss.str(), AT);
+	}
+}
+
+void TiledIO::write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date)
+{
+	//the path will be added by write2DGrid
+	if(parameter==MeteoGrids::DEM || parameter==MeteoGrids::AZI || parameter==MeteoGrids::SLOPE) {
+		write2DGrid(grid_in, MeteoGrids::getParameterName(parameter) + grid2d_ext_out);
+	} else {
+		std::string date_str = date.toString(Date::ISO);
+		std::replace( date_str.begin(), date_str.end(), ':', '.');
+		write2DGrid(grid_in, date_str + "_" + MeteoGrids::getParameterName(parameter) + grid2d_ext_out);
+	}
+}
+
+} //namespace
@@ -0,0 +1,116 @@
+/***********************************************************************************/
+/*  Copyright 2014 WSL Institute for Snow and Avalanche Research    SLF-DAVOS      */
+/***********************************************************************************/
+/* This file is part of MeteoIO.
+    MeteoIO is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    MeteoIO is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with MeteoIO.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __TILEDIO_H__
+#define __TILEDIO_H__
+
+#include <meteoio/Config.h>
+#include <meteoio/IOInterface.h>
+#include <meteoio/IOUtils.h>
+#include <meteoio/Coords.h>
+#include <meteoio/IOExceptions.h>
+
+#include <string>
+#include <vector>
+
+namespace mio {
+
+/**
+ * @class TiledIO
+ * @brief This class reads and writes 2D grids as binary files split into tiles, so parts of a grid can be read
+ * without reading the whole file.
+ *
+ * @ingroup plugins
+ * @author Mathias Bavay
+ * @date   2014-06-10
+ */
+class TiledIO : public IOInterface {
+	public:
+		TiledIO(const std::string& configfile);
+		TiledIO(const Config& cfgreader);
+		~TiledIO() throw();
+
+		virtual void read2DGrid(Grid2DObject& grid_out, const std::string& parameter="");
+		virtual void read2DGrid(Grid2DObject& grid_out, const MeteoGrids::Parameters& parameter, const Date& date);
+
+		virtual void readDEM(DEMObject& dem_out);
+		virtual void readLanduse(Grid2DObject& landuse_out);
+
+		virtual void readStationData(const Date& date, std::vector<StationData>& vecStation);
+		virtual void readMeteoData(const Date& dateStart, const Date& dateEnd,
+		                           std::vector< std::vector<MeteoData> >& vecMeteo,
+		                           const size_t& stationindex=IOUtils::npos);
+
+		virtual void writeMeteoData(const std::vector< std::vector<MeteoData> >& vecMeteo,
+		                            const std::string& name="");
+
+		virtual void readAssimilationData(const Date&, Grid2DObject& da_out);
+		virtual void readPOI(std::vector<Coords>& pts);
+		virtual void write2DGrid(const Grid2DObject& grid_in, const std::string& filename);
+		virtual void write2DGrid(const Grid2DObject& grid_in, const MeteoGrids::Parameters& parameter, const Date& date);
+
+		/**
+		 * @brief Read the part of a grid that is contained in a given bounding box.
+		 * Only the tiles that intersect the bounding box are read from the file. The returned grid contains
+		 * all the cells that intersect the bounding box.
+		 * @param grid_out grid to fill
+		 * @param full_name file name, including its path
+		 * @param llcorner lower left corner of the bounding box
+		 * @param urcorner upper right corner of the bounding box
+		 */
+		void readSubGrid(Grid2DObject& grid_out, const std::string& full_name, const Coords& llcorner, const Coords& urcorner);
+
+	private:
+		///a file mapped in memory, its pages are only read when they are accessed
+		typedef struct MAPPED_FILE {
+			MAPPED_FILE() : data(NULL), size(0), handle(NULL) {}
+			const char *data;
+			size_t size;
+			void *handle; ///< system's handle of the mapping (only used on Windows)
+		} mapped_file;
+
+		///what is read from the file's header
+		typedef struct TILED_HEADER {
+			TILED_HEADER() : ncols(0), nrows(0), tile_size(0), value_size(0), xllcorner(0.), yllcorner(0.), cellsize(0.), nodata(0.), offsets(), sizes() {}
+			size_t ncols, nrows, tile_size, value_size;
+			double xllcorner, yllcorner, cellsize, nodata;
+			std::vector<size_t> offsets, sizes; ///< position and stored size of each tile
+		} tiled_header;
+
+		void getGridPaths();
+		void read2DGrid_internal(Grid2DObject& grid_out, const std::string& full_name);
+		void readWindow(Grid2DObject& grid_out, const std::string& full_name, const std::vector<double>& window);
+		static void readHeader(const mapped_file& file, const std::string& full_name, tiled_header& header);
+		static void readTile(const mapped_file& file, const tiled_header& header, const size_t& tile, std::vector<char>& buffer, std::vector<double>& values);
+		static void mapFile(const std::string& full_name, mapped_file& file);
+		static void unmapFile(mapped_file& file);
+
+		const Config cfg;
+		static const size_t header_size, index_entry_size;
+		static const double plugin_nodata; //plugin specific nodata value, e.g. -999
+		std::string coordin, coordinparam, coordout, coordoutparam; //projection parameters
+		std::string grid2dpath_in, grid2dpath_out;
+		std::string grid2d_ext_in, grid2d_ext_out; //file extension
+		std::vector<double> bbox; ///< bounding box to read (xll, yll, xur, yur), empty to read whole grids
+		size_t tile_size; ///< size of the tiles (in cells) to write
+		bool write_double; ///< write the values as float64 instead of float32?
+		bool compress; ///< compress the tiles when writing?
+};
+
+} //end namespace mio
+
+#endif
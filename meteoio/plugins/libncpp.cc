@@ -217,6 +217,20 @@ void read_data_2D(const int& ncid, const std::string& varname, const int& varid,
 		throw IOException("Could not retrieve data for variable '" + varname + "': " + nc_strerror(status), AT);
 }
 
+//returns the chunk length of the variable along the given dimension, 0 if the variable is not chunked
+size_t get_chunk_length(const int& ncid, const std::string& varname, const int& varid, const size_t& dim_index)
+{
+	int storage;
+	size_t chunks[NC_MAX_VAR_DIMS];
+
+	const int status = nc_inq_var_chunking(ncid, varid, &storage, chunks);
+	if (status != NC_NOERR)
+		throw IOException("Could not retrieve chunking for variable '" + varname + "': " + nc_strerror(status), AT);
+
+	if (storage == NC_CONTIGUOUS) return 0;
+	return chunks[dim_index];
+}
+
 void read_value(const int& ncid, const std::string& varname, const int& varid, double& data)
 {
 	read_value(ncid, varname, varid, 0, data);
@@ -57,6 +57,7 @@ namespace ncpp {
 	               const size_t& pos, const size_t& latlen, const size_t& lonlen, double*& data);
 	void read_data_2D(const int& ncid, const std::string& varname, const int& varid,
 	                  const size_t& record, const size_t& count, const size_t& length, double*& data);
+	size_t get_chunk_length(const int& ncid, const std::string& varname, const int& varid, const size_t& dim_index);
 	void read_value(const int& ncid, const std::string& varname, const int& varid, double& data);
 	void read_value(const int& ncid, const std::string& varname, const int& varid, const size_t& pos, double& data);
 	void read_data(const int& ncid, const std::string& varname, const int& varid, double*& data);
@@ -221,10 +221,10 @@ size_t SMETCommon::readLineToVec(const std::string& line_in, std::vector<std::st
 	return vec_string.size();
 }
 
-SMETWriter::SMETWriter(const std::string& in_filename, const SMETType& in_type, const bool& in_gzip)
+SMETWriter::SMETWriter(const std::string& in_filename, const SMETType& in_type, const bool& in_gzip, const bool& in_append)
            : other_header_keys(), ascii_precision(), ascii_width(), header(), mandatory_header_keys(), fout(),
              filename(in_filename), nodata_string(), smet_type(in_type), nodata_value(-999.), nr_of_fields(0),
-             julian_field(0), timestamp_field(0), location_wgs84(0), location_epsg(0), gzip(in_gzip),
+             julian_field(0), timestamp_field(0), location_wgs84(0), location_epsg(0), gzip(in_gzip), append(in_append),
              location_in_header(false), location_in_data_wgs84(false), location_in_data_epsg(false),
              timestamp_present(false), julian_present(false), file_is_binary(false)
 {
@@ -417,14 +417,17 @@ bool SMETWriter::valid_header()
 
 void SMETWriter::write(const std::vector<std::string>& vec_timestamp, const std::vector<double>& data)
 {
-	fout.open(filename.c_str(), ios::binary);
+	if (append) fout.open(filename.c_str(), ios::out | ios::app | ios::binary);
+	else fout.open(filename.c_str(), ios::binary);
 	if (fout.fail()) {
 		ostringstream ss;
 		ss << "Error opening file \"" << filename << "\" for writing, possible reason: " << strerror(errno);
 		throw SMETException(ss.str(), SMET_AT);
 	}
 
-	write_header(); //Write the header info, always in ASCII format
+	if (!append) write_header(); //Write the header info, always in ASCII format
+	else if (!valid_header()) //the header is still needed to format the data
+		throw SMETException("The header data you supplied is not valid, file \""+filename+"\" cannot be written", SMET_AT);
 
 	if (nr_of_fields == 0){
 		cleanup();
@@ -463,14 +466,17 @@ void SMETWriter::write(const std::vector<std::string>& vec_timestamp, const std:
 
 void SMETWriter::write(const std::vector<double>& data)
 {
-	fout.open(filename.c_str(), ios::binary);
+	if (append) fout.open(filename.c_str(), ios::out | ios::app | ios::binary);
+	else fout.open(filename.c_str(), ios::binary);
 	if (fout.fail()) {
 		ostringstream ss;
 		ss << "Error opening file \"" << filename << "\" for writing, possible reason: " << strerror(errno);
 		throw SMETException(ss.str(), SMET_AT);
 	}
 
-	write_header(); //Write the header info, always in ASCII format
+	if (!append) write_header(); //Write the header info, always in ASCII format
+	else if (!valid_header()) //the header is still needed to format the data
+		throw SMETException("The header data you supplied is not valid, file \""+filename+"\" cannot be written", SMET_AT);
 
 	if (nr_of_fields == 0){
 		cleanup();
@@ -1135,6 +1141,7 @@ void SMETReader::read_data_binary(std::ifstream& fin, std::vector<double>& vec_d
 	size_t linenr = 0;
 	streampos current_fpointer = static_cast<streampos>(-1);
 	while (!fin.eof()){
+		if (fin.peek() == EOF) break; //the last line has been read
 		const streampos tmp_fpointer = fin.tellg();
 		double julian = -1.0;
 		for (size_t ii=0; ii<nr_of_fields; ii++){
@@ -259,8 +259,11 @@ class SMETWriter {
 		 * @param[in] in_fname The filename of the SMET file to be written
 		 * @param[in] in_type  The type of the SMET file, i.e. smet::ASCII or smet::BINARY (default: ASCII)
 		 * @param[in] in_gzip  Whether the file should be zipped or not (default: false)
+		 * @param[in] in_append Whether the data should be appended to an existing file, in which case
+		 *            the header is only used to format the data and is not written again (default: false)
 		 */
-		SMETWriter(const std::string& in_fname, const SMETType& in_type=ASCII, const bool& in_gzip=false);
+		SMETWriter(const std::string& in_fname, const SMETType& in_type=ASCII, const bool& in_gzip=false,
+		           const bool& in_append=false);
 		~SMETWriter();
 
 		/**
@@ -333,7 +336,7 @@ class SMETWriter {
 		double nodata_value;
 		size_t nr_of_fields, julian_field, timestamp_field;
 		char location_wgs84, location_epsg;
-		bool gzip;
+		bool gzip, append;
 		bool location_in_header, location_in_data_wgs84, location_in_data_epsg;
 		bool timestamp_present, julian_present;
 		bool file_is_binary;
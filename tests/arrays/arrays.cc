@@ -204,6 +204,66 @@ bool matrix(const size_t& n) {
 	return status;
 }
 
+bool compactgrid(const unsigned int& n) {
+	cout << "Testing CompactGrid\n";
+	bool status = true;
+	srand((unsigned)time(0));
+	Coords llcorner("CH1903","");
+	llcorner.setXY(785425. , 191124., 1400.);
+
+	Grid2DObject grid(n, n, 100, llcorner);
+	for(unsigned int jj=0; jj<grid.getNy(); jj++) {
+		for(unsigned int ii=0; ii<grid.getNx(); ii++) {
+			grid.grid2D(ii,jj) = 1500. + (double)rand()/(double)RAND_MAX*1000.;
+		}
+	}
+	grid.grid2D(1,2) = IOUtils::nodata;
+
+	//double precision: exact copy
+	const CompactGrid<Grid2DObject> grid_double(grid, false);
+	Grid2DObject grid2;
+	grid_double.get(grid2);
+	if(!grid2.isSameGeolocalization(grid) || grid2.grid2D!=grid.grid2D) {
+		cout << "\terror: the double precision copy differs from the original grid!\n";
+		status=false;
+	}
+
+	//single precision: half the memory, same values up to float precision
+	const CompactGrid<Grid2DObject> grid_float(grid, true);
+	grid_float.get(grid2);
+	if(!grid2.isSameGeolocalization(grid) || grid2.grid2D(1,2)!=IOUtils::nodata || !grid2.grid2D.checkEpsilonEquality(grid.grid2D, 1e-3)) {
+		cout << "\terror: the single precision copy differs from the original grid!\n";
+		status=false;
+	}
+	if(grid_float.getMemorySize() >= grid_double.getMemorySize()*6/10) {
+		cout << "\terror: the single precision copy is too large!\n";
+		status=false;
+	}
+
+	//dem: the derived fields are kept too
+	const DEMObject dem(grid, true);
+	const CompactGrid<DEMObject> dem_float(dem, true);
+	DEMObject dem2;
+	dem_float.get(dem2);
+	if(!dem2.isSameGeolocalization(dem) || dem2.getUpdatePpt()!=dem.getUpdatePpt() || dem2.max_altitude!=dem.max_altitude
+	   || !dem2.grid2D.checkEpsilonEquality(dem.grid2D, 1e-3) || !dem2.slope.checkEpsilonEquality(dem.slope, 1e-4)
+	   || !dem2.Nz.checkEpsilonEquality(dem.Nz, 1e-6)) {
+		cout << "\terror: the single precision copy differs from the original dem!\n";
+		status=false;
+	}
+
+	//fields that are not computed stay empty
+	DEMObject dem_no_update(grid, false);
+	dem_no_update.setUpdatePpt(DEMObject::NO_UPDATE);
+	const CompactGrid<DEMObject> dem_no_update_float(dem_no_update, true);
+	dem_no_update_float.get(dem2);
+	if(!dem2.slope.isEmpty() || !dem2.Nx.isEmpty() || dem2.grid2D.isEmpty()) {
+		cout << "\terror: the dem fields are not restored as they were!\n";
+		status=false;
+	}
+
+	return status;
+}
 
 int main() {
 	const unsigned int n=50;
@@ -212,6 +272,7 @@ int main() {
 	const bool grid2d_status = grid2d(n);
 	const bool grid3d_status = grid3d(n);
 	const bool matrix_status = matrix(n);
-	if(grid1d_status!=true || grid2d_status!=true || grid3d_status!=true || matrix_status!=true) throw IOException("Grid/Matrix error", AT);
+	const bool compactgrid_status = compactgrid(n);
+	if(grid1d_status!=true || grid2d_status!=true || grid3d_status!=true || matrix_status!=true || compactgrid_status!=true) throw IOException("Grid/Matrix error", AT);
 	return 0;
 }
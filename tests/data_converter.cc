@@ -22,28 +22,18 @@ int main(int argc, char** argv) {
 	Config cfg("io.ini");
 	IOManager io(cfg);
 	//io.setProcessingLevel(IOManager::raw);
-	std::vector< std::vector<MeteoData> > vecMeteo;
 
-	std::cout << "Reading input data" << std::endl;
+	std::cout << "Converting data" << std::endl;
 
 	//Very basic conversion: get the whole data set at once, with its original sampling rate
+	//std::vector< std::vector<MeteoData> > vecMeteo;
 	//io.getMeteoData(d1, d2, vecMeteo);
+	//io.writeMeteoData(vecMeteo);
 
-	//More elaborate conversion: sample the data to a specific rate
-	//by looping over the time and calling readMeteoData for each timestep
-	std::vector<MeteoData> Meteo; //we need some intermediate storage, for storing data sets for 1 timestep
-	io.getMeteoData(d1, Meteo); //we need to know how many stations will be available
-	vecMeteo.insert(vecMeteo.begin(), Meteo.size(), std::vector<MeteoData>()); //allocation for the vectors
-	for(; d1<=d2; d1+=.5/24.) { //time loop, sampling rate = 1/24 day = 1 hour
-		io.getMeteoData(d1, Meteo); //read 1 timestep at once, forcing resampling to the timestep
-		for(unsigned int ii=0; ii<Meteo.size(); ii++) {
-			vecMeteo.at(ii).push_back(Meteo[ii]); //fill the data manually into the vector of vectors
-		}
-	}
-
-	//In both case, we write the data out
-	std::cout << "Writing output data" << std::endl;
-	io.writeMeteoData(vecMeteo);
+	//More elaborate conversion: sample the data to a specific rate (here .5/24 day = 30 minutes)
+	//and process it by chunks of 30 days, so long periods do not have to fit in memory.
+	//Each chunk is read, filtered, resampled and written before the next one is processed
+	io.streamMeteoData(d1, d2, 30., .5/24.);
 
 	std::cout << "Done!!" << std::endl;
 	return 0;
@@ -0,0 +1,131 @@
+#include <meteoio/MeteoIO.h>
+
+using namespace std;
+using namespace mio;
+
+//build a snapshot of a few stations, with TA set to a value that identifies the date
+MeteoSnapshot getSnapshot(const Date& date) {
+	METEO_SET vecMeteo;
+	for (size_t ii=0; ii<3; ii++) {
+		MeteoData md(date);
+		md.meta.stationID = string("STATION") + static_cast<char>('A'+ii);
+		md(MeteoData::TA) = date.getJulian(true) + static_cast<double>(ii);
+		vecMeteo.push_back(md);
+	}
+	return MeteoSnapshot(date, vecMeteo);
+}
+
+//check that the cached snapshot is the one of the given date
+bool checkSnapshot(const MeteoSnapshot* snapshot, const Date& date) {
+	if (snapshot==NULL) {
+		cout << "\terror: " << date.toString(Date::ISO) << " should be in the cache\n";
+		return false;
+	}
+	if (snapshot->getDate()!=date || snapshot->getNrStations()!=3
+	    || !IOUtils::checkEpsilonEquality(snapshot->getParameter(MeteoData::TA)[2], date.getJulian(true)+2., 1e-9)) {
+		cout << "\terror: wrong snapshot returned for " << date.toString(Date::ISO) << "\n";
+		return false;
+	}
+	return true;
+}
+
+bool regularSteps() {
+	cout << "Testing regular time steps\n";
+	bool status = true;
+	PointCache cache;
+	const Date start(2008, 12, 1, 0, 0, 1.);
+
+	for (size_t ii=0; ii<48; ii++)
+		cache.insert( getSnapshot(start + static_cast<double>(ii)/24.) );
+	if (cache.size()!=48) {
+		cout << "\terror: " << cache.size() << " snapshots in the cache instead of 48\n";
+		status = false;
+	}
+	for (size_t ii=0; ii<48; ii++) {
+		if (!checkSnapshot(cache.find(start + static_cast<double>(ii)/24.), start + static_cast<double>(ii)/24.))
+			status = false;
+	}
+	if (cache.find(start + 1./48.)!=NULL || cache.find(start - 1./24.)!=NULL) {
+		cout << "\terror: a date that has not been inserted has been found\n";
+		status = false;
+	}
+	if (cache.getStats().hits!=48 || cache.getStats().misses!=2) {
+		cout << "\terror: wrong usage statistics: " << cache.getStats().toString() << "\n";
+		status = false;
+	}
+
+	//replacing a snapshot does not add an entry
+	cache.insert( getSnapshot(start) );
+	if (cache.size()!=48 || !checkSnapshot(cache.peek(start), start)) {
+		cout << "\terror: replacing a snapshot fails\n";
+		status = false;
+	}
+
+	cache.clear();
+	if (cache.size()!=0 || cache.peek(start)!=NULL) {
+		cout << "\terror: clearing the cache fails\n";
+		status = false;
+	}
+	return status;
+}
+
+bool irregularSteps() {
+	cout << "Testing refined and irregular time steps\n";
+	bool status = true;
+	PointCache cache;
+	const Date start(2008, 12, 1, 0, 0, 1.);
+
+	//first every 6 hours, then every hour and finally at odd dates
+	vector<Date> dates;
+	for (size_t ii=0; ii<4; ii++) dates.push_back( start + static_cast<double>(ii)*.25 );
+	for (size_t ii=1; ii<6; ii++) dates.push_back( start + static_cast<double>(ii)/24. );
+	dates.push_back( start + 17./(24.*60.) );
+	dates.push_back( start + 1. + 7./(24.*60.) );
+
+	for (size_t ii=0; ii<dates.size(); ii++)
+		cache.insert( getSnapshot(dates[ii]) );
+	if (cache.size()!=dates.size()) {
+		cout << "\terror: " << cache.size() << " snapshots in the cache instead of " << dates.size() << "\n";
+		status = false;
+	}
+	for (size_t ii=0; ii<dates.size(); ii++) {
+		if (!checkSnapshot(cache.find(dates[ii]), dates[ii]))
+			status = false;
+	}
+	return status;
+}
+
+bool memoryLimit() {
+	cout << "Testing the memory limit\n";
+	bool status = true;
+	PointCache cache;
+	const Date start(2008, 12, 1, 0, 0, 1.);
+	const size_t snapshot_size = CacheStats::getMemorySize( getSnapshot(start) );
+	cache.setMaxMemory(10*snapshot_size);
+
+	for (size_t ii=0; ii<100; ii++)
+		cache.insert( getSnapshot(start + static_cast<double>(ii)/24.) );
+	if (cache.size()>10 || cache.getStats().bytes>10*snapshot_size) {
+		cout << "\terror: the memory limit is not respected: " << cache.getStats().toString() << "\n";
+		status = false;
+	}
+	if (cache.getStats().evictions<90) {
+		cout << "\terror: not enough evictions: " << cache.getStats().toString() << "\n";
+		status = false;
+	}
+	//the snapshots the furthest away from the last inserted one are evicted first
+	if (!checkSnapshot(cache.peek(start + 99./24.), start + 99./24.) || cache.peek(start)!=NULL) {
+		cout << "\terror: the wrong snapshots have been evicted\n";
+		status = false;
+	}
+	return status;
+}
+
+int main() {
+	const bool status_regular = regularSteps();
+	const bool status_irregular = irregularSteps();
+	const bool status_memory = memoryLimit();
+
+	if (!status_regular || !status_irregular || !status_memory) return 1;
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include <meteoio/MeteoIO.h>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+using namespace std;
+using namespace mio;
+
+//Process a period in several chunks with streamMeteoData() and check that the output is the same
+//as when the whole period is resampled at once and written with a single call to writeMeteoData()
+
+const double timestep = .5/24.; //half an hour
+const double chunk_size = 7.; //days
+const Date dateStart(2008, 12, 5, 0, 0, 1.);
+const Date dateEnd(2009, 1, 20, 0, 0, 1.);
+
+static bool readFile(const string& filename, string& content)
+{
+	ifstream fin(filename.c_str());
+	if (fin.fail()) return false;
+	ostringstream ss;
+	ss << fin.rdbuf();
+	content = ss.str();
+	return true;
+}
+
+//write a station whose HS only starts in the second chunk and that has an extra parameter
+//starting even later, so its output columns change while it is being streamed
+static void generateInput(Config cfg)
+{
+	cfg.addKey("METEOPATH", "Output", "./generated");
+	IOManager io(cfg);
+
+	Coords position("CH1903", "");
+	position.setLatLon(46.752399, 9.946666, 2390.);
+	const StationData sd(position, "LATE", "Late parameters");
+	const Date hs_start(2008, 12, 15, 0, 0, 1.);
+	const Date extra_start(2009, 1, 5, 0, 0, 1.);
+
+	vector< vector<MeteoData> > vecMeteo(1);
+	for (Date date(2008, 12, 1, 0, 0, 1.); date<=Date(2009, 1, 25, 0, 0, 1.); date+=1./24.) {
+		const double t = date.getJulian() - dateStart.getJulian();
+		MeteoData md(date, sd);
+		md(MeteoData::TA) = 265. + 5.*sin(2.*Cst::PI*t);
+		md(MeteoData::RH) = .8 + .1*cos(2.*Cst::PI*t);
+		md(MeteoData::HS) = (date>=hs_start)? .5 + .01*t : IOUtils::nodata;
+		const size_t extra = md.addParameter("SNOW_TEMP");
+		md(extra) = (date>=extra_start)? 270. - .1*t : IOUtils::nodata;
+		vecMeteo[0].push_back(md);
+	}
+	io.writeMeteoData(vecMeteo);
+}
+
+static bool streamAndCompare(const Config& cfg)
+{
+	//streamed output
+	IOManager io_stream(cfg);
+	const size_t nr_chunks = io_stream.streamMeteoData(dateStart, dateEnd, chunk_size, timestep);
+	if (nr_chunks<2) {
+		cerr << "error: the period has been written in " << nr_chunks << " chunk(s), expected several\n";
+		return false;
+	}
+
+	//one shot output
+	Config cfg_oneshot(cfg);
+	cfg_oneshot.addKey("METEOPATH", "Output", "./oneshot");
+	IOManager io_oneshot(cfg_oneshot);
+	vector< vector<MeteoData> > vecMeteo;
+	vector<MeteoData> Meteo;
+	for (Date date(dateStart); date<=dateEnd; date+=timestep) {
+		io_oneshot.getMeteoData(date, Meteo);
+		if (vecMeteo.empty()) vecMeteo.resize(Meteo.size());
+		if (Meteo.size()!=vecMeteo.size()) {
+			cerr << "error: the number of stations changes at " << date.toString(Date::ISO) << "\n";
+			return false;
+		}
+		for (size_t ii=0; ii<Meteo.size(); ii++)
+			vecMeteo[ii].push_back(Meteo[ii]);
+	}
+	io_oneshot.writeMeteoData(vecMeteo);
+
+	//compare the files
+	bool status = true;
+	for (size_t ii=0; ii<vecMeteo.size(); ii++) {
+		const string filename( vecMeteo[ii].front().meta.stationID + ".smet" );
+		string streamed, oneshot;
+		if (!readFile("./streamed/"+filename, streamed) || !readFile("./oneshot/"+filename, oneshot)) {
+			cerr << "error: could not read the output files for " << filename << "\n";
+			status = false;
+		} else if (streamed!=oneshot) {
+			cerr << "error: the streamed and one shot outputs differ for " << filename << "\n";
+			status = false;
+		}
+	}
+	if (!status) return false;
+
+	//outside of streaming, the files are overwritten
+	vector< vector<MeteoData> > vecLast(vecMeteo.size());
+	for (size_t ii=0; ii<vecMeteo.size(); ii++) {
+		MeteoData md( vecMeteo[ii].back() );
+		md.date += 1.;
+		vecLast[ii].push_back(md);
+	}
+	io_stream.writeMeteoData(vecLast);
+	io_oneshot.writeMeteoData(vecLast);
+	for (size_t ii=0; ii<vecLast.size(); ii++) {
+		const string filename( vecLast[ii].front().meta.stationID + ".smet" );
+		string streamed, oneshot;
+		if (!readFile("./streamed/"+filename, streamed) || !readFile("./oneshot/"+filename, oneshot) || streamed!=oneshot) {
+			cerr << "error: " << filename << " has not been overwritten by writeMeteoData\n";
+			status = false;
+		}
+	}
+
+	if (status) cout << "Streamed " << nr_chunks << " chunks, identical to the one shot output\n";
+	return status;
+}
+
+int main() {
+	const Config cfg("io.ini");
+	if (!streamAndCompare(cfg)) return 1;
+
+	//parameters that only get data after the first chunk
+	generateInput(cfg);
+	Config cfg_late(cfg);
+	cfg_late.addKey("METEOPATH", "Input", "./generated");
+	cfg_late.addKey("STATION1", "Input", "LATE");
+	cfg_late.deleteKey("STATION2", "Input");
+	cfg_late.deleteKey("STATION3", "Input");
+	if (!streamAndCompare(cfg_late)) return 1;
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+#include <meteoio/MeteoIO.h>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+using namespace mio;
+
+//Write a dem as tiled grids with various options, read it back (whole or partially) and compare with the original
+
+Config getConfig(const string& demfile) {
+	Config cfg;
+	cfg.addKey("COORDSYS", "Input", "CH1903");
+	cfg.addKey("DEM", "Input", "ARC");
+	cfg.addKey("DEMFILE", "Input", demfile);
+	cfg.addKey("GRID2D", "Input", "TILED");
+	cfg.addKey("GRID2DPATH", "Input", ".");
+	cfg.addKey("COORDSYS", "Output", "CH1903");
+	cfg.addKey("GRID2D", "Output", "TILED");
+	cfg.addKey("GRID2DPATH", "Output", ".");
+	return cfg;
+}
+
+//compare the cells of grid with the cells of ref at the same positions
+bool compareGrids(const Grid2DObject& ref, const Grid2DObject& grid, const double& rel_epsilon) {
+	const double offset_x = (grid.llcorner.getEasting() - ref.llcorner.getEasting()) / ref.cellsize;
+	const double offset_y = (grid.llcorner.getNorthing() - ref.llcorner.getNorthing()) / ref.cellsize;
+	const long ii0 = static_cast<long>(floor(offset_x + .5)), jj0 = static_cast<long>(floor(offset_y + .5));
+	if (grid.cellsize!=ref.cellsize || fabs(offset_x-static_cast<double>(ii0))>1e-6 || fabs(offset_y-static_cast<double>(jj0))>1e-6
+	    || ii0<0 || jj0<0 || static_cast<size_t>(ii0)+grid.ncols>ref.ncols || static_cast<size_t>(jj0)+grid.nrows>ref.nrows) {
+		cout << "\terror: the grid is not aligned with the original grid\n";
+		return false;
+	}
+
+	for (size_t jj=0; jj<grid.nrows; jj++) {
+		for (size_t ii=0; ii<grid.ncols; ii++) {
+			const double ref_val = ref.grid2D(ii+static_cast<size_t>(ii0), jj+static_cast<size_t>(jj0));
+			const double val = grid.grid2D(ii, jj);
+			if ((ref_val==IOUtils::nodata) != (val==IOUtils::nodata) || fabs(val-ref_val)>rel_epsilon*fabs(ref_val)) {
+				cout << "\terror: cell (" << ii << "," << jj << ") is " << val << " instead of " << ref_val << "\n";
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool roundTrip(const string& demfile, const DEMObject& dem, const string& tile_size, const bool& write_double, const bool& compress) {
+	cout << "Testing tiles of " << tile_size << " cells, " << ((write_double)? "float64" : "float32") << ", "
+	     << ((compress)? "compressed" : "uncompressed") << "\n";
+	const string filename( "dem_"+tile_size+((write_double)? "_d" : "_f")+((compress)? "_z" : "_r")+".mtg" );
+
+	Config cfg( getConfig(demfile) );
+	cfg.addKey("TILED_TILESIZE", "Output", tile_size);
+	cfg.addKey("TILED_DOUBLE", "Output", (write_double)? "true" : "false");
+	cfg.addKey("TILED_COMPRESS", "Output", (compress)? "true" : "false");
+	IOManager io(cfg);
+	io.write2DGrid(dem, filename);
+
+	Grid2DObject grid;
+	io.read2DGrid(grid, filename);
+	if (grid.ncols!=dem.ncols || grid.nrows!=dem.nrows) {
+		cout << "\terror: the grid has been read as " << grid.ncols << "x" << grid.nrows << " instead of " << dem.ncols << "x" << dem.nrows << "\n";
+		return false;
+	}
+	return compareGrids(dem, grid, (write_double)? 0. : 1e-6);
+}
+
+bool boundingBox(const string& demfile, const DEMObject& dem) {
+	cout << "Testing the bounding box\n";
+	const double xll = dem.llcorner.getEasting(), yll = dem.llcorner.getNorthing();
+	ostringstream bbox;
+	bbox << fixed << xll+30.*dem.cellsize << " " << yll+40.*dem.cellsize << " " << xll+80.*dem.cellsize << " " << yll+70.*dem.cellsize;
+
+	Config cfg( getConfig(demfile) );
+	cfg.addKey("TILED_TILESIZE", "Output", "16");
+	cfg.addKey("TILED_DOUBLE", "Output", "true");
+	cfg.addKey("TILED_BBOX", "Input", bbox.str());
+	IOManager io(cfg);
+	io.write2DGrid(dem, "dem_bbox.mtg");
+
+	Grid2DObject grid;
+	io.read2DGrid(grid, "dem_bbox.mtg");
+	if (grid.ncols<50 || grid.ncols>51 || grid.nrows<30 || grid.nrows>31) {
+		cout << "\terror: the bounding box has been read as " << grid.ncols << "x" << grid.nrows << " cells instead of 50x30\n";
+		return false;
+	}
+	return compareGrids(dem, grid, 0.);
+}
+
+//a file is written with the given header values, reading it must report an invalid format
+bool invalidFile(const string& demfile, const unsigned int& ncols, const unsigned int& nrows, const unsigned int& tile_size, const size_t& file_size) {
+	char buffer[128] = {0};
+	memcpy(buffer, "MIOTILES", 8);
+	const unsigned int header[5] = {1, ncols, nrows, tile_size, 4};
+	for (size_t ii=0; ii<5; ii++) { //little endian
+		for (size_t kk=0; kk<4; kk++)
+			buffer[8+ii*4+kk] = static_cast<char>((header[ii] >> (8*kk)) & 0xff);
+	}
+	ofstream fout("invalid.mtg", ios::out | ios::binary);
+	fout.write(buffer, static_cast<streamsize>(file_size));
+	fout.close();
+
+	IOManager io( getConfig(demfile) );
+	Grid2DObject grid;
+	try {
+		io.read2DGrid(grid, "invalid.mtg");
+	} catch(const InvalidFormatException&) {
+		return true;
+	} catch(const std::exception& e) {
+		cout << "\terror: wrong exception for an invalid file: " << e.what() << "\n";
+		return false;
+	}
+	cout << "\terror: an invalid file has been read\n";
+	return false;
+}
+
+int main(int argc, char** argv) {
+	if (argc!=2) {
+		cout << "Usage: " << argv[0] << " {ARC dem file}\n";
+		return 1;
+	}
+	const string demfile( argv[1] );
+
+	DEMObject dem;
+	dem.setUpdatePpt(DEMObject::NO_UPDATE);
+	IOManager io( getConfig(demfile) );
+	io.readDEM(dem);
+
+	bool status = true;
+	if (!roundTrip(demfile, dem, "64", false, true)) status = false;
+	if (!roundTrip(demfile, dem, "7", true, true)) status = false;
+	if (!roundTrip(demfile, dem, "100", true, false)) status = false;
+	if (!roundTrip(demfile, dem, "5000", false, false)) status = false;
+	if (!boundingBox(demfile, dem)) status = false;
+
+	cout << "Testing invalid files\n";
+	if (!invalidFile(demfile, 10, 10, 4, 30)) status = false; //truncated header
+	if (!invalidFile(demfile, 0xffffffff, 0xffffffff, 1, 128)) status = false; //too many tiles
+	if (!invalidFile(demfile, 0xffffffff, 2, 0xffffffff, 128)) status = false; //huge tiles
+	if (!invalidFile(demfile, 10, 10, 4, 128)) status = false; //truncated index
+
+	if (!status) return 1;
+	return 0;
+}